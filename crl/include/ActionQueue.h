@@ -0,0 +1,163 @@
+/** ***********************************************************************************
+ * \file ActionQueue.h
+ * \author Ariane Piel & Jean Bourrely / Onera DCPS
+ * \date 2014
+ * \brief Asynchronous delivery of the new recognitions by batches
+ **************************************************************************************/
+
+/*  Copyright (C) 2012, 2013, 2014  ONERA  http://www.onera.fr
+    This file is part of CRL : Chronicle Recognition Library.
+
+    CRL is free software: you can redistribute it and/or modify it under
+    the terms of the Lesser GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    CRL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    Lesser GNU General Public License for more details.
+
+    You should have received a copy of the Lesser GNU General Public License
+    along with CRL.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef ACTION_QUEUE_H_
+#define ACTION_QUEUE_H_
+
+// ----------------------------------------------------------------------------
+// INCLUDE FILES
+// ----------------------------------------------------------------------------
+
+#include <vector>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+
+#include "RecoTree.h"
+
+
+// ----------------------------------------------------------------------------
+// CLASS DESCRIPTION
+// ----------------------------------------------------------------------------
+
+namespace CRL {
+
+  class ActionQueue
+  {
+  public:
+
+    //! Signature of the user function receiving the batches of new recognitions
+    typedef void (*BatchFunction)(const std::vector<RecoTree*>& batch);
+
+  private:
+
+    //! Lock-free ring buffer, with a single producer thread and a single consumer thread
+    class Ring
+    {
+    private:
+
+      //! Slots (one is always left empty)
+      std::vector<RecoTree*> _slots;
+
+      //! Next slot to be read, written by the consumer only
+      std::atomic<size_t> _head;
+
+      //! Next slot to be written, written by the producer only
+      std::atomic<size_t> _tail;
+
+    public:
+
+      //! Constructor
+      Ring(size_t capacity) : _slots(capacity + 1, NULL), _head(0), _tail(0) { }
+
+      //! Producer side, returns false if the ring is full
+      bool push(RecoTree* rc);
+
+      //! Consumer side, returns false if the ring is empty
+      bool pop(RecoTree*& rc);
+
+      //! Tests whether the ring is empty
+      bool empty() const { return (_head.load() == _tail.load()); }
+
+    }; // class Ring
+
+    //! User function called by the consumer thread
+    BatchFunction _batchFunction;
+
+    //! Maximal number of recognitions per batch
+    size_t _maxBatchSize;
+
+    //! New recognitions, from the engine to the consumer thread
+    Ring _outbound;
+
+    //! Delivered recognitions, from the consumer thread back to the engine which releases them
+    Ring _delivered;
+
+    //! Number of recognitions pushed (engine side)
+    unsigned long _pushedCount;
+
+    //! Number of recognitions delivered to the user function
+    std::atomic<unsigned long> _deliveredCount;
+
+    //! Number of calls of the user function
+    std::atomic<unsigned long> _batchCount;
+
+    //! Asks the consumer thread to stop once the queue is empty
+    std::atomic<bool> _stopping;
+
+    //! Indicates that the consumer thread has stopped
+    std::atomic<bool> _finished;
+
+    //! Indicates that the consumer thread waits for recognitions
+    std::atomic<bool> _sleeping;
+
+    //! Mutex of #_wakeUp (the rings themselves are lock-free)
+    std::mutex _mutex;
+
+    //! Wakes the consumer thread up
+    std::condition_variable _wakeUp;
+
+    //! Consumer thread
+    std::thread _consumer;
+
+  public:
+
+    //! Constructor, starts the consumer thread
+    ActionQueue(BatchFunction f, size_t capacity = 1024, size_t maxBatchSize = 64);
+
+    //! Destructor, delivers the pending recognitions then stops the consumer thread
+    ~ActionQueue();
+
+    //! Queues a new recognition, held until it is delivered (engine side)
+    void push(RecoTree* rc);
+
+    //! Releases the recognitions already delivered (engine side)
+    void collect();
+
+    //! Waits until all the recognitions queued are delivered, then releases them (engine side)
+    void flush();
+
+    //! Accessor
+    unsigned long getDeliveredCount() const { return _deliveredCount.load(); }
+
+    //! Accessor
+    unsigned long getBatchCount() const { return _batchCount.load(); }
+
+  private:
+
+    //! Loop of the consumer thread
+    void run();
+
+    //! Copy forbidden
+    ActionQueue(const ActionQueue&);
+
+    //! Copy forbidden
+    ActionQueue& operator=(const ActionQueue&);
+
+  }; // class ActionQueue
+
+} /* namespace CRL */
+
+#endif /* ACTION_QUEUE_H_ */
@@ -32,11 +32,18 @@
 
 #include <string>
 #include <set>
+#include <map>
+#include <list>
+#include <unordered_set>
 #include <iostream>
 
 #include "Event.h"
 #include "Context.h"
 #include "RecoTree.h"
+#include "RecoIndex.h"
+#include "RecoColumns.h"
+#include "RecoBudget.h"
+#include "ChronicleArena.h"
 #include "Property.h"
 
 
@@ -52,8 +59,19 @@ namespace CRL {
   {
   public:
 
-    //! Data type : set of recognition trees
-    typedef std::set<RecoTree*> RecoSet;
+    //! Data type : set of recognition trees, in the order of insertion
+    typedef CRL::RecoSet RecoSet;
+
+    //! Data type : set of recognition trees, without structural duplicates (see RecoTree::equal)
+    typedef std::unordered_set<const RecoTree*, RecoTreeHash, RecoTreeEqual> RecoHashSet;
+
+    //! Data type : recognition trees ordered by maximal date (expiry order)
+    typedef std::multimap<DateType, RecoTree*> ExpiryQueue;
+
+  private:
+
+    //! Arena in which the chronicles are allocated (NULL: heap)
+    static ChronicleArena* _allocationArena;
 
   protected:
 
@@ -66,6 +84,15 @@ namespace CRL {
     //! Set of the new recognitions of the chronicle (during #process)
     RecoSet _newRecognitions;
 
+    //! Recognition set ordered by maximal date, maintained when a peremption duration is set
+    ExpiryQueue _expiryQueue;
+
+    //! Hash indexes of the recognition set, requested by the parent chronicles (equi-joins)
+    std::list<RecoIndex*> _indexes;
+
+    //! Columns of the orders of the recognition set, a row per position of the set, requested by the parent chronicles (NULL: none)
+    RecoColumns* _columns;
+
     //! Evaluation context of the (possible) predicate of the chronicle
     Context _evaluationContext;
 
@@ -100,13 +127,39 @@ namespace CRL {
     //! Peremption duration
     DurationType _peremptionDuration;
 
+    //! Budget of the recognition set (NULL: unbounded)
+    RecoBudget* _budget;
+
+    //! Number of recognitions evicted from the recognition set
+    unsigned long _evictionCount;
+
+    //! Retention horizon inferred from the temporal constraints (negative value: unbounded)
+    DurationType _retentionHorizon;
+
+    //! Number of additional parents sharing the chronicle (see RecognitionEngine::setShareSubChronicles)
+    int _shareCount;
+
+    //! Indicates whether the chronicle belongs to a tree rewritten by the optimizer (see ChronicleOptimizer)
+    bool _rewritten;
+
+    //! Indicates whether the recognitions are only counted, not built (see #setCountOnly)
+    bool _countOnly;
+
+    //! Number of recognitions at the last event processed (count-only mode)
+    double _newCount;
+
+    //! Number of recognitions since the beginning (count-only mode)
+    double _count;
+
   public:
 
     //! Constructor, by default purgeable
     Chronicle()
-      : _name(""), _purgeable(true), 
+      : _name(""), _columns(NULL), _purgeable(true), 
         _alreadyProcessed(false), _hasNewRecognitions(false), _hasOutputPropertiesMethod(false),
-        _myEngine(NULL), _predicateFunction(NULL), _outputFunction(NULL), _actionFunction(NULL), _peremptionDuration(-1.0) { }
+        _myEngine(NULL), _predicateFunction(NULL), _outputFunction(NULL), _actionFunction(NULL), _peremptionDuration(-1.0),
+        _budget(NULL), _evictionCount(0), _retentionHorizon(-1.0),
+        _shareCount(0), _rewritten(false), _countOnly(false), _newCount(0.0), _count(0.0) { }
 
   protected:
 
@@ -115,11 +168,35 @@ namespace CRL {
 
   public:
 
+    //! Allocation, in the current arena if any (see #setAllocationArena)
+    static void* operator new(size_t size);
+
+    //! Deallocation, in the arena of the allocation if any
+    static void operator delete(void* ptr);
+
+    //! Sets the arena of the next allocations (NULL: heap), returns the previous one
+    static ChronicleArena* setAllocationArena(ChronicleArena* arena);
+
     //! Calls the destructor
     void destroy() { delete this; }
 
     //! Deletes sub-chronicles (if any), and calls the destructor
-    virtual void deepDestroy() { delete this; }
+    virtual void deepDestroy() { if (!unshare()) delete this; }
+
+    //! Registers an additional parent of the chronicle
+    void share() { _shareCount++; }
+
+    //! Unregisters an additional parent, returns false if the chronicle is no longer shared
+    bool unshare() { if (_shareCount == 0) return false; _shareCount--; return true; }
+
+    //! Accessor, returns the number of additional parents of the chronicle
+    int getShareCount() const { return _shareCount; }
+
+    //! Accessor
+    void setRewritten(bool b) { _rewritten = b; }
+
+    //! Accessor
+    bool isRewritten() const { return _rewritten; }
 
     //! Function to be re-defined in the sub-classes
     virtual std::string toString() const = 0;
@@ -136,6 +213,12 @@ namespace CRL {
     //! Main event processing function
     virtual bool process(const DateType& d, CRL::Event* e = NULL) = 0;
 
+    //! Marks the chronicle as processed without new recognition (see ChroniclePlan)
+    void skipProcess() { _alreadyProcessed = true; _hasNewRecognitions = false; _newCount = 0.0; }
+
+    //! Accessor, true if the chronicle has had new recognitions for the current event
+    bool hasNewRecognitions() const { return _hasNewRecognitions; }
+
     //! Accessor
     bool isPurgeable() const { return _purgeable; }
 
@@ -200,6 +283,12 @@ namespace CRL {
     //! Empties the new recognition set
     virtual void purgeNewRecognitions(bool daughtersOnly = false);
 
+    //! Removes a recognition from the new recognition set, releasing it if no longer in a set
+    RecoSet::iterator eraseNewRecognition(RecoSet::iterator it);
+
+    //! Removes a recognition from the recognition set, used by the parents consuming it
+    void consumeRecognition(RecoTree* rc) { removeRecognition(rc); }
+
     //! Empties the recognition set (optimisation purpose)
     virtual void purgeRecognitionsIfPurgeable();
 
@@ -207,14 +296,60 @@ namespace CRL {
     DurationType getPeremptionDuration() { return _peremptionDuration; }
 
     //! Accessor
-    virtual void setPeremptionDuration(double duration, bool recursive){ _peremptionDuration = duration; }
+    virtual void setPeremptionDuration(DurationType duration, bool recursive);
 
     //! Empties the recognition sets of too old recognitions (optimisation purpose)
     virtual void purgeOldRecognitions();
 
-    //! Determines whether a recognition tree belongs to a given set
+    //! Bounds the size of the recognition set (negative value: unbounded)
+    void setRecognitionBudget(long maxRecognitions, 
+                              RecoBudget::Policy policy = RecoBudget::OLDEST_MAX_DATE);
+
+    //! Accessor, returns the maximal size of the recognition set (-1: unbounded)
+    long getRecognitionBudget() const { return (_budget == NULL) ? -1L : (long)_budget->getMaxSize(); }
+
+    //! Accessor, returns the number of recognitions evicted from the recognition set
+    unsigned long getEvictionCount() const { return _evictionCount; }
+
+    //! Evicts one recognition from the recognition set, returns false if the set is empty
+    bool evictRecognition();
+
+    //! Inserts an existing recognition in the recognition set, not as a new recognition (change of plan)
+    void adoptRecognition(RecoTree* rc);
+
+    //! Accessor, returns the inferred retention horizon (negative value: unbounded)
+    DurationType getRetentionHorizon() const { return _retentionHorizon; }
+
+    //! Resets the retention horizon before a new analysis
+    void resetRetentionHorizon() { _retentionHorizon = 0.0; }
+
+    //! Widens the retention horizon to \a horizon (negative value: unbounded)
+    void mergeRetentionHorizon(DurationType horizon);
+
+    //! Infers the retention horizons of the sub-chronicles (static analysis)
+    virtual void inferRetentionHorizons(DurationType) { }
+
+    //! Narrows a window (negative value: unbounded) to \a bound
+    static DurationType narrowWindow(DurationType window, DurationType bound);
+
+    //! Returns a hash index of the recognition set on keys \a paths (created if necessary)
+    RecoIndex* requestIndex(const RecoIndex::KeyPaths& paths);
+
+    //! Deletes an index returned by #requestIndex
+    void releaseIndex(RecoIndex* index);
+
+    //! Accessor, number of hash indexes of the recognition set
+    size_t getIndexCount() const { return _indexes.size(); }
+
+    //! Returns the columns of the dates and orders of the recognition set (created if necessary)
+    const RecoColumns& getColumns();
+
+    //! Determines whether a recognition tree belongs to a given set (linear scan)
     static bool isIn(const RecoTree& elmt, const RecoSet& rset);
 
+    //! Determines whether a recognition tree belongs to a given set (constant time)
+    static bool isIn(const RecoTree& elmt, const RecoHashSet& rset) { return (rset.count(&elmt) != 0); }
+
     //! Returns the date in the future at which the recognitions set of the chronicle must be re-assessed
     virtual DateType lookAhead(const DateType& tcurr) const = 0;
 
@@ -233,6 +368,30 @@ namespace CRL {
     //! Tests during recognitions whether an action has been provided by the user 
     bool hasOutputFunction() const;
 
+    //! Tests whether a predicate function has been provided by the user
+    bool hasPredicateFunction() const { return (_predicateFunction != NULL); }
+
+    //! Tests whether an action function has been provided by the user
+    bool hasActionFunction() const { return (_actionFunction != NULL); }
+
+    //! Only counts the recognitions of the chronicle tree, without building them
+    void setCountOnly(bool b);
+
+    //! Accessor
+    bool isCountOnly() const { return _countOnly; }
+
+    //! Accessor, returns the number of recognitions at the last event processed (count-only mode)
+    double getNewCount() const { return _newCount; }
+
+    //! Accessor, returns the number of recognitions since the beginning (count-only mode)
+    double getCount() const { return _count; }
+
+    //! Indicates whether the chronicle may count its recognitions without building them
+    virtual bool supportsCountOnly() const { return false; }
+
+    //! Indicates whether all the recognitions begin and end with the same event
+    virtual bool isInstantaneous() const { return false; }
+
     //! Output flow for tests
     friend std::ostream& operator<<(std::ostream& os, const Chronicle& cr);
 
@@ -251,9 +410,32 @@ namespace CRL {
     //! Return the right part of binary chronicles
     Chronicle* getChildRight() { return getChild2(); }
 
+    //! Replaces the (first) sub-chronicle, if any
+    virtual void setChild1(Chronicle*) { }
+
+    //! Replaces the right sub-chronicle, if any
+    virtual void setChild2(Chronicle*) { }
+
+    //! Indicates whether the chronicle removes recognitions from its sub-chronicles (forbids sharing them)
+    virtual bool consumesChildRecognitions() const { return false; }
+
+    //! Returns a string identifying the structure and the settings of the chronicle tree
+    virtual std::string structuralSignature() const;
+
 
   protected:
 
+    //! Removes a recognition (at position \a pos of the recognition set) from the hash indexes and the columns
+    void unindexRecognition(RecoTree* rc, size_t pos);
+
+    //! Releases a recognition if it no longer belongs to any recognition set
+    void releaseIfUnheld(RecoTree* rc);
+
+    //! Removes a recognition from the recognition set and its auxiliary structures
+    void removeRecognition(RecoTree* rc);
+
+    //! Count-only version of #process, updates _newCount and _count (see #setCountOnly)
+    virtual bool processCount(const DateType& d, CRL::Event* e);
 
     //! USER method defining a predicate
     virtual bool predicateMethod(const PropertyManager&) {
@@ -68,9 +68,18 @@ namespace CRL {
     //! Main event processing function
     bool process(const DateType& d, CRL::Event* e = NULL);
 
+    //! Processing of the chronicle alone, its members being already processed (see ChroniclePlan)
+    bool processNode(const DateType& d, CRL::Event* e, bool flagLeft, bool flagRight);
+
     //! Display function for unit tests
     std::string toString() const;
 
+    //! Returns a string identifying the structure and the settings of the chronicle tree
+    std::string structuralSignature() const;
+
+    //! Infers the retention horizons of the sub-chronicles (static analysis)
+    void inferRetentionHorizons(DurationType window);
+
   protected:
 
     //! Destructor protected (to prevent stack allocation)
@@ -0,0 +1,57 @@
+/** ***********************************************************************************
+ * \file ChronicleArena.h
+ * \author Ariane Piel & Jean Bourrely / Onera DCPS
+ * \date 2014
+ * \brief Contiguous memory arena for the nodes of chronicles
+ **************************************************************************************/
+
+/*  Copyright (C) 2012, 2013, 2014  ONERA  http://www.onera.fr
+    This file is part of CRL : Chronicle Recognition Library.
+
+    CRL is free software: you can redistribute it and/or modify it under
+    the terms of the Lesser GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    CRL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    Lesser GNU General Public License for more details.
+
+    You should have received a copy of the Lesser GNU General Public License
+    along with CRL.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef CHRONICLE_ARENA_H_
+#define CHRONICLE_ARENA_H_
+
+// ----------------------------------------------------------------------------
+// INCLUDE FILES
+// ----------------------------------------------------------------------------
+
+#include "SegmentedArena.h"
+
+
+// ----------------------------------------------------------------------------
+// CLASS DESCRIPTION
+// ----------------------------------------------------------------------------
+
+namespace CRL {
+
+  class ChronicleArena : public SegmentedArena
+  {
+  public:
+
+    //! Constructor
+    ChronicleArena(size_t blockSize = 65536) : SegmentedArena(blockSize) { }
+
+  private:
+
+    //! Destructor (private: see #close)
+    ~ChronicleArena() { }
+
+  }; // class ChronicleArena
+
+} /* namespace CRL */
+
+#endif /* CHRONICLE_ARENA_H_ */
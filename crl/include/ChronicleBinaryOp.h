@@ -29,6 +29,8 @@
 // INCLUDE FILES
 // ----------------------------------------------------------------------------
 
+#include <vector>
+
 #include "Chronicle.h"
 
 // ----------------------------------------------------------------------------
@@ -39,6 +41,15 @@ namespace CRL {
 
   class ChronicleBinaryOp : public CRL::Chronicle 
   {
+  public:
+
+    //! Selection of the recognitions of a member joined with a new recognition of the other member
+    enum SelectionPolicy { ALL_COMBINATIONS,   //!< all the candidates (default)
+                           EARLIEST,           //!< only the first candidate to begin giving a recognition
+                           MOST_RECENT,        //!< only the last candidate to end giving a recognition
+                           STRICT_CONTIGUITY   //!< only the candidates adjacent in the flow of events
+                         };
+
   protected:
 
     //! Pointor to the left member
@@ -47,6 +58,24 @@ namespace CRL {
     //! Pointor to the right member
     Chronicle* _opRight;
 
+    //! Equi-join keys : paths of the properties of the left member
+    RecoIndex::KeyPaths _leftKeyPaths;
+
+    //! Equi-join keys : paths of the properties of the right member
+    RecoIndex::KeyPaths _rightKeyPaths;
+
+    //! Hash index of the left recognition set (NULL if no equi-join key)
+    RecoIndex* _leftIndex;
+
+    //! Hash index of the right recognition set (NULL if no equi-join key)
+    RecoIndex* _rightIndex;
+
+    //! Selection policy of the candidates of the joins
+    SelectionPolicy _selectionPolicy;
+
+    //! Indicates whether the recognitions of the members are removed once joined
+    bool _consumeOnMatch;
+
   public:
 
     //! Constructor
@@ -54,6 +83,8 @@ namespace CRL {
 
     //! Calls destructors of sub-chronicles, and destructor of this
     void deepDestroy() {
+      if (unshare()) return;
+      releaseIndexes();
       _opLeft->deepDestroy();
       _opRight->deepDestroy();
       delete this;
@@ -87,11 +118,52 @@ namespace CRL {
     //! Accessor (non const), implementation of pure virtual
     Chronicle* getChild2() { return _opRight; }
 
+    //! Replaces the left sub-chronicle
+    void setChild1(Chronicle* c) { setOpLeft(c); }
+
+    //! Replaces the right sub-chronicle
+    void setChild2(Chronicle* c) { setOpRight(c); }
+
+    //! Returns a string identifying the structure and the settings of the chronicle tree
+    std::string structuralSignature() const;
+
+    //! Accessor
+    void setOpLeft(Chronicle* opLeft);
+
+    //! Accessor
+    void setOpRight(Chronicle* opRight);
+
+    //! Declares an equi-join key : property \a leftPath of the left member equals \a rightPath of the right member
+    void addJoinKey(const RecoIndex::PropertyPath& leftPath, 
+                    const RecoIndex::PropertyPath& rightPath);
+
+    //! Declares an equi-join key through aliases (ex: x."CRL ID" == y."CRL ID")
+    void addJoinKey(const std::string& leftAlias, const std::string& leftProperty,
+                    const std::string& rightAlias, const std::string& rightProperty);
+
     //! Accessor
-    void setOpLeft(Chronicle* opLeft) { _opLeft = opLeft; }
+    bool hasJoinKeys() const { return !_leftKeyPaths.empty(); }
+
+    //! Tests whether the operator enumerates its joins through the equi-join keys
+    virtual bool supportsJoinKeys() const { return true; }
+
+    //! Accessor
+    void setSelectionPolicy(SelectionPolicy policy) { _selectionPolicy = policy; }
+
+    //! Accessor
+    SelectionPolicy getSelectionPolicy() const { return _selectionPolicy; }
+
+    //! Removes the recognitions of the members once they take part in a recognition
+    void setConsumeOnMatch(bool b) { _consumeOnMatch = b; }
 
     //! Accessor
-    void setOpRight(Chronicle* opRight) { _opRight = opRight; }
+    bool isConsumeOnMatch() const { return _consumeOnMatch; }
+
+    //! Tests whether all the combinations of recognitions are built (default semantics)
+    bool hasDefaultSelection() const { return (_selectionPolicy == ALL_COMBINATIONS) && !_consumeOnMatch; }
+
+    //! The recognitions of the members are consumed (see #setConsumeOnMatch)
+    bool consumesChildRecognitions() const { return _consumeOnMatch; }
 
     //! Empties the new recognitions set
     void purgeNewRecognitions(bool daughtersOnly = false);
@@ -100,18 +172,54 @@ namespace CRL {
     void purgeRecognitionsIfPurgeable();
 
     //! Sets peremption duration to \a duration, recursively if \a recursive.
-    void setPeremptionDuration(double duration, bool recursive);
+    void setPeremptionDuration(DurationType duration, bool recursive);
 
     //! Deletes too old recognitions recursively.
     void purgeOldRecognitions();
 
+    //! Infers the retention horizons of the sub-chronicles (static analysis)
+    void inferRetentionHorizons(DurationType window);
+
     //! Returns the date in the future at which the recognitions set of the chronicle must be re-assessed
     DateType lookAhead(const DateType& tcurr) const;
 
   protected:
 
-    //! Destructor protected (to prevent stack allocation)
-    ~ChronicleBinaryOp() { /* empty */ }
+    //! Destructor protected (to prevent stack allocation), releases the indexes if #deepDestroy has not
+    ~ChronicleBinaryOp() { releaseIndexes(); }
+
+    //! Releases the indexes requested on the sub-chronicles (which may be shared, and outlive this)
+    //! Once released, the sub-chronicles are not touched again (#deepDestroy may have deleted them)
+    void releaseIndexes() {
+      if (_leftIndex != NULL) _opLeft->releaseIndex(_leftIndex);
+      if (_rightIndex != NULL) _opRight->releaseIndex(_rightIndex);
+      _leftIndex = _rightIndex = NULL;
+    }
+
+    //! Returns the left recognitions which may be joined with the right recognition \a r
+    const Chronicle::RecoSet& leftCandidates(const RecoTree& r) const;
+
+    //! Returns the right recognitions which may be joined with the left recognition \a l
+    const Chronicle::RecoSet& rightCandidates(const RecoTree& l) const;
+
+    //! Collects the left candidates for \a r with minLow < minOrder < minHigh and maxLow < maxOrder < maxHigh
+    void leftMatches(const RecoTree& r, int64_t minLow, int64_t minHigh, int64_t maxLow, int64_t maxHigh,
+                     std::vector<RecoTree*>& matches);
+
+    //! Orders the \a candidates to be joined with \a rc according to the selection policy
+    void selectCandidates(const Chronicle::RecoSet& candidates, const RecoTree& rc,
+                          std::vector<RecoTree*>& selected) const;
+
+    //! Tests whether the selection policy stops at the first recognition
+    bool selectsFirstOnly() const { return (_selectionPolicy == EARLIEST) || (_selectionPolicy == MOST_RECENT); }
+
+  private:
+
+    //! Order of the EARLIEST policy
+    static bool beginsBefore(const RecoTree* r1, const RecoTree* r2);
+
+    //! Order of the MOST_RECENT policy
+    static bool endsAfter(const RecoTree* r1, const RecoTree* r2);
 
   }; // class ChronicleBinaryOp
 
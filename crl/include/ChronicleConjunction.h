@@ -29,6 +29,9 @@
 // INCLUDE FILES
 // ----------------------------------------------------------------------------
 
+#include <utility>
+#include <unordered_set>
+
 #include "ChronicleBinaryOp.h"
 #include "RecoTreeCouple.h"
 
@@ -41,6 +44,44 @@ namespace CRL {
 
   class ChronicleConjunction: public CRL::ChronicleBinaryOp 
   {
+  protected:
+
+    //! Data type : members of a join
+    typedef std::pair<const RecoTree*, const RecoTree*> Members;
+
+    //! Hash function of the members of a join, regardless of their order
+    struct MembersHash
+    {
+      std::size_t operator()(const Members& m) const;
+    };
+
+    //! Structural equality of the members of a join, regardless of their order
+    struct MembersEqual
+    {
+      bool operator()(const Members& m1, const Members& m2) const;
+    };
+
+    //! Indicates whether the joins of members already joined are eliminated (see #setEliminateDuplicates)
+    bool _eliminateDuplicates;
+
+    //! Members joined for the current event (see #setEliminateDuplicates)
+    std::unordered_set<Members, MembersHash, MembersEqual> _joinedMembers;
+
+    //! Indicates whether the recognitions are kept in factorised form (see #setFactorised)
+    bool _factorised;
+
+    //! Recognitions of the left member, in order of arrival (factorised form)
+    Chronicle::RecoSet _leftFactor;
+
+    //! Recognitions of the right member, in order of arrival (factorised form)
+    Chronicle::RecoSet _rightFactor;
+
+    //! Number of recognitions of the left factor before the last processing (factorised form)
+    size_t _oldLeftSize;
+
+    //! Number of recognitions of the right factor before the last processing (factorised form)
+    size_t _oldRightSize;
+
   public:
 
     //! Constructor
@@ -52,13 +93,68 @@ namespace CRL {
     //! Main event processing function
     bool process(const DateType& d, CRL::Event* e = NULL);
 
+    //! Processing of the chronicle alone, its members being already processed (see ChroniclePlan)
+    bool processNode(const DateType& d, CRL::Event* e, bool flagLeft, bool flagRight);
+
     //! Display function for unit tests
     std::string toString() const;
 
+    //! Eliminates (or not) the recognitions which members are structurally equal to those of a former one
+    void setEliminateDuplicates(bool b) { _eliminateDuplicates = b; }
+
+    //! Accessor
+    bool isEliminateDuplicates() const { return _eliminateDuplicates; }
+
+    //! Returns a string identifying the structure and the settings of the chronicle
+    std::string structuralSignature() const;
+
+    //! Infers the retention horizons of the sub-chronicles (static analysis)
+    void inferRetentionHorizons(DurationType window);
+
+    //! Implementation of virtual
+    bool supportsCountOnly() const 
+      { return !hasJoinKeys() && hasDefaultSelection() && !_eliminateDuplicates && !_factorised; }
+
+    //! Keeps the recognitions as the product of the recognitions of the members, without building them
+    void setFactorised(bool b);
+
+    //! Accessor
+    bool isFactorised() const { return _factorised; }
+
+    //! Accessor
+    const Chronicle::RecoSet& getLeftFactor() const { return _leftFactor; }
+
+    //! Accessor
+    const Chronicle::RecoSet& getRightFactor() const { return _rightFactor; }
+
+    //! Returns true if the recognition made of \a l and \a r is represented (factorised form)
+    bool containsRecognition(const RecoTree* l, const RecoTree* r) const;
+
+    //! Builds the recognitions represented (or only the new ones) and passes them to \a f (factorised form)
+    size_t enumerateRecognitions(void (*f)(RecoTree& rc), bool newOnly = false) const;
+
   protected:
 
+    //! Builds the recognition made of \a l and \a r, if the predicate is verified
+    bool join(RecoTree* l, RecoTree* r);
+
+    //! Joins the new recognitions with the recognitions chosen by the selection policy
+    void joinSelected(CRL::Event* e);
+
+    //! Count-only version of #process
+    bool processCount(const DateType& d, CRL::Event* e);
+
+    //! Factorised version of #process
+    bool processFactorised(const DateType& d, CRL::Event* e);
+
+    //! Builds the recognition made of \a l and \a r, without predicate (factorised form)
+    RecoTree* buildRecognition(RecoTree* l, RecoTree* r) const;
+
+    //! Releases the recognitions of the factors
+    void clearFactors();
+
     //! Destructor protected (to prevent stack allocation)
-    ~ChronicleConjunction() { /* empty */ }
+    ~ChronicleConjunction();
 
   }; // class ChronicleConjunction
 
@@ -44,6 +44,9 @@ namespace CRL {
     //! Recognitions set awaiting the left member of the chronicle
     Chronicle::RecoSet _tempRecogSet;
 
+    //! Columns of the orders of #_tempRecogSet
+    RecoColumns _tempColumns;
+
   public:
 
     //! Constructor
@@ -55,13 +58,22 @@ namespace CRL {
     //! Main event processing function
     bool process(const DateType& d, CRL::Event* e = NULL);
 
+    //! Processing of the chronicle alone, its members being already processed (see ChroniclePlan)
+    bool processNode(const DateType& d, CRL::Event* e, bool flagLeft, bool flagRight);
+
     //! Display function for unit tests
     std::string toString() const;
 
+    //! Infers the retention horizons of the sub-chronicles (static analysis)
+    void inferRetentionHorizons(DurationType window);
+
+    //! Implementation of virtual (the joins scan the awaiting left recognitions)
+    bool supportsJoinKeys() const { return false; }
+
   protected:
 
-    //! Destructor protected (to prevent stack allocation)
-    ~ChronicleCut() { /* empty */ }
+    //! Destructor protected (to prevent stack allocation), releases the awaiting recognitions
+    ~ChronicleCut();
 
   }; // class ChronicleCut
 
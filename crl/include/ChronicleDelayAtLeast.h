@@ -51,6 +51,9 @@ namespace CRL {
     //! Main event processing function
     bool process(const DateType& d, CRL::Event* e = NULL);
 
+    //! Processing of the chronicle alone, its member being already processed (see ChroniclePlan)
+    bool processNode(const DateType& d, CRL::Event* e, bool flagChild);
+
     //! Display function for unit tests
     std::string toString() const;
 
@@ -51,9 +51,15 @@ namespace CRL {
     //! Main event processing function
     bool process(const DateType& d, CRL::Event* e = NULL);
 
+    //! Processing of the chronicle alone, its member being already processed (see ChroniclePlan)
+    bool processNode(const DateType& d, CRL::Event* e, bool flagChild);
+
     //! Display function for unit tests
     std::string toString() const;
 
+    //! Infers the retention horizons of the sub-chronicles (static analysis)
+    void inferRetentionHorizons(DurationType window);
+
   protected:
 
     //! Destructor protected (to prevent stack allocation)
@@ -55,6 +55,7 @@ namespace CRL {
 
     //! Calls destructor of sub-chronicle, and destructor of this
     void deepDestroy() {
+      if (unshare()) return;
       _opLeft->deepDestroy();
       delete this;
     }
@@ -83,6 +84,12 @@ namespace CRL {
     //! Implementation of pure virtual
     Chronicle* getChild2() { return NULL; }
 
+    //! Replaces the sub-chronicle
+    void setChild1(Chronicle* c) { setOpLeft(c); }
+
+    //! Returns a string identifying the structure and the settings of the chronicle tree
+    std::string structuralSignature() const;
+
     //! Accessor
     void setOpLeft(Chronicle* opLeft) { _opLeft = opLeft; }
 
@@ -96,11 +103,14 @@ namespace CRL {
     void purgeRecognitionsIfPurgeable();
 
     //! Sets peremption duration to \a duration, recursively if \a recursive.
-    void setPeremptionDuration(double duration, bool recursive);
+    void setPeremptionDuration(DurationType duration, bool recursive);
 
     //! Deletes too old recognitions recursively.
     void purgeOldRecognitions();
 
+    //! Infers the retention horizons of the sub-chronicles (static analysis)
+    void inferRetentionHorizons(DurationType window);
+
     //! Returns the date in the future at which the recognitions set of the chronicle must be re-assessed
     DateType lookAhead(const DateType& tcurr) const {
       return _opLeft->lookAhead(tcurr);
@@ -51,9 +51,18 @@ namespace CRL {
     //! Main event processing function
     bool process(const DateType& d, CRL::Event* e = NULL);
 
+    //! Processing of the chronicle alone, its member being already processed (see ChroniclePlan)
+    bool processNode(const DateType& d, CRL::Event* e, bool flagChild);
+
     //! Display function for unit tests
     std::string toString() const;
 
+    //! The new recognitions of the sub-chronicle are removed once delayed
+    bool consumesChildRecognitions() const { return true; }
+
+    //! Infers the retention horizons of the sub-chronicles (static analysis)
+    void inferRetentionHorizons(DurationType window);
+
     //! Empties the new recognitions set
     void purgeNewRecognitions(bool daughtersOnly = false);
 
@@ -52,11 +52,29 @@ namespace CRL {
     //! Main event processing function
     bool process(const DateType& d, CRL::Event* e = NULL);
 
+    //! Processing of the chronicle alone, its members being already processed (see ChroniclePlan)
+    bool processNode(const DateType& d, CRL::Event* e, bool flagLeft, bool flagRight);
+
     //! Display function for unit tests
     std::string toString() const;
 
+    //! Infers the retention horizons of the sub-chronicles (static analysis)
+    void inferRetentionHorizons(DurationType window);
+
+    //! Implementation of virtual
+    bool supportsCountOnly() const { return true; }
+
+    //! Implementation of virtual (no join)
+    bool supportsJoinKeys() const { return false; }
+
+    //! Instantaneous when both members are
+    bool isInstantaneous() const { return _opLeft->isInstantaneous() && _opRight->isInstantaneous(); }
+
   protected:
 
+    //! Count-only version of #process
+    bool processCount(const DateType& d, CRL::Event* e);
+
     //! Destructor protected (to prevent stack allocation)
     ~ChronicleDisjunction() { /* empty */ }
 
@@ -0,0 +1,169 @@
+/** ***********************************************************************************
+ * \file ChronicleLoader.h
+ * \author Ariane Piel & Jean Bourrely / Onera DCPS
+ * \date 2014
+ * \brief Loading of chronicles from their text notation
+ **************************************************************************************/
+
+/*  Copyright (C) 2012, 2013, 2014  ONERA  http://www.onera.fr
+    This file is part of CRL : Chronicle Recognition Library.
+
+    CRL is free software: you can redistribute it and/or modify it under
+    the terms of the Lesser GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    CRL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    Lesser GNU General Public License for more details.
+
+    You should have received a copy of the Lesser GNU General Public License
+    along with CRL.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef CHRONICLE_LOADER_H_
+#define CHRONICLE_LOADER_H_
+
+// ----------------------------------------------------------------------------
+// INCLUDE FILES
+// ----------------------------------------------------------------------------
+
+#include <string>
+#include <list>
+#include <map>
+#include <unordered_map>
+#include <set>
+#include <iostream>
+
+#include "Chronicle.h"
+#include "ChronicleArena.h"
+
+
+// ----------------------------------------------------------------------------
+// CLASS DESCRIPTION
+// ----------------------------------------------------------------------------
+
+namespace CRL {
+
+  class ChronicleLoader
+  {
+  private:
+
+    //! Loaded chronicles (one per expression or definition), in the order of loading
+    std::list<Chronicle*> _chronicles;
+
+    //! Named definitions
+    std::map<std::string, Chronicle*> _definitions;
+
+    //! Text of the named definitions
+    std::map<std::string, std::string> _definitionTexts;
+
+    //! Shared sub-chronicles, by canonical key (deduplication)
+    std::unordered_map<std::string, Chronicle*> _built;
+
+    //! Canonical keys of the chronicles built by the loader
+    std::unordered_map<Chronicle*, std::string> _keys;
+
+    //! Chronicles built by the expression being parsed (rollback on error)
+    std::set<Chronicle*> _created;
+
+    //! Additional parents given by the expression being parsed to existing chronicles (rollback on error)
+    std::map<Chronicle*, int> _shared;
+
+    //! Nesting of #parseText (references to definitions)
+    int _depth;
+
+    //! Arena in which the chronicles are laid out
+    ChronicleArena* _arena;
+
+    //! Text being parsed
+    std::string _text;
+
+    //! Position in #_text
+    size_t _pos;
+
+    //! Line being parsed (error messages)
+    int _line;
+
+  public:
+
+    //! Constructor
+    ChronicleLoader(size_t arenaBlockSize = 65536);
+
+    //! Destructor, releases the arena (the chronicles are not destroyed)
+    ~ChronicleLoader();
+
+    //! Builds a chronicle from its notation (ex: \code ((A B)&&C) \endcode)
+    Chronicle* parse(const std::string& text);
+
+    //! Builds a chronicle from its notation, and names it
+    Chronicle* define(const std::string& name, const std::string& text);
+
+    //! Loads the chronicles of a text flow, returns the number of chronicles loaded
+    size_t load(std::istream& is);
+
+    //! Loads the chronicles of a file, returns the number of chronicles loaded
+    size_t loadFile(const std::string& fileName);
+
+    //! Accessor, returns the loaded chronicles
+    const std::list<Chronicle*>& getChronicles() const { return _chronicles; }
+
+    //! Returns the chronicle defined as \a name (NULL if none)
+    Chronicle* getDefinition(const std::string& name) const;
+
+    //! Destroys all the loaded chronicles
+    void destroyChronicles();
+
+  private:
+
+    //! Parses a whole expression (fresh top node)
+    Chronicle* parseText(const std::string& text);
+
+    //! Parses an operand: event, date, reference, \@ or parenthesised expression
+    Chronicle* parseAtom(bool exclusive);
+
+    //! Parses the contents of parentheses
+    Chronicle* parseBody(bool exclusive);
+
+    //! Parses the contents of the parentheses of an absence (ex: \code [A B]-C \endcode)
+    Chronicle* parseAbsence(bool exclusive);
+
+    //! Parses an identifier (possibly empty)
+    std::string parseIdentifier();
+
+    //! Parses a number, returns false if there is none
+    bool parseNumber(double& value);
+
+    //! Returns a private copy or a shared reference to a definition
+    Chronicle* reference(const std::string& name, bool exclusive);
+
+    //! Skips blanks, returns true if some were skipped
+    bool skipSpaces();
+
+    //! Consumes \a token if present
+    bool match(const char* token);
+
+    //! Returns the shared chronicle of key \a key (NULL if none or if \a exclusive)
+    Chronicle* lookup(const std::string& key, bool exclusive);
+
+    //! Records a new chronicle and its key, shares it unless \a exclusive
+    Chronicle* remember(Chronicle* cr, const std::string& key, bool exclusive);
+
+    //! Returns an operand that is not shared, parsed again from \a start if needed
+    Chronicle* makeExclusive(Chronicle* cr, size_t start);
+
+    //! Gives back an operand which is no longer used
+    void discard(Chronicle* cr);
+
+    //! Undoes the expression being parsed
+    void rollback();
+
+    //! Throws a parse error
+    void error(const std::string& msg) const;
+
+  }; // class ChronicleLoader
+
+} /* namespace CRL */
+
+#endif /* CHRONICLE_LOADER_H_ */
@@ -59,6 +59,7 @@ namespace CRL {
 
     //! Calls destructor of sub-chronicle, and destructor of this
     void deepDestroy() {
+      if (unshare()) return;
       _myChronicle->deepDestroy();
       delete this;
     }
@@ -72,6 +73,9 @@ namespace CRL {
     //! Main event processing function
     bool process(const DateType& d, CRL::Event* e = NULL);
 
+    //! Processing of the chronicle alone, its member being already processed (see ChroniclePlan)
+    bool processNode(const DateType& d, CRL::Event* e, bool flagChild);
+
     //! Display function for unit tests
     std::string toString() const;
 
@@ -82,11 +86,14 @@ namespace CRL {
     void purgeRecognitionsIfPurgeable();
 
     //! Sets peremption duration to \a duration, recursively if \a recursive.
-    void setPeremptionDuration(double duration, bool recursive);
+    void setPeremptionDuration(DurationType duration, bool recursive);
 
     //! Deletes too old recognitions recursively.
     void purgeOldRecognitions();
 
+    //! Infers the retention horizons of the sub-chronicles (static analysis)
+    void inferRetentionHorizons(DurationType window);
+
     //! Returns the date in the future at which the recognitions set of the chronicle must be re-assessed
     DateType lookAhead(const DateType& tcurr) const ;
 
@@ -96,8 +103,23 @@ namespace CRL {
     //! Implementation of pure virtual
     Chronicle* getChild2() { return NULL; }
 
+    //! Replaces the sub-chronicle
+    void setChild1(Chronicle* c) { _myChronicle = c; }
+
+    //! Returns a string identifying the structure and the settings of the chronicle tree
+    std::string structuralSignature() const;
+
+    //! The alias only renames properties, so counts go through
+    bool supportsCountOnly() const { return true; }
+
+    //! Instantaneous when the inner chronicle is
+    bool isInstantaneous() const { return _myChronicle->isInstantaneous(); }
+
   protected:
 
+    //! Count-only version of #process
+    bool processCount(const DateType& d, CRL::Event* e);
+
     //! Destructor protected (to prevent stack allocation)
     ~ChronicleNamed() { /* empty */ }
 
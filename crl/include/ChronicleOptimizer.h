@@ -0,0 +1,141 @@
+/** ***********************************************************************************
+ * \file ChronicleOptimizer.h
+ * \author Ariane Piel & Jean Bourrely / Onera DCPS
+ * \date 2014
+ * \brief Semantics-preserving rewrites of chronicle trees
+ **************************************************************************************/
+
+/*  Copyright (C) 2012, 2013, 2014  ONERA  http://www.onera.fr
+    This file is part of CRL : Chronicle Recognition Library.
+
+    CRL is free software: you can redistribute it and/or modify it under
+    the terms of the Lesser GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    CRL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    Lesser GNU General Public License for more details.
+
+    You should have received a copy of the Lesser GNU General Public License
+    along with CRL.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef CHRONICLE_OPTIMIZER_H_
+#define CHRONICLE_OPTIMIZER_H_
+
+// ----------------------------------------------------------------------------
+// INCLUDE FILES
+// ----------------------------------------------------------------------------
+
+#include <string>
+#include <vector>
+#include <map>
+#include <typeinfo>
+
+#include "Chronicle.h"
+
+
+// ----------------------------------------------------------------------------
+// CLASS DESCRIPTION
+// ----------------------------------------------------------------------------
+
+namespace CRL {
+
+  class ChronicleOptimizer
+  {
+  private:
+
+    //! Expected number of recognitions of the single events, by event name
+    std::map<std::string, double> _eventCardinalities;
+
+    //! Expected number of recognitions of the single events not in #_eventCardinalities
+    double _defaultCardinality;
+
+    //! Number of rewrites applied
+    unsigned long _rewriteCount;
+
+  public:
+
+    //! Fraction of the recognitions kept by a delay filter (cardinality model)
+    static const double FILTER_SELECTIVITY;
+
+    //! Fraction of the pairs of recognitions kept by a sequence (cardinality model)
+    static const double SEQUENCE_SELECTIVITY;
+
+    //! Fraction of the pairs of recognitions kept by the other temporal relations (cardinality model)
+    static const double RELATION_SELECTIVITY;
+
+    //! Constructor
+    ChronicleOptimizer();
+
+    //! Accessor, expected number of recognitions of the event \a name
+    void setEventCardinality(const std::string& name, double n) { _eventCardinalities[name] = n; }
+
+    //! Accessor
+    double getEventCardinality(const std::string& name) const;
+
+    //! Accessor
+    void setDefaultCardinality(double n) { _defaultCardinality = n; }
+
+    //! Accessor
+    double getDefaultCardinality() const { return _defaultCardinality; }
+
+    //! Accessor
+    unsigned long getRewriteCount() const { return _rewriteCount; }
+
+    //! Rewrites the chronicle tree into an equivalent cheaper one (the root is kept)
+    void optimize(Chronicle* cr);
+
+    //! Estimates the number of recognitions of a chronicle
+    double estimateCardinality(Chronicle* cr) const;
+
+    //! Estimates the number of recognitions built by a chronicle tree
+    double estimateCost(Chronicle* cr) const;
+
+    //! Computes the cheapest association of a chain, returns its cost (root excluded)
+    static double planChain(const std::vector<double>& cards, double selectivity,
+                            std::vector<std::vector<size_t> >& splits);
+
+    //! Estimated number of recognitions of the chain of members \a first to \a last
+    static double chainCardinality(const std::vector<double>& cards, size_t first, size_t last,
+                                   double selectivity);
+
+    //! Builds the chain of members \a first to \a last, split as given by \a splits
+    static Chronicle* buildChain(const std::vector<Chronicle*>& members,
+                                 const std::vector<std::vector<size_t> >& splits,
+                                 size_t first, size_t last, bool sequence);
+
+    //! Collects the members of the chain of chronicles of the type of \a cr
+    static void flattenChain(Chronicle* cr, const std::type_info& type,
+                             std::vector<Chronicle*>& members, std::vector<Chronicle*>& links);
+
+    //! Indicates whether a chronicle may be rewritten (no user function, not shared, not started...)
+    static bool isPlain(Chronicle* cr);
+
+    //! Marks a rewritten chronicle tree (see Chronicle::isRewritten)
+    static void markRewritten(Chronicle* cr);
+
+  private:
+
+    //! Optimizes the sub-chronicles, then the chronicle
+    void optimizeNode(Chronicle* cr);
+
+    //! DelayAtMost of a DelayAtMost (resp. DelayAtLeast) -> one DelayAtMost (resp. DelayAtLeast)
+    bool fuseFilters(Chronicle* cr);
+
+    //! Absence of an absence -> absence of the disjunction of the undesired chronicles
+    bool fuseAbsences(Chronicle* cr);
+
+    //! Chain of sequences (resp. conjunctions) -> cheapest association
+    bool reassociate(Chronicle* cr);
+
+    //! DelayAtMost of a sequence (resp. conjunction) -> filters on the members too
+    bool pushDownFilter(Chronicle* cr);
+
+  }; // class ChronicleOptimizer
+
+} /* namespace CRL */
+
+#endif /* CHRONICLE_OPTIMIZER_H_ */
@@ -0,0 +1,134 @@
+/** ***********************************************************************************
+ * \file ChroniclePlan.h
+ * \author Ariane Piel & Jean Bourrely / Onera DCPS
+ * \date 2014
+ * \brief Compiled execution plan of trees of chronicles
+ **************************************************************************************/
+
+/*  Copyright (C) 2012, 2013, 2014  ONERA  http://www.onera.fr
+    This file is part of CRL : Chronicle Recognition Library.
+
+    CRL is free software: you can redistribute it and/or modify it under
+    the terms of the Lesser GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    CRL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    Lesser GNU General Public License for more details.
+
+    You should have received a copy of the Lesser GNU General Public License
+    along with CRL.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef CHRONICLE_PLAN_H_
+#define CHRONICLE_PLAN_H_
+
+// ----------------------------------------------------------------------------
+// INCLUDE FILES
+// ----------------------------------------------------------------------------
+
+#include <list>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "Chronicle.h"
+
+
+// ----------------------------------------------------------------------------
+// CLASS DESCRIPTION
+// ----------------------------------------------------------------------------
+
+namespace CRL {
+
+  class ChroniclePlan
+  {
+  public:
+
+    //! Kind of operator, telling when the processing of a chronicle may be skipped
+    enum OperatorKind { LEAF_EVENT,     //!< single event: only the events of its name
+                        RIGHT_DRIVEN,   //!< only the new recognitions of the right member (ex: sequence)
+                        EITHER_DRIVEN,  //!< only the new recognitions of one of the members (ex: conjunction)
+                        CHILD_DRIVEN,   //!< only the new recognitions of the sub-chronicle (ex: naming)
+                        ALWAYS          //!< every event (ex: delays, absences, dates)
+                      };
+
+    //! Operator of a chronicle, telling which processing is called by the plan
+    enum Operator { OTHER,          //!< user sub-class: virtual Chronicle::process()
+                    SINGLE_EVENT, SINGLE_DATE,
+                    SEQUENCE, DURING, OVERLAPS, EQUALS, STARTS, FINISHES, MEETS,
+                    CONJUNCTION, DISJUNCTION, CUT, ABSENCE, STATE_CHANGE,
+                    NAMED, AT, DELAY_AT_LEAST, DELAY_AT_MOST, DELAY_LASTS, DELAY_THEN
+                  };
+
+    //! Operator record of the plan
+    struct Step
+    {
+      //! Chronicle processed
+      Chronicle* node;
+
+      //! Kind of operator
+      OperatorKind kind;
+
+      //! Operator
+      Operator op;
+
+      //! Steps of the sub-chronicles (-1: none)
+      int child1, child2;
+
+      //! Event name of a #LEAF_EVENT chronicle
+      const std::string* code;
+
+      //! Indicates whether the new recognitions are kept from one event to the next (left member of a delay)
+      bool keepNewRecognitions;
+    };
+
+  private:
+
+    //! Operator records, sub-chronicles before their parents
+    std::vector<Step> _steps;
+
+    //! New recognitions of each step, for the current event
+    std::vector<char> _hasNew;
+
+  public:
+
+    //! Constructor
+    ChroniclePlan() { }
+
+    //! Builds the plan of the trees of chronicles \a roots
+    void compile(const std::list<Chronicle*>& roots);
+
+    //! Empties the plan
+    void clear() { _steps.clear(); _hasNew.clear(); }
+
+    //! Accessor
+    const std::vector<Step>& getSteps() const { return _steps; }
+
+    //! Processes an event: one pass over the steps, each chronicle being processed once
+    void process(const DateType& d, CRL::Event* e);
+
+    //! Empties the new recognitions of all the chronicles, in one pass over the steps
+    void purgeNewRecognitions();
+
+    //! Returns the kind of operator of chronicle \a cr
+    static OperatorKind kindOf(Chronicle* cr);
+
+    //! Returns the operator of chronicle \a cr (OTHER if not a library operator)
+    static Operator operatorOf(Chronicle* cr);
+
+  protected:
+
+    //! Adds the steps of the tree of \a cr (post-order), returns the step of \a cr
+    int addSteps(Chronicle* cr, std::map<Chronicle*, int>& steps);
+
+    //! Processes the chronicle of step \a s alone, from the new recognitions of its members
+    void processStep(const Step& s, const DateType& d, CRL::Event* e);
+
+  }; // class ChroniclePlan
+
+} /* namespace CRL */
+
+#endif /* CHRONICLE_PLAN_H_ */
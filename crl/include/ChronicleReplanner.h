@@ -0,0 +1,157 @@
+/** ***********************************************************************************
+ * \file ChronicleReplanner.h
+ * \author Ariane Piel & Jean Bourrely / Onera DCPS
+ * \date 2014
+ * \brief Adaptive re-planning of chains of sequences and conjunctions
+ **************************************************************************************/
+
+/*  Copyright (C) 2012, 2013, 2014  ONERA  http://www.onera.fr
+    This file is part of CRL : Chronicle Recognition Library.
+
+    CRL is free software: you can redistribute it and/or modify it under
+    the terms of the Lesser GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    CRL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    Lesser GNU General Public License for more details.
+
+    You should have received a copy of the Lesser GNU General Public License
+    along with CRL.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef CHRONICLE_REPLANNER_H_
+#define CHRONICLE_REPLANNER_H_
+
+// ----------------------------------------------------------------------------
+// INCLUDE FILES
+// ----------------------------------------------------------------------------
+
+#include <list>
+#include <vector>
+
+#include "Chronicle.h"
+#include "ChronicleBinaryOp.h"
+
+
+// ----------------------------------------------------------------------------
+// CLASS DESCRIPTION
+// ----------------------------------------------------------------------------
+
+namespace CRL {
+
+  class ChronicleReplanner
+  {
+  public:
+
+    //! Chain of sequences (resp. conjunctions) and its statistics
+    struct Chain
+    {
+      //! Root of the chain (kept when the chain is re-associated)
+      ChronicleBinaryOp* root;
+
+      //! Chain of sequences (true) or of conjunctions (false)
+      bool sequence;
+
+      //! Members of the chain, in order
+      std::vector<Chronicle*> members;
+
+      //! Number of new recognitions of each member (exponentially decayed)
+      std::vector<double> arrivals;
+
+      //! Number of new recognitions of the root (exponentially decayed)
+      double produced;
+    };
+
+  private:
+
+    //! Chains followed
+    std::list<Chain> _chains;
+
+    //! Number of events between two plannings (0: no adaptive planning)
+    unsigned long _period;
+
+    //! Number of events observed
+    unsigned long _eventCount;
+
+    //! Number of changes of plan
+    unsigned long _replanCount;
+
+    //! A new plan is adopted if its cost is below this fraction of the cost of the current plan
+    double _threshold;
+
+    //! Links replaced by a new plan, destroyed with the replanner
+    std::list<Chronicle*> _retiredLinks;
+
+  public:
+
+    //! Weight of the past statistics at each planning
+    static const double DECAY;
+
+    //! Constructor
+    ChronicleReplanner();
+
+    //! Destructor
+    ~ChronicleReplanner();
+
+    //! Accessor
+    unsigned long getPeriod() const { return _period; }
+
+    //! Accessor, number of events between two plannings (0: no adaptive planning)
+    void setPeriod(unsigned long n) { _period = n; }
+
+    //! Accessor
+    double getThreshold() const { return _threshold; }
+
+    //! Accessor
+    void setThreshold(double r) { _threshold = r; }
+
+    //! Accessor
+    unsigned long getReplanCount() const { return _replanCount; }
+
+    //! Accessor
+    const std::list<Chain>& getChains() const { return _chains; }
+
+    //! Follows the chains of sequences (resp. conjunctions) of a chronicle tree
+    void addChronicle(Chronicle* cr);
+
+    //! Forgets all the chains
+    void clear() { _chains.clear(); }
+
+    //! Gathers the statistics of an event (before the new recognitions are purged)
+    void observe();
+
+    //! Re-plans the chains if the period has elapsed, returns true if a plan has changed
+    bool replanIfDue();
+
+    //! Re-plans the chains, returns true if a plan has changed
+    bool replan();
+
+  private:
+
+    //! Looks for the chains of a chronicle tree
+    void findChains(Chronicle* cr);
+
+    //! Collects the members and the links of the chain under \a cr
+    static void flattenChain(Chronicle* cr, const std::type_info& type,
+                             std::vector<Chronicle*>& members, std::vector<Chronicle*>& links);
+
+    //! Re-plans a chain, returns true if its plan has changed
+    bool replan(Chain& chain);
+
+    //! Cost of the current association of the chain (root excluded)
+    double linkCost(Chronicle* cr, const Chain& chain, const std::vector<double>& cards,
+                    double selectivity, size_t& next, size_t& first, size_t& last) const;
+
+    //! Builds the members \a first to \a last of the new plan, with the pending recognitions
+    Chronicle* buildLinks(const Chain& chain, const std::vector<std::vector<size_t> >& splits,
+                          const std::vector<long>& earliest, size_t first, size_t last,
+                          std::vector<RecoTree*>& matches) const;
+
+  }; // class ChronicleReplanner
+
+} /* namespace CRL */
+
+#endif /* CHRONICLE_REPLANNER_H_ */
@@ -51,11 +51,26 @@ namespace CRL {
     //! Main event processing function
     bool process(const DateType& d, CRL::Event* e = NULL);
 
+    //! Processing of the chronicle alone, its members being already processed (see ChroniclePlan)
+    bool processNode(const DateType& d, CRL::Event* e, bool flagLeft, bool flagRight);
+
     //! Display function for unit tests
     std::string toString() const;
 
+    //! Counts propagate in O(1) when the right member is instantaneous
+    bool supportsCountOnly() const { return !hasJoinKeys() && hasDefaultSelection() && _opRight->isInstantaneous(); }
+
   protected:
 
+    //! Builds the recognition made of \a l then \a r, if the predicate is verified
+    bool join(RecoTree* l, RecoTree* r);
+
+    //! Joins \a r with the left recognitions chosen by the selection policy
+    void joinSelected(RecoTree* r);
+
+    //! Count-only version of #process
+    bool processCount(const DateType& d, CRL::Event* e);
+
     //! Destructor protected (to prevent stack allocation)
     ~ChronicleSequence() { /* empty */ }
 
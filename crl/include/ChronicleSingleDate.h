@@ -87,6 +87,9 @@ namespace CRL {
     //! Implementation of pure virtual
     Chronicle* getChild2() { return NULL; }
 
+    //! Returns a string identifying the structure and the settings of the chronicle
+    std::string structuralSignature() const;
+
   protected:
 
     //! Destructor protected (to prevent stack allocation)
@@ -30,8 +30,10 @@
 // ----------------------------------------------------------------------------
 
 #include <string>
+#include <vector>
 
 #include "Chronicle.h"
+#include "EventBatch.h"
 
 // ----------------------------------------------------------------------------
 // CLASS DESCRIPTION
@@ -69,6 +71,9 @@ namespace CRL {
     //! Accessor
     void setCode(const std::string& code) { _code = code; }
 
+    //! Appends the rows of the events of \a batch matching the chronicle to \a rows
+    void findMatchingRows(const EventBatch& batch, std::vector<size_t>& rows) const;
+
     //! Main event processing function
     virtual bool process(const DateType& d, CRL::Event* e = NULL);
 
@@ -81,8 +86,22 @@ namespace CRL {
     //! Implementation of pure virtual
     Chronicle* getChild2() { return NULL; }
 
+    //! Returns a string identifying the structure and the settings of the chronicle
+    std::string structuralSignature() const {
+      return Chronicle::structuralSignature() + "[" + _code + "]";
+    }
+
+    //! Implementation of virtual
+    bool supportsCountOnly() const { return true; }
+
+    //! Implementation of virtual
+    bool isInstantaneous() const { return true; }
+
   protected:
 
+    //! Count-only version of #process
+    bool processCount(const DateType& d, CRL::Event* e);
+
     //! Destructor protected (to prevent stack allocation)
     ~ChronicleSingleEvent() { /* empty */ }
 
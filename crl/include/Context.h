@@ -30,7 +30,10 @@
 // ----------------------------------------------------------------------------
 
 #include <string>
-#include <set>
+#include <vector>
+#include <deque>
+#include <map>
+#include <iostream>
 
 
 // ----------------------------------------------------------------------------
@@ -41,19 +44,71 @@ namespace CRL {
 
   class Context 
   {
+  public:
+
+    //! Reference to an element of a context, allowing its renaming (see #operator[])
+    class Element
+    {
+    private:
+
+      //! Context of the element
+      Context& _context;
+
+      //! Identifier of the element (see #internName)
+      unsigned int _id;
+
+    public:
+
+      //! Constructor
+      Element(Context& c, unsigned int id) : _context(c), _id(id) { }
+
+      //! Renames the element
+      Element& operator=(const std::string& s);
+
+      //! Accessor
+      const std::string& str() const { return Context::getName(_id); }
+
+      //! Accessor
+      operator const std::string&() const { return str(); }
+
+      //! Accessor
+      const char* c_str() const { return str().c_str(); }
+
+      //! Display function
+      friend std::ostream& operator<<(std::ostream& os, const Element& e) { return os << e.str(); }
+    };
+
   private:
 
     //! Name-symbol meaning "anonymous"
     static std::string ANONYMOUS_CODE_NAME;
 
-    //! Context of the chronicle
-    std::set<std::string> data;
+    //! Identifier of ANONYMOUS_CODE_NAME, lower than every other identifier
+    static const unsigned int ANONYMOUS_ID;
+
+    //! Identifiers of the interned names
+    static std::map<std::string, unsigned int> _nameDictionary;
+
+    //! Interned names, indexed by identifier (references stable)
+    static std::deque<std::string> _names;
+
+    //! Context of the chronicle : identifiers of the names, sorted
+    std::vector<unsigned int> data;
+
+    //! Returns the identifier of the i-th name in the alphabetical order
+    unsigned int idAt(int i) const;
 
   public:
 
     //! Accessor to the class attribute
     static const std::string& ANONYMOUS() { return ANONYMOUS_CODE_NAME; }
 
+    //! Returns the identifier of \a name, interning it if needed
+    static unsigned int internName(const std::string& name);
+
+    //! Returns the name of identifier \a id
+    static const std::string& getName(unsigned int id) { return _names[id]; }
+
     //! Default constructor
     Context(bool withAnonymous = false);
 
@@ -72,14 +127,14 @@ namespace CRL {
     //! Returns the context size (cardinal)
     int size() const;
 
-    //! Returns (const) the i-th element of the context
+    //! Returns (const) the i-th element of the context, in the alphabetical order
     const std::string& operator[](int i) const;
 
-    //! Retourne (non const) le ime lment du contexte
-    std::string& operator[](int i);
+    //! Retourne (non const) le ime lment du contexte, dans l'ordre alphabtique
+    Element operator[](int i);
 
     //! Returns true if the element belong sto the context
-    bool contains(const std::string& s);
+    bool contains(const std::string& s) const;
 
     //! Returns true if the context is reduced to singleton {ANONYMOUS}
     bool isSingletonAnonymous() const;
@@ -0,0 +1,97 @@
+/** ***********************************************************************************
+ * \file DateTraits.h
+ * \author Ariane Piel & Jean Bourrely / Onera DCPS
+ * \date 2014
+ * \brief Conversions of the date representations
+ **************************************************************************************/
+
+/*  Copyright (C) 2012, 2013, 2014  ONERA  http://www.onera.fr
+    This file is part of CRL : Chronicle Recognition Library.
+
+    CRL is free software: you can redistribute it and/or modify it under
+    the terms of the Lesser GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    CRL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    Lesser GNU General Public License for more details.
+
+    You should have received a copy of the Lesser GNU General Public License
+    along with CRL.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef DATE_TRAITS_H_
+#define DATE_TRAITS_H_
+
+// ----------------------------------------------------------------------------
+// INCLUDE FILES
+// ----------------------------------------------------------------------------
+
+#include <stdint.h>
+#include <cmath>
+
+
+// ----------------------------------------------------------------------------
+// CLASS DESCRIPTION
+// ----------------------------------------------------------------------------
+
+namespace CRL {
+
+  //! Conversions of a date representation from and to seconds (default: dates counted in seconds)
+  template <class T>
+  struct DateTraits
+  {
+    //! Indicates whether the comparisons of dates are exact
+    static const bool exact = false;
+
+    //! Number of time units in a second
+    static double unitsPerSecond() { return 1.0; }
+
+    //! Returns the date (or duration) corresponding to \a s seconds
+    static T fromSeconds(double s) { return T(s); }
+
+    //! Returns the number of seconds of date (or duration) \a d
+    static double toSeconds(const T& d) { return (double)d; }
+
+    //! Indicates whether \a u time units are represented exactly
+    static bool representable(double) { return true; }
+
+    //! Returns the date (or duration) of \a u time units
+    static T fromUnits(double u) { return T(u); }
+  };
+
+
+  //! Dates counted in nanoseconds on 64-bit integers (see CRL_INTEGER_DATES)
+  template <>
+  struct DateTraits<int64_t>
+  {
+    //! Indicates whether the comparisons of dates are exact
+    static const bool exact = true;
+
+    //! Number of time units in a second
+    static double unitsPerSecond() { return 1.0e9; }
+
+    //! Returns the date (or duration) corresponding to \a s seconds, rounded to the nearest nanosecond
+    static int64_t fromSeconds(double s) { return (int64_t)floor(s * 1.0e9 + 0.5); }
+
+    //! Returns the number of seconds of date (or duration) \a d
+    static double toSeconds(const int64_t& d) { return (double)d / 1.0e9; }
+
+    //! Indicates whether \a u nanoseconds are represented exactly (whole number)
+    static bool representable(double u) { return floor(u) == u; }
+
+    //! Returns the date (or duration) of \a u nanoseconds, a fractional number is rejected
+    static int64_t fromUnits(double u)
+    {
+      if (!representable(u))
+        throw("DateTraits : fractional number of nanoseconds");
+      return (int64_t)u;
+    }
+  };
+
+} /* namespace CRL */
+
+#endif /* DATE_TRAITS_H_ */
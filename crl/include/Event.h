@@ -29,9 +29,9 @@
 // INCLUDE FILES
 // ----------------------------------------------------------------------------
 
-#include <list>
 #include <string>
 #include <iostream>
+#include <unordered_set>
 
 #include "PropertyManager.h"
 
@@ -39,8 +39,22 @@
 /* Note : the user may define his own classes to represent dates et durations
  * To do this, use the option in the CMakelists.txt file and define whatever is
  * wanted (name of classes, include files and optional library).
+ * The option CRL_INTEGER_DATES represents dates and durations as numbers of
+ * nanoseconds (64-bit integers), which are compared exactly ; the sentinels
+ * are far enough from the limits of the type for sums of dates not to overflow.
+ * The dates given as floating numbers (events, engine, loader) are then
+ * numbers of nanoseconds too: a fractional one is rejected, not truncated
+ * (see DateTraits::fromUnits, and DateTraits::fromSeconds to convert seconds).
  */
 
+#ifdef CRL_INTEGER_DATES
+#include <stdint.h>
+#define DateType int64_t
+#define DurationType int64_t
+#define INFTY_DATE ((int64_t)0x3FFFFFFFFFFFFFFFLL)
+#define NO_DATE (-INFTY_DATE)
+#endif
+
 #ifndef DateType
 #define DateType double
 #endif
@@ -65,6 +79,8 @@
 #define NO_DATE -1.0e100
 #endif
 
+#include "DateTraits.h"
+
 // ----------------------------------------------------------------------------
 // CLASS DESCRIPTION
 // ----------------------------------------------------------------------------
@@ -88,8 +104,23 @@ namespace CRL {
     //! Order (once in the recognition engine buffer)
     long _order;
 
-    //! List of instances allocated on the heap (dynamic allocation)
-    static std::list<Event*> _dynamicInstances;
+    //! Indicates whether the event has been allocated on the heap (see #operator new)
+    bool _dynamic;
+
+    //! Number of holders of a dynamic event (engine buffer, recognition trees), not atomic
+    mutable int _refCount;
+
+    //! Indicates whether a dynamic event is deleted with its last holder (see #release)
+    mutable bool _releasable;
+
+    //! Set of the instances allocated on the heap by the current thread
+    static thread_local std::unordered_set<Event*> _dynamicInstances;
+
+    //! Instance just allocated by #operator new, not built yet (current thread)
+    static thread_local const void* _lastAllocated;
+
+    //! Called by the constructors, returns true if \a e has just been allocated on the heap
+    static bool takeAllocated(const Event* e);
 
   public:
 
@@ -102,15 +133,41 @@ namespace CRL {
     //! Constructor (event of type "pure date")
     Event(const DateType& date);
 
+#ifdef CRL_INTEGER_DATES
+    //! Constructor (actual event of the event flow), rejects a fractional number of nanoseconds
+    Event(const std::string& name, double date);
+
+    //! Constructor (event of type "pure date"), rejects a fractional number of nanoseconds
+    Event(double date);
+#endif
+
     //! Operator new, stores the instance in the dynamic list of instances
     void* operator new(size_t size);
 
     //! Operator delete, removes the instance from the list
     void operator delete(void* ptr);
 
-    //! Deletes every dynamic instances of Event class
+    //! Deletes every dynamic instances of the current thread (those still held are deleted with their last holder)
     static void freeAllInstances();
 
+    //! Returns the number of dynamic instances of the current thread
+    static size_t getDynamicInstanceCount();
+
+    //! Registers a new holder of a dynamic event (engine buffer, recognition tree)
+    void addRef() const { if (_dynamic) ++_refCount; }
+
+    //! Unregisters a holder of a dynamic event, deleted if releasable and no holder remains
+    void release() const { if ( _dynamic && (--_refCount <= 0) && _releasable ) delete this; }
+
+    //! Makes a dynamic event deleted with its last holder (see #release)
+    void setReleasable() const { _releasable = true; }
+
+    //! Accessor
+    bool isDynamic() const { return _dynamic; }
+
+    //! Accessor
+    int getRefCount() const { return _refCount; }
+
     //! Accessor
     static const std::string& getTimeEventName() { return _timeEventName; }
 
@@ -0,0 +1,162 @@
+/** ***********************************************************************************
+ * \file EventBatch.h
+ * \author Ariane Piel & Jean Bourrely / Onera DCPS
+ * \date 2014
+ * \brief Columnar batch of events
+ **************************************************************************************/
+
+/*  Copyright (C) 2012, 2013, 2014  ONERA  http://www.onera.fr
+    This file is part of CRL : Chronicle Recognition Library.
+
+    CRL is free software: you can redistribute it and/or modify it under
+    the terms of the Lesser GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    CRL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    Lesser GNU General Public License for more details.
+
+    You should have received a copy of the Lesser GNU General Public License
+    along with CRL.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef EVENT_BATCH_H_
+#define EVENT_BATCH_H_
+
+// ----------------------------------------------------------------------------
+// INCLUDE FILES
+// ----------------------------------------------------------------------------
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "Event.h"
+#include "Property.h"
+
+
+// ----------------------------------------------------------------------------
+// CLASS DESCRIPTION
+// ----------------------------------------------------------------------------
+
+namespace CRL {
+
+  class EventBatch
+  {
+  public:
+
+    //! Typed column of a property, one value per event (row) of the batch
+    class Column
+    {
+    public:
+
+      //! Type of the values (Property::L, Property::D or Property::STR)
+      Property::DataTypeEnum type;
+
+      //! Indicates whether the event has a value for this property
+      std::vector<bool> present;
+
+      //! Values if the type is Property::L
+      std::vector<long> longs;
+
+      //! Values if the type is Property::D
+      std::vector<double> doubles;
+
+      //! Values if the type is Property::STR
+      std::vector<std::string> strings;
+
+      //! Constructor
+      Column(Property::DataTypeEnum t) : type(t) { }
+
+      //! Adds empty rows until the column has \a n rows
+      void resize(size_t n);
+    };
+
+  private:
+
+    //! Identifiers of the event names (see #internName)
+    std::vector<unsigned int> _nameIds;
+
+    //! Event dates, in non decreasing order
+    std::vector<DateType> _dates;
+
+    //! Event orders, given by the recognition engine (-1 before processing)
+    std::vector<long> _orders;
+
+    //! Property columns, by property name
+    std::map<std::string, Column> _columns;
+
+    //! Identifiers of the event names, shared by all the batches
+    static std::map<std::string, unsigned int> _nameDictionary;
+
+    //! Event names, by identifier
+    static std::vector<std::string> _names;
+
+  public:
+
+    //! Constructor
+    EventBatch() { }
+
+    //! Returns the identifier of an event name, the name being registered if needed
+    static unsigned int internName(const std::string& name);
+
+    //! Returns the event name of identifier \a id
+    static const std::string& getName(unsigned int id) { return _names[id]; }
+
+    //! Adds an event (row) at the end of the batch, returns its row
+    size_t addEvent(const std::string& name, const DateType& date);
+
+    //! Sets an integer property of the event of row \a row
+    void setLong(size_t row, const std::string& prop, long value);
+
+    //! Sets a real property of the event of row \a row
+    void setDouble(size_t row, const std::string& prop, double value);
+
+    //! Sets a string property of the event of row \a row
+    void setString(size_t row, const std::string& prop, const std::string& value);
+
+    //! Empties the batch
+    void clear();
+
+    //! Accessor, returns the number of events (rows)
+    size_t size() const { return _dates.size(); }
+
+    //! Accessor
+    unsigned int getNameId(size_t row) const { return _nameIds[row]; }
+
+    //! Accessor
+    const DateType& getDate(size_t row) const { return _dates[row]; }
+
+    //! Accessor
+    long getOrder(size_t row) const { return _orders[row]; }
+
+    //! Accessor, used by the recognition engine
+    void setOrder(size_t row, long order) { _orders[row] = order; }
+
+    //! Accessor, returns the column of the names
+    const std::vector<unsigned int>& getNameIds() const { return _nameIds; }
+
+    //! Accessor, returns the column of property \a prop (NULL if none)
+    const Column* getColumn(const std::string& prop) const;
+
+    //! Appends the rows of the events named \a nameId to \a rows (SIMD scan if available)
+    void findRows(unsigned int nameId, std::vector<size_t>& rows) const;
+
+    //! Scalar version of #findRows
+    void findRowsScalar(unsigned int nameId, std::vector<size_t>& rows) const;
+
+    //! Allocates the event of row \a row, with its properties
+    Event* makeEvent(size_t row) const;
+
+  protected:
+
+    //! Returns the column of property \a prop, created if needed, checks its type
+    Column& column(const std::string& prop, Property::DataTypeEnum type);
+
+  }; // class EventBatch
+
+} /* namespace CRL */
+
+#endif /* EVENT_BATCH_H_ */
@@ -34,6 +34,7 @@
 #include <iostream>
 
 #include "PropertyManager.h"
+#include "RecoTreeArena.h"
 
 
 // ----------------------------------------------------------------------------
@@ -100,6 +101,12 @@ namespace CRL {
     //! Destructor
     ~Property() { }
 
+    //! Allocation, in the arena of the thread if any (see RecoTreeArena::setCurrent)
+    static void* operator new(size_t size) { return RecoTreeArena::allocateCurrent(size); }
+
+    //! Deallocation, in the arena of the allocation
+    static void operator delete(void* ptr) { RecoTreeArena::deallocateAny(ptr); }
+
     //! Allocation operators from simple types
     Property& operator=(const bool& x);
     Property& operator=(const char& x);
@@ -29,7 +29,7 @@
 // INCLUDE FILES
 // ----------------------------------------------------------------------------
 
-#include <map>
+#include <cstddef>
 #include <string>
 
 
@@ -45,20 +45,39 @@ namespace CRL {
   {
   private:
 
-    //! Pair of property and boolean indicating if the manager should delete the property
-    typedef std::pair<Property*,bool> PropertyStored;
-
-    //! Manages a property list indexed by names
-    std::map<std::string, PropertyStored> properties;
+    //! Named property, and boolean indicating if the manager should delete the property
+    struct Entry
+    {
+      std::string name;   //!< Name of the property
+      Property* value;    //!< Property
+      bool toDelete;      //!< Indicates whether the property is owned by the manager
+    };
+
+    //! Header of the properties, followed by their entries sorted by name
+    struct Block
+    {
+      unsigned int size;       //!< Number of entries
+      unsigned int capacity;   //!< Number of entries allocated
+      Entry* entries() { return reinterpret_cast<Entry*>(this + 1); }
+    };
+
+    //! Properties, allocated out of line with the first one (NULL: none)
+    Block* _block;
 
   public:
 
     //! Default constructor
-    PropertyManager() { }
+    PropertyManager() : _block(NULL) { }
+
+    //! Copy constructor, the properties owned by \a pm are copied, the others shared
+    PropertyManager(const PropertyManager& pm);
 
     //! Destructor, deletes the properties owned by the manager
     ~PropertyManager();
 
+    //! Assignment, the properties owned by \a pm are copied, the others shared
+    PropertyManager& operator=(const PropertyManager& pm);
+
     //! Returns the number of properties
     int countProperties() const;
 
@@ -92,6 +111,17 @@ namespace CRL {
     //! Returns the property named "s", error if it does not exist
     const Property& operator[](const std::string& s) const;
 
+  private:
+
+    //! Returns the index of the first entry not named before \a s
+    size_t lowerBound(char const * const s) const;
+
+    //! Enlarges the block so that it holds \a n entries
+    void reserve(size_t n);
+
+    //! Deletes the owned properties and the block
+    void clearProperties();
+
   }; // class PropertyManager
 
 } /* namespace CRL */
@@ -0,0 +1,119 @@
+/** ***********************************************************************************
+ * \file RecoBudget.h
+ * \author Ariane Piel & Jean Bourrely / Onera DCPS
+ * \date 2014
+ * \brief Memory budget of a recognition set and its eviction policies
+ **************************************************************************************/
+
+/*  Copyright (C) 2012, 2013, 2014  ONERA  http://www.onera.fr
+    This file is part of CRL : Chronicle Recognition Library.
+
+    CRL is free software: you can redistribute it and/or modify it under
+    the terms of the Lesser GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    CRL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    Lesser GNU General Public License for more details.
+
+    You should have received a copy of the Lesser GNU General Public License
+    along with CRL.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef RECO_BUDGET_H_
+#define RECO_BUDGET_H_
+
+// ----------------------------------------------------------------------------
+// INCLUDE FILES
+// ----------------------------------------------------------------------------
+
+#include <list>
+#include <map>
+#include <vector>
+#include <random>
+#include <unordered_map>
+
+#include "RecoTree.h"
+
+
+// ----------------------------------------------------------------------------
+// CLASS DESCRIPTION
+// ----------------------------------------------------------------------------
+
+namespace CRL {
+
+  class RecoBudget
+  {
+  public:
+
+    //! Eviction policy when the recognition set exceeds its budget
+    enum Policy { OLDEST_MAX_DATE, OLDEST_INSERTION, RESERVOIR };
+
+  private:
+
+    //! Maximal number of recognitions
+    size_t _maxSize;
+
+    //! Eviction policy
+    Policy _policy;
+
+    //! Recognitions ordered by maximal date (#OLDEST_MAX_DATE)
+    std::multimap<DateType, RecoTree*> _byDate;
+
+    //! Recognitions ordered by insertion (#OLDEST_INSERTION)
+    std::list<RecoTree*> _byInsertion;
+
+    //! Positions in #_byInsertion
+    std::unordered_map<RecoTree*, std::list<RecoTree*>::iterator> _insertionPos;
+
+    //! Reservoir of recognitions (#RESERVOIR)
+    std::vector<RecoTree*> _slots;
+
+    //! Positions in #_slots
+    std::unordered_map<RecoTree*, size_t> _slotPos;
+
+    //! Number of recognitions offered to the reservoir
+    unsigned long _seen;
+
+    //! Random generator of the reservoir sampling (deterministic seed)
+    std::minstd_rand _random;
+
+  public:
+
+    //! Constructor
+    RecoBudget(size_t maxSize, Policy policy)
+      : _maxSize(maxSize), _policy(policy), _seen(0), _random(1) { }
+
+    //! Accessor
+    size_t getMaxSize() const { return _maxSize; }
+
+    //! Accessor
+    Policy getPolicy() const { return _policy; }
+
+    //! Number of recognitions tracked
+    size_t size() const;
+
+    //! Tracks a new recognition, returns the recognition to be evicted (NULL if none)
+    RecoTree* admit(RecoTree* rc);
+
+    //! Stops tracking a recognition which has left the set
+    void erase(RecoTree* rc);
+
+    //! Selects and stops tracking the next recognition to be evicted (NULL if empty)
+    RecoTree* evict();
+
+    //! Stops tracking all the recognitions
+    void clear();
+
+  private:
+
+    //! Tracks a recognition without eviction
+    void track(RecoTree* rc);
+
+  }; // class RecoBudget
+
+} /* namespace CRL */
+
+#endif /* RECO_BUDGET_H_ */
@@ -0,0 +1,118 @@
+/** ***********************************************************************************
+ * \file RecoColumns.h
+ * \author Ariane Piel & Jean Bourrely / Onera DCPS
+ * \date 2014
+ * \brief Columns of the orders of a recognition set
+ **************************************************************************************/
+
+/*  Copyright (C) 2012, 2013, 2014  ONERA  http://www.onera.fr
+    This file is part of CRL : Chronicle Recognition Library.
+
+    CRL is free software: you can redistribute it and/or modify it under
+    the terms of the Lesser GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    CRL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    Lesser GNU General Public License for more details.
+
+    You should have received a copy of the Lesser GNU General Public License
+    along with CRL.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef RECO_COLUMNS_H_
+#define RECO_COLUMNS_H_
+
+// ----------------------------------------------------------------------------
+// INCLUDE FILES
+// ----------------------------------------------------------------------------
+
+#include <vector>
+#include <stdint.h>
+
+#include "RecoTree.h"
+
+
+// ----------------------------------------------------------------------------
+// CLASS DESCRIPTION
+// ----------------------------------------------------------------------------
+
+namespace CRL {
+
+  class RecoColumns
+  {
+  public:
+
+    //! Lower bound of #select meaning "no bound"
+    static const int64_t NO_LOWER_BOUND;
+
+    //! Upper bound of #select meaning "no bound"
+    static const int64_t NO_UPPER_BOUND;
+
+  private:
+
+    //! Minimal orders of the recognitions
+    std::vector<int64_t> _minOrders;
+
+    //! Maximal orders of the recognitions
+    std::vector<int64_t> _maxOrders;
+
+    //! Recognitions, in the same rows, in order of insertion (NULL: erased row)
+    std::vector<RecoTree*> _trees;
+
+    //! Number of recognitions
+    size_t _size;
+
+  public:
+
+    //! Constructor
+    RecoColumns() : _size(0) { }
+
+    //! Adds a recognition at row \a row, its position in the mirrored recognition set (see RecoSet)
+    void insert(size_t row, RecoTree* rc);
+
+    //! Removes the recognition of row \a row, the row is left empty until the next compaction
+    void erase(size_t row);
+
+    //! Empties the columns
+    void clear();
+
+    //! Removes the empty rows, as RecoSet::compact renumbers the positions of the mirrored set
+    void compact();
+
+    //! Accessor, returns the number of recognitions
+    size_t size() const { return _size; }
+
+    //! Accessor, returns the number of rows (recognitions and empty rows)
+    size_t getRowCount() const { return _trees.size(); }
+
+    //! Accessor, returns the number of empty rows
+    size_t getTombstoneCount() const { return _trees.size() - _size; }
+
+    //! Accessor (NULL for an empty row)
+    RecoTree* getTree(size_t row) const { return _trees[row]; }
+
+    //! Accessor
+    int64_t getMinOrder(size_t row) const { return _minOrders[row]; }
+
+    //! Accessor
+    int64_t getMaxOrder(size_t row) const { return _maxOrders[row]; }
+
+    //! Appends to \a rows the rows with minLow < minOrder < minHigh and maxLow < maxOrder < maxHigh
+    void select(int64_t minLow, int64_t minHigh, int64_t maxLow, int64_t maxHigh,
+                std::vector<size_t>& rows) const;
+
+    //! Scalar version of #select
+    void selectScalar(int64_t minLow, int64_t minHigh, int64_t maxLow, int64_t maxHigh,
+                      std::vector<size_t>& rows) const;
+
+    //! Indicates whether #select uses AVX2 on this processor
+    static bool hasAVX2();
+
+  }; // class RecoColumns
+
+} /* namespace CRL */
+
+#endif /* RECO_COLUMNS_H_ */
@@ -0,0 +1,107 @@
+/** ***********************************************************************************
+ * \file RecoIndex.h
+ * \author Ariane Piel & Jean Bourrely / Onera DCPS
+ * \date 2014
+ * \brief Hash index of a recognition set on equi-join keys
+ **************************************************************************************/
+
+/*  Copyright (C) 2012, 2013, 2014  ONERA  http://www.onera.fr
+    This file is part of CRL : Chronicle Recognition Library.
+
+    CRL is free software: you can redistribute it and/or modify it under
+    the terms of the Lesser GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    CRL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    Lesser GNU General Public License for more details.
+
+    You should have received a copy of the Lesser GNU General Public License
+    along with CRL.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef RECO_INDEX_H_
+#define RECO_INDEX_H_
+
+// ----------------------------------------------------------------------------
+// INCLUDE FILES
+// ----------------------------------------------------------------------------
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+#include "RecoTree.h"
+#include "RecoSet.h"
+
+
+// ----------------------------------------------------------------------------
+// CLASS DESCRIPTION
+// ----------------------------------------------------------------------------
+
+namespace CRL {
+
+  class RecoIndex
+  {
+  public:
+
+    //! Data type : path of property names, from a recognition to a property (ex: x / "CRL ID")
+    typedef std::vector<std::string> PropertyPath;
+
+    //! Data type : list of the paths making up a (composite) key
+    typedef std::vector<PropertyPath> KeyPaths;
+
+    //! Data type : bucket of recognitions sharing the same key
+    typedef RecoSet Bucket;
+
+  private:
+
+    //! Paths of the properties making up the key
+    KeyPaths _paths;
+
+    //! Recognitions indexed by key value
+    std::unordered_map<std::string, Bucket> _buckets;
+
+    //! Number of parent chronicles using the index
+    int _users;
+
+  public:
+
+    //! Empty bucket, returned when a key is not found
+    static const Bucket EMPTY_BUCKET;
+
+    //! Constructor
+    RecoIndex(const KeyPaths& paths) : _paths(paths), _users(0) { }
+
+    //! Registers a new user of the index, returns the number of users
+    int acquire() { return ++_users; }
+
+    //! Unregisters a user of the index, returns the number of remaining users
+    int release() { return --_users; }
+
+    //! Accessor
+    const KeyPaths& getPaths() const { return _paths; }
+
+    //! Indexes a recognition (ignored if the key cannot be computed)
+    void insert(RecoTree* rc);
+
+    //! Removes a recognition from the index
+    void erase(RecoTree* rc);
+
+    //! Empties the index
+    void clear() { _buckets.clear(); }
+
+    //! Returns the recognitions indexed with key \a key
+    const Bucket& find(const std::string& key) const;
+
+    //! Computes the key of a property set, returns false if a property is missing
+    static bool extractKey(const PropertyManager& pm, const KeyPaths& paths, 
+                           std::string& key);
+
+  }; // class RecoIndex
+
+} /* namespace CRL */
+
+#endif /* RECO_INDEX_H_ */
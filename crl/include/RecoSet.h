@@ -0,0 +1,217 @@
+/** ***********************************************************************************
+ * \file RecoSet.h
+ * \author Ariane Piel & Jean Bourrely / Onera DCPS
+ * \date 2014
+ * \brief Insertion-ordered set of recognitions, stored by chunks
+ **************************************************************************************/
+
+/*  Copyright (C) 2012, 2013, 2014  ONERA  http://www.onera.fr
+    This file is part of CRL : Chronicle Recognition Library.
+
+    CRL is free software: you can redistribute it and/or modify it under
+    the terms of the Lesser GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    CRL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    Lesser GNU General Public License for more details.
+
+    You should have received a copy of the Lesser GNU General Public License
+    along with CRL.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef RECO_SET_H_
+#define RECO_SET_H_
+
+// ----------------------------------------------------------------------------
+// INCLUDE FILES
+// ----------------------------------------------------------------------------
+
+#include <cstddef>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+
+// ----------------------------------------------------------------------------
+// CLASS DESCRIPTION
+// ----------------------------------------------------------------------------
+
+namespace CRL {
+
+  class RecoTree;
+
+  class RecoSet
+  {
+  public:
+
+    //! Size of the first chunk, each following chunk being twice as large
+    static const size_t FIRST_CHUNK = 8;
+
+    //! Iterator in the order of insertion, skipping the erased recognitions
+    class const_iterator
+    {
+      friend class RecoSet;
+
+    private:
+
+      //! Iterated set
+      const RecoSet* _set;
+
+      //! Chunk of the current position
+      size_t _chunk;
+
+      //! Offset of the current position in its chunk
+      size_t _offset;
+
+      //! Current position, in the order of insertion
+      size_t _pos;
+
+      //! Constructor, on position \a pos
+      const_iterator(const RecoSet* s, size_t chunk, size_t offset, size_t pos)
+        : _set(s), _chunk(chunk), _offset(offset), _pos(pos) { }
+
+      //! Goes to the next position
+      void step() {
+        ++_pos;
+        if (++_offset == (FIRST_CHUNK << _chunk)) { ++_chunk; _offset = 0; }
+      }
+
+      //! Goes past the erased positions
+      void skip() {
+        while ( (_pos < _set->_end) && (_set->_chunks[_chunk][_offset] == NULL) )
+          step();
+      }
+
+    public:
+
+      typedef std::forward_iterator_tag iterator_category;
+      typedef RecoTree* value_type;
+      typedef std::ptrdiff_t difference_type;
+      typedef RecoTree* const* pointer;
+      typedef RecoTree* const& reference;
+
+      //! Default constructor
+      const_iterator() : _set(NULL), _chunk(0), _offset(0), _pos(0) { }
+
+      //! Accessor
+      reference operator*() const { return _set->_chunks[_chunk][_offset]; }
+
+      //! Accessor, position in the order of insertion (renumbered by #compact, see RecoColumns)
+      size_t getPosition() const { return _pos; }
+
+      //! Pre-increment
+      const_iterator& operator++() { step(); skip(); return *this; }
+
+      //! Post-increment
+      const_iterator operator++(int) { const_iterator tmp(*this); ++(*this); return tmp; }
+
+      //! Comparison
+      bool operator==(const const_iterator& it) const { return _pos == it._pos; }
+
+      //! Comparison
+      bool operator!=(const const_iterator& it) const { return _pos != it._pos; }
+
+    }; // class const_iterator
+
+    //! The recognitions are not modifiable through the iterators (as in a std::set)
+    typedef const_iterator iterator;
+
+  private:
+
+    //! Entry of the hash table: empty if key and pos are null, erased if only key is null
+    struct Slot
+    {
+      RecoTree* key;   //!< Recognition
+      size_t pos;      //!< Position of the recognition in the chunks
+    };
+
+    //! Chunks of the recognitions, in the order of insertion (NULL: erased)
+    std::vector<RecoTree**> _chunks;
+
+    //! Number of positions used (erased ones included)
+    size_t _end;
+
+    //! Number of recognitions
+    size_t _size;
+
+    //! Positions of the recognitions by address (empty while the first chunk is enough)
+    std::vector<Slot> _table;
+
+    //! Number of non-empty slots of #_table
+    size_t _tableUsed;
+
+  public:
+
+    //! Default constructor
+    RecoSet() : _end(0), _size(0), _tableUsed(0) { }
+
+    //! Copy constructor (the erased recognitions are not copied)
+    RecoSet(const RecoSet& s);
+
+    //! Destructor, frees the chunks (not the recognitions)
+    ~RecoSet();
+
+    //! Assignment (the erased recognitions are not copied)
+    RecoSet& operator=(const RecoSet& s);
+
+    //! Accessor
+    const_iterator begin() const;
+
+    //! Accessor
+    const_iterator end() const { return const_iterator(this, 0, 0, _end); }
+
+    //! Accessor
+    size_t size() const { return _size; }
+
+    //! Accessor
+    bool empty() const { return (_size == 0); }
+
+    //! Accessor, returns the number of erased positions not yet reclaimed
+    size_t getTombstoneCount() const { return _end - _size; }
+
+    //! Appends a recognition, returns its position and false if it was already present
+    std::pair<const_iterator, bool> insert(RecoTree* rc);
+
+    //! Erases a recognition, returns the number of recognitions erased (0 or 1)
+    size_t erase(RecoTree* rc);
+
+    //! Erases the recognition at position \a it, returns the following position
+    const_iterator erase(const_iterator it);
+
+    //! Returns the position of a recognition, #end if absent
+    const_iterator find(RecoTree* rc) const;
+
+    //! Returns 1 if the recognition is present, 0 otherwise
+    size_t count(RecoTree* rc) const { return (find(rc) != end()) ? 1 : 0; }
+
+    //! Empties the set
+    void clear();
+
+    //! Reclaims the erased positions if they outnumber the recognitions (invalidates the iterators), returns true if done
+    bool compact();
+
+  private:
+
+    //! Returns the position of a recognition in the chunks, #_end if absent
+    size_t locate(RecoTree* rc) const;
+
+    //! Returns the iterator on position \a pos
+    const_iterator at(size_t pos) const;
+
+    //! Returns the slot of \a pos
+    RecoTree*& slot(size_t pos);
+
+    //! Returns the index of the slot of a recognition in #_table (or of the empty slot ending its probe)
+    size_t probe(RecoTree* rc) const;
+
+    //! Rebuilds #_table from the chunks
+    void rebuildTable();
+
+  }; // class RecoSet
+
+} /* namespace CRL */
+
+#endif /* RECO_SET_H_ */
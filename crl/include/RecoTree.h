@@ -30,8 +30,10 @@
 // ----------------------------------------------------------------------------
 
 #include <iostream>
+#include <cstddef>
 #include "Event.h"
 #include "PropertyManager.h"
+#include "RecoTreeArena.h"
 
 // ----------------------------------------------------------------------------
 // CLASS DESCRIPTION
@@ -46,9 +48,6 @@ namespace CRL {
   {
   protected:
 
-    //! Indicates whether single (1) or couple (2)
-    int _arity;
-
     //! Min order of the leaf events
     long _minOrder;
 
@@ -64,20 +63,60 @@ namespace CRL {
     //! Link to the chronicle which has created the recognition
     Chronicle* _myChronicle;
 
+    //! Hash of the structure of the tree, set by the constructors of the sub-classes (see #equal)
+    std::size_t _structuralHash;
+
+    //! Number of holders of the tree (chronicles, parent trees, user)
+    mutable int _refCount;
+
+    //! Class of the node, the methods dispatch on it (no vtable): without member (0), single (1) or couple (2).
+    //! Last so that the sub-classes may use the padding
+    unsigned char _arity;
+
   protected:
 
-    //! Protected constructor (abstract class)
-    RecoTree(int n) : _arity(n), _minOrder(0), _maxOrder(0), 
-                      _minDate(0.0), _maxDate(0.0), _myChronicle(NULL) { }
+    //! Protected constructor (sub-classes)
+    RecoTree(int n) : _minOrder(0), _maxOrder(0), 
+                      _minDate(0.0), _maxDate(0.0), _myChronicle(NULL),
+                      _structuralHash((std::size_t)n), _refCount(0), _arity((unsigned char)n) { }
+
+    //! Destructor, not virtual: see #release
+    ~RecoTree() { }
+
+    //! Combines value \a v into hash \a h
+    static std::size_t combineHash(std::size_t h, std::size_t v) {
+      return h ^ (v + (std::size_t)0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2));
+    }
+
+    //! Deletes the tree as an instance of its sub-class (see #_arity)
+    void destroy() const;
 
   public:
 
-    //! Virtual destructor
-    virtual ~RecoTree() { }
+    //! Constructor of a recognition without member: dates and orders only (as the static chronicles)
+    RecoTree(long minOrder, long maxOrder, const DateType& minDate, const DateType& maxDate);
+
+    //! Allocation, in the arena of the thread if any (see RecoTreeArena::setCurrent)
+    static void* operator new(size_t size) { return RecoTreeArena::allocateCurrent(size); }
+
+    //! Deallocation, in the arena of the allocation
+    static void operator delete(void* ptr) { RecoTreeArena::deallocateAny(ptr); }
+
+    //! Registers a new holder of the tree
+    void addRef() const { ++_refCount; }
+
+    //! Unregisters a holder of the tree, deletes the tree when no holder remains
+    void release() const { if (--_refCount <= 0) destroy(); }
+
+    //! Accessor
+    int getRefCount() const { return _refCount; }
 
     //! Accessor
     int getArity() const { return _arity; }
 
+    //! Accessor, equal trees (see #equal) have the same hash
+    std::size_t getStructuralHash() const { return _structuralHash; }
+
     //! Accessor
     long getMinOrder() const { return _minOrder; }
 
@@ -108,6 +147,9 @@ namespace CRL {
     //! Accessor
     Chronicle* getMyChronicle() { return _myChronicle; }
 
+    //! Accessor (const)
+    const Chronicle* getMyChronicle() const { return _myChronicle; }
+
     //! Accessor, via the chronicle
     RecognitionEngine* getMyEngine();
 
@@ -124,22 +166,22 @@ namespace CRL {
     void copyDateAndOrder(const RecoTree& r1, const Event& r2);
 
     //! Accessor (valid if #_arity is 1);
-    virtual const Event* getEvent() const = 0;
+    const Event* getEvent() const;
 
     //! Accessor (valid if #_arity is 2)
-    virtual const RecoTree* getLeftMember() const = 0;
+    const RecoTree* getLeftMember() const;
 
     //! Accessor (valid if #_arity is 2)
-    virtual const RecoTree* getRightMember() const = 0;
+    const RecoTree* getRightMember() const;
 
     //! Returns true if the input tree is the same as "this"
-    virtual bool equal(const RecoTree* t) const = 0;
+    bool equal(const RecoTree* t) const;
 
     //! Returns the most recent (leaf) event of a tree
-    virtual const Event* lastEvent() const = 0;
+    const Event* lastEvent() const;
 
     //! Tree display function
-    virtual void prettyPrint(std::ostream& os, int ntab) const = 0;
+    void prettyPrint(std::ostream& os, int ntab) const;
 
     //! Output flow for tests
     friend std::ostream& operator<<(std::ostream& os, const RecoTree& t) {
@@ -149,6 +191,20 @@ namespace CRL {
 
   }; // class RecoTree
 
+
+  //! Hash function of the recognition trees, on their structure
+  struct RecoTreeHash
+  {
+    std::size_t operator()(const RecoTree* t) const { return t->getStructuralHash(); }
+  };
+
+
+  //! Equality of the recognition trees, on their structure
+  struct RecoTreeEqual
+  {
+    bool operator()(const RecoTree* t1, const RecoTree* t2) const { return t1->equal(t2); }
+  };
+
 } /* namespace CRL */
 
 #endif /* RECO_TREE_H_ */
@@ -0,0 +1,84 @@
+/** ***********************************************************************************
+ * \file RecoTreeArena.h
+ * \author Ariane Piel & Jean Bourrely / Onera DCPS
+ * \date 2014
+ * \brief Segmented memory arena for the recognition trees and their properties
+ **************************************************************************************/
+
+/*  Copyright (C) 2012, 2013, 2014  ONERA  http://www.onera.fr
+    This file is part of CRL : Chronicle Recognition Library.
+
+    CRL is free software: you can redistribute it and/or modify it under
+    the terms of the Lesser GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    CRL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    Lesser GNU General Public License for more details.
+
+    You should have received a copy of the Lesser GNU General Public License
+    along with CRL.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef RECO_TREE_ARENA_H_
+#define RECO_TREE_ARENA_H_
+
+// ----------------------------------------------------------------------------
+// INCLUDE FILES
+// ----------------------------------------------------------------------------
+
+#include "SegmentedArena.h"
+
+
+// ----------------------------------------------------------------------------
+// CLASS DESCRIPTION
+// ----------------------------------------------------------------------------
+
+namespace CRL {
+
+  class RecoTreeArena : public SegmentedArena
+  {
+  private:
+
+    //! Arena of the allocations of the thread (NULL: heap)
+    static thread_local RecoTreeArena* _currentArena;
+
+  public:
+
+    //! Installs an arena for the allocations of the thread, for the lifetime of the scope
+    class Scope
+    {
+    private:
+      RecoTreeArena* _previous;
+    public:
+      Scope(RecoTreeArena* arena) : _previous(setCurrent(arena)) { }
+      ~Scope() { setCurrent(_previous); }
+    };
+
+    //! Constructor
+    RecoTreeArena(size_t segmentSize = 65536) : SegmentedArena(segmentSize) { }
+
+    //! Allocates \a size bytes in the arena of the thread, or on the heap if none
+    static void* allocateCurrent(size_t size);
+
+    //! Deallocates memory returned by #allocateCurrent, whatever the arena of the thread
+    static void deallocateAny(void* ptr);
+
+    //! Modifies the arena of the allocations of the thread (NULL: heap), returns the previous one
+    static RecoTreeArena* setCurrent(RecoTreeArena* arena);
+
+    //! Accessor, returns the arena of the allocations of the thread (NULL: heap)
+    static RecoTreeArena* getCurrent() { return _currentArena; }
+
+  private:
+
+    //! Destructor (private: see #close)
+    ~RecoTreeArena() { }
+
+  }; // class RecoTreeArena
+
+} /* namespace CRL */
+
+#endif /* RECO_TREE_ARENA_H_ */
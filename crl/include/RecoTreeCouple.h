@@ -49,16 +49,13 @@ namespace CRL {
     //! Right member
     const RecoTree* _rightMember;
 
-    //! Indicates whether the right member must be destroyed
-    bool _rightToDelete;
-
   public:
 
-    //! Destructor
-    ~RecoTreeCouple() { if (_rightToDelete) delete _rightMember; }
+    //! Destructor, releases the members
+    ~RecoTreeCouple();
 
-    //! Constructor
-    RecoTreeCouple(const RecoTree* left, const RecoTree* right, bool rightToDelete = false);
+    //! Constructor, the members are held until destruction
+    RecoTreeCouple(const RecoTree* left, const RecoTree* right);
 
     //! Accessor (overload of RecoTree)
     const Event* getEvent() const;
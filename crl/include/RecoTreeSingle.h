@@ -45,33 +45,43 @@ namespace CRL {
   {
   private:
 
-    //! (1) Event linked to the recognition
-    const Event* _event;
+    //! Indicates whether the event is held by the node (dynamic event, see Event::addRef)
+    bool _eventHeld;
 
-    //! (2) OR lower node of the tree linked to the recognition
-    const RecoTree* _tree;
+    //! Indicates whether the node is linked to a lower node (2) instead of an event (1)
+    bool _hasTree;
 
-    //! Indicates whether the event has to be destroyed
-    bool _eventToDelete;
+    //! Linked element, only one of them being used (see #_hasTree)
+    union
+    {
+      //! (1) Event linked to the recognition
+      const Event* _event;
 
-    //! Indicates whether the underlying recognition has to be destroyed
-    bool _treeToDelete;
+      //! (2) OR lower node of the tree linked to the recognition
+      const RecoTree* _tree;
+    };
+
+    //! Recognition held because its properties are shared by this node (not part of the tree)
+    const RecoTree* _heldTree;
 
   public:
 
     //! Constructor (default)
     RecoTreeSingle()
-      : RecoTree(0), _event(NULL), _tree(NULL), _eventToDelete(false), _treeToDelete(false)  { }
+      : RecoTree(1), _eventHeld(false), _hasTree(false), _event(NULL), _heldTree(NULL)  { }
 
-    //! Constructor (1)
+    //! Constructor (1), the event is held until destruction (and then deleted if \a eventToDelete)
     RecoTreeSingle(const Event* e, bool eventToDelete = false);
 
-    //! Constructor (2)
-    RecoTreeSingle(const RecoTree* r, bool treeToDelete = false);
+    //! Constructor (2), the lower node is held until destruction
+    RecoTreeSingle(const RecoTree* r);
 
     //! Destructor
     ~RecoTreeSingle();
 
+    //! Holds recognition \a r, which properties are shared by this node
+    void holdTree(const RecoTree* r);
+
     //! Accessor (overload of RecoTree)
     const Event* getEvent() const;
 
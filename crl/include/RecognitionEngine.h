@@ -30,11 +30,21 @@
 // ----------------------------------------------------------------------------
 
 #include <list>
+#include <map>
+#include <string>
+#include <vector>
 #include <iostream>
 #include <utility>
 
 #include "Event.h"
 #include "Chronicle.h"
+#include "ChronicleOptimizer.h"
+#include "ChronicleReplanner.h"
+#include "ChroniclePlan.h"
+#include "ActionQueue.h"
+#include "RecognitionSink.h"
+#include "EventBatch.h"
+#include "RecoTreeArena.h"
 
 
 // ----------------------------------------------------------------------------
@@ -79,6 +89,48 @@ namespace CRL {
     //! Indicates whether too old recognitions have to be purged
     bool _purgeOldRecognitions;
 
+    //! Maximal number of recognitions in all the recognition sets (-1: unbounded)
+    long _maxTotalRecognitions;
+
+    //! Number of recognitions evicted to respect #_maxTotalRecognitions
+    unsigned long _evictionCount;
+
+    //! Indicates whether identical sub-chronicles are merged when chronicles are added
+    bool _shareSubChronicles;
+
+    //! Shared chronicles, by structural signature
+    std::map<std::string, CRL::Chronicle*> _sharedChronicles;
+
+    //! Sub-chronicles replaced by a shared one, destroyed with the engine
+    std::list<CRL::Chronicle*> _detachedChronicles;
+
+    //! Indicates whether the chronicles are rewritten into cheaper ones when they are added
+    bool _optimizeChronicles;
+
+    //! Optimizer of the chronicles added (see #setOptimizeChronicles)
+    ChronicleOptimizer _optimizer;
+
+    //! Adaptive planning of the chains of the chronicles added (see #setReplanPeriod)
+    ChronicleReplanner _replanner;
+
+    //! Asynchronous delivery of the new recognitions of the root chronicles (NULL: none)
+    ActionQueue* _actionQueue;
+
+    //! Binary records of the new recognitions of the root chronicles (NULL: none)
+    RecognitionSink* _recognitionSink;
+
+    //! Indicates whether the events are processed through #_plan
+    bool _useCompiledPlan;
+
+    //! Flat execution plan of the chronicles (see #setUseCompiledPlan)
+    ChroniclePlan _plan;
+
+    //! Indicates whether #_plan has to be compiled again before the next event
+    bool _planOutdated;
+
+    //! Arena of the recognitions created while processing the events (NULL: heap)
+    RecoTreeArena* _recoTreeArena;
+
   public:
 
     //! Default constructor
@@ -87,7 +139,7 @@ namespace CRL {
     //! Constructor with an output flow for logs
     RecognitionEngine(std::ostream* out, VerbosityLevel lvl = WARNING);
 
-    //! Destructor: deletes only the events created by the engine itself
+    //! Destructor: deletes only the events created by the engine itself, delivers the queued recognitions
     ~RecognitionEngine();
 
     //! Adds a chronicle in the list of the chronicles to be recognised (#_rootChronicles)
@@ -117,8 +169,19 @@ namespace CRL {
     //! Adds an event to the input buffer
     RecognitionEngine& operator<<(CRL::Event *e);
 
+#ifdef CRL_INTEGER_DATES
+    //! Adds a date to the input buffer which will increase #_currentTime (exact, in nanoseconds)
+    RecognitionEngine& operator<<(const DateType& d);
+
+    //! Adds a date in nanoseconds to the input buffer, rejected if fractional (see DateTraits::fromUnits)
+    RecognitionEngine& operator<<(const double& d);
+
+    //! Adds a date in nanoseconds to the input buffer
+    RecognitionEngine& operator<<(int d) { return *this << (DateType)d; }
+#else
     //! Adds a delay to the input buffer which will increase #_currentTime
     RecognitionEngine& operator<<(const double& d);
+#endif
 
     //! Empties the input buffer of all the events
     void clearEventBuffer();
@@ -126,6 +189,9 @@ namespace CRL {
     //! Updates all the recognition sets until instant d
     int process(const DateType& date = INFTY_DATE);
 
+    //! Processes the events of the input buffer, then the events of \a batch
+    int processBatch(EventBatch& batch);
+
     //! Inserts an event and updates the recognition sets
     //int process(CRL::Event *e);
 
@@ -169,7 +235,70 @@ namespace CRL {
     void setPolicyCurrentTime();
 
     //! Activates the deleting policy of too old recognitions
-    void activateForget(double d);
+    void activateForget(DurationType d);
+
+    //! Activates the deleting policy of too old recognitions, with the inferred retention horizons
+    void activateAutoForget();
+
+    //! Infers the retention horizons of all the chronicles from their temporal constraints
+    void computeRetentionHorizons();
+
+    //! Accessor
+    bool getShareSubChronicles() const { return _shareSubChronicles; }
+
+    //! Merges the identical sub-chronicles of the chronicles added from now on
+    void setShareSubChronicles(bool b) { _shareSubChronicles = b; }
+
+    //! Accessor
+    bool getOptimizeChronicles() const { return _optimizeChronicles; }
+
+    //! Rewrites the chronicles added from now on into equivalent cheaper ones
+    void setOptimizeChronicles(bool b) { _optimizeChronicles = b; }
+
+    //! Accessor, gives access to the cardinality model of the optimizer
+    ChronicleOptimizer& getOptimizer() { return _optimizer; }
+
+    //! Accessor
+    unsigned long getReplanPeriod() const { return _replanner.getPeriod(); }
+
+    //! Re-plans the chains of the chronicles added from now on every \a n events (0: never)
+    void setReplanPeriod(unsigned long n) { _replanner.setPeriod(n); }
+
+    //! Accessor, gives access to the statistics of the adaptive planning
+    ChronicleReplanner& getReplanner() { return _replanner; }
+
+    //! Delivers the new recognitions of the root chronicles by batches to \a f, in another thread (NULL: stops)
+    void setAsyncActions(ActionQueue::BatchFunction f, size_t capacity = 1024, size_t maxBatchSize = 64);
+
+    //! Accessor
+    bool hasAsyncActions() const { return (_actionQueue != NULL); }
+
+    //! Accessor, returns the asynchronous delivery queue (NULL if none)
+    ActionQueue* getActionQueue() { return _actionQueue; }
+
+    //! Waits until the new recognitions queued have been delivered
+    void flushActions();
+
+    //! Serialises the new recognitions of the root chronicles into \a sink, not owned (NULL: none)
+    void setRecognitionSink(RecognitionSink* sink) { _recognitionSink = sink; }
+
+    //! Accessor
+    RecognitionSink* getRecognitionSink() { return _recognitionSink; }
+
+    //! Allocates the recognitions and their properties in segments of \\a segmentSize bytes (0: heap)
+    void setRecoTreeArena(size_t segmentSize = 65536);
+
+    //! Accessor, returns the arena of the recognitions (NULL if none)
+    const RecoTreeArena* getRecoTreeArena() const { return _recoTreeArena; }
+
+    //! Accessor
+    bool getUseCompiledPlan() const { return _useCompiledPlan; }
+
+    //! Processes the events through a flat plan of the chronicles instead of recursive calls
+    void setUseCompiledPlan(bool b) { _useCompiledPlan = b; _planOutdated = true; }
+
+    //! Compiles the plan again before the next event (to be called when a chronicle tree is modified)
+    void invalidatePlan() { _planOutdated = true; }
 
     //! Accessor
     void setVerbosityLevel(VerbosityLevel v) { _verbosityLevel = v; }
@@ -186,6 +315,18 @@ namespace CRL {
     //! Accessor
     void setPurgeOldRecognitions(bool  purgeOldRecognitions) { _purgeOldRecognitions = purgeOldRecognitions; }
 
+    //! Accessor, returns the maximal number of recognitions in all the chronicles (-1: unbounded)
+    long getMaxTotalRecognitions() const { return _maxTotalRecognitions; }
+
+    //! Bounds the number of recognitions in all the chronicles (negative value: unbounded)
+    void setMaxTotalRecognitions(long maxTotal) { _maxTotalRecognitions = maxTotal; }
+
+    //! Accessor, returns the number of recognitions evicted to respect the total budget
+    unsigned long getEvictionCount() const { return _evictionCount; }
+
+    //! Returns the number of recognitions in all the chronicles
+    long getTotalRecognitions();
+
     //! Displays a list of events as a string
     static std::string eventListToString(const std::list<EventStored> &s);
 
@@ -204,6 +345,9 @@ namespace CRL {
 
   protected:
 
+    //! Processes a "pure date" event at \a date
+    void processDate(const DateType& date);
+
     //! Removes an event from the buffer
     void removeEvent(CRL::Event* e);
 
@@ -213,6 +357,21 @@ namespace CRL {
     //! Deletes too old recognitions
     void purgeOldRecognitions();
 
+    //! Evicts recognitions until the total budget is respected
+    void enforceTotalBudget();
+
+    //! Collects the chronicles of the tree of \a cr (each of them once)
+    static void collectChronicles(Chronicle* cr, std::vector<Chronicle*>& nodes);
+
+    //! Collects the factorised conjunctions among \a nodes, and their members (which keep all their recognitions)
+    static void collectFactorised(const std::vector<Chronicle*>& nodes, std::vector<Chronicle*>& factorised);
+
+    //! Replaces the sub-chronicles of \a parent by identical shared ones
+    void shareSubChronicles(Chronicle* parent);
+
+    //! Indicates whether a chronicle may be shared by several parents
+    static bool isShareable(Chronicle* cr);
+
   }; // class RecognitionEngine
 
   
@@ -0,0 +1,285 @@
+/** ***********************************************************************************
+ * \file RecognitionSink.h
+ * \author Ariane Piel & Jean Bourrely / Onera DCPS
+ * \date 2014
+ * \brief Compact binary records of the recognitions
+ **************************************************************************************/
+
+/*  Copyright (C) 2012, 2013, 2014  ONERA  http://www.onera.fr
+    This file is part of CRL : Chronicle Recognition Library.
+
+    CRL is free software: you can redistribute it and/or modify it under
+    the terms of the Lesser GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    CRL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    Lesser GNU General Public License for more details.
+
+    You should have received a copy of the Lesser GNU General Public License
+    along with CRL.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef RECOGNITION_SINK_H_
+#define RECOGNITION_SINK_H_
+
+// ----------------------------------------------------------------------------
+// INCLUDE FILES
+// ----------------------------------------------------------------------------
+
+#include <cstdio>
+#include <stdint.h>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "RecoTree.h"
+#include "RecoIndex.h"
+
+
+// ----------------------------------------------------------------------------
+// CLASS DESCRIPTION
+// ----------------------------------------------------------------------------
+
+namespace CRL {
+
+  class Chronicle;
+
+  //! Destination of the binary records of a RecognitionSink
+  class RecordWriter
+  {
+  public:
+
+    //! Virtual destructor
+    virtual ~RecordWriter() { }
+
+    //! Writes the header of the stream (once, before the first record)
+    virtual void writeHeader(const char* data, size_t size) { write(data, size); }
+
+    //! Writes one record, length prefix included
+    virtual void write(const char* data, size_t size) = 0;
+
+    //! Pushes the buffered records to their destination
+    virtual void flush() { }
+
+  }; // class RecordWriter
+
+
+  //! Buffered writer into a file
+  class FileRecordWriter : public RecordWriter
+  {
+  private:
+
+    //! Output file
+    std::FILE* _file;
+
+    //! Records not yet written into the file
+    std::vector<char> _buffer;
+
+    //! Size of #_buffer triggering a write
+    size_t _bufferSize;
+
+  public:
+
+    //! Constructor, opens (truncates) the file \a path
+    FileRecordWriter(const std::string& path, size_t bufferSize = 65536);
+
+    //! Destructor, flushes then closes the file
+    ~FileRecordWriter();
+
+    //! Implementation of pure virtual
+    void write(const char* data, size_t size);
+
+    //! Writes the buffer into the file
+    void flush();
+
+  private:
+
+    //! Copy forbidden
+    FileRecordWriter(const FileRecordWriter&);
+
+    //! Copy forbidden
+    FileRecordWriter& operator=(const FileRecordWriter&);
+
+  }; // class FileRecordWriter
+
+
+  //! Writer into a ring buffer of bounded size, the oldest records are dropped when full
+  class RingRecordWriter : public RecordWriter
+  {
+  private:
+
+    //! Header of the stream
+    std::string _header;
+
+    //! Bytes of the records, circular
+    std::vector<char> _ring;
+
+    //! Position of the oldest record in #_ring
+    size_t _head;
+
+    //! Number of bytes held
+    size_t _size;
+
+    //! Number of records dropped to respect the capacity
+    unsigned long _droppedCount;
+
+  public:
+
+    //! Constructor, \a capacity in bytes
+    RingRecordWriter(size_t capacity) : _ring(capacity), _head(0), _size(0), _droppedCount(0) { }
+
+    //! Keeps the header apart from the records
+    void writeHeader(const char* data, size_t size) { _header.assign(data, size); }
+
+    //! Implementation of pure virtual
+    void write(const char* data, size_t size);
+
+    //! Accessor
+    const std::string& getHeader() const { return _header; }
+
+    //! Removes the oldest record (length prefix included), returns false if empty
+    bool read(std::string& record);
+
+    //! Accessor, returns the number of bytes held
+    size_t size() const { return _size; }
+
+    //! Accessor
+    unsigned long getDroppedCount() const { return _droppedCount; }
+
+  private:
+
+    //! Removes the oldest record
+    void dropOldest();
+
+    //! Copies \a size bytes from position \a pos of the ring
+    void copyOut(size_t pos, char* data, size_t size) const;
+
+  }; // class RingRecordWriter
+
+
+  //! Serialises the new recognitions into length-prefixed binary records
+  class RecognitionSink
+  {
+  public:
+
+    //! Magic number at the beginning of the stream ("CRLR" when read in host order)
+    static const char MAGIC[4];
+
+    //! Version of the format
+    static const unsigned short VERSION = 1;
+
+    //! Decoded value of a selected property
+    struct Value
+    {
+      //! Type of the property (Property::NONE if missing)
+      int type;
+
+      //! Integral value (bool, char, wchar_t, int, long and their unsigned variants)
+      int64_t l;
+
+      //! Floating value (float, double)
+      double d;
+
+      //! String value
+      std::string str;
+
+      //! Extended string value
+      std::wstring wstr;
+    };
+
+    //! Decoded record
+    struct Record
+    {
+      //! Identifier of the chronicle (see #setChronicleId)
+      uint32_t chronicleId;
+
+      //! Dates of the recognition
+      DateType minDate, maxDate;
+
+      //! Orders of the recognition
+      int64_t minOrder, maxOrder;
+
+      //! Orders of the leaf events, from left to right
+      std::vector<int64_t> events;
+
+      //! Values of the selected properties, in the order of selection
+      std::vector<Value> properties;
+    };
+
+  private:
+
+    //! Destination of the records
+    RecordWriter& _writer;
+
+    //! Paths of the properties written in each record
+    RecoIndex::KeyPaths _selectedPaths;
+
+    //! Identifiers of the chronicles
+    std::map<const Chronicle*, uint32_t> _chronicleIds;
+
+    //! Next identifier given automatically
+    uint32_t _nextId;
+
+    //! Indicates whether the header has been written
+    bool _headerWritten;
+
+    //! Number of records written
+    unsigned long _recordCount;
+
+    //! Record being encoded (buffer reused from one record to the next)
+    std::string _record;
+
+  public:
+
+    //! Constructor, the writer must outlive the sink
+    RecognitionSink(RecordWriter& writer)
+      : _writer(writer), _nextId(0), _headerWritten(false), _recordCount(0) { }
+
+    //! Adds a property (path from the recognition) to the records, before the first one
+    void selectProperty(const RecoIndex::PropertyPath& path);
+
+    //! Adds a property of the recognition to the records, before the first one
+    void selectProperty(const std::string& name);
+
+    //! Sets the identifier of a chronicle in the records
+    void setChronicleId(const Chronicle* cr, uint32_t id);
+
+    //! Returns the identifier of a chronicle, gives a new one if needed
+    uint32_t getChronicleId(const Chronicle* cr);
+
+    //! Serialises a recognition
+    void write(const RecoTree& rc);
+
+    //! Pushes the buffered records to their destination
+    void flush() { _writer.flush(); }
+
+    //! Accessor
+    unsigned long getRecordCount() const { return _recordCount; }
+
+    //! Decodes a record (length prefix included), returns false if malformed
+    static bool decode(const std::string& data, Record& record);
+
+  private:
+
+    //! Writes the header, with the format and the selected properties
+    void writeHeader();
+
+    //! Appends the orders of the leaf events of a tree
+    void appendEvents(const RecoTree* rc, uint32_t& count);
+
+    //! Appends the value of a selected property
+    void appendProperty(const PropertyManager& pm, const RecoIndex::PropertyPath& path);
+
+    //! Appends a value, in host byte order
+    template <class T> void append(const T& x) {
+      _record.append(reinterpret_cast<const char*>(&x), sizeof(T));
+    }
+
+  }; // class RecognitionSink
+
+} /* namespace CRL */
+
+#endif /* RECOGNITION_SINK_H_ */
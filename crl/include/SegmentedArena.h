@@ -0,0 +1,143 @@
+/** ***********************************************************************************
+ * \file SegmentedArena.h
+ * \author Ariane Piel & Jean Bourrely / Onera DCPS
+ * \date 2014
+ * \brief Segmented memory arena, whose segments are found from the addresses
+ **************************************************************************************/
+
+/*  Copyright (C) 2012, 2013, 2014  ONERA  http://www.onera.fr
+    This file is part of CRL : Chronicle Recognition Library.
+
+    CRL is free software: you can redistribute it and/or modify it under
+    the terms of the Lesser GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    CRL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    Lesser GNU General Public License for more details.
+
+    You should have received a copy of the Lesser GNU General Public License
+    along with CRL.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef SEGMENTED_ARENA_H_
+#define SEGMENTED_ARENA_H_
+
+// ----------------------------------------------------------------------------
+// INCLUDE FILES
+// ----------------------------------------------------------------------------
+
+#include <cstddef>
+#include <stdint.h>
+#include <unordered_map>
+
+
+// ----------------------------------------------------------------------------
+// CLASS DESCRIPTION
+// ----------------------------------------------------------------------------
+
+namespace CRL {
+
+  class SegmentedArena
+  {
+  private:
+
+    //! Segment of memory, aligned on #GRANULE
+    struct Segment
+    {
+      SegmentedArena* arena;  //!< Owner of the segment
+      char* memory;           //!< Memory allocated on the heap
+      char* begin;            //!< First address of the segment, aligned on #GRANULE
+      size_t size;            //!< Number of bytes available
+      size_t used;            //!< Number of bytes allocated
+      size_t live;            //!< Number of allocations not yet deallocated
+    };
+
+    //! Segments of the thread, indexed by the addresses of their granules divided by #GRANULE
+    static thread_local std::unordered_map<uintptr_t, Segment*> _segments;
+
+    //! Size of the segments
+    size_t _segmentSize;
+
+    //! Segment of the next allocations
+    Segment* _current;
+
+    //! Empty segment kept for reuse (NULL: none)
+    Segment* _spare;
+
+    //! Number of segments in use (current one included)
+    size_t _segmentCount;
+
+    //! Number of segments freed since the creation of the arena
+    size_t _freedSegmentCount;
+
+    //! Number of allocations not yet deallocated
+    size_t _live;
+
+    //! Indicates whether the owner has released the arena
+    bool _closed;
+
+  public:
+
+    //! Alignment of the allocations
+    static const size_t ALIGNMENT = 16;
+
+    //! Alignment and size unit of the segments
+    static const size_t GRANULE = 4096;
+
+    //! Constructor, the size of the segments is rounded up to a multiple of #GRANULE
+    SegmentedArena(size_t segmentSize = 65536);
+
+    //! Allocates \a size bytes at the end of the current segment
+    void* allocate(size_t size);
+
+    //! Deallocates memory returned by #allocate, returns false if \a ptr is not in a segment of the thread
+    static bool deallocate(void* ptr);
+
+    //! Starts a new segment, so that the next allocations do not share the current one
+    void newSegment();
+
+    //! Releases the arena: it is deleted as soon as all its allocations are deallocated
+    void close();
+
+    //! Accessor
+    size_t getSegmentSize() const { return _segmentSize; }
+
+    //! Accessor
+    size_t getLiveCount() const { return _live; }
+
+    //! Accessor
+    size_t getSegmentCount() const { return _segmentCount; }
+
+    //! Accessor
+    size_t getFreedSegmentCount() const { return _freedSegmentCount; }
+
+  protected:
+
+    //! Destructor, frees the segments (protected: see #close)
+    virtual ~SegmentedArena();
+
+  private:
+
+    //! Allocates a segment of \a size bytes (reusing #_spare if possible)
+    Segment* createSegment(size_t size);
+
+    //! Frees an empty segment which is not #_current (or keeps it as #_spare)
+    void dropSegment(Segment* s);
+
+    //! Frees the memory of a segment and removes it from #_segments
+    static void freeSegment(Segment* s);
+
+    //! Copy forbidden
+    SegmentedArena(const SegmentedArena&);
+
+    //! Copy forbidden
+    SegmentedArena& operator=(const SegmentedArena&);
+
+  }; // class SegmentedArena
+
+} /* namespace CRL */
+
+#endif /* SEGMENTED_ARENA_H_ */
@@ -0,0 +1,435 @@
+/** ***********************************************************************************
+ * \file StaticChronicle.h
+ * \author Ariane Piel & Jean Bourrely / Onera DCPS
+ * \date 2014
+ * \brief Header-only front end: statically typed chronicle expressions
+ **************************************************************************************/
+
+/*  Copyright (C) 2012, 2013, 2014  ONERA  http://www.onera.fr
+    This file is part of CRL : Chronicle Recognition Library.
+
+    CRL is free software: you can redistribute it and/or modify it under
+    the terms of the Lesser GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    CRL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    Lesser GNU General Public License for more details.
+
+    You should have received a copy of the Lesser GNU General Public License
+    along with CRL.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef STATIC_CHRONICLE_H_
+#define STATIC_CHRONICLE_H_
+
+// ----------------------------------------------------------------------------
+// INCLUDE FILES
+// ----------------------------------------------------------------------------
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "Chronicle.h"
+#include "Event.h"
+#include "RecoTree.h"
+#include "RecognitionEngine.h"
+
+// ----------------------------------------------------------------------------
+// CLASS DESCRIPTION
+// ----------------------------------------------------------------------------
+
+// Static front end: the expression built by the operators below is a type
+// (e.g. SequenceExpr<EventExpr, ConjunctionExpr<EventExpr, EventExpr> >) whose
+// nodes are held by value, so that the whole recognition logic of a chronicle
+// is inlined in StaticChronicle<E>::process, without virtual call.
+// Only the dates and the orders of the recognitions are kept: the operators
+// handle neither properties, nor predicates, nor output functions.
+
+namespace CRL {
+
+  class RecognitionEngine;
+
+  namespace Static {
+
+    //! Dates and orders of a recognition of a static expression
+    struct Span
+    {
+      long minOrder;
+      long maxOrder;
+      DateType minDate;
+      DateType maxDate;
+    };
+
+    //! Data type : recognitions of a node of an expression, the new ones last
+    typedef std::vector<Span> SpanSet;
+
+    //! Returns the span covering \a l and \a r (see RecoTree::copyDateAndOrder)
+    inline Span join(const Span& l, const Span& r)
+    {
+      Span s;
+      s.minOrder = (l.minOrder > r.minOrder ? r.minOrder : l.minOrder);
+      s.maxOrder = (l.maxOrder > r.maxOrder ? l.maxOrder : r.maxOrder);
+      s.minDate  = (l.minDate > r.minDate ? r.minDate : l.minDate);
+      s.maxDate  = (l.maxDate > r.maxDate ? l.maxDate : r.maxDate);
+      return s;
+    }
+
+
+    //! Base of the expressions (curiously recurring template)
+    template <class Derived>
+    class Expr
+    {
+    public:
+      //! Returns the expression with its actual type
+      const Derived& self() const { return static_cast<const Derived&>(*this); }
+    };
+
+
+    //! Recognition set of a node of an expression
+    template <class Derived>
+    class Node : public Expr<Derived>
+    {
+    protected:
+
+      //! Recognitions of the node, the new ones (of the current event) last
+      SpanSet _all;
+
+      //! Number of new recognitions (at the end of #_all)
+      size_t _nbNew;
+
+      //! Starts the processing of a new event
+      void beginEvent() { _nbNew = 0; }
+
+      //! Adds a new recognition
+      void add(const Span& s) { _all.push_back(s); _nbNew++; }
+
+      //! Deletes the recognitions ending before \a limit; the new ones are forgotten
+      void purgeNode(const DateType& limit)
+      {
+        size_t j = 0;
+        for (size_t i=0; i<_all.size(); i++)
+          if ( !(_all[i].maxDate < limit) )
+            _all[j++] = _all[i];
+        _all.resize(j);
+        _nbNew = 0;
+      }
+
+    public:
+
+      //! Constructor
+      Node() : _nbNew(0) { }
+
+      //! Accessor
+      const SpanSet& all() const { return _all; }
+
+      //! Returns the index in #all of the first new recognition
+      size_t firstNew() const { return _all.size() - _nbNew; }
+
+      //! Accessor
+      size_t getNbNew() const { return _nbNew; }
+    };
+
+
+    //! Single event : recognises the events named after the code
+    class EventExpr : public Node<EventExpr>
+    {
+    private:
+
+      //! String which has to correspond to event names
+      std::string _code;
+
+    public:
+
+      //! Constructor
+      explicit EventExpr(const std::string& code) : _code(code) { }
+
+      //! Main event processing function (see ChronicleSingleEvent::process)
+      void process(const DateType& d, const Event* e)
+      {
+        beginEvent();
+        if ( (e != NULL) && (e->getName() == _code) && (e->getDate() <= d) )
+        {
+          Span s = { e->getOrder(), e->getOrder(), e->getDate(), e->getDate() };
+          add(s);
+        }
+      }
+
+      //! Deletes the recognitions ending before \a limit
+      void purge(const DateType& limit) { purgeNode(limit); }
+
+      //! Display function
+      std::string toString() const { return _code; }
+    };
+
+
+    //! Common part of the binary operators
+    template <class Derived, class L, class R>
+    class BinaryExpr : public Node<Derived>
+    {
+    protected:
+
+      //! Left operand
+      L _left;
+
+      //! Right operand
+      R _right;
+
+      //! Processes both operands
+      void processOperands(const DateType& d, const Event* e)
+      {
+        this->beginEvent();
+        _left.process(d, e);
+        _right.process(d, e);
+      }
+
+    public:
+
+      //! Constructor, the operands are copied
+      BinaryExpr(const L& l, const R& r) : _left(l), _right(r) { }
+
+      //! Deletes the recognitions ending before \a limit
+      void purge(const DateType& limit)
+      {
+        this->purgeNode(limit);
+        _left.purge(limit);
+        _right.purge(limit);
+      }
+
+      //! Display function
+      std::string toString(const std::string& op) const
+      {
+        return "(" + _left.toString() + op + _right.toString() + ")";
+      }
+    };
+
+
+    //! Sequence (L R) : a new recognition of R after a recognition of L
+    template <class L, class R>
+    class SequenceExpr : public BinaryExpr<SequenceExpr<L, R>, L, R>
+    {
+    public:
+
+      //! Constructor
+      SequenceExpr(const L& l, const R& r) : BinaryExpr<SequenceExpr<L, R>, L, R>(l, r) { }
+
+      //! Main event processing function (see ChronicleSequence::process)
+      void process(const DateType& d, const Event* e)
+      {
+        this->processOperands(d, e);
+        const SpanSet& ls = this->_left.all();
+        const SpanSet& rs = this->_right.all();
+        for (size_t j=this->_right.firstNew(); j<rs.size(); j++)
+          for (size_t i=0; i<ls.size(); i++)
+            if (ls[i].maxOrder < rs[j].minOrder)
+              this->add(join(ls[i], rs[j]));
+      }
+
+      //! Display function
+      std::string toString() const { return BinaryExpr<SequenceExpr<L, R>, L, R>::toString(" "); }
+    };
+
+
+    //! Conjunction (L && R) : a new recognition of one operand with any of the other
+    template <class L, class R>
+    class ConjunctionExpr : public BinaryExpr<ConjunctionExpr<L, R>, L, R>
+    {
+    public:
+
+      //! Constructor
+      ConjunctionExpr(const L& l, const R& r) : BinaryExpr<ConjunctionExpr<L, R>, L, R>(l, r) { }
+
+      //! Main event processing function (see ChronicleConjunction::process)
+      void process(const DateType& d, const Event* e)
+      {
+        this->processOperands(d, e);
+        const SpanSet& ls = this->_left.all();
+        const SpanSet& rs = this->_right.all();
+        size_t firstNewLeft = this->_left.firstNew();
+        for (size_t i=firstNewLeft; i<ls.size(); i++)
+          for (size_t j=0; j<rs.size(); j++)
+            this->add(join(ls[i], rs[j]));
+        // The couples of two new recognitions have already been built
+        for (size_t j=this->_right.firstNew(); j<rs.size(); j++)
+          for (size_t i=0; i<firstNewLeft; i++)
+            this->add(join(ls[i], rs[j]));
+      }
+
+      //! Display function
+      std::string toString() const { return BinaryExpr<ConjunctionExpr<L, R>, L, R>::toString("&"); }
+    };
+
+
+    //! Disjunction (L || R) : the new recognitions of both operands
+    template <class L, class R>
+    class DisjunctionExpr : public BinaryExpr<DisjunctionExpr<L, R>, L, R>
+    {
+    public:
+
+      //! Constructor
+      DisjunctionExpr(const L& l, const R& r) : BinaryExpr<DisjunctionExpr<L, R>, L, R>(l, r) { }
+
+      //! Main event processing function (see ChronicleDisjunction::process)
+      void process(const DateType& d, const Event* e)
+      {
+        this->processOperands(d, e);
+        const SpanSet& ls = this->_left.all();
+        const SpanSet& rs = this->_right.all();
+        for (size_t i=this->_left.firstNew(); i<ls.size(); i++)
+          this->add(ls[i]);
+        for (size_t j=this->_right.firstNew(); j<rs.size(); j++)
+          this->add(rs[j]);
+      }
+
+      //! Display function
+      std::string toString() const { return BinaryExpr<DisjunctionExpr<L, R>, L, R>::toString("||"); }
+    };
+
+
+    //! Absence (L - R) : a new recognition of L containing no recognition of R
+    template <class L, class R>
+    class AbsenceExpr : public BinaryExpr<AbsenceExpr<L, R>, L, R>
+    {
+    public:
+
+      //! Constructor
+      AbsenceExpr(const L& l, const R& r) : BinaryExpr<AbsenceExpr<L, R>, L, R>(l, r) { }
+
+      //! Main event processing function (see ChronicleAbsence::process, default bounds [min, max[)
+      void process(const DateType& d, const Event* e)
+      {
+        this->processOperands(d, e);
+        const SpanSet& ls = this->_left.all();
+        const SpanSet& rs = this->_right.all();
+        for (size_t i=this->_left.firstNew(); i<ls.size(); i++)
+        {
+          bool found = false;
+          for (size_t j=0; (j<rs.size()) && !found; j++)
+            found = (ls[i].minOrder <= rs[j].minOrder) && (rs[j].maxOrder < ls[i].maxOrder);
+          if (!found)
+            this->add(ls[i]);
+        }
+      }
+
+      //! Display function
+      std::string toString() const { return BinaryExpr<AbsenceExpr<L, R>, L, R>::toString("-"); }
+    };
+
+
+    //! Operator sequence
+    template <class L, class R>
+    inline SequenceExpr<L, R> operator+(const Expr<L>& l, const Expr<R>& r)
+    {
+      return SequenceExpr<L, R>(l.self(), r.self());
+    }
+
+    //! Operator conjunction
+    template <class L, class R>
+    inline ConjunctionExpr<L, R> operator&&(const Expr<L>& l, const Expr<R>& r)
+    {
+      return ConjunctionExpr<L, R>(l.self(), r.self());
+    }
+
+    //! Operator disjunction
+    template <class L, class R>
+    inline DisjunctionExpr<L, R> operator||(const Expr<L>& l, const Expr<R>& r)
+    {
+      return DisjunctionExpr<L, R>(l.self(), r.self());
+    }
+
+    //! Operator absence
+    template <class L, class R>
+    inline AbsenceExpr<L, R> operator-(const Expr<L>& l, const Expr<R>& r)
+    {
+      return AbsenceExpr<L, R>(l.self(), r.self());
+    }
+
+
+    //! Chronicle recognising a static expression, pluggable in a RecognitionEngine
+    template <class E>
+    class StaticChronicle : public CRL::Chronicle
+    {
+    protected:
+
+      //! Expression recognised, held by value
+      E _expr;
+
+      //! Destructor protected (to prevent stack allocation)
+      ~StaticChronicle() { /* empty */ }
+
+    public:
+
+      //! Constructor, the expression is copied
+      explicit StaticChronicle(const E& expr) : _expr(expr) { }
+
+      //! Accessor, links to the recognition engine
+      void setMyEngine(RecognitionEngine* e) { _myEngine = e; }
+
+      //! Display function for unit tests
+      std::string toString() const
+      {
+        if (_name != "")
+          return _name;
+        return _expr.toString();
+      }
+
+      //! Main event processing function, a recognition tree without member (dates and orders only) is built per new span
+      bool process(const DateType& d, CRL::Event* e = NULL)
+      {
+        if (_alreadyProcessed)
+          return _hasNewRecognitions;
+
+        _expr.process(d, e);
+        const SpanSet& spans = _expr.all();
+        for (size_t i=_expr.firstNew(); i<spans.size(); i++)
+          applyActionFunction(new RecoTree(spans[i].minOrder, spans[i].maxOrder, spans[i].minDate, spans[i].maxDate));
+
+        _alreadyProcessed = true;
+        return _hasNewRecognitions;
+      }
+
+      //! Deletes the obsolete recognitions, in the chronicle and in the expression
+      void purgeOldRecognitions()
+      {
+        Chronicle::purgeOldRecognitions();
+        if ( (_peremptionDuration >= 0.0) && (_myEngine != NULL) )
+          _expr.purge(_myEngine->getCurrentTime() - _peremptionDuration);
+      }
+
+      //! Returns the date in the future at which the recognitions set of the chronicle must be re-assessed
+      DateType lookAhead(const DateType&) const { return INFTY_DATE; }
+
+      //! Implementation of pure virtual
+      Chronicle* getChild1() { return NULL; }
+
+      //! Implementation of pure virtual
+      Chronicle* getChild2() { return NULL; }
+
+      //! Returns a string identifying the structure and the settings of the chronicle
+      std::string structuralSignature() const
+      {
+        return Chronicle::structuralSignature() + "[" + _expr.toString() + "]";
+      }
+    };
+
+
+    //! Returns a (heap allocated) chronicle recognising \a expr
+    template <class E>
+    inline StaticChronicle<E>& makeChronicle(const Expr<E>& expr)
+    {
+      return *(new StaticChronicle<E>(expr.self()));
+    }
+
+  } /* namespace Static */
+
+} /* namespace CRL */
+
+
+//! Macro : static single event
+#define $S(s) (CRL::Static::EventExpr(#s))
+
+#endif /* STATIC_CHRONICLE_H_ */
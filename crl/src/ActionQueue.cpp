@@ -0,0 +1,185 @@
+/** ***********************************************************************************
+ * \file ActionQueue.cpp
+ * \author Ariane Piel & Jean Bourrely / Onera DCPS
+ * \date 2014
+ * \brief Asynchronous delivery of the new recognitions by batches
+ **************************************************************************************/
+
+/*  Copyright (C) 2012, 2013, 2014  ONERA  http://www.onera.fr
+    This file is part of CRL : Chronicle Recognition Library.
+
+    CRL is free software: you can redistribute it and/or modify it under
+    the terms of the Lesser GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    CRL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    Lesser GNU General Public License for more details.
+
+    You should have received a copy of the Lesser GNU General Public License
+    along with CRL.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// ----------------------------------------------------------------------------
+// INCLUDE FILES
+// ----------------------------------------------------------------------------
+
+#include <chrono>
+
+#include "ActionQueue.h"
+
+
+// ----------------------------------------------------------------------------
+// CLASS METHODS
+// ----------------------------------------------------------------------------
+
+namespace CRL 
+{
+
+  /** \param[in] rc recognition
+  *   \return false if the ring is full
+  */
+  bool ActionQueue::Ring::push(RecoTree* rc)
+  {
+    size_t tail = _tail.load(std::memory_order_relaxed);
+    size_t next = (tail + 1) % _slots.size();
+    if (next == _head.load(std::memory_order_acquire))
+      return false;
+    _slots[tail] = rc;
+    _tail.store(next, std::memory_order_release);
+    return true;
+  }
+
+
+  /** \param[out] rc recognition
+  *   \return false if the ring is empty
+  */
+  bool ActionQueue::Ring::pop(RecoTree*& rc)
+  {
+    size_t head = _head.load(std::memory_order_relaxed);
+    if (head == _tail.load(std::memory_order_acquire))
+      return false;
+    rc = _slots[head];
+    _head.store((head + 1) % _slots.size(), std::memory_order_release);
+    return true;
+  }
+
+
+  /** \param[in] f user function called with each batch, by the consumer thread
+  *   \param[in] capacity maximal number of recognitions waiting for delivery
+  *   \param[in] maxBatchSize maximal number of recognitions per batch
+  */
+  ActionQueue::ActionQueue(BatchFunction f, size_t capacity, size_t maxBatchSize)
+    : _batchFunction(f), _maxBatchSize((maxBatchSize > 0) ? maxBatchSize : 1),
+      _outbound((capacity > 0) ? capacity : 1), _delivered((capacity > 0) ? capacity : 1),
+      _pushedCount(0), _deliveredCount(0), _batchCount(0),
+      _stopping(false), _finished(false), _sleeping(false)
+  {
+    if (_batchFunction == NULL)
+      throw("ActionQueue : no batch function");
+    _consumer = std::thread(&ActionQueue::run, this);
+  }
+
+
+  /** The recognitions still queued are delivered before the consumer thread stops.
+  */
+  ActionQueue::~ActionQueue()
+  {
+    _stopping = true;
+    _wakeUp.notify_one();
+    while (!_finished)
+    {
+      collect();
+      std::this_thread::yield();
+    }
+    _consumer.join();
+    collect();
+  }
+
+
+  /** The recognition is held until the engine collects it back, once
+  *   delivered: the tree remains valid during the call of the user function.
+  *   When the queue is full, the engine waits for the consumer thread.
+  *   \param[in] rc new recognition
+  */
+  void ActionQueue::push(RecoTree* rc)
+  {
+    rc->addRef();
+    _pushedCount++;
+    while (!_outbound.push(rc))
+    {
+      collect();
+      std::this_thread::yield();
+    }
+    if (_sleeping)
+      _wakeUp.notify_one();
+  }
+
+
+  /** The trees are released by the engine thread only, so that their
+  *   reference counts and their destruction are never concurrent.
+  */
+  void ActionQueue::collect()
+  {
+    RecoTree* rc;
+    while (_delivered.pop(rc))
+      rc->release();
+  }
+
+
+  /** Used before reading the state of the user function, or before
+  *   destroying the chronicles which recognitions may still be queued.
+  */
+  void ActionQueue::flush()
+  {
+    while (_deliveredCount < _pushedCount)
+    {
+      collect();
+      std::this_thread::yield();
+    }
+    collect();
+  }
+
+
+  /** Drains the queue by batches, and sleeps when it is empty. The waiting
+  *   is bounded so that a notification sent before the sleep is never lost
+  *   for long.
+  */
+  void ActionQueue::run()
+  {
+    std::vector<RecoTree*> batch;
+    batch.reserve(_maxBatchSize);
+    RecoTree* rc;
+
+    while (true)
+    {
+      while ( (batch.size() < _maxBatchSize) && _outbound.pop(rc) )
+        batch.push_back(rc);
+
+      if (!batch.empty())
+      {
+        (*_batchFunction)(batch);
+        _batchCount++;
+        for (size_t i = 0; i < batch.size(); i++)
+          while (!_delivered.push(batch[i]))
+            std::this_thread::yield();
+        _deliveredCount += batch.size();
+        batch.clear();
+        continue;
+      }
+
+      if (_stopping)
+        break;
+
+      std::unique_lock<std::mutex> lock(_mutex);
+      _sleeping = true;
+      if (_outbound.empty() && !_stopping)
+        _wakeUp.wait_for(lock, std::chrono::milliseconds(1));
+      _sleeping = false;
+    }
+    _finished = true;
+  }
+
+} /* namespace CRL */
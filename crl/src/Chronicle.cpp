@@ -31,6 +31,9 @@
 #include <limits>
 #include <algorithm>
 #include <sstream>
+#include <typeinfo>
+#include <cstdlib>
+#include <new>
 
 
 // --------------------------------------------------------------------
@@ -73,20 +76,64 @@
 namespace CRL 
 {
 
-  /** Destructor, deletes the recognition sets. The destructor is declared 
+  //! Definition of the class variable
+  ChronicleArena* Chronicle::_allocationArena = NULL;
+
+
+  /** Without an arena, the allocation is a plain heap allocation.
+  *   \param[in] size size of the object
+  *   \return address of the object
+  */
+  void* Chronicle::operator new(size_t size)
+  {
+    if (_allocationArena != NULL)
+      return _allocationArena->allocate(size);
+    return ::operator new(size);
+  }
+
+
+  /** The arena of the object, if any, is found from its address, so that
+  *   the deallocation is possible whatever the arena current at that time.
+  *   \param[in] ptr address returned by #operator new
+  */
+  void Chronicle::operator delete(void* ptr)
+  {
+    if ( (ptr != NULL) && !SegmentedArena::deallocate(ptr) )
+      ::operator delete(ptr);
+  }
+
+
+  /** \param[in] arena arena of the next allocations (NULL: heap)
+  *   \return previous arena
+  */
+  ChronicleArena* Chronicle::setAllocationArena(ChronicleArena* arena)
+  {
+    ChronicleArena* previous = _allocationArena;
+    _allocationArena = arena;
+    return previous;
+  }
+
+  /** Destructor, releases the recognitions of the sets (they are deleted
+  *   unless held by a recognition of another chronicle). The destructor is declared 
   *   protected to prevent allocation of instance on the stack (allowing
   *   only allocation on the heap).
   */
   Chronicle::~Chronicle()
   {
-    std::set<RecoTree*>::iterator it;
+    Chronicle::RecoSet::iterator it;
     for(it=_newRecognitions.begin(); it!=_newRecognitions.end(); it++)
     {
       if (_recognitionSet.find(*it) == _recognitionSet.end())
-       delete (*it);
+       (*it)->release();
     }
     for(it=_recognitionSet.begin(); it!=_recognitionSet.end(); it++)
-      delete (*it);
+      (*it)->release();
+
+    std::list<RecoIndex*>::iterator itI;
+    for(itI=_indexes.begin(); itI!=_indexes.end(); itI++)
+      delete (*itI);
+    delete _columns;
+    delete _budget;
   }
 
   /** Displays the chronicle as a string: the definition 
@@ -98,6 +145,12 @@ namespace CRL
   {
     std::ostringstream os;
     os << "Chronicle       : " << this->toString() << std::endl;
+    if (_countOnly)
+    {
+      os << "                  Reco Count = " << _count
+         << " (+" << _newCount << ")" << std::endl;
+      return os.str();
+    }
     Chronicle::RecoSet::const_iterator it;
     os << "                  Reco Set = { ";
     for (it=_recognitionSet.begin();it!=_recognitionSet.end();it++)
@@ -119,35 +172,105 @@ namespace CRL
     // Resets the flag which avoids double processing
     _alreadyProcessed = false;
     _hasNewRecognitions = false;
+
+    // The positions of the recognitions erased during the event are reclaimed
+    if ( _recognitionSet.compact() && (_columns != NULL) )
+      _columns->compact();
     
     if (!daughtersOnly)
+    {
+      Chronicle::RecoSet::iterator it;
+      for (it=_newRecognitions.begin();it!=_newRecognitions.end();it++)
+        if (_recognitionSet.find(*it) == _recognitionSet.end())
+          (*it)->release();
       _newRecognitions.clear();
+    }
+  }
+
+
+  /** Used by the parent chronicles consuming the recognitions of their
+  *   sub-chronicles (ex: chronicle THEN).
+  *   \param[in] it position of the recognition in the new recognition set
+  *   \return position following the erased recognition
+  */
+  Chronicle::RecoSet::iterator Chronicle::eraseNewRecognition(Chronicle::RecoSet::iterator it)
+  {
+    RecoTree* rc = *it;
+    Chronicle::RecoSet::iterator itNext = _newRecognitions.erase(it);
+    releaseIfUnheld(rc);
+    return itNext;
+  }
+
+
+  /** The chronicle holds one reference on each recognition belonging to
+  *   at least one of its sets.
+  *   \param[in] rc recognition which has just left one of the sets
+  */
+  void Chronicle::releaseIfUnheld(RecoTree* rc)
+  {
+    if ( (_recognitionSet.find(rc) == _recognitionSet.end()) &&
+         (_newRecognitions.find(rc) == _newRecognitions.end()) )
+      rc->release();
+  }
+
+
+  /** Sets the peremption duration. The recognition set is then also stored
+  *   in the order of the maximal dates, so that the purge of old recognitions 
+  *   only visits the expired ones.
+  *   The sub-chronicles of a tree rewritten by the optimizer are not those
+  *   of the tree built by the user: a peremption duration would purge other
+  *   recognitions, and is refused, except the retention horizon of the 
+  *   chronicle (see RecognitionEngine::activateAutoForget), which does not 
+  *   change the recognitions of the roots.
+  *   \param[in] duration peremption duration (negative value: no peremption)
+  *   \param[in] recursive unused at this level
+  */
+  void Chronicle::setPeremptionDuration(DurationType duration, bool recursive)
+  {
+    if ( _rewritten && (duration >= 0.0) && (duration != _retentionHorizon) )
+      throw("Chronicle : peremption duration on a chronicle rewritten by the optimizer " + toString());
+
+    bool wasActive = (_peremptionDuration >= 0.0);
+    _peremptionDuration = duration;
+
+    if (_peremptionDuration < 0.0)
+      _expiryQueue.clear();
+    else if (!wasActive)
+    {
+      Chronicle::RecoSet::iterator it;
+      for (it=_recognitionSet.begin();it!=_recognitionSet.end();it++)
+        _expiryQueue.insert(std::make_pair((*it)->getMaxDate(), *it));
+    }
   }
 
 
   /** Deletes recognitions which are considered
    *  obsolete: the recognitions which have been created
    *  since more than _peremptionDuration.
+   *  The expired recognitions are popped from the front of the expiry queue:
+   *  the cost is proportional to the number of recognitions deleted.
    */
   void Chronicle::purgeOldRecognitions() 
   {
     if ( _peremptionDuration >= 0.0 )
     {
-      Chronicle::RecoSet::iterator itTmp, it=_recognitionSet.begin();
+      Chronicle::RecoSet::iterator itTmp;
 
       DateType limitDate = _myEngine->getCurrentTime() - _peremptionDuration;
-      while (it!=_recognitionSet.end())
+      Chronicle::ExpiryQueue::iterator itE = _expiryQueue.begin();
+      while ( (itE != _expiryQueue.end()) && (itE->first < limitDate) )
       {
-        if ((*it)->getMaxDate() < limitDate)
-        {
-          itTmp=it;
-          itTmp++;
-          _recognitionSet.erase(it);
-          it=itTmp;
-        }
-        else ++it;
+        unindexRecognition(itE->second, _recognitionSet.find(itE->second).getPosition());
+        if (_budget != NULL)
+          _budget->erase(itE->second);
+        _recognitionSet.erase(itE->second);
+        releaseIfUnheld(itE->second);
+        ++itE;
       }
+      _expiryQueue.erase(_expiryQueue.begin(), itE);
+
       // Usefull when recursively inside a ''then''
+      // (the set is empty between two events, except inside a ''then'')
       Chronicle::RecoSet::iterator itNew=_newRecognitions.begin();
       while (itNew!=_newRecognitions.end())
       {
@@ -155,7 +278,9 @@ namespace CRL
         {
           itTmp=itNew;
           itTmp++;
+          RecoTree* rc = *itNew;
           _newRecognitions.erase(itNew);
+          releaseIfUnheld(rc);
           itNew=itTmp;
         }
         else ++itNew;
@@ -175,16 +300,308 @@ namespace CRL
   {
     if (_purgeable)
     {
-      // The set of pointers may be emptied, but the destructors may not be called
-      // since the objects are maybe used in a recognition set
-      // above.
+      // The set of pointers may be emptied, the objects are only released
+      // since they are maybe used in a recognition set above.
+      Chronicle::RecoSet::iterator it;
+      for (it=_recognitionSet.begin();it!=_recognitionSet.end();it++)
+        if (_newRecognitions.find(*it) == _newRecognitions.end())
+          (*it)->release();
       _recognitionSet.clear();
+      _expiryQueue.clear();
+      if (_budget != NULL)
+        _budget->clear();
+
+      std::list<RecoIndex*>::iterator itI;
+      for(itI=_indexes.begin(); itI!=_indexes.end(); itI++)
+        (*itI)->clear();
+      if (_columns != NULL)
+        _columns->clear();
     }
   }
 
 
+  /** Equi-joins of the parent chronicles look up the recognitions having a
+  *   given key instead of scanning the whole recognition set. Indexes with the
+  *   same key paths are shared.
+  *   \param[in] paths paths of the properties making up the key
+  *   \return index, maintained along with the recognition set
+  */
+  RecoIndex* Chronicle::requestIndex(const RecoIndex::KeyPaths& paths)
+  {
+    std::list<RecoIndex*>::iterator itI;
+    for(itI=_indexes.begin(); itI!=_indexes.end(); itI++)
+      if ((*itI)->getPaths() == paths)
+      {
+        (*itI)->acquire();
+        return (*itI);
+      }
+
+    RecoIndex* index = new RecoIndex(paths);
+    Chronicle::RecoSet::iterator it;
+    for (it=_recognitionSet.begin();it!=_recognitionSet.end();it++)
+      index->insert(*it);
+    index->acquire();
+    _indexes.push_back(index);
+    return index;
+  }
+
+
+  /** The index is deleted when its last user releases it.
+  *   \param[in] index index to be released (ignored if NULL)
+  */
+  void Chronicle::releaseIndex(RecoIndex* index)
+  {
+    if ( (index == NULL) || (index->release() > 0) ) return;
+    _indexes.remove(index);
+    delete index;
+  }
+
+
+  /** The joins of the parent chronicles filter the orders of the candidates
+  *   over these columns instead of visiting the recognitions one by one.
+  *   Once requested, the columns are maintained along with the recognition set.
+  *   \return columns of the recognition set
+  */
+  const RecoColumns& Chronicle::getColumns()
+  {
+    if (_columns == NULL)
+    {
+      _columns = new RecoColumns();
+      Chronicle::RecoSet::iterator it;
+      for (it=_recognitionSet.begin();it!=_recognitionSet.end();it++)
+        _columns->insert(it.getPosition(), *it);
+    }
+    return *_columns;
+  }
+
+
+  /** Once the budget is reached, each new recognition causes the eviction
+  *   of a recognition chosen by the policy (it may be the new recognition itself,
+  *   which is nevertheless transmitted to the parent chronicles as a new recognition).
+  *   Evicted recognitions are no longer combined with future recognitions.
+  *   \param[in] maxRecognitions maximal size of the recognition set (negative value: unbounded)
+  *   \param[in] policy eviction policy
+  */
+  void Chronicle::setRecognitionBudget(long maxRecognitions, RecoBudget::Policy policy)
+  {
+    delete _budget;
+    _budget = NULL;
+    if (maxRecognitions < 0) return;
+
+    _budget = new RecoBudget((size_t)maxRecognitions, policy);
+    Chronicle::RecoSet::iterator it;
+    std::vector<RecoTree*> victims;
+    for (it=_recognitionSet.begin();it!=_recognitionSet.end();it++)
+    {
+      RecoTree* victim = _budget->admit(*it);
+      if (victim != NULL)
+        victims.push_back(victim);
+    }
+    for (size_t i=0; i<victims.size(); i++)
+    {
+      removeRecognition(victims[i]);
+      _evictionCount++;
+    }
+  }
+
+
+  /** The victim is chosen by the policy of the budget, or is the recognition
+  *   of oldest maximal date if the set has no budget.
+  *   \return false if the recognition set is empty
+  */
+  bool Chronicle::evictRecognition()
+  {
+    RecoTree* victim = NULL;
+    if (_budget != NULL)
+      victim = _budget->evict();
+    if ( (victim == NULL) && (!_expiryQueue.empty()) )
+      victim = _expiryQueue.begin()->second;
+    if (victim == NULL)
+    {
+      Chronicle::RecoSet::iterator it;
+      for (it=_recognitionSet.begin();it!=_recognitionSet.end();it++)
+        if ( (victim == NULL) || ((*it)->getMaxDate() < victim->getMaxDate()) )
+          victim = *it;
+    }
+    if (victim == NULL)
+      return false;
+
+    removeRecognition(victim);
+    _evictionCount++;
+    return true;
+  }
+
+
+  /** No action is applied: the recognition is not a new one, it is moved from
+  *   chronicles replaced by this one.
+  *   \param[in] rc recognition
+  */
+  void Chronicle::adoptRecognition(RecoTree* rc)
+  {
+    std::pair<Chronicle::RecoSet::iterator, bool> inserted = _recognitionSet.insert(rc);
+    if (!inserted.second) return;
+
+    if (_newRecognitions.find(rc) == _newRecognitions.end())
+      rc->addRef();
+    std::list<RecoIndex*>::iterator itI;
+    for(itI=_indexes.begin(); itI!=_indexes.end(); itI++)
+      (*itI)->insert(rc);
+    if (_columns != NULL)
+      _columns->insert(inserted.first.getPosition(), rc);
+    if (_peremptionDuration >= 0.0)
+      _expiryQueue.insert(std::make_pair(rc->getMaxDate(), rc));
+    rc->setMyChronicle(this);
+
+    if (_budget != NULL)
+    {
+      RecoTree* victim = _budget->admit(rc);
+      if (victim != NULL)
+      {
+        removeRecognition(victim);
+        _evictionCount++;
+      }
+    }
+  }
+
+
+  /** A chronicle used by several parents keeps its recognitions as long as
+  *   the most demanding of them needs it.
+  *   \param[in] horizon retention horizon required by a parent
+  */
+  void Chronicle::mergeRetentionHorizon(DurationType horizon)
+  {
+    if ( (horizon < 0.0) || (_retentionHorizon < 0.0) )
+      _retentionHorizon = -1.0;
+    else if (horizon > _retentionHorizon)
+      _retentionHorizon = horizon;
+  }
+
+
+  /** \param[in] window window (negative value: unbounded)
+  *   \param[in] bound upper bound of the window
+  *   \return smallest of the two
+  */
+  DurationType Chronicle::narrowWindow(DurationType window, DurationType bound)
+  {
+    return ( (window < 0.0) || (bound < window) ) ? bound : window;
+  }
+
+
+  /** Two chronicle trees having the same signature recognise the same
+  *   recognitions, so that one of them may be used in place of the other.
+  *   At this level: exact class, name, user functions and settings.
+  *   \return signature
+  */
+  std::string Chronicle::structuralSignature() const
+  {
+    std::ostringstream os;
+    os.precision(17);
+    os << typeid(*this).name() << "{" << _name
+       << "|" << reinterpret_cast<size_t>(_predicateFunction)
+       << "|" << reinterpret_cast<size_t>(_outputFunction)
+       << "|" << reinterpret_cast<size_t>(_actionFunction)
+       << "|" << _hasOutputPropertiesMethod
+       << "|" << _peremptionDuration
+       << "|" << getRecognitionBudget()
+       << "|" << _countOnly;
+    if (_budget != NULL)
+      os << "/" << _budget->getPolicy();
+    os << "}";
+    return os.str();
+  }
+
+
+  /** In count-only mode, the operators of the chronicle tree propagate the
+  *   number of their recognitions instead of building them: memory stays
+  *   constant and each node costs O(1) per event. Only the chronicle trees
+  *   made of operators supporting it (see #supportsCountOnly), without any
+  *   user function, peremption, budget nor shared sub-chronicle qualify.
+  *   Beware that a predicate method overloaded by a subclass is ignored.
+  *   Must be set before the first event; the recognition sets stay empty.
+  *   If a node of the tree does not qualify, the whole tree is left unchanged.
+  *   \param[in] b true to only count, false to build the recognitions again
+  */
+  void Chronicle::setCountOnly(bool b)
+  {
+    if (b)
+    {
+      if ( !supportsCountOnly() || hasPredicateFunction() || hasOutputFunction() ||
+           hasActionFunction() || _hasOutputPropertiesMethod || (_peremptionDuration >= 0.0) ||
+           (_budget != NULL) || (_shareCount > 0) ||
+           !_recognitionSet.empty() || !_newRecognitions.empty() )
+        throw("Chronicle : count-only mode not supported by " + toString());
+    }
+    _countOnly = b;
+    _newCount  = 0.0;
+    _count     = 0.0;
+    try
+    {
+      if (getChild1() != NULL) getChild1()->setCountOnly(b);
+      if (getChild2() != NULL) getChild2()->setCountOnly(b);
+    }
+    catch (std::string&)
+    {
+      setCountOnly(false);
+      throw;
+    }
+  }
+
+
+  /** Chronicles supporting the count-only mode overload this method.
+  *   \param[in] d date at which the evaluation is undertaken
+  *   \param[in] e event to be evaluated
+  *   \return true if there are new recognitions
+  */
+  bool Chronicle::processCount(const DateType&, CRL::Event*)
+  {
+    throw("Chronicle : count-only mode not supported by " + toString());
+  }
+
+
+  /** \param[in] rc recognition leaving the recognition set
+  */
+  void Chronicle::removeRecognition(RecoTree* rc)
+  {
+    Chronicle::RecoSet::iterator itS = _recognitionSet.find(rc);
+    if (itS == _recognitionSet.end()) return;
+
+    unindexRecognition(rc, itS.getPosition());
+    _recognitionSet.erase(rc);
+    if (_budget != NULL)
+      _budget->erase(rc);
+    if (_peremptionDuration >= 0.0)
+    {
+      std::pair<ExpiryQueue::iterator, ExpiryQueue::iterator> range;
+      range = _expiryQueue.equal_range(rc->getMaxDate());
+      for ( ; range.first != range.second; range.first++)
+        if (range.first->second == rc)
+        {
+          _expiryQueue.erase(range.first);
+          break;
+        }
+    }
+    releaseIfUnheld(rc);
+  }
+
+
+  /** \param[in] rc recognition leaving the recognition set
+  *   \param[in] pos position of the recognition in the set (row of the columns)
+  */
+  void Chronicle::unindexRecognition(RecoTree* rc, size_t pos)
+  {
+    std::list<RecoIndex*>::iterator itI;
+    for(itI=_indexes.begin(); itI!=_indexes.end(); itI++)
+      (*itI)->erase(rc);
+    if (_columns != NULL)
+      _columns->erase(pos);
+  }
+
+
   /** Scans a set of recognition trees, and returns \a true
-  *   if one is found equal to \a elmt
+  *   if one is found equal to \a elmt. The scan is linear: the table of
+  *   a RecoSet is indexed by address, not by structure (only each
+  *   comparison is cut short by the structural hashes, see RecoTree::equal).
+  *   Use a RecoHashSet for a lookup in constant time.
   *   \param[in] elmt sought after recognition tree
   *   \param[in] rset recognition set
   *   \return true if belongs
@@ -254,12 +671,33 @@ namespace CRL
    */
   void Chronicle::applyActionFunction(RecoTree& rc)
   {
-    // 1) Saves the new recognition
-    _newRecognitions.insert(&rc);
-    _recognitionSet.insert(&rc);
+    // 1) Saves the new recognition (held while it belongs to one of the sets)
+    bool newInNew = _newRecognitions.insert(&rc).second;
+    std::pair<Chronicle::RecoSet::iterator, bool> inserted = _recognitionSet.insert(&rc);
+    bool newInSet = inserted.second;
+    if (newInNew && newInSet)
+      rc.addRef();
+    std::list<RecoIndex*>::iterator itI;
+    for(itI=_indexes.begin(); itI!=_indexes.end(); itI++)
+      (*itI)->insert(&rc);
+    if ( (_columns != NULL) && newInSet )
+      _columns->insert(inserted.first.getPosition(), &rc);
+    if ( (_peremptionDuration >= 0.0) && newInSet )
+      _expiryQueue.insert(std::make_pair(rc.getMaxDate(), &rc));
     rc.setMyChronicle(this);
     _hasNewRecognitions = true;
 
+    // The set is kept within its budget (the new recognition remains a new one)
+    if ( (_budget != NULL) && newInSet )
+    {
+      RecoTree* victim = _budget->admit(&rc);
+      if (victim != NULL)
+      {
+        removeRecognition(victim);
+        _evictionCount++;
+      }
+    }
+
     // 2) Applies the possible action method provided by the user
     if (_actionFunction == NULL)
       actionMethod(rc);
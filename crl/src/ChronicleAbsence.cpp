@@ -114,10 +114,24 @@ namespace CRL
     if (_alreadyProcessed) 
       return _hasNewRecognitions;
 
+    bool flagRight = _opRight->process(d, e);
+    bool flagLeft  = _opLeft->process(d, e);
+    return processNode(d, e, flagLeft, flagRight);
+  }
+
+
+  /** Processing of the chronicle alone, its members having been processed
+  *   (by #process, or before by ChroniclePlan).
+  *   \param[in] d date at which the evaluation is undertaken
+  *   \param[in] e event to be evaluated
+  *   \param[in] flagLeft true if the left member has new recognitions
+  *   \param[in] flagRight true if the right member has new recognitions
+  */
+  bool ChronicleAbsence::processNode(const DateType& d, CRL::Event* e, bool flagLeft, bool flagRight)
+  {
     _hasNewRecognitions = false;
-    _opRight->process(d, e);
 
-    if (_opLeft->process(d, e))
+    if (flagLeft)
     {
       Chronicle::RecoSet::const_iterator itL, itR;
 
@@ -129,8 +143,9 @@ namespace CRL
         // 1) The presence of a tree on the right is tested
         bool flag = true;
 
-        for (itR  = _opRight->getRecognitionSet().begin(); 
-             itR != _opRight->getRecognitionSet().end(); itR++)
+        const Chronicle::RecoSet& candidates = rightCandidates(**itL);
+        for (itR  = candidates.begin();
+             itR != candidates.end(); itR++)
         {
           // If a recognition r2 is found during r1, according to 
           // the specified boundaries, it is tested with the predicate
@@ -182,4 +197,25 @@ namespace CRL
   }
 
 
+  /** \return signature, including the boundaries of the absence
+  */
+  std::string ChronicleAbsence::structuralSignature() const
+  {
+    return std::string(_exclInf ? "]" : "[") + (_exclSup ? "[" : "]") 
+           + ChronicleBinaryOp::structuralSignature();
+  }
+
+
+  /** Only the new recognitions of the left member are used, the recognition
+  *   set of the right member is searched within their span.
+  *   \param[in] window maximal useful span of the recognitions (negative value: unbounded)
+  */
+  void ChronicleAbsence::inferRetentionHorizons(DurationType window)
+  {
+    _opLeft->mergeRetentionHorizon(0.0);
+    _opRight->mergeRetentionHorizon(window);
+    _opLeft->inferRetentionHorizons(window);
+    _opRight->inferRetentionHorizons(window);
+  }
+
 } /* namespace CRL */
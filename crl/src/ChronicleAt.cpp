@@ -91,9 +91,22 @@ namespace CRL
     if (_alreadyProcessed) 
       return _hasNewRecognitions;
 
+    bool flagChild = _myChronicle->process(d, e);
+    return processNode(d, e, flagChild);
+  }
+
+
+  /** Processing of the chronicle alone, its member having been processed
+  *   (by #process, or before by ChroniclePlan).
+  *   \param[in] d date at which the evaluation is undertaken
+  *   \param[in] e event to be evaluated
+  *   \param[in] flagChild true if the member has new recognitions
+  */
+  bool ChronicleAt::processNode(const DateType& d, CRL::Event* e, bool flagChild)
+  {
     _hasNewRecognitions = false;
 
-    if (_myChronicle->process(d, e))
+    if (flagChild)
     {
       Chronicle::RecoSet::iterator it;
       for (it  = _myChronicle->getNewRecognitions().begin();
@@ -103,8 +116,10 @@ namespace CRL
         {
           RecoTreeSingle* r = new RecoTreeSingle(e);
           r->copyDateAndOrder(*e);
-          // The attributes of r are the ones of the recognition *it
+          // The attributes of r are the ones of the recognition *it,
+          // which is held as long as r shares them
           r->copyProperties(**it, false, false); // Untransfer ownership
+          r->holdTree(*it);
           if ( hasOutputFunction() )
           {
             PropertyManager pm;
@@ -141,7 +156,7 @@ namespace CRL
   * \param[in] duration indicates the peremption duration
   * \param[in] recursive indicates whether the setting of the peremption duration should be recursive
   */
-    void ChronicleAt::setPeremptionDuration(double duration, bool recursive)
+    void ChronicleAt::setPeremptionDuration(DurationType duration, bool recursive)
   {
     Chronicle::setPeremptionDuration(duration, recursive);
     if (recursive)
@@ -170,4 +185,23 @@ namespace CRL
 
 
 
+  /** \return signature, including the sub-chronicle
+  */
+  std::string ChronicleAt::structuralSignature() const
+  {
+    return Chronicle::structuralSignature()
+           + "(" + _myChronicle->structuralSignature() + ")";
+  }
+
+
+  /** Only the new recognitions of the sub-chronicle are used, and the
+  *   recognitions of the chronicle are instantaneous whatever their span.
+  *   \param[in] window maximal useful span of the recognitions (negative value: unbounded)
+  */
+  void ChronicleAt::inferRetentionHorizons(DurationType window)
+  {
+    _myChronicle->mergeRetentionHorizon(0.0);
+    _myChronicle->inferRetentionHorizons(-1.0);
+  }
+
 } /* namespace CRL */
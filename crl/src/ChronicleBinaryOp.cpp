@@ -26,6 +26,9 @@
 // INCLUDE FILES
 // ----------------------------------------------------------------------------
 
+#include <algorithm>
+#include <sstream>
+
 #include "RecoTreeCouple.h"
 #include "ChronicleBinaryOp.h"
 
@@ -41,8 +44,198 @@ namespace CRL
   *   \param[in] opR Right member chronicle
   */
   ChronicleBinaryOp::ChronicleBinaryOp(Chronicle* opL, Chronicle* opR) 
-    : _opLeft(opL),_opRight(opR)
+    : _opLeft(opL),_opRight(opR), _leftIndex(NULL), _rightIndex(NULL),
+      _selectionPolicy(ALL_COMBINATIONS), _consumeOnMatch(false)
+  {
+  }
+
+
+  /** \param[in] opLeft new left member chronicle
+  */
+  void ChronicleBinaryOp::setOpLeft(Chronicle* opLeft)
+  {
+    if (_leftIndex != NULL)
+    {
+      _opLeft->releaseIndex(_leftIndex);
+      _leftIndex = opLeft->requestIndex(_leftKeyPaths);
+    }
+    _opLeft = opLeft;
+  }
+
+
+  /** \param[in] opRight new right member chronicle
+  */
+  void ChronicleBinaryOp::setOpRight(Chronicle* opRight)
+  {
+    if (_rightIndex != NULL)
+    {
+      _opRight->releaseIndex(_rightIndex);
+      _rightIndex = opRight->requestIndex(_rightKeyPaths);
+    }
+    _opRight = opRight;
+  }
+
+
+  /** Once a key is declared, the join only enumerates the pairs of
+  *   recognitions having equal values for all the keys, thanks to hash
+  *   indexes maintained by the members. A recognition lacking one of the
+  *   properties is never joined. The predicate, if any, is still applied
+  *   to the enumerated pairs. The operators which do not join the
+  *   recognition sets of their members (see #supportsJoinKeys) refuse the keys.
+  *   \param[in] leftPath path of the property in the left recognitions
+  *   \param[in] rightPath path of the property in the right recognitions
+  */
+  void ChronicleBinaryOp::addJoinKey(const RecoIndex::PropertyPath& leftPath, 
+                                     const RecoIndex::PropertyPath& rightPath)
+  {
+    if (!supportsJoinKeys())
+      throw("ChronicleBinaryOp : equi-join keys not supported by " + toString());
+    if (leftPath.empty() || rightPath.empty())
+      throw("ChronicleBinaryOp : empty equi-join key");
+
+    _leftKeyPaths.push_back(leftPath);
+    _rightKeyPaths.push_back(rightPath);
+
+    _opLeft->releaseIndex(_leftIndex);
+    _opRight->releaseIndex(_rightIndex);
+    _leftIndex  = _opLeft->requestIndex(_leftKeyPaths);
+    _rightIndex = _opRight->requestIndex(_rightKeyPaths);
+  }
+
+
+  /** \param[in] leftAlias name of the sub-chronicle (see ChronicleNamed) in the left member
+  *   \param[in] leftProperty property of the left sub-chronicle
+  *   \param[in] rightAlias name of the sub-chronicle in the right member
+  *   \param[in] rightProperty property of the right sub-chronicle
+  */
+  void ChronicleBinaryOp::addJoinKey(const std::string& leftAlias, const std::string& leftProperty,
+                                     const std::string& rightAlias, const std::string& rightProperty)
+  {
+    RecoIndex::PropertyPath leftPath, rightPath;
+    leftPath.push_back(leftAlias);
+    leftPath.push_back(leftProperty);
+    rightPath.push_back(rightAlias);
+    rightPath.push_back(rightProperty);
+    addJoinKey(leftPath, rightPath);
+  }
+
+
+  /** Without equi-join key, all the left recognitions are candidates.
+  *   \param[in] r right recognition
+  *   \return set of the candidate left recognitions
+  */
+  const Chronicle::RecoSet& ChronicleBinaryOp::leftCandidates(const RecoTree& r) const
+  {
+    if (_leftIndex == NULL)
+      return _opLeft->getRecognitionSet();
+
+    std::string key;
+    if (!RecoIndex::extractKey(r, _rightKeyPaths, key))
+      return RecoIndex::EMPTY_BUCKET;
+    return _leftIndex->find(key);
+  }
+
+
+  /** Without equi-join key, all the right recognitions are candidates.
+  *   \param[in] l left recognition
+  *   \return set of the candidate right recognitions
+  */
+  const Chronicle::RecoSet& ChronicleBinaryOp::rightCandidates(const RecoTree& l) const
   {
+    if (_rightIndex == NULL)
+      return _opRight->getRecognitionSet();
+
+    std::string key;
+    if (!RecoIndex::extractKey(l, _leftKeyPaths, key))
+      return RecoIndex::EMPTY_BUCKET;
+    return _rightIndex->find(key);
+  }
+
+
+  /** The bounds are strict (see RecoColumns::select). Without equi-join key,
+  *   the orders of all the left recognitions are filtered over the columns
+  *   of the left member, before any property is read.
+  *   \param[in] r right recognition
+  *   \param[in] minLow lower bound of the minimal order
+  *   \param[in] minHigh upper bound of the minimal order
+  *   \param[in] maxLow lower bound of the maximal order
+  *   \param[in] maxHigh upper bound of the maximal order
+  *   \param[out] matches left recognitions satisfying the bounds
+  */
+  void ChronicleBinaryOp::leftMatches(const RecoTree& r, int64_t minLow, int64_t minHigh,
+                                      int64_t maxLow, int64_t maxHigh,
+                                      std::vector<RecoTree*>& matches)
+  {
+    matches.clear();
+    if (_leftIndex == NULL)
+    {
+      const RecoColumns& columns = _opLeft->getColumns();
+      std::vector<size_t> rows;
+      columns.select(minLow, minHigh, maxLow, maxHigh, rows);
+      for (size_t i=0; i<rows.size(); i++)
+        matches.push_back(columns.getTree(rows[i]));
+      return;
+    }
+
+    const Chronicle::RecoSet& candidates = leftCandidates(r);
+    Chronicle::RecoSet::const_iterator it;
+    for (it=candidates.begin(); it!=candidates.end(); it++)
+      if ( ((*it)->getMinOrder() > minLow) && ((*it)->getMinOrder() < minHigh) &&
+           ((*it)->getMaxOrder() > maxLow) && ((*it)->getMaxOrder() < maxHigh) )
+        matches.push_back(*it);
+  }
+
+
+  /** With the EARLIEST (resp. MOST_RECENT) policy, the candidates are sorted
+  *   so that the operator may stop at the first one giving a recognition.
+  *   When the recognitions are consumed, the other policies also try the
+  *   candidates in the order of their beginnings.
+  *   With STRICT_CONTIGUITY, only the candidates ending with the event just
+  *   before \a rc, or beginning with the event just after it, are kept (the
+  *   dates inserted in the flow are events as well).
+  *   \param[in] candidates recognitions of a member
+  *   \param[in] rc new recognition of the other member
+  *   \param[out] selected candidates to be tried, in order
+  */
+  void ChronicleBinaryOp::selectCandidates(const Chronicle::RecoSet& candidates, const RecoTree& rc,
+                                           std::vector<RecoTree*>& selected) const
+  {
+    selected.clear();
+    Chronicle::RecoSet::const_iterator it;
+    for (it=candidates.begin(); it!=candidates.end(); it++)
+      if ( (_selectionPolicy != STRICT_CONTIGUITY) ||
+           ((*it)->getMaxOrder() + 1 == rc.getMinOrder()) ||
+           (rc.getMaxOrder() + 1 == (*it)->getMinOrder()) )
+        selected.push_back(*it);
+
+    if (_selectionPolicy == MOST_RECENT)
+      std::sort(selected.begin(), selected.end(), endsAfter);
+    else if ( (_selectionPolicy == EARLIEST) || _consumeOnMatch )
+      std::sort(selected.begin(), selected.end(), beginsBefore);
+  }
+
+
+  /** \param[in] r1 first recognition
+  *   \param[in] r2 second recognition
+  *   \return true if \a r1 begins before \a r2 (or ends before, if they begin together)
+  */
+  bool ChronicleBinaryOp::beginsBefore(const RecoTree* r1, const RecoTree* r2)
+  {
+    if (r1->getMinOrder() != r2->getMinOrder())
+      return (r1->getMinOrder() < r2->getMinOrder());
+    return (r1->getMaxOrder() < r2->getMaxOrder());
+  }
+
+
+  /** \param[in] r1 first recognition
+  *   \param[in] r2 second recognition
+  *   \return true if \a r1 ends after \a r2 (or begins after, if they end together)
+  */
+  bool ChronicleBinaryOp::endsAfter(const RecoTree* r1, const RecoTree* r2)
+  {
+    if (r1->getMaxOrder() != r2->getMaxOrder())
+      return (r1->getMaxOrder() > r2->getMaxOrder());
+    return (r1->getMinOrder() > r2->getMinOrder());
   }
 
 
@@ -71,7 +264,7 @@ namespace CRL
   * \param[in] duration indicates the peremption duration
   * \param[in] recursive indicates whether the setting of the peremption duration should be recursive
   */
-    void ChronicleBinaryOp::setPeremptionDuration(double duration, bool recursive)
+    void ChronicleBinaryOp::setPeremptionDuration(DurationType duration, bool recursive)
   {
     Chronicle::setPeremptionDuration(duration, recursive);
     if (recursive)
@@ -118,4 +311,43 @@ namespace CRL
   }
 
 
+  /** \return signature, including the join keys and the sub-chronicles
+  */
+  std::string ChronicleBinaryOp::structuralSignature() const
+  {
+    std::string s = Chronicle::structuralSignature();
+    for (size_t i=0; i<_leftKeyPaths.size(); i++)
+    {
+      s += "[";
+      for (size_t j=0; j<_leftKeyPaths[i].size(); j++)
+        s += _leftKeyPaths[i][j] + "/";
+      s += "=";
+      for (size_t j=0; j<_rightKeyPaths[i].size(); j++)
+        s += _rightKeyPaths[i][j] + "/";
+      s += "]";
+    }
+    if (!hasDefaultSelection())
+    {
+      std::ostringstream os;
+      os << "<" << _selectionPolicy << (_consumeOnMatch ? "!" : "") << ">";
+      s += os.str();
+    }
+    return s + "(" + _opLeft->structuralSignature() + "," + _opRight->structuralSignature() + ")";
+  }
+
+
+  /** Default case of the joins: the whole recognition set of the left member
+  *   is combined with the new recognitions of the right member. A recognition
+  *   of the left member is useless once older than the window, since it
+  *   could only take part in recognitions spanning more than the window.
+  *   \param[in] window maximal useful span of the recognitions (negative value: unbounded)
+  */
+  void ChronicleBinaryOp::inferRetentionHorizons(DurationType window)
+  {
+    _opLeft->mergeRetentionHorizon(window);
+    _opRight->mergeRetentionHorizon(0.0);
+    _opLeft->inferRetentionHorizons(window);
+    _opRight->inferRetentionHorizons(window);
+  }
+
 } /* namespace CRL */
@@ -41,7 +41,8 @@ namespace CRL
   *   \param[in] opR Right member chronicle
   */
   ChronicleConjunction::ChronicleConjunction(Chronicle* opL, Chronicle* opR) 
-    : ChronicleBinaryOp(opL,opR) 
+    : ChronicleBinaryOp(opL,opR), _eliminateDuplicates(false),
+      _factorised(false), _oldLeftSize(0), _oldRightSize(0)
   {
     // If chronicles are used in an AND, they are not "purgeable" anymore
     opL->setPurgeable(false);
@@ -66,7 +67,8 @@ namespace CRL
   *   \param[in] opR Right member chronicle
   */
   ChronicleConjunction::ChronicleConjunction(Chronicle& opL, Chronicle& opR) 
-    : ChronicleBinaryOp(&opL,&opR) 
+    : ChronicleBinaryOp(&opL,&opR), _eliminateDuplicates(false),
+      _factorised(false), _oldLeftSize(0), _oldRightSize(0)
   {
     // If chronicles are used in an AND, they are not "purgeable" anymore
     opL.setPurgeable(false);
@@ -87,6 +89,12 @@ namespace CRL
   }
 
 
+  ChronicleConjunction::~ChronicleConjunction()
+  {
+    clearFactors();
+  }
+
+
   /** Display in the form : \code (a & b) \endcode
   *   \return string
   */
@@ -97,6 +105,35 @@ namespace CRL
   }
 
 
+  /** \return signature of the binary operator, marked if the duplicates are eliminated
+  */
+  std::string ChronicleConjunction::structuralSignature() const
+  {
+    return ChronicleBinaryOp::structuralSignature() + (_eliminateDuplicates ? "<unique>" : "")
+                                                    + (_factorised ? "<factorised>" : "");
+  }
+
+
+  /** \param[in] m members of a join
+  *   \return hash of the members, symmetric
+  */
+  std::size_t ChronicleConjunction::MembersHash::operator()(const Members& m) const
+  {
+    return m.first->getStructuralHash() + m.second->getStructuralHash();
+  }
+
+
+  /** \param[in] m1 members of a join
+  *   \param[in] m2 members of another join
+  *   \return true if the members are structurally equal, in the same order or not
+  */
+  bool ChronicleConjunction::MembersEqual::operator()(const Members& m1, const Members& m2) const
+  {
+    return ( (m1.first->equal(m2.first)  && m1.second->equal(m2.second))
+          || (m1.first->equal(m2.second) && m1.second->equal(m2.first)) );
+  }
+
+
   /** Updates the recognition set of the chronicle.
   *   \param[in] d date at which the evaluation is undertaken
   *   \param[in] e event to be evaluated
@@ -107,82 +144,322 @@ namespace CRL
     if (_alreadyProcessed) 
       return _hasNewRecognitions;
 
+    bool flagLeft  = _opLeft->process(d, e);
+    bool flagRight = _opRight->process(d, e);
+    return processNode(d, e, flagLeft, flagRight);
+  }
+
+
+  /** Processing of the chronicle alone, its members having been processed
+  *   (by #process, or before by ChroniclePlan).
+  *   \param[in] d date at which the evaluation is undertaken
+  *   \param[in] e event to be evaluated
+  *   \param[in] flagLeft true if the left member has new recognitions
+  *   \param[in] flagRight true if the right member has new recognitions
+  */
+  bool ChronicleConjunction::processNode(const DateType& d, CRL::Event* e, bool flagLeft, bool flagRight)
+  {
+    if (_countOnly)
+      return processCount(d, e);
+    if (_factorised)
+      return processFactorised(d, e);
+
     _hasNewRecognitions = false;
-    bool flagLeft       = _opLeft->process(d, e);
-    bool flagRight      = _opRight->process(d, e);
 
     if (flagLeft || flagRight)
     {
-      Chronicle::RecoSet::iterator it, itL, itR;
+      if (!hasDefaultSelection())
+      {
+        joinSelected(e);
+        _joinedMembers.clear();
+        _alreadyProcessed = true;
+        return _hasNewRecognitions;
+      }
+
+      Chronicle::RecoSet::const_iterator itL, itR;
 
       //the new recognitions of Left are merged with the recognitions of Right
       for (itL  = _opLeft->getNewRecognitions().begin();
            itL != _opLeft->getNewRecognitions().end(); itL++)
       {
-        for (itR  = _opRight->getRecognitionSet().begin();
-             itR != _opRight->getRecognitionSet().end(); itR++)
-        {
-          PropertyManager x1x2;  // Union of the properties, except anonymous
-          x1x2.copyProperties(**itL, true, false); // no transfer of ownership, thus
-          x1x2.copyProperties(**itR, true, false); // instance x1x2 is safely deletable 
-
-          if ( applyPredicate(x1x2) )
-          {
-            RecoTree* tmp = new RecoTreeCouple(*itL, *itR);
-            tmp->copyDateAndOrder(**itL, **itR);
-            tmp->copyProperties(x1x2, false, false); // Untransfer ownership
-            if ( hasOutputFunction() )
-            {
-              PropertyManager pm;
-              applyOutputFunction(x1x2, pm);
-              tmp->upgradeProperties(pm, true, true); // Transfer ownership
-            }
-            applyActionFunction(tmp);
-          }
-        }
+        const Chronicle::RecoSet& candidates = rightCandidates(**itL);
+        for (itR  = candidates.begin();
+             itR != candidates.end(); itR++)
+          join(*itL, *itR);
       }
 
       //the new recognitions of Right are merged with the recognitions of Left
       for (itR  = _opRight->getNewRecognitions().begin();
            itR != _opRight->getNewRecognitions().end(); itR++)
       { 
-        for (itL  = _opLeft->getRecognitionSet().begin();
-             itL != _opLeft->getRecognitionSet().end(); itL++)
+        const Chronicle::RecoSet& candidates = leftCandidates(**itR);
+        for (itL  = candidates.begin();
+             itL != candidates.end(); itL++)
         {
           // This test eliminates the couples (new reco left, new reco right)
           // already treated with the previous double loop
           if ((*itL)->getMaxOrder() == e->getOrder())
             continue;
 
-          PropertyManager x1x2;  // Union of the properties, except anonymous
-          x1x2.copyProperties(**itL, true, false);
-          x1x2.copyProperties(**itR, true, false);  
-
-          if ( applyPredicate(x1x2) )
-          {
-            RecoTree* tmp = new RecoTreeCouple(*itL, *itR);
-            tmp->copyDateAndOrder(**itL, **itR);
-            tmp->copyProperties(x1x2, false, false); // Untransfer ownership
-            // OLD' FASHION TO ELIMINATE DOUBLE RECOGNITIONS
-            // Do not use because of quadratic cost !
-            //if (isIn(*tmp, this->_newRecognitions))
-            //{
-            //  delete tmp;
-            //  continue;
-            //}
-            if ( hasOutputFunction() )
-            {
-              PropertyManager pm;
-              applyOutputFunction(x1x2, pm);
-              tmp->upgradeProperties(pm, true, true); // Transfer ownership
-            }
-            applyActionFunction(tmp);
-          }
+          // The other duplicates are eliminated by #join, if required
+          join(*itL, *itR);
         }
       }
+      _joinedMembers.clear();
     }
     _alreadyProcessed = true;
     return _hasNewRecognitions;
   }
 
+
+  /** \param[in] l recognition of the left member
+  *   \param[in] r recognition of the right member
+  *   \return true if the predicate is verified (new recognition)
+  */
+  bool ChronicleConjunction::join(RecoTree* l, RecoTree* r)
+  {
+    // The members of the recognitions built for the current event are
+    // hashed regardless of their order: a join of members structurally
+    // equal to those of a former join (possibly swapped) is eliminated
+    if ( _eliminateDuplicates && !_joinedMembers.insert(Members(l, r)).second )
+      return false;
+
+    PropertyManager x1x2;  // Union of the properties, except anonymous
+    x1x2.copyProperties(*l, true, false); // no transfer of ownership, thus
+    x1x2.copyProperties(*r, true, false); // instance x1x2 is safely deletable 
+
+    if ( !applyPredicate(x1x2) )
+      return false;
+
+    RecoTree* tmp = new RecoTreeCouple(l, r);
+    tmp->copyDateAndOrder(*l, *r);
+    tmp->copyProperties(x1x2, false, false); // Untransfer ownership
+    if ( hasOutputFunction() )
+    {
+      PropertyManager pm;
+      applyOutputFunction(x1x2, pm);
+      tmp->upgradeProperties(pm, true, true); // Transfer ownership
+    }
+    applyActionFunction(tmp);
+    return true;
+  }
+
+
+  /** Same joins as the default case, but each new recognition of a member
+  *   is only joined with the recognitions of the other member chosen by the
+  *   selection policy. If required, both recognitions of a join are then
+  *   consumed: a consumed new recognition is not joined any further.
+  *   \param[in] e event being evaluated
+  */
+  void ChronicleConjunction::joinSelected(CRL::Event* e)
+  {
+    std::set<RecoTree*> consumed;
+    std::vector<RecoTree*> selected;
+    Chronicle::RecoSet::const_iterator it;
+
+    //the new recognitions of Left are merged with the recognitions of Right
+    for (it  = _opLeft->getNewRecognitions().begin();
+         it != _opLeft->getNewRecognitions().end(); it++)
+    {
+      selectCandidates(rightCandidates(**it), **it, selected);
+      for (size_t i=0; i<selected.size(); i++)
+      {
+        if ( (consumed.find(*it) != consumed.end()) || !join(*it, selected[i]) )
+          continue;
+        if (_consumeOnMatch)
+        {
+          consumed.insert(*it);
+          consumed.insert(selected[i]);
+          _opLeft->consumeRecognition(*it);
+          _opRight->consumeRecognition(selected[i]);
+        }
+        if (selectsFirstOnly()) break;
+      }
+    }
+
+    //the new recognitions of Right are merged with the former recognitions of Left
+    for (it  = _opRight->getNewRecognitions().begin();
+         it != _opRight->getNewRecognitions().end(); it++)
+    {
+      selectCandidates(leftCandidates(**it), **it, selected);
+      for (size_t i=0; i<selected.size(); i++)
+      {
+        if ( (selected[i]->getMaxOrder() == e->getOrder()) ||
+             (consumed.find(*it) != consumed.end()) || !join(selected[i], *it) )
+          continue;
+        if (_consumeOnMatch)
+        {
+          consumed.insert(*it);
+          _opLeft->consumeRecognition(selected[i]);
+          _opRight->consumeRecognition(*it);
+        }
+        if (selectsFirstOnly()) break;
+      }
+    }
+  }
+
+
+  /** New left recognitions with all the right ones, plus the former left
+  *   recognitions with the new right ones.
+  *   \param[in] d date at which the evaluation is undertaken
+  *   \param[in] e event to be evaluated
+  */
+  bool ChronicleConjunction::processCount(const DateType& d, CRL::Event* e)
+  {
+    _opLeft->process(d, e);
+    _opRight->process(d, e);
+
+    double newLeft = _opLeft->getNewCount();
+    _newCount = newLeft * _opRight->getCount()
+              + (_opLeft->getCount() - newLeft) * _opRight->getNewCount();
+    _count   += _newCount;
+    _hasNewRecognitions = (_newCount > 0.0);
+    _alreadyProcessed = true;
+    return _hasNewRecognitions;
+  }
+
+
+  /** Every join of the default case is made at the arrival of its last
+  *   member, with all the recognitions of the other member: the recognition
+  *   set is thus exactly the product of the recognitions ever made by both
+  *   members. Only these recognitions are kept, once each, and the
+  *   recognitions of the conjunction are built on demand (see 
+  *   #enumerateRecognitions). The memory grows with the sum of the sizes
+  *   of the members, instead of their product.
+  *
+  *   The recognition set of the chronicle stays empty: the chronicle cannot
+  *   be used by another one, nor have predicate, output or action function
+  *   (same restrictions as the count-only mode). The members must keep all
+  *   their recognitions (no peremption), and their recognitions are kept
+  *   for as long as the chronicle. The counters of #getCount and 
+  *   #getNewCount are those of the count-only mode.
+  *   \param[in] b true to factorise the recognitions, false to release them
+  */
+  void ChronicleConjunction::setFactorised(bool b)
+  {
+    if (b && !_factorised)
+    {
+      if ( !supportsCountOnly() || hasPredicateFunction() || hasOutputFunction() 
+           || hasActionFunction() || _hasOutputPropertiesMethod || (_peremptionDuration >= 0.0)
+           || (_budget != NULL) || _countOnly || (_shareCount > 0)
+           || !_recognitionSet.empty() || !_newRecognitions.empty()
+           || (_opLeft->getPeremptionDuration() >= 0.0) || (_opRight->getPeremptionDuration() >= 0.0) )
+        throw("ChronicleConjunction : factorised form not supported by " + toString());
+      _count = _newCount = 0.0;
+    }
+    if (!b)
+      clearFactors();
+    _factorised = b;
+  }
+
+
+  void ChronicleConjunction::clearFactors()
+  {
+    Chronicle::RecoSet::const_iterator it;
+    for (it = _leftFactor.begin(); it != _leftFactor.end(); it++)
+      (*it)->release();
+    for (it = _rightFactor.begin(); it != _rightFactor.end(); it++)
+      (*it)->release();
+    _leftFactor.clear();
+    _rightFactor.clear();
+    _oldLeftSize = _oldRightSize = 0;
+  }
+
+
+  /** The new recognitions of the members are appended to the factors.
+  *   \param[in] d date at which the evaluation is undertaken
+  *   \param[in] e event to be evaluated
+  */
+  bool ChronicleConjunction::processFactorised(const DateType& d, CRL::Event* e)
+  {
+    _opLeft->process(d, e);
+    _opRight->process(d, e);
+
+    _oldLeftSize  = _leftFactor.size();
+    _oldRightSize = _rightFactor.size();
+
+    Chronicle::RecoSet::const_iterator it;
+    for (it = _opLeft->getNewRecognitions().begin(); it != _opLeft->getNewRecognitions().end(); it++)
+      if ( _leftFactor.insert(*it).second )
+        (*it)->addRef();
+    for (it = _opRight->getNewRecognitions().begin(); it != _opRight->getNewRecognitions().end(); it++)
+      if ( _rightFactor.insert(*it).second )
+        (*it)->addRef();
+
+    double newLeft = (double)(_leftFactor.size() - _oldLeftSize);
+    _newCount = newLeft * _rightFactor.size()
+              + _oldLeftSize * (double)(_rightFactor.size() - _oldRightSize);
+    _count   += _newCount;
+    _hasNewRecognitions = (_newCount > 0.0);
+    _alreadyProcessed = true;
+    return _hasNewRecognitions;
+  }
+
+
+  /** \param[in] l recognition of the left member
+  *   \param[in] r recognition of the right member
+  *   \return true if both recognitions are in the factors
+  */
+  bool ChronicleConjunction::containsRecognition(const RecoTree* l, const RecoTree* r) const
+  {
+    return ( _leftFactor.count(const_cast<RecoTree*>(l)) > 0 )
+        && ( _rightFactor.count(const_cast<RecoTree*>(r)) > 0 );
+  }
+
+
+  /** \param[in] l recognition of the left member
+  *   \param[in] r recognition of the right member
+  *   \return recognition of the chronicle (unreferenced)
+  */
+  RecoTree* ChronicleConjunction::buildRecognition(RecoTree* l, RecoTree* r) const
+  {
+    RecoTree* tmp = new RecoTreeCouple(l, r);
+    tmp->copyDateAndOrder(*l, *r);
+    tmp->copyProperties(*l, true, false);
+    tmp->copyProperties(*r, true, false);
+    tmp->setMyChronicle(const_cast<ChronicleConjunction*>(this));
+    return tmp;
+  }
+
+
+  /** The recognitions are built one at a time, in the order of the left 
+  *   factor then of the right one, and released after the call of \a f 
+  *   (which may reference them to keep them).
+  *   \param[in] f function called on each recognition
+  *   \param[in] newOnly true to enumerate only the recognitions of the last processing
+  *   \return number of recognitions enumerated
+  */
+  size_t ChronicleConjunction::enumerateRecognitions(void (*f)(RecoTree& rc), bool newOnly) const
+  {
+    size_t n = 0, i = 0;
+    Chronicle::RecoSet::const_iterator itL, itR;
+    for (itL = _leftFactor.begin(); itL != _leftFactor.end(); itL++, i++)
+    {
+      size_t j = 0;
+      for (itR = _rightFactor.begin(); itR != _rightFactor.end(); itR++, j++)
+      {
+        if ( newOnly && (i < _oldLeftSize) && (j < _oldRightSize) )
+          continue;
+        RecoTree* tmp = buildRecognition(*itL, *itR);
+        tmp->addRef();
+        f(*tmp);
+        tmp->release();
+        n++;
+      }
+    }
+    return n;
+  }
+
+  /** Both recognition sets are combined with the new recognitions of the
+  *   other member.
+  *   \param[in] window maximal useful span of the recognitions (negative value: unbounded)
+  */
+  void ChronicleConjunction::inferRetentionHorizons(DurationType window)
+  {
+    _opLeft->mergeRetentionHorizon(window);
+    _opRight->mergeRetentionHorizon(window);
+    _opLeft->inferRetentionHorizons(window);
+    _opRight->inferRetentionHorizons(window);
+  }
+
 } /* namespace CRL */
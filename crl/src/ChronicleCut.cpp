@@ -88,6 +88,17 @@ namespace CRL
   /** Display in the form : \code (C1 C2) \endcode
   *   \return string
   */
+  /** The awaiting recognitions of the left member are held by the
+  *   chronicle, since they may have been purged from the sub-chronicle.
+  */
+  ChronicleCut::~ChronicleCut()
+  {
+    Chronicle::RecoSet::iterator it;
+    for (it=_tempRecogSet.begin(); it!=_tempRecogSet.end(); it++)
+      (*it)->release();
+  }
+
+
   std::string ChronicleCut::toString() const 
   {
     if (_name != "") return _name;
@@ -105,40 +116,73 @@ namespace CRL
     if (_alreadyProcessed) 
       return _hasNewRecognitions;
 
+    bool flagLeft  = _opLeft->process(d, e);
+    bool flagRight = _opRight->process(d, e);
+    return processNode(d, e, flagLeft, flagRight);
+  }
+
+
+  /** Processing of the chronicle alone, its members having been processed
+  *   (by #process, or before by ChroniclePlan).
+  *   \param[in] d date at which the evaluation is undertaken
+  *   \param[in] e event to be evaluated
+  *   \param[in] flagLeft true if the left member has new recognitions
+  *   \param[in] flagRight true if the right member has new recognitions
+  */
+  bool ChronicleCut::processNode(const DateType& d, CRL::Event* e, bool flagLeft, bool flagRight)
+  {
     _hasNewRecognitions = false;
-    _opLeft->process(d, e);
 
     // Transfers the new recognitions of Left into temporary
     Chronicle::RecoSet::iterator it;
     for (it= _opLeft->getNewRecognitions().begin();
          it!=  _opLeft->getNewRecognitions().end();
          it++)
-      _tempRecogSet.insert(*it);
+    {
+      std::pair<Chronicle::RecoSet::iterator, bool> inserted = _tempRecogSet.insert(*it);
+      if (inserted.second)
+      {
+        (*it)->addRef();
+        _tempColumns.insert(inserted.first.getPosition(), *it);
+      }
+    }
 
 
-    if (_opRight->process(d, e))
+    if (flagRight)
     {
-      Chronicle::RecoSet::iterator itL, itR, itLtmp;
+      Chronicle::RecoSet::iterator itR;
+      std::vector<size_t> rows;
+
+      // Only the awaiting recognitions of Left ending before the latest start of
+      // a new recognition of Right may be joined (filtered over the columns)
+      int64_t maxMinOrder = RecoColumns::NO_LOWER_BOUND;
+      for (itR  = _opRight->getNewRecognitions().begin();
+        itR != _opRight->getNewRecognitions().end(); itR++)
+        if ((*itR)->getMinOrder() > maxMinOrder)
+          maxMinOrder = (*itR)->getMinOrder();
+      _tempColumns.select(RecoColumns::NO_LOWER_BOUND, RecoColumns::NO_UPPER_BOUND,
+                          RecoColumns::NO_LOWER_BOUND, maxMinOrder, rows);
 
       //the new recognitions of Right are merged with the recognitions of Left
-      itL  = _tempRecogSet.begin();
-      while (itL != _tempRecogSet.end())
-      { 
+      //(in the order of the awaiting recognitions of Left, then of Right)
+      for (size_t i=0; i<rows.size(); i++)
+      {
+        RecoTree* l = _tempColumns.getTree(rows[i]);
         bool flag = false;
         for (itR  = _opRight->getNewRecognitions().begin();
           itR != _opRight->getNewRecognitions().end(); itR++)
         {
-          if ((*itL)->getMaxOrder() < (*itR)->getMinOrder())
+          if (l->getMaxOrder() < (*itR)->getMinOrder())
           {
             PropertyManager x1x2;  // Union of the properties, except anonymous
-            x1x2.copyProperties(**itL, true, false);
+            x1x2.copyProperties(*l, true, false);
             x1x2.copyProperties(**itR, true, false); 
 
             if ( applyPredicate(x1x2) )
             {
-              flag=true;
-              RecoTree* tmp = new RecoTreeCouple(*itL, *itR);
-              tmp->copyDateAndOrder(**itL, **itR);
+              flag = true;
+              RecoTree* tmp = new RecoTreeCouple(l, *itR);
+              tmp->copyDateAndOrder(*l, **itR);
               tmp->copyProperties(x1x2, false, false); // Untransfer ownership
               if ( hasOutputFunction() )
               {
@@ -151,15 +195,16 @@ namespace CRL
           } // if
         } // for itR
 
+        // The left recognition joined no longer waits
         if (flag)
         {
-          itLtmp = std::next(itL);
-          _tempRecogSet.erase(itL);
-          itL = itLtmp;
+          _tempRecogSet.erase(l);
+          _tempColumns.erase(rows[i]);
+          l->release();
         }
-        else
-          itL++;
-      }
+      } // for rows
+      if (_tempRecogSet.compact())
+        _tempColumns.compact();
     }
 
     _alreadyProcessed = true;
@@ -168,4 +213,15 @@ namespace CRL
 
 
 
+  /** Only the new recognitions of the members are used.
+  *   \param[in] window maximal useful span of the recognitions (negative value: unbounded)
+  */
+  void ChronicleCut::inferRetentionHorizons(DurationType window)
+  {
+    _opLeft->mergeRetentionHorizon(0.0);
+    _opRight->mergeRetentionHorizon(0.0);
+    _opLeft->inferRetentionHorizons(window);
+    _opRight->inferRetentionHorizons(window);
+  }
+
 } /* namespace CRL */
@@ -90,9 +90,22 @@ namespace CRL
     if (_alreadyProcessed) 
       return _hasNewRecognitions;
 
+    bool flagChild = _opLeft->process(d, e);
+    return processNode(d, e, flagChild);
+  }
+
+
+  /** Processing of the chronicle alone, its member having been processed
+  *   (by #process, or before by ChroniclePlan).
+  *   \param[in] d date at which the evaluation is undertaken
+  *   \param[in] e event to be evaluated
+  *   \param[in] flagChild true if the member has new recognitions
+  */
+  bool ChronicleDelayAtLeast::processNode(const DateType& d, CRL::Event* e, bool flagChild)
+  {
     _hasNewRecognitions =  false;
 
-    if (_opLeft->process(d, e))
+    if (flagChild)
     {
       Chronicle::RecoSet::const_iterator itL;
       for (itL  = _opLeft->getNewRecognitions().begin();
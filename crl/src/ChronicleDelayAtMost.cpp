@@ -91,9 +91,22 @@ namespace CRL
     if (_alreadyProcessed) 
       return _hasNewRecognitions;
 
+    bool flagChild = _opLeft->process(d, e);
+    return processNode(d, e, flagChild);
+  }
+
+
+  /** Processing of the chronicle alone, its member having been processed
+  *   (by #process, or before by ChroniclePlan).
+  *   \param[in] d date at which the evaluation is undertaken
+  *   \param[in] e event to be evaluated
+  *   \param[in] flagChild true if the member has new recognitions
+  */
+  bool ChronicleDelayAtMost::processNode(const DateType& d, CRL::Event* e, bool flagChild)
+  {
     _hasNewRecognitions = false;
 
-    if (_opLeft->process(d,e))
+    if (flagChild)
     {
       Chronicle::RecoSet::iterator itL;
       for (itL  = _opLeft->getNewRecognitions().begin();
@@ -123,4 +136,13 @@ namespace CRL
     return _hasNewRecognitions;
   }
 
+  /** Only the recognitions of the sub-chronicle lasting at most #_delay are useful.
+  *   \param[in] window maximal useful span of the recognitions (negative value: unbounded)
+  */
+  void ChronicleDelayAtMost::inferRetentionHorizons(DurationType window)
+  {
+    _opLeft->mergeRetentionHorizon(0.0);
+    _opLeft->inferRetentionHorizons(narrowWindow(window, _delay));
+  }
+
 } /* namespace CRL */
@@ -71,7 +71,7 @@ namespace CRL
   * \param[in] duration indicates the peremption duration
   * \param[in] recursive indicates whether the setting of the peremption duration should be recursive
   */
-    void ChronicleDelayOp::setPeremptionDuration(double duration, bool recursive)
+    void ChronicleDelayOp::setPeremptionDuration(DurationType duration, bool recursive)
   {
     Chronicle::setPeremptionDuration(duration, recursive);
     if (recursive)
@@ -106,4 +106,25 @@ namespace CRL
 
 
 
+  /** \return signature, including the delay and the sub-chronicle
+  */
+  std::string ChronicleDelayOp::structuralSignature() const
+  {
+    std::ostringstream os;
+    os.precision(17);
+    os << Chronicle::structuralSignature() << "[" << _delay << "]"
+       << "(" << _opLeft->structuralSignature() << ")";
+    return os.str();
+  }
+
+
+  /** Default case: only the new recognitions of the sub-chronicle are used.
+  *   \param[in] window maximal useful span of the recognitions (negative value: unbounded)
+  */
+  void ChronicleDelayOp::inferRetentionHorizons(DurationType window)
+  {
+    _opLeft->mergeRetentionHorizon(0.0);
+    _opLeft->inferRetentionHorizons(window);
+  }
+
 } /* namespace CRL */
@@ -113,12 +113,24 @@ namespace CRL
     if (_alreadyProcessed) 
       return _hasNewRecognitions;
 
-    _hasNewRecognitions =  false;
+    bool flagChild = _opLeft->process(d, e);
+    return processNode(d, e, flagChild);
+  }
+
 
-    _opLeft->process(d, e);
+  /** Processing of the chronicle alone, its member having been processed
+  *   (by #process, or before by ChroniclePlan).
+  *   \param[in] d date at which the evaluation is undertaken
+  *   \param[in] e event to be evaluated
+  *   \param[in] flagChild true if the member has new recognitions
+  */
+  bool ChronicleDelayThen::processNode(const DateType& d, CRL::Event* e, bool flagChild)
+  {
+    _hasNewRecognitions =  false;
 
+    // The new recognitions of the member are scanned even without a new one
+    // at this event: they are kept until their delay expires
     Chronicle::RecoSet::iterator itL= _opLeft->getNewRecognitions().begin();
-    Chronicle::RecoSet::iterator itLtmp;
 
     while (itL != _opLeft->getNewRecognitions().end())
     {
@@ -137,7 +149,7 @@ namespace CRL
           // The order and date of event e are adopted, no matter which case
           tmpR->copyDateAndOrder(*e); 
 
-          RecoTree* tmp = new RecoTreeCouple(*itL, tmpR, true);
+          RecoTree* tmp = new RecoTreeCouple(*itL, tmpR);
           tmp->copyDateAndOrder(**itL, *tmpR);
           tmp->copyProperties(**itL, true, false); // Untransfer ownership
 
@@ -151,10 +163,7 @@ namespace CRL
 
           // Removes element itL processed in the list, while keeping
           // an iterator in a correct state for the following element
-          itLtmp=itL;
-          itLtmp++;
-          _opLeft->getNewRecognitions().erase(itL);
-          itL=itLtmp;
+          itL = _opLeft->eraseNewRecognition(itL);
         }
         else itL++; //if ( applyPredicate(xL) )
       }
@@ -181,4 +190,17 @@ namespace CRL
   }
 
 
+  /** The new recognitions of the sub-chronicle are kept during #_delay, and
+  *   the recognitions of the chronicle last #_delay more than them.
+  *   \param[in] window maximal useful span of the recognitions (negative value: unbounded)
+  */
+  void ChronicleDelayThen::inferRetentionHorizons(DurationType window)
+  {
+    _opLeft->mergeRetentionHorizon(_delay);
+    if (window < 0.0)
+      _opLeft->inferRetentionHorizons(window);
+    else
+      _opLeft->inferRetentionHorizons(window > _delay ? window - _delay : 0.0);
+  }
+
 } /* namespace CRL */
@@ -91,6 +91,21 @@ namespace CRL
 
     bool flagLeft  = _opLeft->process(d, e);
     bool flagRight = _opRight->process(d, e);
+    return processNode(d, e, flagLeft, flagRight);
+  }
+
+
+  /** Processing of the chronicle alone, its members having been processed
+  *   (by #process, or before by ChroniclePlan).
+  *   \param[in] d date at which the evaluation is undertaken
+  *   \param[in] e event to be evaluated
+  *   \param[in] flagLeft true if the left member has new recognitions
+  *   \param[in] flagRight true if the right member has new recognitions
+  */
+  bool ChronicleDisjunction::processNode(const DateType& d, CRL::Event* e, bool flagLeft, bool flagRight)
+  {
+    if (_countOnly)
+      return processCount(d, e);
 
     if (flagLeft||flagRight)
     {
@@ -148,4 +163,31 @@ namespace CRL
   }
 
 
+  /** \param[in] d date at which the evaluation is undertaken
+  *   \param[in] e event to be evaluated
+  */
+  bool ChronicleDisjunction::processCount(const DateType& d, CRL::Event* e)
+  {
+    _opLeft->process(d, e);
+    _opRight->process(d, e);
+
+    _newCount = _opLeft->getNewCount() + _opRight->getNewCount();
+    _count   += _newCount;
+    _hasNewRecognitions = (_newCount > 0.0);
+    _alreadyProcessed = true;
+    return _hasNewRecognitions;
+  }
+
+
+  /** Only the new recognitions of the members are used.
+  *   \param[in] window maximal useful span of the recognitions (negative value: unbounded)
+  */
+  void ChronicleDisjunction::inferRetentionHorizons(DurationType window)
+  {
+    _opLeft->mergeRetentionHorizon(0.0);
+    _opRight->mergeRetentionHorizon(0.0);
+    _opLeft->inferRetentionHorizons(window);
+    _opRight->inferRetentionHorizons(window);
+  }
+
 } /* namespace CRL */
@@ -0,0 +1,645 @@
+/** ***********************************************************************************
+ * \file ChronicleLoader.cpp
+ * \author Ariane Piel & Jean Bourrely / Onera DCPS
+ * \date 2014
+ * \brief Loading of chronicles from their text notation
+ **************************************************************************************/
+
+/*  Copyright (C) 2012, 2013, 2014  ONERA  http://www.onera.fr
+    This file is part of CRL : Chronicle Recognition Library.
+
+    CRL is free software: you can redistribute it and/or modify it under
+    the terms of the Lesser GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    CRL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    Lesser GNU General Public License for more details.
+
+    You should have received a copy of the Lesser GNU General Public License
+    along with CRL.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// ----------------------------------------------------------------------------
+// INCLUDE FILES
+// ----------------------------------------------------------------------------
+
+#include <cstdlib>
+#include <cctype>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+#include "ChronicleLoader.h"
+#include "Operators.h"
+
+
+// ----------------------------------------------------------------------------
+// CLASS METHODS
+// ----------------------------------------------------------------------------
+
+namespace CRL 
+{
+
+  /** The nodes of the loaded chronicles are laid out contiguously in an arena of
+   *  blocks of \a arenaBlockSize bytes.
+   * \param[in] arenaBlockSize size of the blocks of the arena
+  */
+  ChronicleLoader::ChronicleLoader(size_t arenaBlockSize) :
+    _depth(0),
+    _arena(new ChronicleArena(arenaBlockSize)),
+    _pos(0),
+    _line(0)
+  { /* empty */ }
+
+
+  /** The arena is freed when the last loaded chronicle is destroyed.
+  */
+  ChronicleLoader::~ChronicleLoader()
+  {
+    _arena->close();
+  }
+
+
+  /** Identical sub-chronicles are built once and shared (see Chronicle::share), the top
+   *  node is always a new chronicle.
+   * \param[in] text notation of the chronicle, as given by Chronicle::toString
+   * \return the chronicle, added to the loaded chronicles
+  */
+  Chronicle* ChronicleLoader::parse(const std::string& text)
+  {
+    Chronicle* cr = parseText(text);
+    _chronicles.push_back(cr);
+    return cr;
+  }
+
+
+  /** The chronicle can then be referred to by \a name in the following expressions.
+   * \param[in] name name of the chronicle
+   * \param[in] text notation of the chronicle
+   * \return the chronicle, added to the loaded chronicles
+  */
+  Chronicle* ChronicleLoader::define(const std::string& name, const std::string& text)
+  {
+    if (_definitions.find(name) != _definitions.end())
+      error("chronicle " + name + " already defined");
+    Chronicle* cr = parse(text);
+    cr->setName(name);
+    _definitions[name] = cr;
+    _definitionTexts[name] = text;
+    return cr;
+  }
+
+
+  /** Each line holds either a definition \code name = expression \endcode or an
+   *  anonymous expression. Blank lines and text following '#' are ignored.
+   * \param[in] is text flow
+   * \return number of chronicles loaded
+  */
+  size_t ChronicleLoader::load(std::istream& is)
+  {
+    size_t count = 0;
+    std::string line;
+    _line = 0;
+    while (std::getline(is, line))
+    {
+      _line++;
+      size_t comment = line.find('#');
+      if (comment != std::string::npos)
+        line.erase(comment);
+      if (line.find_first_not_of(" \t\r") == std::string::npos)
+        continue;
+
+      _text = line;
+      _pos = 0;
+      skipSpaces();
+      std::string name = parseIdentifier();
+      skipSpaces();
+      if (name != "" && match("=") && (_pos >= _text.size() || _text[_pos] != '='))
+        define(name, line.substr(_pos));
+      else
+        parse(line);
+      count++;
+    }
+    _line = 0;
+    return count;
+  }
+
+
+  /** \param[in] fileName path of the file
+   * \return number of chronicles loaded
+  */
+  size_t ChronicleLoader::loadFile(const std::string& fileName)
+  {
+    std::ifstream file(fileName.c_str());
+    if (!file)
+      throw("ChronicleLoader : cannot open " + fileName);
+    return load(file);
+  }
+
+
+  /** \param[in] name name of the definition
+   * \return the chronicle, NULL if \a name is not defined
+  */
+  Chronicle* ChronicleLoader::getDefinition(const std::string& name) const
+  {
+    std::map<std::string, Chronicle*>::const_iterator it = _definitions.find(name);
+    return (it == _definitions.end()) ? NULL : it->second;
+  }
+
+
+  /** The loaded chronicles must not be used afterwards.
+  */
+  void ChronicleLoader::destroyChronicles()
+  {
+    for (std::list<Chronicle*>::iterator it = _chronicles.begin(); it != _chronicles.end(); it++)
+      (*it)->deepDestroy();
+    _chronicles.clear();
+    _definitions.clear();
+    _definitionTexts.clear();
+    _built.clear();
+    _keys.clear();
+  }
+
+
+  /** The nodes are allocated in the arena of the loader. On error, the chronicles
+   *  built by the expression are destroyed.
+   * \param[in] text notation of the chronicle
+   * \return the chronicle
+  */
+  Chronicle* ChronicleLoader::parseText(const std::string& text)
+  {
+    std::string savedText = _text;
+    size_t savedPos = _pos;
+    _text = text;
+    _pos = 0;
+    _depth++;
+
+    ChronicleArena* previous = Chronicle::setAllocationArena(_arena);
+    Chronicle* cr = NULL;
+    try
+    {
+      cr = parseAtom(true);
+      skipSpaces();
+      if (_pos != _text.size())
+        error("unexpected characters");
+    }
+    catch (...)
+    {
+      Chronicle::setAllocationArena(previous);
+      _text = savedText;
+      _pos = savedPos;
+      if (--_depth == 0)
+        rollback();
+      throw;
+    }
+    Chronicle::setAllocationArena(previous);
+
+    _text = savedText;
+    _pos = savedPos;
+    if (--_depth == 0)
+    {
+      _created.clear();
+      _shared.clear();
+    }
+    return cr;
+  }
+
+
+  /** \param[in] exclusive true if the chronicle must not be shared (top node, operand of a DelayThen)
+   * \return the chronicle
+  */
+  Chronicle* ChronicleLoader::parseAtom(bool exclusive)
+  {
+    skipSpaces();
+    if (match("@"))
+    {
+      Chronicle* child = parseAtom(false);
+      std::string key = "@(" + _keys[child] + ")";
+      Chronicle* cr = lookup(key, exclusive);
+      if (cr != NULL)
+      {
+        discard(child);
+        return cr;
+      }
+      return remember(new ChronicleAt(child), key, exclusive);
+    }
+
+    if (match("("))
+    {
+      Chronicle* cr = parseBody(exclusive);
+      skipSpaces();
+      if (!match(")"))
+        error("')' expected");
+      return cr;
+    }
+
+    std::string ident = parseIdentifier();
+    if (ident == "")
+      error("event, date or '(' expected");
+
+    if (_definitions.find(ident) != _definitions.end())
+      return reference(ident, exclusive);
+
+    const std::string& dateCode = ChronicleSingleDate::getSingleDateCode();
+    if (ident.size() > dateCode.size() && ident.compare(0, dateCode.size(), dateCode) == 0)
+    {
+      const char* begin = ident.c_str() + dateCode.size();
+      char* end = NULL;
+      double value = strtod(begin, &end);
+      if (*end == '\0')
+      {
+        if (!DateTraits<DateType>::representable(value))
+          error("date not representable : " + ident);
+        DateType date = DateTraits<DateType>::fromUnits(value);
+        std::stringstream ss;
+        ss.precision(17);
+        ss << "tcrl(" << date << ")";
+        Chronicle* cr = lookup(ss.str(), exclusive);
+        if (cr != NULL)
+          return cr;
+        return remember(new ChronicleSingleDate(date), ss.str(), exclusive);
+      }
+    }
+
+    std::string key = "$(" + ident + ")";
+    Chronicle* cr = lookup(key, exclusive);
+    if (cr != NULL)
+      return cr;
+    return remember(new ChronicleSingleEvent(ident), key, exclusive);
+  }
+
+
+  /** \param[in] exclusive true if the chronicle must not be shared
+   * \return the chronicle
+  */
+  Chronicle* ChronicleLoader::parseBody(bool exclusive)
+  {
+    skipSpaces();
+    if (_pos < _text.size() && (_text[_pos] == '[' || _text[_pos] == ']'))
+      return parseAbsence(exclusive);
+
+    size_t start = _pos;
+    Chronicle* left = parseAtom(false);
+    bool spaced = skipSpaces();
+
+    if (_pos >= _text.size() || _text[_pos] == ')' || _text[_pos] == '[' || _text[_pos] == ']')
+    {
+      // Parenthesised operand, or left operand of an absence
+      if (exclusive)
+        left = makeExclusive(left, start);
+      return left;
+    }
+
+    // Unary operators
+    std::string op;
+    if (match("->"))
+    {
+      skipSpaces();
+      std::string alias = parseIdentifier();
+      if (alias == "")
+        error("alias expected");
+      std::string key = "(" + _keys[left] + "->" + alias + ")";
+      Chronicle* cr = lookup(key, exclusive);
+      if (cr != NULL)
+      {
+        discard(left);
+        return cr;
+      }
+      return remember(new ChronicleNamed(left, alias), key, exclusive);
+    }
+
+    double value = 0;
+    size_t opPos = _pos;
+    if (match("+") || match("==") || match(">>") || match("<<"))
+    {
+      op = _text.substr(opPos, _pos - opPos);
+      size_t numberPos = _pos;
+      skipSpaces();
+      if (parseNumber(value))
+      {
+        skipSpaces();
+        if (_pos < _text.size() && _text[_pos] == ')')
+        {
+          if (!DateTraits<DurationType>::representable(value))
+            error("duration not representable");
+          DurationType delay = DateTraits<DurationType>::fromUnits(value);
+          std::stringstream ss;
+          ss.precision(17);
+          ss << "(" << _keys[left] << op << value << ")";
+          Chronicle* cr = lookup(ss.str(), exclusive);
+          if (cr != NULL)
+          {
+            discard(left);
+            return cr;
+          }
+          if (op == "+")
+          {
+            // DelayThen consumes the recognitions of its operand: the operand is its own
+            left = makeExclusive(left, start);
+            return remember(new ChronicleDelayThen(left, delay), ss.str(), exclusive);
+          }
+          else if (op == "==")
+            return remember(new ChronicleDelayLasts(left, delay), ss.str(), exclusive);
+          else if (op == ">>")
+            return remember(new ChronicleDelayAtLeast(left, delay), ss.str(), exclusive);
+          else
+            return remember(new ChronicleDelayAtMost(left, delay), ss.str(), exclusive);
+        }
+      }
+      if (op != "==")
+        error("duration expected");
+      _pos = numberPos;
+    }
+
+    // Binary operators
+    static const char* operators[] = { "&&", "||", "==", "&=", "|=", ">=", "!=", "!", "/", "meets", NULL };
+    if (op == "")
+    {
+      for (int i = 0; operators[i] != NULL && op == ""; i++)
+        if (match(operators[i]))
+          op = operators[i];
+      if (op == "meets" && _pos < _text.size() && !isspace((unsigned char)_text[_pos]))
+      {
+        // Event whose name begins with "meets"
+        _pos = opPos;
+        op = "";
+      }
+      if (op == "")
+      {
+        if (!spaced)
+          error("operator expected");
+        op = " ";
+      }
+    }
+
+    Chronicle* right = parseAtom(false);
+    std::string key = "(" + _keys[left] + op + _keys[right] + ")";
+    Chronicle* cr = lookup(key, exclusive);
+    if (cr != NULL)
+    {
+      discard(left);
+      discard(right);
+      return cr;
+    }
+
+    if (op == " ")
+      cr = new ChronicleSequence(left, right);
+    else if (op == "&&")
+      cr = new ChronicleConjunction(left, right);
+    else if (op == "||")
+      cr = new ChronicleDisjunction(left, right);
+    else if (op == "==")
+      cr = new ChronicleEquals(left, right);
+    else if (op == "&=")
+      cr = new ChronicleDuring(left, right);
+    else if (op == "|=")
+      cr = new ChronicleStarts(left, right);
+    else if (op == ">=")
+      cr = new ChronicleFinishes(left, right);
+    else if (op == "!=")
+      cr = new ChronicleStateChange(left, right);
+    else if (op == "!")
+      cr = new ChronicleCut(left, right);
+    else if (op == "/")
+      cr = new ChronicleOverlaps(left, right);
+    else
+      cr = new ChronicleMeets(left, right);
+    return remember(cr, key, exclusive);
+  }
+
+
+  /** The bracket following '(' excludes the lower bound when it is ']', the
+   *  bracket preceding '-' excludes the upper bound when it is '['.
+   * \param[in] exclusive true if the chronicle must not be shared
+   * \return the chronicle
+  */
+  Chronicle* ChronicleLoader::parseAbsence(bool exclusive)
+  {
+    bool exclInf = (_text[_pos] == ']');
+    _pos++;
+    Chronicle* left = parseBody(false);
+    skipSpaces();
+    if (_pos >= _text.size() || (_text[_pos] != '[' && _text[_pos] != ']'))
+      error("'[' or ']' expected");
+    bool exclSup = (_text[_pos] == '[');
+    _pos++;
+    skipSpaces();
+    if (!match("-"))
+      error("'-' expected");
+    Chronicle* right = parseAtom(false);
+
+    std::string key = std::string("(") + (exclInf ? "]" : "[") + _keys[left] + (exclSup ? "[" : "]")
+      + "-" + _keys[right] + ")";
+    Chronicle* cr = lookup(key, exclusive);
+    if (cr != NULL)
+    {
+      discard(left);
+      discard(right);
+      return cr;
+    }
+    ChronicleAbsence* absence = new ChronicleAbsence(left, right);
+    absence->setExclInf(exclInf);
+    absence->setExclSup(exclSup);
+    return remember(absence, key, exclusive);
+  }
+
+
+  /** Identifiers are made of letters, digits, '_', '.' and ':'.
+   * \return the identifier, empty if there is none
+  */
+  std::string ChronicleLoader::parseIdentifier()
+  {
+    size_t start = _pos;
+    while (_pos < _text.size() && (isalnum((unsigned char)_text[_pos]) || strchr("_.:", _text[_pos]) != NULL))
+      _pos++;
+    return _text.substr(start, _pos - start);
+  }
+
+
+  /** \param[out] value parsed number
+   * \return false if there is no number at the current position
+  */
+  bool ChronicleLoader::parseNumber(double& value)
+  {
+    const char* begin = _text.c_str() + _pos;
+    char* end = NULL;
+    value = strtod(begin, &end);
+    if (end == begin)
+      return false;
+    _pos += end - begin;
+    return true;
+  }
+
+
+  /** A shared reference is the definition itself. A private copy is built from
+   *  the text of the definition, it shares the sub-chronicles of the definition.
+   * \param[in] name name of the definition
+   * \param[in] exclusive true if a private copy is required
+   * \return the chronicle
+  */
+  Chronicle* ChronicleLoader::reference(const std::string& name, bool exclusive)
+  {
+    if (!exclusive)
+    {
+      Chronicle* cr = _definitions[name];
+      cr->share();
+      _shared[cr]++;
+      return cr;
+    }
+    return parseText(_definitionTexts[name]);
+  }
+
+
+  /** \return true if blanks were skipped
+  */
+  bool ChronicleLoader::skipSpaces()
+  {
+    size_t start = _pos;
+    while (_pos < _text.size() && isspace((unsigned char)_text[_pos]))
+      _pos++;
+    return (_pos != start);
+  }
+
+
+  /** \param[in] token expected token
+   * \return true if \a token was found (and consumed) at the current position
+  */
+  bool ChronicleLoader::match(const char* token)
+  {
+    size_t len = strlen(token);
+    if (_text.compare(_pos, len, token) != 0)
+      return false;
+    _pos += len;
+    return true;
+  }
+
+
+  /** An operand registered for sharing is withdrawn from the shared chronicles if it
+   *  has no other parent, otherwise it is parsed again as a new chronicle.
+   * \param[in] cr operand
+   * \param[in] start position of the operand in the text
+   * \return a chronicle that no other chronicle shares
+  */
+  Chronicle* ChronicleLoader::makeExclusive(Chronicle* cr, size_t start)
+  {
+    if (cr->getShareCount() == 0)
+    {
+      std::unordered_map<std::string, Chronicle*>::iterator it = _built.find(_keys[cr]);
+      if ((it != _built.end()) && (it->second == cr))
+        _built.erase(it);
+      return cr;
+    }
+    size_t end = _pos;
+    discard(cr);
+    _pos = start;
+    cr = parseAtom(true);
+    _pos = end;
+    return cr;
+  }
+
+
+  /** A chronicle found is shared by one more parent.
+   * \param[in] key canonical key of the chronicle
+   * \param[in] exclusive true if a new chronicle is required
+   * \return the shared chronicle, NULL if none
+  */
+  Chronicle* ChronicleLoader::lookup(const std::string& key, bool exclusive)
+  {
+    if (exclusive)
+      return NULL;
+    std::unordered_map<std::string, Chronicle*>::iterator it = _built.find(key);
+    if (it == _built.end())
+      return NULL;
+    it->second->share();
+    _shared[it->second]++;
+    return it->second;
+  }
+
+
+  /** \param[in] cr new chronicle
+   * \param[in] key canonical key of the chronicle
+   * \param[in] exclusive true if the chronicle must not be shared
+   * \return \a cr
+  */
+  Chronicle* ChronicleLoader::remember(Chronicle* cr, const std::string& key, bool exclusive)
+  {
+    _keys[cr] = key;
+    _created.insert(cr);
+    if (!exclusive)
+      _built[key] = cr;
+    return cr;
+  }
+
+
+  /** The operand is unshared, or destroyed with its sub-chronicles if it has no other parent.
+   * \param[in] cr operand
+  */
+  void ChronicleLoader::discard(Chronicle* cr)
+  {
+    if (cr->unshare())
+    {
+      std::map<Chronicle*, int>::iterator itShared = _shared.find(cr);
+      if ((itShared != _shared.end()) && (--itShared->second == 0))
+        _shared.erase(itShared);
+      return;
+    }
+    _created.erase(cr);
+    std::unordered_map<Chronicle*, std::string>::iterator it = _keys.find(cr);
+    if (it != _keys.end())
+    {
+      std::unordered_map<std::string, Chronicle*>::iterator itBuilt = _built.find(it->second);
+      if (itBuilt != _built.end() && itBuilt->second == cr)
+        _built.erase(itBuilt);
+      _keys.erase(it);
+    }
+    Chronicle* child1 = cr->getChild1();
+    Chronicle* child2 = cr->getChild2();
+    cr->destroy();
+    if (child1 != NULL)
+      discard(child1);
+    if (child2 != NULL)
+      discard(child2);
+  }
+
+
+  /** The chronicles built by the expression are destroyed, the existing chronicles
+   *  it shared are given back.
+  */
+  void ChronicleLoader::rollback()
+  {
+    for (std::map<Chronicle*, int>::iterator it = _shared.begin(); it != _shared.end(); it++)
+      if (_created.find(it->first) == _created.end())
+        for (int i = 0; i < it->second; i++)
+          it->first->unshare();
+
+    for (std::set<Chronicle*>::iterator it = _created.begin(); it != _created.end(); it++)
+    {
+      std::unordered_map<Chronicle*, std::string>::iterator itKey = _keys.find(*it);
+      std::unordered_map<std::string, Chronicle*>::iterator itBuilt = _built.find(itKey->second);
+      if ((itBuilt != _built.end()) && (itBuilt->second == *it))
+        _built.erase(itBuilt);
+      _keys.erase(itKey);
+      (*it)->destroy();
+    }
+
+    _created.clear();
+    _shared.clear();
+  }
+
+
+  /** \param[in] msg description of the error
+  */
+  void ChronicleLoader::error(const std::string& msg) const
+  {
+    std::stringstream ss;
+    ss << "ChronicleLoader : " << msg << " at column " << (_pos + 1);
+    if (_line > 0)
+      ss << " of line " << _line;
+    ss << " in \"" << _text << "\"";
+    throw(ss.str());
+  }
+
+} // namespace CRL
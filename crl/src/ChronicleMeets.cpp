@@ -105,19 +105,34 @@ namespace CRL
     if (_alreadyProcessed) 
       return _hasNewRecognitions;
 
+    bool flagLeft  = _opLeft->process(d, e);
+    bool flagRight = _opRight->process(d, e);
+    return processNode(d, e, flagLeft, flagRight);
+  }
+
+
+  /** Processing of the chronicle alone, its members having been processed
+  *   (by #process, or before by ChroniclePlan).
+  *   \param[in] d date at which the evaluation is undertaken
+  *   \param[in] e event to be evaluated
+  *   \param[in] flagLeft true if the left member has new recognitions
+  *   \param[in] flagRight true if the right member has new recognitions
+  */
+  bool ChronicleMeets::processNode(const DateType& d, CRL::Event* e, bool flagLeft, bool flagRight)
+  {
     _hasNewRecognitions = false;
-    _opLeft->process(d, e);
 
-    if (_opRight->process(d, e))
+    if (flagRight)
     {
-      Chronicle::RecoSet::iterator itL, itR;
+      Chronicle::RecoSet::const_iterator itL, itR;
 
       //the new recognitions of Right are merged with the recognitions of Left
       for (itR  = _opRight->getNewRecognitions().begin();
         itR != _opRight->getNewRecognitions().end(); itR++)
       {
-        for (itL  = _opLeft->getRecognitionSet().begin();
-          itL != _opLeft->getRecognitionSet().end(); itL++)
+        const Chronicle::RecoSet& candidates = leftCandidates(**itR);
+        for (itL  = candidates.begin();
+             itL != candidates.end(); itL++)
         {
           if ((*itL)->getMaxOrder() == (*itR)->getMinOrder())
           {
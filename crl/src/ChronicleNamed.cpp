@@ -89,7 +89,23 @@ namespace CRL
     if (_alreadyProcessed) 
       return _hasNewRecognitions;
 
-    if (_myChronicle->process(d, e))
+    bool flagChild = _myChronicle->process(d, e);
+    return processNode(d, e, flagChild);
+  }
+
+
+  /** Processing of the chronicle alone, its member having been processed
+  *   (by #process, or before by ChroniclePlan).
+  *   \param[in] d date at which the evaluation is undertaken
+  *   \param[in] e event to be evaluated
+  *   \param[in] flagChild true if the member has new recognitions
+  */
+  bool ChronicleNamed::processNode(const DateType& d, CRL::Event* e, bool flagChild)
+  {
+    if (_countOnly)
+      return processCount(d, e);
+
+    if (flagChild)
     {
       Chronicle::RecoSet::iterator it;
 
@@ -98,7 +114,7 @@ namespace CRL
       {
         if( applyPredicate(**it) ) // If the predicate is verified or if there is no predicate
         {
-          RecoTree* tmp = new RecoTreeSingle(*it, true);
+          RecoTree* tmp = new RecoTreeSingle(*it);
           tmp->copyDateAndOrder(**it);
           if ( hasOutputFunction() )
           {
@@ -121,6 +137,21 @@ namespace CRL
   }
 
 
+  /** \param[in] d date at which the evaluation is undertaken
+  *   \param[in] e event to be evaluated
+  */
+  bool ChronicleNamed::processCount(const DateType& d, CRL::Event* e)
+  {
+    _myChronicle->process(d, e);
+
+    _newCount = _myChronicle->getNewCount();
+    _count   += _newCount;
+    _hasNewRecognitions = (_newCount > 0.0);
+    _alreadyProcessed = true;
+    return _hasNewRecognitions;
+  }
+
+
 
 
  /** Empties the temporary set of the last recognitions of the
@@ -146,7 +177,7 @@ namespace CRL
   * \param[in] duration indicates the peremption duration
   * \param[in] recursive indicates whether the setting of the peremption duration should be recursive
   */
-    void ChronicleNamed::setPeremptionDuration(double duration, bool recursive)
+    void ChronicleNamed::setPeremptionDuration(DurationType duration, bool recursive)
   {
     Chronicle::setPeremptionDuration(duration, recursive);
     if (recursive)
@@ -176,4 +207,22 @@ namespace CRL
 
 
 
+  /** \return signature, including the sub-chronicle
+  */
+  std::string ChronicleNamed::structuralSignature() const
+  {
+    return Chronicle::structuralSignature() + "[" + _alias + "]"
+           + "(" + _myChronicle->structuralSignature() + ")";
+  }
+
+
+  /** Only the new recognitions of the sub-chronicle are used.
+  *   \param[in] window maximal useful span of the recognitions (negative value: unbounded)
+  */
+  void ChronicleNamed::inferRetentionHorizons(DurationType window)
+  {
+    _myChronicle->mergeRetentionHorizon(0.0);
+    _myChronicle->inferRetentionHorizons(window);
+  }
+
 } /* namespace CRL */
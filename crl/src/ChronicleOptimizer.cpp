@@ -0,0 +1,477 @@
+/** ***********************************************************************************
+ * \file ChronicleOptimizer.cpp
+ * \author Ariane Piel & Jean Bourrely / Onera DCPS
+ * \date 2014
+ * \brief Semantics-preserving rewrites of chronicle trees
+ **************************************************************************************/
+
+/*  Copyright (C) 2012, 2013, 2014  ONERA  http://www.onera.fr
+    This file is part of CRL : Chronicle Recognition Library.
+
+    CRL is free software: you can redistribute it and/or modify it under
+    the terms of the Lesser GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    CRL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    Lesser GNU General Public License for more details.
+
+    You should have received a copy of the Lesser GNU General Public License
+    along with CRL.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// ----------------------------------------------------------------------------
+// INCLUDE FILES
+// ----------------------------------------------------------------------------
+
+#include <cmath>
+#include <limits>
+#include <algorithm>
+
+#include "ChronicleOptimizer.h"
+#include "Operators.h"
+
+
+// ----------------------------------------------------------------------------
+// CLASS METHODS
+// ----------------------------------------------------------------------------
+
+namespace CRL 
+{
+
+  const double ChronicleOptimizer::FILTER_SELECTIVITY = 0.5;
+  const double ChronicleOptimizer::SEQUENCE_SELECTIVITY = 0.5;
+  const double ChronicleOptimizer::RELATION_SELECTIVITY = 0.1;
+
+
+  /** By default, each single event is expected to be recognised once.
+  */
+  ChronicleOptimizer::ChronicleOptimizer()
+    : _defaultCardinality(1.0), _rewriteCount(0)
+  {
+  }
+
+
+  /** \param[in] name name of the event
+  *   \return expected number of recognitions of the event
+  */
+  double ChronicleOptimizer::getEventCardinality(const std::string& name) const
+  {
+    std::map<std::string, double>::const_iterator it = _eventCardinalities.find(name);
+    return (it == _eventCardinalities.end()) ? _defaultCardinality : it->second;
+  }
+
+
+  /** The rewrites preserve the recognitions of the chronicle, but not the shape
+  *   of the recognition trees of its sub-chronicles. Only the sub-chronicles of
+  *   the library without name, user function, peremption duration, budget,
+  *   equi-join key nor selection policy are rewritten, and only before the chronicle processes events:
+  *   \li DelayAtMost (resp. DelayAtLeast) of a DelayAtMost (resp. DelayAtLeast)
+  *       -> one filter with the tightest delay,
+  *   \li absence of an absence with the same bounds -> absence of the disjunction
+  *       of the undesired chronicles, if cheaper,
+  *   \li chain of sequences (resp. conjunctions) -> cheapest association
+  *       (dynamic programming over the cardinality model),
+  *   \li DelayAtMost of a sequence (resp. conjunction) -> same filter on the
+  *       members too, if cheaper.
+  *
+  *   Count-only chronicle trees are left as they are: their cost is already
+  *   constant per node, and a new association could break their count-only
+  *   support (see Chronicle::setCountOnly).
+  *
+  *   The chronicles of a rewritten tree are marked (see Chronicle::isRewritten):
+  *   a peremption duration set later would apply to other sub-chronicles than
+  *   those of the original tree, and is refused.
+  *   \param[in] cr root of the chronicle tree (kept as root)
+  */
+  void ChronicleOptimizer::optimize(Chronicle* cr)
+  {
+    if ( (cr == NULL) || !cr->getRecognitionSet().empty() || cr->isCountOnly() )
+      return;
+    unsigned long rewriteCount = _rewriteCount;
+    optimizeNode(cr);
+    if (_rewriteCount != rewriteCount)
+      markRewritten(cr);
+  }
+
+
+  /** \param[in] cr chronicle, marked with its sub-chronicles
+  */
+  void ChronicleOptimizer::markRewritten(Chronicle* cr)
+  {
+    if (cr == NULL) return;
+    cr->setRewritten(true);
+    markRewritten(cr->getChild1());
+    markRewritten(cr->getChild2());
+  }
+
+
+  /** Simple model: a single event is recognised #getEventCardinality times,
+  *   a join yields the product of the cardinalities of its members times
+  *   the selectivity of its temporal relation, a filter keeps
+  *   #FILTER_SELECTIVITY of the recognitions of its member.
+  *   \param[in] cr chronicle
+  *   \return expected number of recognitions
+  */
+  double ChronicleOptimizer::estimateCardinality(Chronicle* cr) const
+  {
+    if (dynamic_cast<ChronicleSingleEvent*>(cr) != NULL)
+      return getEventCardinality(static_cast<ChronicleSingleEvent*>(cr)->getCode());
+    if (dynamic_cast<ChronicleSingleDate*>(cr) != NULL)
+      return 1.0;
+
+    Chronicle* child1 = cr->getChild1();
+    Chronicle* child2 = cr->getChild2();
+    double card1 = (child1 == NULL) ? _defaultCardinality : estimateCardinality(child1);
+    if (child2 == NULL)
+    {
+      if ( (dynamic_cast<ChronicleDelayAtMost*>(cr) != NULL)
+        || (dynamic_cast<ChronicleDelayAtLeast*>(cr) != NULL)
+        || (dynamic_cast<ChronicleDelayLasts*>(cr) != NULL) )
+        return card1 * FILTER_SELECTIVITY;
+      return card1;
+    }
+
+    double card2 = estimateCardinality(child2);
+    if (dynamic_cast<ChronicleSequence*>(cr) != NULL)
+      return card1 * card2 * SEQUENCE_SELECTIVITY;
+    if (dynamic_cast<ChronicleConjunction*>(cr) != NULL)
+      return card1 * card2;
+    if (dynamic_cast<ChronicleDisjunction*>(cr) != NULL)
+      return card1 + card2;
+    if (dynamic_cast<ChronicleAbsence*>(cr) != NULL)
+      return card1 * FILTER_SELECTIVITY;
+    if ( (dynamic_cast<ChronicleCut*>(cr) != NULL) || (dynamic_cast<ChronicleStateChange*>(cr) != NULL) )
+      return std::min(card1, card2);
+    return card1 * card2 * RELATION_SELECTIVITY;
+  }
+
+
+  /** \param[in] cr chronicle
+  *   \return expected number of recognitions of the chronicle and of its sub-chronicles
+  */
+  double ChronicleOptimizer::estimateCost(Chronicle* cr) const
+  {
+    double cost = estimateCardinality(cr);
+    if (cr->getChild1() != NULL)
+      cost += estimateCost(cr->getChild1());
+    if (cr->getChild2() != NULL)
+      cost += estimateCost(cr->getChild2());
+    return cost;
+  }
+
+
+  /** \param[in] cr chronicle
+  */
+  void ChronicleOptimizer::optimizeNode(Chronicle* cr)
+  {
+    if (cr->getChild1() != NULL)
+      optimizeNode(cr->getChild1());
+    if (cr->getChild2() != NULL)
+      optimizeNode(cr->getChild2());
+
+    fuseFilters(cr);
+    fuseAbsences(cr);
+    reassociate(cr);
+    pushDownFilter(cr);
+  }
+
+
+  /** \param[in] cr chronicle
+  *   \return true if the chronicle has been rewritten
+  */
+  bool ChronicleOptimizer::fuseFilters(Chronicle* cr)
+  {
+    const std::type_info& type = typeid(*cr);
+    if ( (type != typeid(ChronicleDelayAtMost)) && (type != typeid(ChronicleDelayAtLeast)) )
+      return false;
+
+    ChronicleDelayOp* filter = static_cast<ChronicleDelayOp*>(cr);
+    bool rewritten = false;
+    while ( (typeid(*filter->getOpLeft()) == type) && isPlain(filter->getOpLeft()) )
+    {
+      ChronicleDelayOp* inner = static_cast<ChronicleDelayOp*>(filter->getOpLeft());
+      if (type == typeid(ChronicleDelayAtMost))
+        filter->setDelay(std::min(filter->getDelay(), inner->getDelay()));
+      else
+        filter->setDelay(std::max(filter->getDelay(), inner->getDelay()));
+      filter->setOpLeft(inner->getOpLeft());
+      inner->destroy();
+      _rewriteCount++;
+      rewritten = true;
+    }
+    return rewritten;
+  }
+
+
+  /** \code ([ [X]-C ]-D) -> ([X]-(C||D)) \endcode when both absences have the same
+  *   bounds and no predicate.
+  *   \param[in] cr chronicle
+  *   \return true if the chronicle has been rewritten
+  */
+  bool ChronicleOptimizer::fuseAbsences(Chronicle* cr)
+  {
+    if (typeid(*cr) != typeid(ChronicleAbsence))
+      return false;
+
+    ChronicleAbsence* outer = static_cast<ChronicleAbsence*>(cr);
+    if ( outer->hasPredicateFunction() || outer->hasJoinKeys() )
+      return false;
+    if ( (typeid(*outer->getOpLeft()) != typeid(ChronicleAbsence)) || !isPlain(outer->getOpLeft()) )
+      return false;
+
+    ChronicleAbsence* inner = static_cast<ChronicleAbsence*>(outer->getOpLeft());
+    if ( (inner->isExclInf() != outer->isExclInf()) || (inner->isExclSup() != outer->isExclSup()) )
+      return false;
+
+    double before = estimateCardinality(inner) + estimateCardinality(outer);
+    double after  = estimateCardinality(inner->getOpRight()) + estimateCardinality(outer->getOpRight())
+                  + estimateCardinality(inner->getOpLeft()) * FILTER_SELECTIVITY;
+    if (after >= before)
+      return false;
+
+    Chronicle* undesired = new ChronicleDisjunction(inner->getOpRight(), outer->getOpRight());
+    undesired->setPurgeable(false);
+    if (outer->getMyEngine() != NULL)
+      undesired->setMyEngine(outer->getMyEngine());
+    outer->setOpLeft(inner->getOpLeft());
+    outer->setOpRight(undesired);
+    inner->destroy();
+    _rewriteCount++;
+    return true;
+  }
+
+
+  /** The members of the chain keep their order, only the association changes.
+  *   \param[in] cr chronicle
+  *   \return true if the chronicle has been rewritten
+  */
+  bool ChronicleOptimizer::reassociate(Chronicle* cr)
+  {
+    const std::type_info& type = typeid(*cr);
+    bool sequence = (type == typeid(ChronicleSequence));
+    if ( !sequence && (type != typeid(ChronicleConjunction)) )
+      return false;
+
+    ChronicleBinaryOp* op = static_cast<ChronicleBinaryOp*>(cr);
+    if (op->hasJoinKeys() || !op->hasDefaultSelection())
+      return false;
+
+    std::vector<Chronicle*> members, links;
+    flattenChain(op->getOpLeft(), type, members, links);
+    flattenChain(op->getOpRight(), type, members, links);
+    size_t n = members.size();
+    if (n < 3)
+      return false;
+
+    // Cost of the current association (the root is common to all the associations)
+    double current = 0.0;
+    for (size_t i = 0; i < links.size(); i++)
+      current += estimateCardinality(links[i]);
+
+    std::vector<double> cards(n);
+    for (size_t i = 0; i < n; i++)
+      cards[i] = estimateCardinality(members[i]);
+
+    std::vector<std::vector<size_t> > splits;
+    double best = planChain(cards, sequence ? SEQUENCE_SELECTIVITY : 1.0, splits);
+    if (best >= current * (1.0 - 1e-9))
+      return false;
+
+    size_t k = splits[0][n-1];
+    Chronicle* left  = buildChain(members, splits, 0, k, sequence);
+    Chronicle* right = buildChain(members, splits, k+1, n-1, sequence);
+    left->setPurgeable(false);
+    if (!sequence)
+      right->setPurgeable(false);
+    if (cr->getMyEngine() != NULL)
+    {
+      left->setMyEngine(cr->getMyEngine());
+      right->setMyEngine(cr->getMyEngine());
+    }
+    op->setOpLeft(left);
+    op->setOpRight(right);
+
+    for (size_t i = 0; i < links.size(); i++)
+      links[i]->destroy();
+    _rewriteCount++;
+    return true;
+  }
+
+
+  /** \code ((X Y)<<d) -> (((X<<d) (Y<<d))<<d) \endcode : the recognitions of a
+  *   sequence or a conjunction last at least as long as those of its members.
+  *   Single events and dates last zero and are never filtered.
+  *   \param[in] cr chronicle
+  *   \return true if the chronicle has been rewritten
+  */
+  bool ChronicleOptimizer::pushDownFilter(Chronicle* cr)
+  {
+    if (typeid(*cr) != typeid(ChronicleDelayAtMost))
+      return false;
+
+    ChronicleDelayOp* filter = static_cast<ChronicleDelayOp*>(cr);
+    Chronicle* join = filter->getOpLeft();
+    if ( ( (typeid(*join) != typeid(ChronicleSequence)) && (typeid(*join) != typeid(ChronicleConjunction)) )
+      || !isPlain(join) )
+      return false;
+
+    bool rewritten = false;
+    for (int i = 1; i <= 2; i++)
+    {
+      Chronicle* member = (i == 1) ? join->getChild1() : join->getChild2();
+      const std::type_info& type = typeid(*member);
+      if ( (type == typeid(ChronicleSingleEvent)) || (type == typeid(ChronicleSingleDate)) )
+        continue;
+
+      if ( (type == typeid(ChronicleDelayAtMost)) && isPlain(member) )
+      {
+        ChronicleDelayOp* memberFilter = static_cast<ChronicleDelayOp*>(member);
+        if (memberFilter->getDelay() > filter->getDelay())
+        {
+          memberFilter->setDelay(filter->getDelay());
+          _rewriteCount++;
+          rewritten = true;
+        }
+        continue;
+      }
+
+      double before = estimateCost(cr);
+      Chronicle* memberFilter = new ChronicleDelayAtMost(member, filter->getDelay());
+      memberFilter->setPurgeable(member->isPurgeable());
+      if (i == 1)
+        join->setChild1(memberFilter);
+      else
+        join->setChild2(memberFilter);
+
+      if (estimateCost(cr) < before)
+      {
+        if (cr->getMyEngine() != NULL)
+          memberFilter->setMyEngine(cr->getMyEngine());
+        _rewriteCount++;
+        rewritten = true;
+        pushDownFilter(memberFilter);
+      }
+      else
+      {
+        if (i == 1)
+          join->setChild1(member);
+        else
+          join->setChild2(member);
+        memberFilter->destroy();
+      }
+    }
+    return rewritten;
+  }
+
+
+  /** Dynamic programming over the sub-chains, as for matrix chain products:
+  *   the cost of an association is the sum of the cardinalities of its
+  *   intermediate chronicles.
+  *   \param[in] cards estimated cardinalities of the members
+  *   \param[in] selectivity fraction of the pairs kept by each link of the chain
+  *   \param[out] splits splits[i][j] : the sub-chain of members i to j is split after member splits[i][j]
+  *   \return cost of the cheapest association, the root being excluded
+  */
+  double ChronicleOptimizer::planChain(const std::vector<double>& cards, double selectivity,
+                                       std::vector<std::vector<size_t> >& splits)
+  {
+    size_t n = cards.size();
+    std::vector<std::vector<double> > best(n, std::vector<double>(n, 0.0));
+    splits.assign(n, std::vector<size_t>(n, 0));
+    for (size_t len = 2; len <= n; len++)
+      for (size_t i = 0; i + len <= n; i++)
+      {
+        size_t j = i + len - 1;
+        best[i][j] = std::numeric_limits<double>::max();
+        for (size_t k = i; k < j; k++)
+        {
+          double cost = best[i][k] + best[k+1][j];
+          if (cost < best[i][j])
+          {
+            best[i][j] = cost;
+            splits[i][j] = k;
+          }
+        }
+        if (len < n)
+          best[i][j] += chainCardinality(cards, i, j, selectivity);
+      }
+    return (n == 0) ? 0.0 : best[0][n-1];
+  }
+
+
+  /** \param[in] cr chronicle
+  *   \param[in] type type of the chain
+  *   \param[out] members members of the chain, in order
+  *   \param[out] links chronicles of the chain (except the root)
+  */
+  void ChronicleOptimizer::flattenChain(Chronicle* cr, const std::type_info& type,
+                                        std::vector<Chronicle*>& members, std::vector<Chronicle*>& links)
+  {
+    if ( (typeid(*cr) == type) && isPlain(cr) )
+    {
+      links.push_back(cr);
+      flattenChain(cr->getChild1(), type, members, links);
+      flattenChain(cr->getChild2(), type, members, links);
+    }
+    else
+      members.push_back(cr);
+  }
+
+
+  /** \param[in] cards estimated cardinalities of the members
+  *   \param[in] first index of the first member
+  *   \param[in] last index of the last member
+  *   \param[in] selectivity fraction of the pairs kept by each link of the chain
+  *   \return estimated number of recognitions
+  */
+  double ChronicleOptimizer::chainCardinality(const std::vector<double>& cards, size_t first, size_t last,
+                                              double selectivity)
+  {
+    double card = 1.0;
+    for (size_t i = first; i <= last; i++)
+      card *= cards[i];
+    return card * pow(selectivity, (double)(last - first));
+  }
+
+
+  /** \param[in] members members of the chain
+  *   \param[in] splits best split of each sub-chain
+  *   \param[in] first index of the first member
+  *   \param[in] last index of the last member
+  *   \param[in] sequence true for a chain of sequences, false for conjunctions
+  *   \return the chronicle
+  */
+  Chronicle* ChronicleOptimizer::buildChain(const std::vector<Chronicle*>& members,
+                                            const std::vector<std::vector<size_t> >& splits,
+                                            size_t first, size_t last, bool sequence)
+  {
+    if (first == last)
+      return members[first];
+
+    size_t k = splits[first][last];
+    Chronicle* left  = buildChain(members, splits, first, k, sequence);
+    Chronicle* right = buildChain(members, splits, k+1, last, sequence);
+    if (sequence)
+      return new ChronicleSequence(left, right);
+    else
+      return new ChronicleConjunction(left, right);
+  }
+
+
+  /** \param[in] cr chronicle
+  *   \return true if the chronicle may be rewritten
+  */
+  bool ChronicleOptimizer::isPlain(Chronicle* cr)
+  {
+    ChronicleBinaryOp* op = dynamic_cast<ChronicleBinaryOp*>(cr);
+    return ( (cr->getShareCount() == 0) && (cr->getName() == "")
+          && !cr->hasPredicateFunction() && !cr->hasOutputFunction() && !cr->hasActionFunction()
+          && (cr->getPeremptionDuration() < 0.0) && (cr->getRecognitionBudget() < 0)
+          && cr->getRecognitionSet().empty() && cr->getNewRecognitions().empty()
+          && ( (op == NULL) || (!op->hasJoinKeys() && op->hasDefaultSelection()) ) );
+  }
+
+} // namespace CRL
@@ -105,41 +105,54 @@ namespace CRL
     if (_alreadyProcessed) 
       return _hasNewRecognitions;
 
+    bool flagLeft  = _opLeft->process(d, e);
+    bool flagRight = _opRight->process(d, e);
+    return processNode(d, e, flagLeft, flagRight);
+  }
+
+
+  /** Processing of the chronicle alone, its members having been processed
+  *   (by #process, or before by ChroniclePlan).
+  *   \param[in] d date at which the evaluation is undertaken
+  *   \param[in] e event to be evaluated
+  *   \param[in] flagLeft true if the left member has new recognitions
+  *   \param[in] flagRight true if the right member has new recognitions
+  */
+  bool ChronicleOverlaps::processNode(const DateType& d, CRL::Event* e, bool flagLeft, bool flagRight)
+  {
     _hasNewRecognitions = false;
-    _opLeft->process(d, e);
 
-    if (_opRight->process(d, e))
+    if (flagRight)
     {
-      Chronicle::RecoSet::iterator itL, itR;
+      Chronicle::RecoSet::const_iterator itR;
+      std::vector<RecoTree*> matches;
 
        //the new recognitions of Right are merged with the recognitions of Left
       for (itR  = _opRight->getNewRecognitions().begin();
            itR != _opRight->getNewRecognitions().end(); itR++)
       {
-        for (itL  = _opLeft->getRecognitionSet().begin();
-             itL != _opLeft->getRecognitionSet().end(); itL++)
+        // Left recognitions beginning before the right one, and ending during it
+        leftMatches(**itR, RecoColumns::NO_LOWER_BOUND, (*itR)->getMinOrder(),
+                    (*itR)->getMinOrder(), (*itR)->getMaxOrder(), matches);
+        for (size_t i=0; i<matches.size(); i++)
         {
-          if (   ((*itL)->getMinOrder() < (*itR)->getMinOrder())
-              && ((*itR)->getMinOrder() < (*itL)->getMaxOrder())
-              && ((*itL)->getMaxOrder() < (*itR)->getMaxOrder())  )
-          {
-            PropertyManager x1x2;  // Union of the properties, except anonymous
-            x1x2.copyProperties(**itL, true, false);
-            x1x2.copyProperties(**itR, true, false); 
+          RecoTree* l = matches[i];
+          PropertyManager x1x2;  // Union of the properties, except anonymous
+          x1x2.copyProperties(*l, true, false);
+          x1x2.copyProperties(**itR, true, false); 
 
-            if ( applyPredicate(x1x2) )
+          if ( applyPredicate(x1x2) )
+          {
+            RecoTree* tmp = new RecoTreeCouple(l, *itR);
+            tmp->copyDateAndOrder(*l, **itR);
+            tmp->copyProperties(x1x2, false, false); // Untransfer ownership
+            if ( hasOutputFunction() )
             {
-              RecoTree* tmp = new RecoTreeCouple(*itL, *itR);
-              tmp->copyDateAndOrder(**itL, **itR);
-              tmp->copyProperties(x1x2, false, false); // Untransfer ownership
-              if ( hasOutputFunction() )
-              {
-                PropertyManager pm;
-                applyOutputFunction(x1x2, pm);
-                tmp->upgradeProperties(pm, true, true); // Transfer ownership
-              }
-              applyActionFunction(tmp);
+              PropertyManager pm;
+              applyOutputFunction(x1x2, pm);
+              tmp->upgradeProperties(pm, true, true); // Transfer ownership
             }
+            applyActionFunction(tmp);
           }
         }
       }
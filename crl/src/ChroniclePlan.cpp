@@ -0,0 +1,243 @@
+/** ***********************************************************************************
+ * \file ChroniclePlan.cpp
+ * \author Ariane Piel & Jean Bourrely / Onera DCPS
+ * \date 2014
+ * \brief Compiled execution plan of trees of chronicles
+ **************************************************************************************/
+
+/*  Copyright (C) 2012, 2013, 2014  ONERA  http://www.onera.fr
+    This file is part of CRL : Chronicle Recognition Library.
+
+    CRL is free software: you can redistribute it and/or modify it under
+    the terms of the Lesser GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    CRL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    Lesser GNU General Public License for more details.
+
+    You should have received a copy of the Lesser GNU General Public License
+    along with CRL.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// ----------------------------------------------------------------------------
+// INCLUDE FILES
+// ----------------------------------------------------------------------------
+
+#include <typeinfo>
+
+#include "Operators.h"
+#include "ChroniclePlan.h"
+
+
+// ----------------------------------------------------------------------------
+// CLASS METHODS
+// ----------------------------------------------------------------------------
+
+namespace CRL 
+{
+
+  /** The exact class is compared: a sub-class of a library operator may
+  *   redefine its processing, it is an OTHER chronicle.
+  *   \param[in] cr chronicle
+  *   \return operator
+  */
+  ChroniclePlan::Operator ChroniclePlan::operatorOf(Chronicle* cr)
+  {
+    const std::type_info& t = typeid(*cr);
+    if (t == typeid(ChronicleSingleEvent))  return SINGLE_EVENT;
+    if (t == typeid(ChronicleSingleDate))   return SINGLE_DATE;
+    if (t == typeid(ChronicleSequence))     return SEQUENCE;
+    if (t == typeid(ChronicleDuring))       return DURING;
+    if (t == typeid(ChronicleOverlaps))     return OVERLAPS;
+    if (t == typeid(ChronicleEquals))       return EQUALS;
+    if (t == typeid(ChronicleStarts))       return STARTS;
+    if (t == typeid(ChronicleFinishes))     return FINISHES;
+    if (t == typeid(ChronicleMeets))        return MEETS;
+    if (t == typeid(ChronicleConjunction))  return CONJUNCTION;
+    if (t == typeid(ChronicleDisjunction))  return DISJUNCTION;
+    if (t == typeid(ChronicleCut))          return CUT;
+    if (t == typeid(ChronicleAbsence))      return ABSENCE;
+    if (t == typeid(ChronicleStateChange))  return STATE_CHANGE;
+    if (t == typeid(ChronicleNamed))        return NAMED;
+    if (t == typeid(ChronicleAt))           return AT;
+    if (t == typeid(ChronicleDelayAtLeast)) return DELAY_AT_LEAST;
+    if (t == typeid(ChronicleDelayAtMost))  return DELAY_AT_MOST;
+    if (t == typeid(ChronicleDelayLasts))   return DELAY_LASTS;
+    if (t == typeid(ChronicleDelayThen))    return DELAY_THEN;
+    return OTHER;
+  }
+
+
+  /** The kinds are given to the library operators only: a chronicle of 
+  *   any other class (user sub-class) is processed at every event.
+  *   \param[in] cr chronicle
+  *   \return kind of operator
+  */
+  ChroniclePlan::OperatorKind ChroniclePlan::kindOf(Chronicle* cr)
+  {
+    switch (operatorOf(cr))
+    {
+      case SINGLE_EVENT:
+        return LEAF_EVENT;
+      case SEQUENCE: case DURING: case OVERLAPS: case EQUALS:
+      case STARTS: case FINISHES: case MEETS:
+        return RIGHT_DRIVEN;
+      case CONJUNCTION: case DISJUNCTION: case CUT:
+        return EITHER_DRIVEN;
+      case NAMED: case AT: case DELAY_AT_LEAST: case DELAY_AT_MOST: case DELAY_LASTS:
+        return CHILD_DRIVEN;
+      default:
+        return ALWAYS;
+    }
+  }
+
+
+  /** The chronicles shared by several parents (or several roots) get a
+  *   single step. The new recognitions of a chronicle are kept from one 
+  *   event to the next only if all its parents are delays THEN, like with 
+  *   the recursive Chronicle::purgeNewRecognitions().
+  *   The plan has to be compiled again when the trees are modified.
+  *   \param[in] roots chronicles to be recognised
+  */
+  void ChroniclePlan::compile(const std::list<Chronicle*>& roots)
+  {
+    clear();
+    std::map<Chronicle*, int> steps;
+    std::list<Chronicle*>::const_iterator it;
+    for (it=roots.begin(); it!=roots.end(); it++)
+      addSteps(*it, steps);
+
+    for (size_t i=0; i<_steps.size(); i++)
+      _steps[i].keepNewRecognitions = true;
+    for (it=roots.begin(); it!=roots.end(); it++)
+      _steps[steps[*it]].keepNewRecognitions = false;
+    for (size_t i=0; i<_steps.size(); i++)
+    {
+      bool delayThen = (typeid(*_steps[i].node) == typeid(ChronicleDelayThen));
+      if ( (_steps[i].child1 >= 0) && !delayThen )
+        _steps[_steps[i].child1].keepNewRecognitions = false;
+      if (_steps[i].child2 >= 0)
+        _steps[_steps[i].child2].keepNewRecognitions = false;
+    }
+    _hasNew.assign(_steps.size(), 0);
+  }
+
+
+  /** \param[in] cr root of the tree
+  *   \param[in,out] steps steps of the chronicles already in the plan
+  *   \return step of \a cr
+  */
+  int ChroniclePlan::addSteps(Chronicle* cr, std::map<Chronicle*, int>& steps)
+  {
+    std::map<Chronicle*, int>::iterator it = steps.find(cr);
+    if (it != steps.end())
+      return it->second;
+
+    Step s;
+    s.node   = cr;
+    s.op     = operatorOf(cr);
+    s.kind   = kindOf(cr);
+    s.child1 = (cr->getChild1() != NULL) ? addSteps(cr->getChild1(), steps) : -1;
+    s.child2 = (cr->getChild2() != NULL) ? addSteps(cr->getChild2(), steps) : -1;
+    s.code   = (s.kind == LEAF_EVENT) ? &(static_cast<ChronicleSingleEvent*>(cr)->getCode()) : NULL;
+    s.keepNewRecognitions = false;
+    _steps.push_back(s);
+    steps[cr] = (int)_steps.size() - 1;
+    return (int)_steps.size() - 1;
+  }
+
+
+  /** The sub-chronicles being processed before their parents, each chronicle
+  *   reads the new recognitions of its members from their steps (see
+  *   #processStep). A chronicle which cannot have new recognitions at this
+  *   event (see #OperatorKind) is not processed at all.
+  *   \param[in] d date at which the evaluation is undertaken
+  *   \param[in] e event to be evaluated
+  */
+  void ChroniclePlan::process(const DateType& d, CRL::Event* e)
+  {
+    for (size_t i=0; i<_steps.size(); i++)
+    {
+      const Step& s = _steps[i];
+      bool idle;
+      switch (s.kind)
+      {
+        case LEAF_EVENT:
+          idle = (e == NULL) || (e->getName() != *s.code);
+          break;
+        case RIGHT_DRIVEN:
+          idle = !_hasNew[s.child2];
+          break;
+        case EITHER_DRIVEN:
+          idle = !_hasNew[s.child1] && !_hasNew[s.child2];
+          break;
+        case CHILD_DRIVEN:
+          idle = !_hasNew[s.child1];
+          break;
+        default:
+          idle = false;
+      }
+      if (idle)
+        s.node->skipProcess();
+      else
+        processStep(s, d, e);
+      _hasNew[i] = s.node->hasNewRecognitions();
+    }
+  }
+
+
+  /** The library operators are called without virtual dispatch nor recursion:
+  *   their members have been processed by their own steps. The chronicles of
+  *   other classes are processed by Chronicle::process(), whose recursive
+  *   calls stop at once on the members already processed.
+  *   \param[in] s step
+  *   \param[in] d date at which the evaluation is undertaken
+  *   \param[in] e event to be evaluated
+  */
+  void ChroniclePlan::processStep(const Step& s, const DateType& d, CRL::Event* e)
+  {
+    bool flag1 = (s.child1 >= 0) && _hasNew[s.child1];
+    bool flag2 = (s.child2 >= 0) && _hasNew[s.child2];
+    switch (s.op)
+    {
+      case SINGLE_EVENT:   static_cast<ChronicleSingleEvent*>(s.node)->ChronicleSingleEvent::process(d, e); break;
+      case SINGLE_DATE:    static_cast<ChronicleSingleDate*>(s.node)->ChronicleSingleDate::process(d, e); break;
+      case SEQUENCE:       static_cast<ChronicleSequence*>(s.node)->processNode(d, e, flag1, flag2); break;
+      case DURING:         static_cast<ChronicleDuring*>(s.node)->processNode(d, e, flag1, flag2); break;
+      case OVERLAPS:       static_cast<ChronicleOverlaps*>(s.node)->processNode(d, e, flag1, flag2); break;
+      case EQUALS:         static_cast<ChronicleEquals*>(s.node)->processNode(d, e, flag1, flag2); break;
+      case STARTS:         static_cast<ChronicleStarts*>(s.node)->processNode(d, e, flag1, flag2); break;
+      case FINISHES:       static_cast<ChronicleFinishes*>(s.node)->processNode(d, e, flag1, flag2); break;
+      case MEETS:          static_cast<ChronicleMeets*>(s.node)->processNode(d, e, flag1, flag2); break;
+      case CONJUNCTION:    static_cast<ChronicleConjunction*>(s.node)->processNode(d, e, flag1, flag2); break;
+      case DISJUNCTION:    static_cast<ChronicleDisjunction*>(s.node)->processNode(d, e, flag1, flag2); break;
+      case CUT:            static_cast<ChronicleCut*>(s.node)->processNode(d, e, flag1, flag2); break;
+      case ABSENCE:        static_cast<ChronicleAbsence*>(s.node)->processNode(d, e, flag1, flag2); break;
+      case STATE_CHANGE:   static_cast<ChronicleStateChange*>(s.node)->processNode(d, e, flag1, flag2); break;
+      case NAMED:          static_cast<ChronicleNamed*>(s.node)->processNode(d, e, flag1); break;
+      case AT:             static_cast<ChronicleAt*>(s.node)->processNode(d, e, flag1); break;
+      case DELAY_AT_LEAST: static_cast<ChronicleDelayAtLeast*>(s.node)->processNode(d, e, flag1); break;
+      case DELAY_AT_MOST:  static_cast<ChronicleDelayAtMost*>(s.node)->processNode(d, e, flag1); break;
+      case DELAY_LASTS:    static_cast<ChronicleDelayLasts*>(s.node)->processNode(d, e, flag1); break;
+      case DELAY_THEN:     static_cast<ChronicleDelayThen*>(s.node)->processNode(d, e, flag1); break;
+      default:             s.node->process(d, e);
+    }
+  }
+
+
+  /** Only the sets of each chronicle are emptied (see 
+  *   Chronicle::purgeNewRecognitions()), the sub-chronicles having their own steps.
+  */
+  void ChroniclePlan::purgeNewRecognitions()
+  {
+    for (size_t i=0; i<_steps.size(); i++)
+      _steps[i].node->Chronicle::purgeNewRecognitions(_steps[i].keepNewRecognitions);
+    for (size_t i=0; i<_steps.size(); i++)
+      _steps[i].node->Chronicle::purgeRecognitionsIfPurgeable();
+  }
+
+
+} /* namespace CRL */
@@ -0,0 +1,368 @@
+/** ***********************************************************************************
+ * \file ChronicleReplanner.cpp
+ * \author Ariane Piel & Jean Bourrely / Onera DCPS
+ * \date 2014
+ * \brief Adaptive re-planning of chains of sequences and conjunctions
+ **************************************************************************************/
+
+/*  Copyright (C) 2012, 2013, 2014  ONERA  http://www.onera.fr
+    This file is part of CRL : Chronicle Recognition Library.
+
+    CRL is free software: you can redistribute it and/or modify it under
+    the terms of the Lesser GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    CRL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    Lesser GNU General Public License for more details.
+
+    You should have received a copy of the Lesser GNU General Public License
+    along with CRL.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// ----------------------------------------------------------------------------
+// INCLUDE FILES
+// ----------------------------------------------------------------------------
+
+#include <cmath>
+#include <climits>
+#include <algorithm>
+
+#include "ChronicleReplanner.h"
+#include "ChronicleOptimizer.h"
+#include "ChronicleSequence.h"
+#include "ChronicleConjunction.h"
+#include "RecoTreeCouple.h"
+#include "PropertyManager.h"
+
+
+// ----------------------------------------------------------------------------
+// CLASS METHODS
+// ----------------------------------------------------------------------------
+
+namespace CRL 
+{
+
+  const double ChronicleReplanner::DECAY = 0.5;
+
+
+  /** By default, adaptive planning is off, and a new plan must be 25% cheaper
+  *   than the current one to be adopted.
+  */
+  ChronicleReplanner::ChronicleReplanner()
+    : _period(0), _eventCount(0), _replanCount(0), _threshold(0.75)
+  {
+  }
+
+
+  /** Destroys the links replaced by the former plans.
+  */
+  ChronicleReplanner::~ChronicleReplanner()
+  {
+    std::list<Chronicle*>::iterator it;
+    for (it = _retiredLinks.begin(); it != _retiredLinks.end(); it++)
+      (*it)->destroy();
+  }
+
+
+  /** The members of the chains keep their whole recognition sets (they are not
+  *   purgeable anymore), so that any association may be rebuilt from them.
+  *   Count-only chronicle trees have no recognition to rebuild from: ignored.
+  *   \param[in] cr root of the chronicle tree
+  */
+  void ChronicleReplanner::addChronicle(Chronicle* cr)
+  {
+    if (cr->isCountOnly())
+      return;
+    findChains(cr);
+  }
+
+
+  /** \param[in] cr chronicle
+  */
+  void ChronicleReplanner::findChains(Chronicle* cr)
+  {
+    const std::type_info& type = typeid(*cr);
+    if ( (type == typeid(ChronicleSequence)) || (type == typeid(ChronicleConjunction)) )
+    {
+      ChronicleBinaryOp* root = static_cast<ChronicleBinaryOp*>(cr);
+      std::vector<Chronicle*> members, links;
+      if (!root->hasJoinKeys() && root->hasDefaultSelection())
+      {
+        flattenChain(root->getOpLeft(), type, members, links);
+        flattenChain(root->getOpRight(), type, members, links);
+      }
+
+      std::list<Chain>::iterator it;
+      for (it = _chains.begin(); (it != _chains.end()) && (it->root != root); it++) ;
+      if ( (members.size() >= 3) && (it == _chains.end()) )
+      {
+        Chain chain;
+        chain.root = root;
+        chain.sequence = (type == typeid(ChronicleSequence));
+        chain.members = members;
+        chain.arrivals.assign(members.size(), 0.0);
+        chain.produced = 0.0;
+        for (size_t i = 0; i < members.size(); i++)
+          members[i]->setPurgeable(false);
+        _chains.push_back(chain);
+
+        for (size_t i = 0; i < members.size(); i++)
+          findChains(members[i]);
+        return;
+      }
+    }
+
+    if (cr->getChild1() != NULL)
+      findChains(cr->getChild1());
+    if (cr->getChild2() != NULL)
+      findChains(cr->getChild2());
+  }
+
+
+  /** Unlike ChronicleOptimizer::flattenChain, the links may already hold
+  *   recognitions and have a peremption duration (see #replan).
+  *   \param[in] cr chronicle
+  *   \param[in] type type of the chain
+  *   \param[out] members members of the chain, in order
+  *   \param[out] links chronicles of the chain (except the root)
+  */
+  void ChronicleReplanner::flattenChain(Chronicle* cr, const std::type_info& type,
+                                        std::vector<Chronicle*>& members, std::vector<Chronicle*>& links)
+  {
+    if ( (typeid(*cr) == type) && (cr->getShareCount() == 0) && (cr->getName() == "")
+      && !cr->hasPredicateFunction() && !cr->hasOutputFunction() && !cr->hasActionFunction()
+      && (cr->getRecognitionBudget() < 0) && !static_cast<ChronicleBinaryOp*>(cr)->hasJoinKeys()
+      && static_cast<ChronicleBinaryOp*>(cr)->hasDefaultSelection() )
+    {
+      links.push_back(cr);
+      flattenChain(cr->getChild1(), type, members, links);
+      flattenChain(cr->getChild2(), type, members, links);
+    }
+    else
+      members.push_back(cr);
+  }
+
+
+  /** Counts the new recognitions of the members and of the root of each chain.
+  */
+  void ChronicleReplanner::observe()
+  {
+    _eventCount++;
+    std::list<Chain>::iterator it;
+    for (it = _chains.begin(); it != _chains.end(); it++)
+    {
+      for (size_t i = 0; i < it->members.size(); i++)
+        it->arrivals[i] += it->members[i]->getNewRecognitions().size();
+      it->produced += it->root->getNewRecognitions().size();
+    }
+  }
+
+
+  /** \return true if a plan has changed
+  */
+  bool ChronicleReplanner::replanIfDue()
+  {
+    if ( (_period == 0) || (_eventCount == 0) || ((_eventCount % _period) != 0) )
+      return false;
+    return replan();
+  }
+
+
+  /** The statistics are then decayed, so that the plans follow the changes of rates.
+  *   \return true if a plan has changed
+  */
+  bool ChronicleReplanner::replan()
+  {
+    bool changed = false;
+    std::list<Chain>::iterator it;
+    for (it = _chains.begin(); it != _chains.end(); it++)
+    {
+      if (replan(*it))
+        changed = true;
+      for (size_t i = 0; i < it->arrivals.size(); i++)
+        it->arrivals[i] *= DECAY;
+      it->produced *= DECAY;
+    }
+    return changed;
+  }
+
+
+  /** The cardinality of a member is its (smoothed) number of recognitions. The
+  *   selectivity of each link of a sequence is inferred from the number of
+  *   recognitions of the whole chain; conjunctions keep all the pairs.
+  *   The pending recognitions of the new intermediate chronicles are rebuilt
+  *   from the recognition sets of the members: for sequences, only the partial
+  *   recognitions which may still be completed (a recognition of the preceding
+  *   members ends before them) are kept.
+  *   The chains whose links or members forget recognitions (peremption duration,
+  *   budget) are not re-planned: their pending recognitions could not be rebuilt.
+  *   The former links are emptied but kept until the replanner is destroyed,
+  *   since the recognitions of the root still refer to them.
+  *   A re-planned chronicle tree is marked as rewritten (see Chronicle::isRewritten).
+  *   \param[in] chain chain
+  *   \return true if the plan of the chain has changed
+  */
+  bool ChronicleReplanner::replan(Chain& chain)
+  {
+    if (!chain.root->getNewRecognitions().empty())
+      return false;
+
+    const std::type_info& type = typeid(*chain.root);
+    std::vector<Chronicle*> members, links;
+    flattenChain(chain.root->getOpLeft(), type, members, links);
+    flattenChain(chain.root->getOpRight(), type, members, links);
+    if (members != chain.members)
+    {
+      // The chain has been modified from outside: its statistics start again
+      chain.members = members;
+      chain.arrivals.assign(members.size(), 0.0);
+      chain.produced = 0.0;
+      return false;
+    }
+    for (size_t i = 0; i < links.size(); i++)
+      if (links[i]->getPeremptionDuration() >= 0.0)
+        return false;
+    for (size_t i = 0; i < members.size(); i++)
+      if ( (members[i]->getPeremptionDuration() >= 0.0) || (members[i]->getRecognitionBudget() >= 0) )
+        return false;
+
+    size_t n = members.size();
+    std::vector<double> cards(n);
+    double product = 1.0;
+    for (size_t i = 0; i < n; i++)
+    {
+      cards[i] = chain.arrivals[i] + 1.0;
+      product *= cards[i];
+    }
+    double selectivity = 1.0;
+    if (chain.sequence)
+      selectivity = std::min(1.0, pow((chain.produced + 1.0) / product, 1.0 / (double)(n - 1)));
+
+    size_t next = 0, first = 0, last = 0;
+    double current = linkCost(chain.root, chain, cards, selectivity, next, first, last)
+                   - ChronicleOptimizer::chainCardinality(cards, 0, n-1, selectivity);
+    std::vector<std::vector<size_t> > splits;
+    double best = ChronicleOptimizer::planChain(cards, selectivity, splits);
+    if (best >= _threshold * current)
+      return false;
+
+    // Earliest end of a recognition of the members 0 to k (sequences)
+    std::vector<long> earliest(n, LONG_MAX);
+    long previous = LONG_MIN;
+    for (size_t k = 0; chain.sequence && (k < n) && (previous != LONG_MAX); k++)
+    {
+      Chronicle::RecoSet::const_iterator itR;
+      const Chronicle::RecoSet& recos = members[k]->getRecognitionSet();
+      for (itR = recos.begin(); itR != recos.end(); itR++)
+        if ( ((*itR)->getMinOrder() > previous) && ((*itR)->getMaxOrder() < earliest[k]) )
+          earliest[k] = (*itR)->getMaxOrder();
+      previous = earliest[k];
+    }
+
+    size_t k = splits[0][n-1];
+    std::vector<RecoTree*> leftMatches, rightMatches;
+    Chronicle* left  = buildLinks(chain, splits, earliest, 0, k, leftMatches);
+    Chronicle* right = buildLinks(chain, splits, earliest, k+1, n-1, rightMatches);
+    left->setPurgeable(false);
+    if (!chain.sequence)
+      right->setPurgeable(false);
+    if (chain.root->getMyEngine() != NULL)
+    {
+      left->setMyEngine(chain.root->getMyEngine());
+      right->setMyEngine(chain.root->getMyEngine());
+    }
+    chain.root->setOpLeft(left);
+    chain.root->setOpRight(right);
+    ChronicleOptimizer::markRewritten(chain.root);
+
+    for (size_t i = 0; i < links.size(); i++)
+    {
+      links[i]->setPurgeable(true);
+      links[i]->purgeRecognitionsIfPurgeable();
+      _retiredLinks.push_back(links[i]);
+    }
+    _replanCount++;
+    return true;
+  }
+
+
+  /** \param[in] cr chronicle of the chain
+  *   \param[in] chain chain
+  *   \param[in] cards cardinalities of the members
+  *   \param[in] selectivity selectivity of the links
+  *   \param[in,out] next index of the next member
+  *   \param[out] first index of the first member under \a cr
+  *   \param[out] last index of the last member under \a cr
+  *   \return sum of the cardinalities of the chronicles of the chain under \a cr
+  */
+  double ChronicleReplanner::linkCost(Chronicle* cr, const Chain& chain, const std::vector<double>& cards,
+                                      double selectivity, size_t& next, size_t& first, size_t& last) const
+  {
+    if ( (next < chain.members.size()) && (cr == chain.members[next]) )
+    {
+      first = last = next++;
+      return 0.0;
+    }
+    size_t first2, last1;
+    double cost = linkCost(cr->getChild1(), chain, cards, selectivity, next, first, last1)
+                + linkCost(cr->getChild2(), chain, cards, selectivity, next, first2, last);
+    return cost + ChronicleOptimizer::chainCardinality(cards, first, last, selectivity);
+  }
+
+
+  /** \param[in] chain chain
+  *   \param[in] splits new association
+  *   \param[in] earliest earliest end of a recognition of the members 0 to k (sequences)
+  *   \param[in] first index of the first member
+  *   \param[in] last index of the last member
+  *   \param[out] matches pending recognitions of the chronicle built
+  *   \return the chronicle
+  */
+  Chronicle* ChronicleReplanner::buildLinks(const Chain& chain, const std::vector<std::vector<size_t> >& splits,
+                                            const std::vector<long>& earliest, size_t first, size_t last,
+                                            std::vector<RecoTree*>& matches) const
+  {
+    if (first == last)
+    {
+      const Chronicle::RecoSet& recos = chain.members[first]->getRecognitionSet();
+      matches.assign(recos.begin(), recos.end());
+      return chain.members[first];
+    }
+
+    size_t k = splits[first][last];
+    std::vector<RecoTree*> leftMatches, rightMatches;
+    Chronicle* left  = buildLinks(chain, splits, earliest, first, k, leftMatches);
+    Chronicle* right = buildLinks(chain, splits, earliest, k+1, last, rightMatches);
+    Chronicle* link;
+    if (chain.sequence)
+      link = new ChronicleSequence(left, right);
+    else
+      link = new ChronicleConjunction(left, right);
+
+    std::vector<RecoTree*>::const_iterator itL, itR;
+    for (itL = leftMatches.begin(); itL != leftMatches.end(); itL++)
+    {
+      if ( chain.sequence && (first > 0) && ((*itL)->getMinOrder() <= earliest[first-1]) )
+        continue;
+      for (itR = rightMatches.begin(); itR != rightMatches.end(); itR++)
+      {
+        if ( chain.sequence && ((*itL)->getMaxOrder() >= (*itR)->getMinOrder()) )
+          continue;
+
+        PropertyManager x1x2;  // Union of the properties, except anonymous
+        x1x2.copyProperties(**itL, true, false);
+        x1x2.copyProperties(**itR, true, false);
+        RecoTree* tmp = new RecoTreeCouple(*itL, *itR);
+        tmp->copyDateAndOrder(**itL, **itR);
+        tmp->copyProperties(x1x2, false, false); // Untransfer ownership
+        link->adoptRecognition(tmp);
+        matches.push_back(tmp);
+      }
+    }
+    return link;
+  }
+
+} // namespace CRL
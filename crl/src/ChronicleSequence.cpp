@@ -105,43 +105,117 @@ namespace CRL
     if (_alreadyProcessed) 
       return _hasNewRecognitions;
 
+    bool flagLeft  = _opLeft->process(d, e);
+    bool flagRight = _opRight->process(d, e);
+    return processNode(d, e, flagLeft, flagRight);
+  }
+
+
+  /** Processing of the chronicle alone, its members having been processed
+  *   (by #process, or before by ChroniclePlan).
+  *   \param[in] d date at which the evaluation is undertaken
+  *   \param[in] e event to be evaluated
+  *   \param[in] flagLeft true if the left member has new recognitions
+  *   \param[in] flagRight true if the right member has new recognitions
+  */
+  bool ChronicleSequence::processNode(const DateType& d, CRL::Event* e, bool flagLeft, bool flagRight)
+  {
+    if (_countOnly)
+      return processCount(d, e);
+
     _hasNewRecognitions = false;
-    _opLeft->process(d, e);
 
-    if (_opRight->process(d, e))
+    if (flagRight)
     {
-      Chronicle::RecoSet::iterator itL, itR;
+      Chronicle::RecoSet::const_iterator itR;
+      std::vector<RecoTree*> matches;
 
       //the new recognitions of Right are merged with the recognitions of Left
       for (itR  = _opRight->getNewRecognitions().begin();
            itR != _opRight->getNewRecognitions().end(); itR++)
       { 
-        for (itL  = _opLeft->getRecognitionSet().begin();
-             itL != _opLeft->getRecognitionSet().end(); itL++)
+        if (!hasDefaultSelection())
         {
-          if ((*itL)->getMaxOrder() < (*itR)->getMinOrder())
-          {
-            PropertyManager x1x2;  // Union of the properties, except anonymous
-            x1x2.copyProperties(**itL, true, false);
-            x1x2.copyProperties(**itR, true, false); 
-
-            if ( applyPredicate(x1x2) )
-            {
-              RecoTree* tmp = new RecoTreeCouple(*itL, *itR);
-              tmp->copyDateAndOrder(**itL, **itR);
-              tmp->copyProperties(x1x2, false, false); // Untransfer ownership
-              if ( hasOutputFunction() )
-              {
-                PropertyManager pm;
-                applyOutputFunction(x1x2, pm);
-                tmp->upgradeProperties(pm, true, true); // Transfer ownership
-              }
-             applyActionFunction(tmp);
-            }
-          }
+          joinSelected(*itR);
+          continue;
         }
+        // Left recognitions ending before the right one begins
+        leftMatches(**itR, RecoColumns::NO_LOWER_BOUND, RecoColumns::NO_UPPER_BOUND,
+                    RecoColumns::NO_LOWER_BOUND, (*itR)->getMinOrder(), matches);
+        for (size_t i=0; i<matches.size(); i++)
+          join(matches[i], *itR);
+      }
+    }
+    _alreadyProcessed = true;
+    return _hasNewRecognitions;
+  }
+
+
+  /** \param[in] l recognition of the left member
+  *   \param[in] r recognition of the right member
+  *   \return true if the predicate is verified (new recognition)
+  */
+  bool ChronicleSequence::join(RecoTree* l, RecoTree* r)
+  {
+    PropertyManager x1x2;  // Union of the properties, except anonymous
+    x1x2.copyProperties(*l, true, false);
+    x1x2.copyProperties(*r, true, false); 
+
+    if ( !applyPredicate(x1x2) )
+      return false;
+
+    RecoTree* tmp = new RecoTreeCouple(l, r);
+    tmp->copyDateAndOrder(*l, *r);
+    tmp->copyProperties(x1x2, false, false); // Untransfer ownership
+    if ( hasOutputFunction() )
+    {
+      PropertyManager pm;
+      applyOutputFunction(x1x2, pm);
+      tmp->upgradeProperties(pm, true, true); // Transfer ownership
+    }
+    applyActionFunction(tmp);
+    return true;
+  }
+
+
+  /** Joins the new right recognition \a r with the left recognitions chosen
+  *   by the selection policy, then consumes them if required (they no longer
+  *   take part in the following recognitions).
+  *   \param[in] r new recognition of the right member
+  */
+  void ChronicleSequence::joinSelected(RecoTree* r)
+  {
+    std::vector<RecoTree*> selected, matched;
+    selectCandidates(leftCandidates(*r), *r, selected);
+    for (size_t i=0; i<selected.size(); i++)
+    {
+      if ( (selected[i]->getMaxOrder() < r->getMinOrder()) && join(selected[i], r) )
+      {
+        matched.push_back(selected[i]);
+        if (selectsFirstOnly()) break;
       }
     }
+
+    if (_consumeOnMatch)
+      for (size_t i=0; i<matched.size(); i++)
+        _opLeft->consumeRecognition(matched[i]);
+  }
+
+
+  /** The right member being instantaneous, its new recognitions all begin
+  *   with the current event: they follow every left recognition except
+  *   the new ones.
+  *   \param[in] d date at which the evaluation is undertaken
+  *   \param[in] e event to be evaluated
+  */
+  bool ChronicleSequence::processCount(const DateType& d, CRL::Event* e)
+  {
+    _opLeft->process(d, e);
+    _opRight->process(d, e);
+
+    _newCount = (_opLeft->getCount() - _opLeft->getNewCount()) * _opRight->getNewCount();
+    _count   += _newCount;
+    _hasNewRecognitions = (_newCount > 0.0);
     _alreadyProcessed = true;
     return _hasNewRecognitions;
   }
@@ -63,6 +63,17 @@ namespace CRL
   }
 
 
+  /** \return signature, including the date
+  */
+  std::string ChronicleSingleDate::structuralSignature() const
+  {
+    std::stringstream ss;
+    ss.precision(17);
+    ss << Chronicle::structuralSignature() << "[" << _date << "]";
+    return ss.str();
+  }
+
+
   /** Updates the recognition set of the chronicle.
   *   \param[in] d date at which the evaluation is undertaken
   *   \param[in] e event to be evaluated
@@ -75,7 +86,7 @@ namespace CRL
 
     if ( (d == _date) && _recognitionSet.empty() )
     {
-      RecoTree* tmp = new RecoTreeSingle(new Event(_date));
+      RecoTree* tmp = new RecoTreeSingle(new Event(_date), true);
       applyActionFunction(tmp);
       _alreadyProcessed = true;
       return _hasNewRecognitions;
@@ -56,6 +56,8 @@ namespace CRL
     // If the chronicle has already been processed this turn
     if (_alreadyProcessed) 
       return _hasNewRecognitions;
+    if (_countOnly)
+      return processCount(d, e);
 
     if ( (e != NULL) && (e->getName()==_code) && (e->getDate() <= d) ) 
     {
@@ -86,5 +88,30 @@ namespace CRL
   }
 
 
+  /** The name column of the batch is scanned for the code of the chronicle
+  *   (see EventBatch::findRows()); the predicate is not evaluated.
+  *   \param[in] batch events to be examined
+  *   \param[in,out] rows rows found, in increasing order
+  */
+  void ChronicleSingleEvent::findMatchingRows(const EventBatch& batch, 
+                                              std::vector<size_t>& rows) const
+  {
+    batch.findRows(EventBatch::internName(_code), rows);
+  }
+
+
+  /** \param[in] d date at which the evaluation is undertaken
+  *   \param[in] e event to be evaluated
+  */
+  bool ChronicleSingleEvent::processCount(const DateType& d, CRL::Event* e)
+  {
+    _newCount = ( (e != NULL) && (e->getName()==_code) && (e->getDate() <= d) ) ? 1.0 : 0.0;
+    _count   += _newCount;
+    _hasNewRecognitions = (_newCount > 0.0);
+    _alreadyProcessed = true;
+    return _hasNewRecognitions;
+  }
+
+
 
 } /* namespace CRL */
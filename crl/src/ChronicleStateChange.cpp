@@ -88,6 +88,17 @@ namespace CRL
   /** Display in the form : \code (C1 C2) \endcode
   *   \return string
   */
+  /** The awaiting recognitions of the left member are held by the
+  *   chronicle, since they may have been purged from the sub-chronicle.
+  */
+  ChronicleStateChange::~ChronicleStateChange()
+  {
+    Chronicle::RecoSet::iterator it;
+    for (it=_tempRecogSet.begin(); it!=_tempRecogSet.end(); it++)
+      (*it)->release();
+  }
+
+
   std::string ChronicleStateChange::toString() const 
   {
     if (_name != "") return _name;
@@ -105,6 +116,21 @@ namespace CRL
     if (_alreadyProcessed) 
       return _hasNewRecognitions;
 
+    bool flagRight = _opRight->process(d, e);
+    bool flagLeft  = _opLeft->process(d, e);
+    return processNode(d, e, flagLeft, flagRight);
+  }
+
+
+  /** Processing of the chronicle alone, its members having been processed
+  *   (by #process, or before by ChroniclePlan).
+  *   \param[in] d date at which the evaluation is undertaken
+  *   \param[in] e event to be evaluated
+  *   \param[in] flagLeft true if the left member has new recognitions
+  *   \param[in] flagRight true if the right member has new recognitions
+  */
+  bool ChronicleStateChange::processNode(const DateType& d, CRL::Event* e, bool flagLeft, bool flagRight)
+  {
     _hasNewRecognitions = false;
 
     // If there is a new recognition of C2
@@ -133,11 +159,11 @@ namespace CRL
 
     Chronicle::RecoSet::iterator it;
 
-    if (_opRight->process(d, e))
+    if (flagRight)
     {
       Chronicle::RecoSet::iterator itL, itR;
-      std::set<RecoTree*> recoLeftToDelete;
-      std::set<RecoTree*> tmpNewReco;
+      Chronicle::RecoSet recoLeftToDelete;
+      Chronicle::RecoSet tmpNewReco;
 
       for (itR  = _opRight->getNewRecognitions().begin();
         itR != _opRight->getNewRecognitions().end(); itR++)
@@ -165,7 +191,10 @@ namespace CRL
                 maxLeftMaxOrder = leftMaxOrder;
 
                 for (it = tmpNewReco.begin(); it != tmpNewReco.end(); it++)
+                {
                   recoLeftToDelete.insert(const_cast<RecoTree*>((*it)->getLeftMember()));
+                  (*it)->release();
+                }
                 tmpNewReco.clear();
 
                 if (hasOutputFunction() == true)
@@ -190,7 +219,7 @@ namespace CRL
               else // (leftMaxOrder < maxLeftMaxOrder)
               {
                 recoLeftToDelete.insert(*itL);
-                delete tmp;
+                tmp->release();
               }
             }
           } // if ((leftMaxOrder=(*itL) ...
@@ -203,20 +232,27 @@ namespace CRL
       } // for (itR  = _opRight->getNewRecognitions().begin() ...
 
       for (it = _newRecognitions.begin(); it != _newRecognitions.end(); it++)
-        _tempRecogSet.erase(const_cast<RecoTree*>((*it)->getLeftMember()));
+      {
+        RecoTree* rc = const_cast<RecoTree*>((*it)->getLeftMember());
+        if (_tempRecogSet.erase(rc) > 0)
+          rc->release();
+      }
 
       for (it = recoLeftToDelete.begin(); it != recoLeftToDelete.end(); it++)
-        _tempRecogSet.erase(*it);
+        if (_tempRecogSet.erase(*it) > 0)
+          (*it)->release();
+      _tempRecogSet.compact();
 
-    } // if (_opRight->process(d, e))
+    } // if (flagRight)
 
     // Copies the new recognitions of Left into temporary
-    if (_opLeft->process(d, e))
+    if (flagLeft)
     {
       Chronicle::RecoSet::iterator it;
       for (it= _opLeft->getNewRecognitions().begin();
         it!=  _opLeft->getNewRecognitions().end(); it++)
-        _tempRecogSet.insert(*it);
+        if (_tempRecogSet.insert(*it).second)
+          (*it)->addRef();
     }
  
     _alreadyProcessed = true;
@@ -224,6 +260,17 @@ namespace CRL
   }
 
 
+  /** Only the new recognitions of the members are used.
+  *   \param[in] window maximal useful span of the recognitions (negative value: unbounded)
+  */
+  void ChronicleStateChange::inferRetentionHorizons(DurationType window)
+  {
+    _opLeft->mergeRetentionHorizon(0.0);
+    _opRight->mergeRetentionHorizon(0.0);
+    _opLeft->inferRetentionHorizons(window);
+    _opRight->inferRetentionHorizons(window);
+  }
+
 } /* namespace CRL */
 
 
@@ -26,7 +26,9 @@
 // INCLUDE FILES
 // ----------------------------------------------------------------------------
 
-#include "Utils.h"
+#include <algorithm>
+#include <iterator>
+
 #include "Context.h"
 
 
@@ -40,6 +42,33 @@ namespace CRL
   //! Definition of the class variable
   std::string Context::ANONYMOUS_CODE_NAME = " #ANONYMOUS";
 
+  //! Definition of the class constant
+  const unsigned int Context::ANONYMOUS_ID = 0;
+
+  //! Definition of the class variable
+  std::map<std::string, unsigned int> Context::_nameDictionary;
+
+  //! Definition of the class variable, ANONYMOUS_CODE_NAME first
+  std::deque<std::string> Context::_names(1, Context::ANONYMOUS_CODE_NAME);
+
+
+  /** The identifiers are attributed in the order of the first occurrences.
+  *   \param[in] name name to be interned
+  *   \return identifier of the name
+  */
+  unsigned int Context::internName(const std::string& name)
+  {
+    if (name == ANONYMOUS_CODE_NAME)
+      return ANONYMOUS_ID;
+    std::map<std::string, unsigned int>::iterator it = _nameDictionary.find(name);
+    if (it != _nameDictionary.end())
+      return it->second;
+    unsigned int id = (unsigned int)_names.size();
+    _names.push_back(name);
+    _nameDictionary[name] = id;
+    return id;
+  }
+
 
   /** Creates an empty context or a context reduced to \bot.
   *   \param[in] withAnonymous is true if the context is to be reduced to \bot
@@ -47,7 +76,7 @@ namespace CRL
   Context::Context(bool withAnonymous)
   { 
     if (withAnonymous)
-      data.insert(ANONYMOUS_CODE_NAME);
+      data.push_back(ANONYMOUS_ID);
   }
 
 
@@ -57,8 +86,8 @@ namespace CRL
   Context::Context(const Context& c, bool withAnonymous)
     : data(c.data)
   {
-    if (withAnonymous == false)
-      data.erase(Context::ANONYMOUS_CODE_NAME);
+    if ( (withAnonymous == false) && (!data.empty()) && (data.front() == ANONYMOUS_ID) )
+      data.erase(data.begin());
   }
 
 
@@ -66,9 +95,15 @@ namespace CRL
   */
   void Context::add(const std::string& s, bool nothrow) 
   {
-    std::pair<std::set<std::string>::iterator, bool> res = data.insert(s);
-    if ( (nothrow == false) && (res.second == false) )
-      throw(std::string("Impossible to add element ")+s+std::string(" in context"));
+    unsigned int id = internName(s);
+    std::vector<unsigned int>::iterator it = std::lower_bound(data.begin(), data.end(), id);
+    if ( (it != data.end()) && (*it == id) )
+    {
+      if (nothrow == false)
+        throw(std::string("Impossible to add element ")+s+std::string(" in context"));
+      return;
+    }
+    data.insert(it, id);
   }
 
 
@@ -76,7 +111,9 @@ namespace CRL
   */
   void Context::remove(const std::string& s)
   {
-    data.erase(s);
+    std::vector<unsigned int>::iterator it = std::lower_bound(data.begin(), data.end(), internName(s));
+    if ( (it != data.end()) && (*it == internName(s)) )
+      data.erase(it);
   }
 
 
@@ -85,10 +122,10 @@ namespace CRL
   */
   void Context::clear(bool exceptAnonymous) 
   {
-    bool flag = ( (exceptAnonymous)&&(data.count(Context::ANONYMOUS()) == 1) );
+    bool flag = ( (exceptAnonymous)&&(!data.empty())&&(data.front() == ANONYMOUS_ID) );
     data.clear();
     if (flag)
-      data.insert(ANONYMOUS_CODE_NAME);
+      data.push_back(ANONYMOUS_ID);
   }
 
 
@@ -100,43 +137,62 @@ namespace CRL
   }
 
 
-  /** Raises an exception if the limits [0, size-1] are exceeded
-  *   \result constant reference
+  /** The identifiers being sorted in the order of interning, the names are
+  *   sorted here (display purpose only).
+  *   Raises an exception if the limits [0, size-1] are exceeded
+  *   \result identifier
   */
-  const std::string& Context::operator[](int i) const
+  unsigned int Context::idAt(int i) const
   {
     if ( (i < 0) || (i >= (int)data.size()) )
       throw("Context::operator[] : outside bounds");
 
-    std::set<std::string>::const_iterator it = data.begin();
+    std::map<std::string, unsigned int> sorted;
+    std::vector<unsigned int>::const_iterator it;
+    for (it = data.begin(); it != data.end(); it++)
+      sorted[getName(*it)] = *it;
+    std::map<std::string, unsigned int>::const_iterator itS = sorted.begin();
     for(int n=0; n<i; n++)
-      it++;
-    return *it;
+      itS++;
+    return itS->second;
   }
 
 
   /** Raises an exception if the limits [0, size-1] are exceeded
-  *   \result reference allowing a modification of value
+  *   \result constant reference
   */
-  std::string& Context::operator[](int i)
+  const std::string& Context::operator[](int i) const
   {
-    if ( (i < 0) || (i >= (int)data.size()) )
-      throw("Context::operator[] : outside bounds");
+    return getName(idAt(i));
+  }
 
-    std::set<std::string>::iterator it = data.begin();
-    for(int n=0; n<i; n++)
-      it++;
-    return const_cast<std::string&>(*it);
+
+  /** Raises an exception if the limits [0, size-1] are exceeded
+  *   \result element allowing a renaming
+  */
+  Context::Element Context::operator[](int i)
+  {
+    return Element(*this, idAt(i));
   }
 
 
+  /** \param[in] s new name of the element
+  */
+  Context::Element& Context::Element::operator=(const std::string& s)
+  {
+    _context.remove(Context::getName(_id));
+    _context.add(s, true);
+    _id = Context::internName(s);
+    return *this;
+  }
+
 
   /** \param[in] s event name to be sought for in the context
   *   \result true if the element is indeed in the context
   */
-  bool Context::contains(const std::string& s)
+  bool Context::contains(const std::string& s) const
   {
-    return (data.count(s)==1);
+    return std::binary_search(data.begin(), data.end(), internName(s));
   }
 
 
@@ -145,7 +201,7 @@ namespace CRL
   bool Context::isSingletonAnonymous() const
   {
     return( (data.size() == 1)
-         && (data.count(Context::ANONYMOUS()) == 1) );
+         && (data.front() == ANONYMOUS_ID) );
   }
 
 
@@ -158,10 +214,11 @@ namespace CRL
   bool Context::areEquals(const Context& c1, const Context& c2, 
                           bool exceptAnonymous)
   {
-    if (exceptAnonymous)
-      return Set::equal(c1.data, c2.data, Context::ANONYMOUS_CODE_NAME);
-    else
-      return Set::equal(c1.data, c2.data);
+    // ANONYMOUS, if present, is the first identifier
+    size_t i1 = ( (exceptAnonymous) && (!c1.data.empty()) && (c1.data.front() == ANONYMOUS_ID) ) ? 1 : 0;
+    size_t i2 = ( (exceptAnonymous) && (!c2.data.empty()) && (c2.data.front() == ANONYMOUS_ID) ) ? 1 : 0;
+    return ( (c1.data.size() - i1 == c2.data.size() - i2)
+          && std::equal(c1.data.begin() + i1, c1.data.end(), c2.data.begin() + i2) );
   }
 
 
@@ -175,10 +232,17 @@ namespace CRL
   bool Context::areDisjoint(const Context& c1, const Context& c2, 
                             bool exceptAnonymous)
   {
-    if (exceptAnonymous)
-      return Set::areDisjoint(c1.data, c2.data, Context::ANONYMOUS_CODE_NAME);
-    else
-      return Set::areDisjoint(c1.data, c2.data);
+    std::vector<unsigned int>::const_iterator it1 = c1.data.begin();
+    std::vector<unsigned int>::const_iterator it2 = c2.data.begin();
+
+    while ( (it1 != c1.data.end()) && (it2 != c2.data.end()) )
+    {
+      if ( (*it1) < (*it2) ) it1++;
+      else if ( (*it2) < (*it1) ) it2++;
+      else if ( (exceptAnonymous) && (*it1 == ANONYMOUS_ID) ) { it1++; it2++; }
+      else return false;
+    }
+    return true;
   }
 
 
@@ -191,11 +255,12 @@ namespace CRL
   void Context::contextIntersection(const Context& c1, const Context& c2, 
                                     Context& result, bool exceptAnonymous)
   {
-    if (exceptAnonymous)
-      return Set::set_intersection(c1.data, c2.data, result.data, 
-                                   Context::ANONYMOUS_CODE_NAME);
-    else
-      return Set::set_intersection(c1.data, c2.data, result.data);
+    std::vector<unsigned int> tmp;
+    std::set_intersection(c1.data.begin(), c1.data.end(), c2.data.begin(), c2.data.end(),
+                          std::back_inserter(tmp));
+    if ( (exceptAnonymous) && (!tmp.empty()) && (tmp.front() == ANONYMOUS_ID) )
+      tmp.erase(tmp.begin());
+    result.data.swap(tmp);
   }
 
 
@@ -223,11 +288,13 @@ namespace CRL
   void Context::contextUnion(const Context& c1, const Context& c2, 
                              Context& result, bool exceptAnonymous)
   {
-    if (exceptAnonymous)
-      return Set::set_union(c1.data, c2.data, result.data, 
-                            Context::ANONYMOUS_CODE_NAME);
-    else
-      return Set::set_union(c1.data, c2.data, result.data);
+    std::vector<unsigned int> tmp;
+    tmp.reserve(c1.data.size() + c2.data.size());
+    std::set_union(c1.data.begin(), c1.data.end(), c2.data.begin(), c2.data.end(),
+                   std::back_inserter(tmp));
+    if ( (exceptAnonymous) && (!tmp.empty()) && (tmp.front() == ANONYMOUS_ID) )
+      tmp.erase(tmp.begin());
+    result.data.swap(tmp);
   }
 
   /** Class method.
@@ -24,6 +24,7 @@
 
 #include "Event.h"
 #include <iostream>
+#include <vector>
 
 
 // ----------------------------------------------------------------------------
@@ -37,15 +38,19 @@ namespace CRL
   std::string Event::_timeEventName = "t";
 
 
-  //! Initialisation of the list
-  std::list<Event*> Event::_dynamicInstances;
+  //! Initialisation of the set
+  thread_local std::unordered_set<Event*> Event::_dynamicInstances;
+
+  //! Initialisation of the last allocation
+  thread_local const void* Event::_lastAllocated = NULL;
 
 
   /** Builds an event of name \a name, not dated.
   *   \param[in] name event name
   */
   Event::Event(const std::string& name)
-    : _name(name), _date(NO_DATE), _order(-1)
+    : _name(name), _date(NO_DATE), _order(-1),
+      _dynamic(takeAllocated(this)), _refCount(0), _releasable(false)
   {
     if (name == _timeEventName)
       throw(std::string("Forbidden name event : ")+name);
@@ -57,7 +62,8 @@ namespace CRL
   *   \param[in] date event date
   */
   Event::Event(const std::string& name, const DateType& date)
-    :_name(name), _date(date), _order(-1){
+    :_name(name), _date(date), _order(-1),
+     _dynamic(takeAllocated(this)), _refCount(0), _releasable(false) {
       if (name == _timeEventName)
         throw(std::string("Forbidden name event : ")+name);
   }
@@ -67,17 +73,46 @@ namespace CRL
   *   \param[in] date event date
   */
   Event::Event(const DateType& date)
-    :_name(_timeEventName), _date(date), _order(-1){
+    :_name(_timeEventName), _date(date), _order(-1),
+     _dynamic(takeAllocated(this)), _refCount(0), _releasable(false) {
+  }
+
+
+#ifdef CRL_INTEGER_DATES
+  /** Builds an event of name \a name, at t = \a date nanoseconds.
+  *   \param[in] name event name
+  *   \param[in] date event date, a whole number of nanoseconds
+  */
+  Event::Event(const std::string& name, double date)
+    :_name(name), _date(DateTraits<DateType>::fromUnits(date)), _order(-1),
+     _dynamic(takeAllocated(this)), _refCount(0), _releasable(false) {
+      if (name == _timeEventName)
+        throw(std::string("Forbidden name event : ")+name);
+  }
+
+
+  /** Builds an un-named event, at t = \a date nanoseconds.
+  *   \param[in] date event date, a whole number of nanoseconds
+  */
+  Event::Event(double date)
+    :_name(_timeEventName), _date(DateTraits<DateType>::fromUnits(date)), _order(-1),
+     _dynamic(takeAllocated(this)), _refCount(0), _releasable(false) {
   }
+#endif
 
 
   /** Returns a newly memory allocation, stores the adress
-  *   in the list of instances dynamically created.
+  *   in the set of instances dynamically created, and marks it
+  *   as the instance the next constructor of the thread builds.
+  *   The events are not shared between threads: an event is deleted
+  *   by the thread which allocated it, and its reference count
+  *   (see #addRef) is not atomic.
   */
   void* Event::operator new(size_t size)
   {
     void *ptr = (void *)malloc(size);
-    _dynamicInstances.push_back((Event*)ptr);
+    _dynamicInstances.insert((Event*)ptr);
+    _lastAllocated = ptr;
     return ptr;
   }
 
@@ -87,26 +122,50 @@ namespace CRL
   */
   void Event::operator delete(void* ptr)
   {
-    _dynamicInstances.remove((Event*)ptr);
+    _dynamicInstances.erase((Event*)ptr);
     free(ptr);
   }
 
 
-  /** Deletes all the instances of list _dynamicInstances
+  /** Called by the constructors: an instance is dynamic only if it is
+  *   the one #operator new has just allocated, no lookup is needed.
+  *   \param[in] e instance
+  *   \return true if allocated on the heap
+  */
+  bool Event::takeAllocated(const Event* e)
+  {
+    if (e != _lastAllocated)
+      return false;
+    _lastAllocated = NULL;
+    return true;
+  }
+
+
+  /** Deletes all the instances of set _dynamicInstances which are not held 
+  *   (see #addRef). The instances still held by recognition trees are 
+  *   deleted when released by their last holder.
   */
   void Event::freeAllInstances()
   {
-    Event* tmp;
-    std::list<Event*>::iterator it;
-    for(it = _dynamicInstances.begin(); it != _dynamicInstances.end(); )
+    std::vector<Event*> instances(_dynamicInstances.begin(), _dynamicInstances.end());
+    for (size_t i=0; i<instances.size(); i++)
     {
-      tmp = (*it);
-      it = _dynamicInstances.erase(it);
-      delete tmp;
+      if (instances[i]->_refCount <= 0)
+        delete instances[i];
+      else
+        instances[i]->setReleasable();
     }
   }
 
 
+  /** \return number of instances allocated on the heap, not deleted yet
+  */
+  size_t Event::getDynamicInstanceCount()
+  {
+    return _dynamicInstances.size();
+  }
+
+
   std::ostream& operator<<(std::ostream& os, const Event& e) 
   {
     if (e.getDate() == NO_DATE)
@@ -0,0 +1,234 @@
+/** ***********************************************************************************
+ * \file EventBatch.cpp
+ * \author Ariane Piel & Jean Bourrely / Onera DCPS
+ * \date 2014
+ * \brief Columnar batch of events
+ **************************************************************************************/
+
+/*  Copyright (C) 2012, 2013, 2014  ONERA  http://www.onera.fr
+    This file is part of CRL : Chronicle Recognition Library.
+
+    CRL is free software: you can redistribute it and/or modify it under
+    the terms of the Lesser GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    CRL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    Lesser GNU General Public License for more details.
+
+    You should have received a copy of the Lesser GNU General Public License
+    along with CRL.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// ----------------------------------------------------------------------------
+// INCLUDE FILES
+// ----------------------------------------------------------------------------
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define CRL_EVENT_BATCH_SSE2
+#endif
+
+#include "EventBatch.h"
+
+
+// ----------------------------------------------------------------------------
+// CLASS METHODS
+// ----------------------------------------------------------------------------
+
+namespace CRL 
+{
+
+  //! Initialisation of the class attributes
+  std::map<std::string, unsigned int> EventBatch::_nameDictionary;
+  std::vector<std::string> EventBatch::_names;
+
+
+  /** \param[in] n number of rows wanted
+  */
+  void EventBatch::Column::resize(size_t n)
+  {
+    present.resize(n, false);
+    if (type == Property::L) longs.resize(n, 0);
+    else if (type == Property::D) doubles.resize(n, 0.0);
+    else strings.resize(n);
+  }
+
+
+  /** \param[in] name event name
+  *   \return identifier of the name, the same for all the batches
+  */
+  unsigned int EventBatch::internName(const std::string& name)
+  {
+    std::map<std::string, unsigned int>::iterator it = _nameDictionary.find(name);
+    if (it != _nameDictionary.end())
+      return it->second;
+    unsigned int id = (unsigned int)_names.size();
+    _names.push_back(name);
+    _nameDictionary[name] = id;
+    return id;
+  }
+
+
+  /** The events have to be added in chronological order.
+  *   \param[in] name event name
+  *   \param[in] date event date
+  *   \return row of the event
+  */
+  size_t EventBatch::addEvent(const std::string& name, const DateType& date)
+  {
+    if (name == Event::getTimeEventName())
+      throw(std::string("Forbidden name event : ")+name);
+    if ( (!_dates.empty()) && (date < _dates.back()) )
+      throw("EventBatch::addEvent : events must be added in chronological order");
+
+    _nameIds.push_back(internName(name));
+    _dates.push_back(date);
+    _orders.push_back(-1);
+    return _dates.size() - 1;
+  }
+
+
+  /** \param[in] prop property name
+  *   \param[in] type type of the values of the property
+  *   \return column of the property, with as many rows as the batch
+  */
+  EventBatch::Column& EventBatch::column(const std::string& prop, Property::DataTypeEnum type)
+  {
+    std::map<std::string, Column>::iterator it = _columns.find(prop);
+    if (it == _columns.end())
+      it = _columns.insert(std::make_pair(prop, Column(type))).first;
+    else if (it->second.type != type)
+      throw(std::string("EventBatch : property ")+prop+" already has another type");
+    it->second.resize(_dates.size());
+    return it->second;
+  }
+
+
+  /** \param[in] row row of the event
+  *   \param[in] prop property name
+  *   \param[in] value property value
+  */
+  void EventBatch::setLong(size_t row, const std::string& prop, long value)
+  {
+    Column& c = column(prop, Property::L);
+    c.longs[row] = value;
+    c.present[row] = true;
+  }
+
+
+  /** \param[in] row row of the event
+  *   \param[in] prop property name
+  *   \param[in] value property value
+  */
+  void EventBatch::setDouble(size_t row, const std::string& prop, double value)
+  {
+    Column& c = column(prop, Property::D);
+    c.doubles[row] = value;
+    c.present[row] = true;
+  }
+
+
+  /** \param[in] row row of the event
+  *   \param[in] prop property name
+  *   \param[in] value property value
+  */
+  void EventBatch::setString(size_t row, const std::string& prop, const std::string& value)
+  {
+    Column& c = column(prop, Property::STR);
+    c.strings[row] = value;
+    c.present[row] = true;
+  }
+
+
+  /** The identifiers of the names are kept.
+  */
+  void EventBatch::clear()
+  {
+    _nameIds.clear();
+    _dates.clear();
+    _orders.clear();
+    _columns.clear();
+  }
+
+
+  /** \param[in] prop property name
+  */
+  const EventBatch::Column* EventBatch::getColumn(const std::string& prop) const
+  {
+    std::map<std::string, Column>::const_iterator it = _columns.find(prop);
+    if (it == _columns.end())
+      return NULL;
+    return &(it->second);
+  }
+
+
+  /** Compares four identifiers at a time, when SSE2 is available.
+  *   \param[in] nameId identifier of the name sought
+  *   \param[in,out] rows rows found, in increasing order
+  */
+  void EventBatch::findRows(unsigned int nameId, std::vector<size_t>& rows) const
+  {
+#ifdef CRL_EVENT_BATCH_SSE2
+    const size_t n = _nameIds.size();
+    const unsigned int* ids = n ? &_nameIds[0] : NULL;
+    const __m128i key = _mm_set1_epi32((int)nameId);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+      __m128i block = _mm_loadu_si128((const __m128i*)(ids + i));
+      int mask = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(block, key)));
+      while (mask != 0)
+      {
+        int bit = 0;
+        while ( (mask & (1 << bit)) == 0 ) bit++;
+        rows.push_back(i + bit);
+        mask &= mask - 1;
+      }
+    }
+    for (; i < n; i++)
+      if (ids[i] == nameId)
+        rows.push_back(i);
+#else
+    findRowsScalar(nameId, rows);
+#endif
+  }
+
+
+  /** \param[in] nameId identifier of the name sought
+  *   \param[in,out] rows rows found, in increasing order
+  */
+  void EventBatch::findRowsScalar(unsigned int nameId, std::vector<size_t>& rows) const
+  {
+    for (size_t i=0; i<_nameIds.size(); i++)
+      if (_nameIds[i] == nameId)
+        rows.push_back(i);
+  }
+
+
+  /** The event is allocated on the heap, like the events created by
+  *   the recognition engine (see Event::freeAllInstances()).
+  *   \param[in] row row of the event
+  *   \return new event, with the name, date, order and properties of the row
+  */
+  Event* EventBatch::makeEvent(size_t row) const
+  {
+    Event* e = new Event(_names[_nameIds[row]], _dates[row]);
+    e->setOrder(_orders[row]);
+    std::map<std::string, Column>::const_iterator it;
+    for (it=_columns.begin(); it!=_columns.end(); it++)
+    {
+      const Column& c = it->second;
+      if ( (row >= c.present.size()) || (!c.present[row]) )
+        continue;
+      if (c.type == Property::L) (*e)[it->first] = c.longs[row];
+      else if (c.type == Property::D) (*e)[it->first] = c.doubles[row];
+      else (*e)[it->first] = c.strings[row];
+    }
+    return e;
+  }
+
+
+} /* namespace CRL */
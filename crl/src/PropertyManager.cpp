@@ -21,14 +21,18 @@
     You should have received a copy of the Lesser GNU General Public License
     along with CRL.  If not, see <http://www.gnu.org/licenses/>.
 */
-
 // ----------------------------------------------------------------------------
 // INCLUDE FILES
 // ----------------------------------------------------------------------------
 
+#include <cstring>
+#include <new>
+#include <utility>
+
 #include "Context.h"
 #include "Property.h"
 #include "PropertyManager.h"
+#include "RecoTreeArena.h"
 
 
 // ----------------------------------------------------------------------------
@@ -38,17 +42,105 @@
 namespace CRL 
 {
 
+  /** \param[in] pm properties to be copied
+  */
+  PropertyManager::PropertyManager(const PropertyManager& pm)
+    : _block(NULL)
+  {
+    *this = pm;
+  }
+
+
   /** Deletes the properties created by the manager itself, and marked "true"
-  *   in the pair (Property* bool)
+  *   in their entry
   */
   PropertyManager::~PropertyManager()
   {
-    std::map<std::string, PropertyStored>::iterator it;
-    for(it = properties.begin(); it != properties.end(); it++)
+    clearProperties();
+  }
+
+
+  /** A property owned by \a pm is copied (and owned by \a this), so that
+  *   each manager deletes its own properties.
+  *   \param[in] pm properties to be copied
+  *   \return modified manager
+  */
+  PropertyManager& PropertyManager::operator=(const PropertyManager& pm)
+  {
+    if (this == &pm) return *this;
+
+    clearProperties();
+    if (pm._block == NULL) return *this;
+
+    reserve(pm._block->size);
+    Entry* entries = pm._block->entries();
+    for (unsigned int i=0; i<pm._block->size; i++)
+    {
+      Property* p = entries[i].toDelete ? new Property(*entries[i].value) : entries[i].value;
+      insertProperty(entries[i].name, p, entries[i].toDelete);
+    }
+    return *this;
+  }
+
+
+  void PropertyManager::clearProperties()
+  {
+    if (_block == NULL) return;
+
+    Entry* entries = _block->entries();
+    for (unsigned int i=0; i<_block->size; i++)
     {
-      if ((*it).second.second == true)
-        delete (*it).second.first;
+      if (entries[i].toDelete)
+        delete entries[i].value;
+      entries[i].~Entry();
     }
+    RecoTreeArena::deallocateAny(_block);
+    _block = NULL;
+  }
+
+
+  /** The block is allocated in the arena of the thread, if any 
+  *   (see RecoTreeArena::allocateCurrent), with the exact capacity
+  *   at first, then doubled.
+  *   \param[in] n number of entries to be held
+  */
+  void PropertyManager::reserve(size_t n)
+  {
+    size_t size = (_block == NULL) ? 0 : _block->size;
+    size_t capacity = (_block == NULL) ? 0 : _block->capacity;
+    if (n <= capacity) return;
+    if (n < 2*capacity)
+      n = 2*capacity;
+
+    Block* b = (Block*)RecoTreeArena::allocateCurrent(sizeof(Block) + n*sizeof(Entry));
+    b->size = (unsigned int)size;
+    b->capacity = (unsigned int)n;
+    for (size_t i=0; i<size; i++)
+    {
+      new (b->entries() + i) Entry(std::move(_block->entries()[i]));
+      _block->entries()[i].~Entry();
+    }
+    if (_block != NULL)
+      RecoTreeArena::deallocateAny(_block);
+    _block = b;
+  }
+
+
+  /** \param[in] s name of a property
+  *   \return index of the entry of \a s if it exists, of its insertion position otherwise
+  */
+  size_t PropertyManager::lowerBound(char const * const s) const
+  {
+    size_t low = 0, high = (_block == NULL) ? 0 : _block->size;
+    while (low < high)
+    {
+      size_t mid = (low + high) / 2;
+      if (_block->entries()[mid].name.compare(s) < 0)
+        low = mid + 1;
+      else
+        high = mid;
+    }
+    return low;
   }
 
 
@@ -56,7 +148,7 @@ namespace CRL
   */
   int PropertyManager::countProperties() const
   {
-    return (int)properties.size();
+    return (_block == NULL) ? 0 : (int)_block->size;
   }
 
   /** The insertion method does not do anything if the name provided for argument already exists.
@@ -65,7 +157,25 @@ namespace CRL
   */
   void PropertyManager::insertProperty(const std::string& s, Property* p, bool toDelete)
   { 
-    properties.insert(std::pair<std::string, PropertyStored > (s, PropertyStored(p, toDelete)));
+    size_t pos = lowerBound(s.c_str());
+    if ( (_block != NULL) && (pos < _block->size) && (_block->entries()[pos].name == s) )
+      return;
+
+    reserve(countProperties() + 1);
+    Entry* entries = _block->entries();
+    size_t size = _block->size;
+    if (pos == size)
+      new (entries + size) Entry();
+    else
+    {
+      new (entries + size) Entry(std::move(entries[size-1]));
+      for (size_t i=size-1; i>pos; i--)
+        entries[i] = std::move(entries[i-1]);
+    }
+    entries[pos].name = s;
+    entries[pos].value = p;
+    entries[pos].toDelete = toDelete;
+    _block->size++;
   }
 
 
@@ -79,22 +189,21 @@ namespace CRL
                                        bool exceptAnonymous, 
                                        bool transferOwnership)
   {
-    std::map<std::string, PropertyStored>::iterator it;
-    if (transferOwnership)
-    { 
-      for (it=p.properties.begin(); it!=p.properties.end(); it++)
-        if ( (exceptAnonymous == false) || ((*it).first != Context::ANONYMOUS()) )
+    if (p._block == NULL) return;
+    reserve(countProperties() + p._block->size);
+
+    Entry* entries = p._block->entries();
+    for (unsigned int i=0; i<p._block->size; i++)
+      if ( (exceptAnonymous == false) || (entries[i].name != Context::ANONYMOUS()) )
+      {
+        if (transferOwnership)
         {
-          insertProperty( (*it).first, (*it).second.first, (*it).second.second);
-          (*it).second.second = false;
+          insertProperty(entries[i].name, entries[i].value, entries[i].toDelete);
+          entries[i].toDelete = false;
         }
-    }
-    else
-    {
-      for (it=p.properties.begin(); it!=p.properties.end(); it++)
-        if ( (exceptAnonymous == false) || ((*it).first != Context::ANONYMOUS()) )
-          insertProperty( (*it).first, (*it).second.first, false);
-    }
+        else
+          insertProperty(entries[i].name, entries[i].value, false);
+      }
   }
 
 
@@ -129,11 +238,7 @@ namespace CRL
   */
   Property* PropertyManager::findProperty(const std::string& s) const
   {
-    std::map<std::string, PropertyStored>::const_iterator it = properties.find(s);
-    if (it != properties.end())
-      return (it->second.first);
-    else
-      return NULL;
+    return findProperty(s.c_str());
   }
 
 
@@ -141,34 +246,32 @@ namespace CRL
   */
   Property* PropertyManager::findProperty(char const * const s) const
   {
-    std::map<std::string, PropertyStored>::const_iterator it = properties.find(s);
-    if (it != properties.end())
-      return (it->second.first);
+    size_t pos = lowerBound(s);
+    if ( (_block != NULL) && (pos < _block->size) && (_block->entries()[pos].name == s) )
+      return _block->entries()[pos].value;
     else
       return NULL;
   }
 
 
-  /** Looks in list #properties for a property named \a s.
+  /** Looks in list of properties for a property named \a s.
   *   It is exists, returns it. Otherwise, creates it.
   *   \param[in] s desired property name
   *   \return found or created property
   */
   Property& PropertyManager::operator[](char const * const s)
   {
-    std::map<std::string, PropertyStored>::iterator it = properties.find(s);
-    if (it != properties.end())
-      return *(it->second.first);
-    else
+    Property* p = findProperty(s);
+    if (p == NULL)
     {
-      Property* p = new Property();
+      p = new Property();
       insertProperty( s, p, true );
-      return *p;
     }
+    return *p;
   }
 
 
-  /** Looks in list #properties for a property named \a s.
+  /** Looks in list of properties for a property named \a s.
   *   It is exists, returns it. Otherwise, creates it.
   *   \param[in] s desired property name
   *   \return found or created property
@@ -179,22 +282,21 @@ namespace CRL
   }
 
 
-  /** Looks in list #properties for a property named \a s.
+  /** Looks in list of properties for a property named \a s.
   *   It is exists, returns it. Otherwise, raises an exception.
   *   \param[in] s desired property name
   *   \return found property
   */
   const Property& PropertyManager::operator[](char const * const s) const
   {
-    std::map<std::string, PropertyStored>::const_iterator it = properties.find(s);
-    if (it != properties.end())
-      return *(it->second.first);
-    else
+    Property* p = findProperty(s);
+    if (p == NULL)
       throw(std::string("Property ")+s+std::string(" not found"));
+    return *p;
   }
 
 
-  /** Looks in list #properties for a property named \a s.
+  /** Looks in list of properties for a property named \a s.
   *   It is exists, returns it. Otherwise, raises an exception.
   *   \param[in] s desired property name
   *   \return found property
@@ -206,4 +308,3 @@ namespace CRL
 
 
 } /* namespace CRL */
-
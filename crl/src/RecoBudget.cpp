@@ -0,0 +1,178 @@
+/** ***********************************************************************************
+ * \file RecoBudget.cpp
+ * \author Ariane Piel & Jean Bourrely / Onera DCPS
+ * \date 2014
+ * \brief Memory budget of a recognition set and its eviction policies
+ **************************************************************************************/
+
+/*  Copyright (C) 2012, 2013, 2014  ONERA  http://www.onera.fr
+    This file is part of CRL : Chronicle Recognition Library.
+
+    CRL is free software: you can redistribute it and/or modify it under
+    the terms of the Lesser GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    CRL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    Lesser GNU General Public License for more details.
+
+    You should have received a copy of the Lesser GNU General Public License
+    along with CRL.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// ----------------------------------------------------------------------------
+// INCLUDE FILES
+// ----------------------------------------------------------------------------
+
+#include "RecoBudget.h"
+
+
+// ----------------------------------------------------------------------------
+// CLASS METHODS
+// ----------------------------------------------------------------------------
+
+namespace CRL 
+{
+
+  /** \return number of recognitions tracked by the policy
+  */
+  size_t RecoBudget::size() const
+  {
+    if (_policy == OLDEST_MAX_DATE)
+      return _byDate.size();
+    else if (_policy == OLDEST_INSERTION)
+      return _byInsertion.size();
+    else
+      return _slots.size();
+  }
+
+
+  /** \param[in] rc recognition to be tracked
+  */
+  void RecoBudget::track(RecoTree* rc)
+  {
+    if (_policy == OLDEST_MAX_DATE)
+      _byDate.insert(std::make_pair(rc->getMaxDate(), rc));
+    else if (_policy == OLDEST_INSERTION)
+      _insertionPos[rc] = _byInsertion.insert(_byInsertion.end(), rc);
+    else
+    {
+      _slotPos[rc] = _slots.size();
+      _slots.push_back(rc);
+    }
+  }
+
+
+  /** When the budget is exceeded, the victim is chosen by the policy. In the
+  *   case of the reservoir sampling, each of the recognitions offered so far
+  *   has the same probability to remain in the set: the victim is either
+  *   a random recognition of the reservoir or \a rc itself.
+  *   \param[in] rc new recognition of the set
+  *   \return recognition to be evicted from the set (possibly \a rc), NULL if none
+  */
+  RecoTree* RecoBudget::admit(RecoTree* rc)
+  {
+    if (_policy != RESERVOIR)
+    {
+      track(rc);
+      return (size() > _maxSize) ? evict() : NULL;
+    }
+
+    _seen++;
+    if (_slots.size() < _maxSize)
+    {
+      track(rc);
+      return NULL;
+    }
+
+    unsigned long j = _random() % _seen;
+    if (j >= _slots.size())
+      return rc;
+
+    RecoTree* victim = _slots[j];
+    _slotPos.erase(victim);
+    _slots[j] = rc;
+    _slotPos[rc] = j;
+    return victim;
+  }
+
+
+  /** \param[in] rc recognition which has left the set (ignored if not tracked)
+  */
+  void RecoBudget::erase(RecoTree* rc)
+  {
+    if (_policy == OLDEST_MAX_DATE)
+    {
+      std::pair<std::multimap<DateType, RecoTree*>::iterator,
+                std::multimap<DateType, RecoTree*>::iterator> range;
+      range = _byDate.equal_range(rc->getMaxDate());
+      for ( ; range.first != range.second; range.first++)
+        if (range.first->second == rc)
+        {
+          _byDate.erase(range.first);
+          return;
+        }
+    }
+    else if (_policy == OLDEST_INSERTION)
+    {
+      std::unordered_map<RecoTree*, std::list<RecoTree*>::iterator>::iterator it;
+      it = _insertionPos.find(rc);
+      if (it == _insertionPos.end()) return;
+      _byInsertion.erase(it->second);
+      _insertionPos.erase(it);
+    }
+    else
+    {
+      // The last slot takes the place of the erased one
+      std::unordered_map<RecoTree*, size_t>::iterator it = _slotPos.find(rc);
+      if (it == _slotPos.end()) return;
+      size_t pos = it->second;
+      _slotPos.erase(it);
+      if (pos + 1 < _slots.size())
+      {
+        _slots[pos] = _slots.back();
+        _slotPos[_slots[pos]] = pos;
+      }
+      _slots.pop_back();
+    }
+  }
+
+
+  /** \return recognition to be evicted from the set, NULL if the set is empty
+  */
+  RecoTree* RecoBudget::evict()
+  {
+    RecoTree* victim = NULL;
+    if (_policy == OLDEST_MAX_DATE)
+    {
+      if (_byDate.empty()) return NULL;
+      victim = _byDate.begin()->second;
+    }
+    else if (_policy == OLDEST_INSERTION)
+    {
+      if (_byInsertion.empty()) return NULL;
+      victim = _byInsertion.front();
+    }
+    else
+    {
+      if (_slots.empty()) return NULL;
+      victim = _slots[_random() % _slots.size()];
+    }
+    erase(victim);
+    return victim;
+  }
+
+
+  void RecoBudget::clear()
+  {
+    _byDate.clear();
+    _byInsertion.clear();
+    _insertionPos.clear();
+    _slots.clear();
+    _slotPos.clear();
+  }
+
+
+} /* namespace CRL */
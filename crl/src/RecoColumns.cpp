@@ -0,0 +1,207 @@
+/** ***********************************************************************************
+ * \file RecoColumns.cpp
+ * \author Ariane Piel & Jean Bourrely / Onera DCPS
+ * \date 2014
+ * \brief Columns of the orders of a recognition set
+ **************************************************************************************/
+
+/*  Copyright (C) 2012, 2013, 2014  ONERA  http://www.onera.fr
+    This file is part of CRL : Chronicle Recognition Library.
+
+    CRL is free software: you can redistribute it and/or modify it under
+    the terms of the Lesser GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    CRL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    Lesser GNU General Public License for more details.
+
+    You should have received a copy of the Lesser GNU General Public License
+    along with CRL.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// ----------------------------------------------------------------------------
+// INCLUDE FILES
+// ----------------------------------------------------------------------------
+
+#include <limits>
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define CRL_RECO_COLUMNS_AVX2
+#endif
+
+#include "RecoColumns.h"
+
+
+// ----------------------------------------------------------------------------
+// CLASS METHODS
+// ----------------------------------------------------------------------------
+
+namespace CRL 
+{
+
+  //! Initialisation of the class constants
+  const int64_t RecoColumns::NO_LOWER_BOUND = std::numeric_limits<int64_t>::min();
+  const int64_t RecoColumns::NO_UPPER_BOUND = std::numeric_limits<int64_t>::max();
+
+
+#ifdef CRL_RECO_COLUMNS_AVX2
+  /** Compares four rows at a time; the remaining rows are left to the caller.
+  *   \return number of rows examined
+  */
+  __attribute__((target("avx2")))
+  static size_t selectAVX2(const int64_t* minOrders, const int64_t* maxOrders, size_t n,
+                           int64_t minLow, int64_t minHigh, int64_t maxLow, int64_t maxHigh,
+                           std::vector<size_t>& rows)
+  {
+    const __m256i vMinLow  = _mm256_set1_epi64x(minLow);
+    const __m256i vMinHigh = _mm256_set1_epi64x(minHigh);
+    const __m256i vMaxLow  = _mm256_set1_epi64x(maxLow);
+    const __m256i vMaxHigh = _mm256_set1_epi64x(maxHigh);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+      __m256i mn = _mm256_loadu_si256((const __m256i*)(minOrders + i));
+      __m256i mx = _mm256_loadu_si256((const __m256i*)(maxOrders + i));
+      __m256i ok = _mm256_and_si256(
+        _mm256_and_si256(_mm256_cmpgt_epi64(mn, vMinLow), _mm256_cmpgt_epi64(vMinHigh, mn)),
+        _mm256_and_si256(_mm256_cmpgt_epi64(mx, vMaxLow), _mm256_cmpgt_epi64(vMaxHigh, mx)));
+      int mask = _mm256_movemask_pd(_mm256_castsi256_pd(ok));
+      while (mask != 0)
+      {
+        int bit = __builtin_ctz(mask);
+        rows.push_back(i + bit);
+        mask &= mask - 1;
+      }
+    }
+    return i;
+  }
+#endif
+
+
+  /** \return true if the processor supports AVX2 (checked once)
+  */
+  bool RecoColumns::hasAVX2()
+  {
+#ifdef CRL_RECO_COLUMNS_AVX2
+    static const bool avx2 = __builtin_cpu_supports("avx2");
+    return avx2;
+#else
+    return false;
+#endif
+  }
+
+
+  /** The columns mirror a recognition set row by row: the row of a
+  *   recognition is its position in the set, so that no table of the rows
+  *   is needed. The rows up to \a row are added empty if necessary (erased
+  *   positions of the set, or positions of the set before the columns).
+  *   \param[in] row position of the recognition in the set (after the last row)
+  *   \param[in] rc recognition
+  */
+  void RecoColumns::insert(size_t row, RecoTree* rc)
+  {
+    if (row < _trees.size())
+      throw("RecoColumns : row already used");
+    _minOrders.resize(row, NO_LOWER_BOUND);
+    _maxOrders.resize(row, NO_LOWER_BOUND);
+    _trees.resize(row, NULL);
+    _minOrders.push_back(rc->getMinOrder());
+    _maxOrders.push_back(rc->getMaxOrder());
+    _trees.push_back(rc);
+    _size++;
+  }
+
+
+  /** The rows keep the order of insertion of the recognitions, as the
+  *   recognition sets do (see RecoSet): the row of the recognition is only
+  *   emptied. Its orders are set to #NO_LOWER_BOUND, which no strict lower
+  *   bound of #select lets through.
+  *   \param[in] row row of the recognition (ignored if empty)
+  */
+  void RecoColumns::erase(size_t row)
+  {
+    if ( (row >= _trees.size()) || (_trees[row] == NULL) ) return;
+
+    _minOrders[row] = NO_LOWER_BOUND;
+    _maxOrders[row] = NO_LOWER_BOUND;
+    _trees[row]     = NULL;
+    _size--;
+  }
+
+
+  void RecoColumns::clear()
+  {
+    _minOrders.clear();
+    _maxOrders.clear();
+    _trees.clear();
+    _size = 0;
+  }
+
+
+  /** The rows are renumbered, in the same order, as the positions of the
+  *   mirrored set: to be called when RecoSet::compact returns true. The rows
+  *   previously returned by #select are no longer valid.
+  */
+  void RecoColumns::compact()
+  {
+    size_t n = 0;
+    for (size_t i = 0; i < _trees.size(); i++)
+      if (_trees[i] != NULL)
+      {
+        _minOrders[n] = _minOrders[i];
+        _maxOrders[n] = _maxOrders[i];
+        _trees[n]     = _trees[i];
+        n++;
+      }
+    _minOrders.resize(n);
+    _maxOrders.resize(n);
+    _trees.resize(n);
+  }
+
+
+  /** Filters the order columns with AVX2 when the processor supports it 
+  *   (see #hasAVX2), with #selectScalar otherwise. The bounds are strict,
+  *   #NO_LOWER_BOUND and #NO_UPPER_BOUND disable a bound. The empty rows
+  *   are never selected.
+  *   \param[in] minLow lower bound of the minimal order
+  *   \param[in] minHigh upper bound of the minimal order
+  *   \param[in] maxLow lower bound of the maximal order
+  *   \param[in] maxHigh upper bound of the maximal order
+  *   \param[in,out] rows rows found, in increasing order
+  */
+  void RecoColumns::select(int64_t minLow, int64_t minHigh, int64_t maxLow, int64_t maxHigh,
+                           std::vector<size_t>& rows) const
+  {
+    size_t i = 0, n = _trees.size();
+#ifdef CRL_RECO_COLUMNS_AVX2
+    if ( (n >= 4) && hasAVX2() )
+      i = selectAVX2(&_minOrders[0], &_maxOrders[0], n, minLow, minHigh, maxLow, maxHigh, rows);
+#endif
+    for (; i < n; i++)
+      if ( (_minOrders[i] > minLow) && (_minOrders[i] < minHigh) &&
+           (_maxOrders[i] > maxLow) && (_maxOrders[i] < maxHigh) )
+        rows.push_back(i);
+  }
+
+
+  /** \param[in] minLow lower bound of the minimal order
+  *   \param[in] minHigh upper bound of the minimal order
+  *   \param[in] maxLow lower bound of the maximal order
+  *   \param[in] maxHigh upper bound of the maximal order
+  *   \param[in,out] rows rows found, in increasing order
+  */
+  void RecoColumns::selectScalar(int64_t minLow, int64_t minHigh, int64_t maxLow, int64_t maxHigh,
+                                 std::vector<size_t>& rows) const
+  {
+    for (size_t i = 0; i < _trees.size(); i++)
+      if ( (_minOrders[i] > minLow) && (_minOrders[i] < minHigh) &&
+           (_maxOrders[i] > maxLow) && (_maxOrders[i] < maxHigh) )
+        rows.push_back(i);
+  }
+
+
+} /* namespace CRL */
@@ -0,0 +1,174 @@
+/** ***********************************************************************************
+ * \file RecoIndex.cpp
+ * \author Ariane Piel & Jean Bourrely / Onera DCPS
+ * \date 2014
+ * \brief Hash index of a recognition set on equi-join keys
+ **************************************************************************************/
+
+/*  Copyright (C) 2012, 2013, 2014  ONERA  http://www.onera.fr
+    This file is part of CRL : Chronicle Recognition Library.
+
+    CRL is free software: you can redistribute it and/or modify it under
+    the terms of the Lesser GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    CRL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    Lesser GNU General Public License for more details.
+
+    You should have received a copy of the Lesser GNU General Public License
+    along with CRL.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// ----------------------------------------------------------------------------
+// INCLUDE FILES
+// ----------------------------------------------------------------------------
+
+#include <cmath>
+#include <limits>
+
+#include "Property.h"
+#include "RecoIndex.h"
+
+
+// ----------------------------------------------------------------------------
+// CLASS METHODS
+// ----------------------------------------------------------------------------
+
+namespace CRL 
+{
+
+  //! Definition of the class variable
+  const RecoIndex::Bucket RecoIndex::EMPTY_BUCKET;
+
+
+  /** \param[in] rc recognition to be indexed
+  */
+  void RecoIndex::insert(RecoTree* rc)
+  {
+    std::string key;
+    if (extractKey(*rc, _paths, key))
+      _buckets[key].insert(rc);
+  }
+
+
+  /** \param[in] rc recognition to be removed from the index
+  */
+  void RecoIndex::erase(RecoTree* rc)
+  {
+    std::string key;
+    if (extractKey(*rc, _paths, key))
+    {
+      std::unordered_map<std::string, Bucket>::iterator it = _buckets.find(key);
+      if (it != _buckets.end())
+      {
+        it->second.erase(rc);
+        if (it->second.empty())
+          _buckets.erase(it);
+      }
+    }
+  }
+
+
+  /** \param[in] key value of the key
+  *   \return set of the recognitions with this key (possibly empty)
+  */
+  const RecoIndex::Bucket& RecoIndex::find(const std::string& key) const
+  {
+    std::unordered_map<std::string, Bucket>::const_iterator it = _buckets.find(key);
+    if (it == _buckets.end())
+      return EMPTY_BUCKET;
+    return it->second;
+  }
+
+
+  /** The value of each property is encoded with its type family, so that
+  *   integral values compare equal whatever their C++ type (as the casts
+  *   of the user predicates do). The values are appended in binary form
+  *   (strings prefixed with their length), without any formatting.
+  *   \param[in] pm property set (typically a recognition tree)
+  *   \param[in] paths paths of the properties making up the key
+  *   \param[out] key computed key
+  *   \return false if one of the properties does not exist
+  */
+  bool RecoIndex::extractKey(const PropertyManager& pm, const KeyPaths& paths, 
+                             std::string& key)
+  {
+    key.clear();
+    KeyPaths::const_iterator itP;
+    for (itP = paths.begin(); itP != paths.end(); itP++)
+    {
+      const PropertyManager* current = &pm;
+      const Property* p = NULL;
+      PropertyPath::const_iterator itN;
+      for (itN = itP->begin(); itN != itP->end(); itN++)
+      {
+        p = current->findProperty(*itN);
+        if (p == NULL) return false;
+        current = p;
+      }
+      if (p == NULL) return false;
+
+      // Integral and floating values are reduced to a common representation
+      bool isIntegral = true;
+      long l = 0;
+      double v = 0.0;
+      if (p->isBool())              l = (bool)(*p);
+      else if (p->isChar())         l = (char)(*p);
+      else if (p->isWchar_t())      l = (wchar_t)(*p);
+      else if (p->isInt())          l = (int)(*p);
+      else if (p->isUnsignedInt())  l = (unsigned int)(*p);
+      else if (p->isLong())         l = (long)(*p);
+      else if (p->isUnsignedLong()) l = (long)(unsigned long)(*p);
+      else
+      {
+        isIntegral = false;
+        if (p->isFloat())       v = (float)(*p);
+        else if (p->isDouble()) v = (double)(*p);
+      }
+
+      // A floating value is integral if it has no fractional part and fits
+      // in a long (the conversion of a value out of range is undefined)
+      if ( !isIntegral && (p->isFloat() || p->isDouble()) &&
+           (v >= (double)std::numeric_limits<long>::min()) &&
+           (v < -(double)std::numeric_limits<long>::min()) && (std::trunc(v) == v) )
+      {
+        isIntegral = true;
+        l = (long)v;
+      }
+
+      if (isIntegral)
+      {
+        key += 'i';
+        key.append((const char*)&l, sizeof(l));
+      }
+      else if (p->isFloat() || p->isDouble())
+      {
+        key += 'd';
+        key.append((const char*)&v, sizeof(v));
+      }
+      else if (p->isString())
+      {
+        const std::string& s = (std::string)(*p);
+        size_t n = s.size();
+        key += 's';
+        key.append((const char*)&n, sizeof(n));
+        key.append(s);
+      }
+      else if (p->isWstring())
+      {
+        const std::wstring& w = (std::wstring)(*p);
+        size_t n = w.size();
+        key += 'w';
+        key.append((const char*)&n, sizeof(n));
+        key.append((const char*)w.data(), n * sizeof(wchar_t));
+      }
+      else
+        return false;
+    }
+    return true;
+  }
+
+} /* namespace CRL */
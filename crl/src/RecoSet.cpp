@@ -0,0 +1,301 @@
+/** ***********************************************************************************
+ * \file RecoSet.cpp
+ * \author Ariane Piel & Jean Bourrely / Onera DCPS
+ * \date 2014
+ * \brief Insertion-ordered set of recognitions, stored by chunks
+ **************************************************************************************/
+
+/*  Copyright (C) 2012, 2013, 2014  ONERA  http://www.onera.fr
+    This file is part of CRL : Chronicle Recognition Library.
+
+    CRL is free software: you can redistribute it and/or modify it under
+    the terms of the Lesser GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    CRL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    Lesser GNU General Public License for more details.
+
+    You should have received a copy of the Lesser GNU General Public License
+    along with CRL.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// ----------------------------------------------------------------------------
+// INCLUDE FILES
+// ----------------------------------------------------------------------------
+
+#include "RecoSet.h"
+
+
+// ----------------------------------------------------------------------------
+// CLASS METHODS
+// ----------------------------------------------------------------------------
+
+namespace CRL 
+{
+
+  /** \param[in] s set to be copied
+  */
+  RecoSet::RecoSet(const RecoSet& s)
+    : _end(0), _size(0), _tableUsed(0)
+  {
+    const_iterator it;
+    for (it=s.begin(); it!=s.end(); it++)
+      insert(*it);
+  }
+
+
+  RecoSet::~RecoSet()
+  {
+    for (size_t k=0; k<_chunks.size(); k++)
+      delete[] _chunks[k];
+  }
+
+
+  /** \param[in] s set to be copied
+  *   \return modified set
+  */
+  RecoSet& RecoSet::operator=(const RecoSet& s)
+  {
+    if (this != &s)
+    {
+      clear();
+      const_iterator it;
+      for (it=s.begin(); it!=s.end(); it++)
+        insert(*it);
+    }
+    return *this;
+  }
+
+
+  /** \return position of the oldest recognition
+  */
+  RecoSet::const_iterator RecoSet::begin() const
+  {
+    const_iterator it(this, 0, 0, 0);
+    it.skip();
+    return it;
+  }
+
+
+  /** The recognition is appended after the others, in constant time
+  *   (the chunks already filled are never moved).
+  *   \param[in] rc recognition to be inserted
+  *   \return position of the recognition, and true if it has been inserted
+  */
+  std::pair<RecoSet::const_iterator, bool> RecoSet::insert(RecoTree* rc)
+  {
+    if (rc == NULL)
+      throw("RecoSet : null recognition");
+
+    size_t pos = locate(rc);
+    if (pos != _end)
+      return std::make_pair(at(pos), false);
+
+    size_t n = _chunks.size();
+    if (_end == FIRST_CHUNK * (((size_t)1 << n) - 1))
+      _chunks.push_back(new RecoTree*[FIRST_CHUNK << n]);
+    pos = _end++;
+    slot(pos) = rc;
+    _size++;
+
+    if (_end > FIRST_CHUNK)
+    {
+      if ( _table.empty() || (2*(_tableUsed + 1) > _table.size()) )
+        rebuildTable();
+      else
+      {
+        size_t i = probe(rc);
+        _table[i].key = rc;
+        _table[i].pos = pos;
+        _tableUsed++;
+      }
+    }
+    return std::make_pair(at(pos), true);
+  }
+
+
+  /** The position of the recognition becomes a tombstone, so that the
+  *   iterators stay valid (see #compact).
+  *   \param[in] rc recognition to be erased
+  *   \return 1 if the recognition was present, 0 otherwise
+  */
+  size_t RecoSet::erase(RecoTree* rc)
+  {
+    if (rc == NULL) return 0;
+
+    size_t pos = _end;
+    if (_table.empty())
+      pos = locate(rc);
+    else
+    {
+      size_t i = probe(rc);
+      if (_table[i].key == rc)
+      {
+        pos = _table[i].pos;
+        _table[i].key = NULL;
+        _table[i].pos = 1;
+      }
+    }
+    if (pos == _end) return 0;
+
+    slot(pos) = NULL;
+    _size--;
+    return 1;
+  }
+
+
+  /** \param[in] it position of the recognition to be erased
+  *   \return position of the following recognition
+  */
+  RecoSet::const_iterator RecoSet::erase(RecoSet::const_iterator it)
+  {
+    RecoTree* rc = *it;
+    const_iterator next(it);
+    ++next;
+    erase(rc);
+    return next;
+  }
+
+
+  /** \param[in] rc sought after recognition
+  *   \return position of the recognition, #end if absent
+  */
+  RecoSet::const_iterator RecoSet::find(RecoTree* rc) const
+  {
+    size_t pos = locate(rc);
+    return (pos == _end) ? end() : at(pos);
+  }
+
+
+  /** The first chunk is kept for the next insertions.
+  */
+  void RecoSet::clear()
+  {
+    for (size_t k=1; k<_chunks.size(); k++)
+      delete[] _chunks[k];
+    if (_chunks.size() > 1)
+      _chunks.resize(1);
+    _end = 0;
+    _size = 0;
+    _table.clear();
+    _tableUsed = 0;
+  }
+
+
+  /** The recognitions are moved towards the beginning, in the same order,
+  *   and the chunks no longer used are freed. Must not be called while
+  *   the set is iterated.
+  *   \return true if the positions have been renumbered
+  */
+  bool RecoSet::compact()
+  {
+    if (getTombstoneCount() <= _size) return false;
+
+    size_t w = 0;
+    const_iterator it;
+    for (it=begin(); it!=end(); ++it)
+      slot(w++) = *it;
+    _end = _size;
+
+    while ( (_chunks.size() > 1) && 
+            (FIRST_CHUNK * (((size_t)1 << (_chunks.size() - 1)) - 1) >= _end) )
+    {
+      delete[] _chunks.back();
+      _chunks.pop_back();
+    }
+    _table.clear();
+    _tableUsed = 0;
+    if (_end > FIRST_CHUNK)
+      rebuildTable();
+    return true;
+  }
+
+
+  /** While the first chunk is enough, it is scanned instead of the table.
+  *   \param[in] rc sought after recognition
+  *   \return position of the recognition, #_end if absent
+  */
+  size_t RecoSet::locate(RecoTree* rc) const
+  {
+    if (rc == NULL)
+      return _end;
+    if (_table.empty())
+    {
+      for (size_t pos=0; pos<_end; pos++)
+        if (_chunks[0][pos] == rc) return pos;
+      return _end;
+    }
+    size_t i = probe(rc);
+    return (_table[i].key == rc) ? _table[i].pos : _end;
+  }
+
+
+  /** \param[in] pos position (lower than #_end)
+  *   \return iterator on this position
+  */
+  RecoSet::const_iterator RecoSet::at(size_t pos) const
+  {
+    size_t k = 0, offset = pos, chunkSize = FIRST_CHUNK;
+    while (offset >= chunkSize)
+    {
+      offset -= chunkSize;
+      chunkSize <<= 1;
+      k++;
+    }
+    return const_iterator(this, k, offset, pos);
+  }
+
+
+  /** \param[in] pos position (lower than #_end)
+  *   \return reference to the recognition at this position
+  */
+  RecoTree*& RecoSet::slot(size_t pos)
+  {
+    const_iterator it = at(pos);
+    return _chunks[it._chunk][it._offset];
+  }
+
+
+  /** Linear probing from the (mixed) address of the recognition.
+  *   \param[in] rc sought after recognition
+  *   \return index of its slot, or of the first empty slot found
+  */
+  size_t RecoSet::probe(RecoTree* rc) const
+  {
+    size_t mask = _table.size() - 1;
+    size_t h = reinterpret_cast<size_t>(rc) >> 4;
+    h *= (size_t)2654435761U;
+    h ^= (h >> 16);
+    size_t i = h & mask;
+    while ( (_table[i].key != rc) && ((_table[i].key != NULL) || (_table[i].pos != 0)) )
+      i = (i + 1) & mask;
+    return i;
+  }
+
+
+  /** The table is at most a quarter full after a rebuild, the erased
+  *   slots being dropped.
+  */
+  void RecoSet::rebuildTable()
+  {
+    size_t capacity = 16;
+    while (capacity < 4*_size)
+      capacity <<= 1;
+    Slot empty = { NULL, 0 };
+    _table.assign(capacity, empty);
+    _tableUsed = 0;
+
+    const_iterator it;
+    for (it=begin(); it!=end(); ++it)
+    {
+      size_t i = probe(*it);
+      _table[i].key = *it;
+      _table[i].pos = it._pos;
+      _tableUsed++;
+    }
+  }
+
+} /* namespace CRL */
@@ -28,6 +28,8 @@
 
 #include "Chronicle.h"
 #include "RecoTree.h"
+#include "RecoTreeSingle.h"
+#include "RecoTreeCouple.h"
 #include "RecognitionEngine.h"
 
 
@@ -38,6 +40,117 @@
 namespace CRL 
 {
 
+  /** The structural hash of such a recognition is made of its orders (see #equal).
+  *   \param[in] minOrder min order
+  *   \param[in] maxOrder max order
+  *   \param[in] minDate min date
+  *   \param[in] maxDate max date
+  */
+  RecoTree::RecoTree(long minOrder, long maxOrder, const DateType& minDate, const DateType& maxDate)
+    : _minOrder(minOrder), _maxOrder(maxOrder), _minDate(minDate), _maxDate(maxDate), _myChronicle(NULL),
+      _structuralHash(0), _refCount(0), _arity(0)
+  {
+    _structuralHash = combineHash(combineHash(_structuralHash, (std::size_t)_minOrder), (std::size_t)_maxOrder);
+  }
+
+
+  /** The destructor of RecoTree is not virtual: the sub-class is given by #_arity.
+  */
+  void RecoTree::destroy() const
+  {
+    switch (_arity)
+    {
+      case 1:  delete static_cast<const RecoTreeSingle*>(this); break;
+      case 2:  delete static_cast<const RecoTreeCouple*>(this); break;
+      default: delete this;
+    }
+  }
+
+
+  /** \return the event of a single node, NULL otherwise
+  */
+  const Event* RecoTree::getEvent() const
+  {
+    if (_arity == 1)
+      return static_cast<const RecoTreeSingle*>(this)->getEvent();
+    return NULL;
+  }
+
+
+  /** \return the left member of a couple, the lower node of a single node, NULL otherwise
+  */
+  const RecoTree* RecoTree::getLeftMember() const
+  {
+    switch (_arity)
+    {
+      case 1:  return static_cast<const RecoTreeSingle*>(this)->getLeftMember();
+      case 2:  return static_cast<const RecoTreeCouple*>(this)->getLeftMember();
+      default: return NULL;
+    }
+  }
+
+
+  /** \return the right member of a couple, the lower node of a single node, NULL otherwise
+  */
+  const RecoTree* RecoTree::getRightMember() const
+  {
+    switch (_arity)
+    {
+      case 1:  return static_cast<const RecoTreeSingle*>(this)->getRightMember();
+      case 2:  return static_cast<const RecoTreeCouple*>(this)->getRightMember();
+      default: return NULL;
+    }
+  }
+
+
+  /** Recognitions without member are equal if they have the same dates and orders.
+  *   \param[in] t recognition tree to be compared
+  *   \return true if the two trees are identical
+  */
+  bool RecoTree::equal(const RecoTree* t) const
+  {
+    switch (_arity)
+    {
+      case 1:  return static_cast<const RecoTreeSingle*>(this)->equal(t);
+      case 2:  return static_cast<const RecoTreeCouple*>(this)->equal(t);
+      default:
+        return (t != NULL) && (t->_arity == 0) && (t->_structuralHash == _structuralHash)
+          && (t->_minOrder == _minOrder) && (t->_maxOrder == _maxOrder)
+          && (t->_minDate == _minDate) && (t->_maxDate == _maxDate);
+    }
+  }
+
+
+  /** \return the most recent (leaf) event of the tree, NULL for a recognition without member
+  */
+  const Event* RecoTree::lastEvent() const
+  {
+    switch (_arity)
+    {
+      case 1:  return static_cast<const RecoTreeSingle*>(this)->lastEvent();
+      case 2:  return static_cast<const RecoTreeCouple*>(this)->lastEvent();
+      default: return NULL;
+    }
+  }
+
+
+  /** A recognition without member is displayed with its dates.
+  *   \param[in] ntab tabulations to be respected for the tree view display
+  *   \param[in,out] os display flow
+  */
+  void RecoTree::prettyPrint(std::ostream& os, int ntab) const
+  {
+    switch (_arity)
+    {
+      case 1:  static_cast<const RecoTreeSingle*>(this)->prettyPrint(os, ntab); break;
+      case 2:  static_cast<const RecoTreeCouple*>(this)->prettyPrint(os, ntab); break;
+      default:
+        for(int n=0; n<ntab; n++) os << ' ';
+        os << "<[" << _minDate << "," << _maxDate << "]>" << std::endl;
+    }
+  }
+
+
   //! Accessor, via the chronicle
   RecognitionEngine* RecoTree::getMyEngine() 
   { 
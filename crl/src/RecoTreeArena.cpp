@@ -0,0 +1,78 @@
+/** ***********************************************************************************
+ * \file RecoTreeArena.cpp
+ * \author Ariane Piel & Jean Bourrely / Onera DCPS
+ * \date 2014
+ * \brief Segmented memory arena for the recognition trees and their properties
+ **************************************************************************************/
+
+/*  Copyright (C) 2012, 2013, 2014  ONERA  http://www.onera.fr
+    This file is part of CRL : Chronicle Recognition Library.
+
+    CRL is free software: you can redistribute it and/or modify it under
+    the terms of the Lesser GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    CRL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    Lesser GNU General Public License for more details.
+
+    You should have received a copy of the Lesser GNU General Public License
+    along with CRL.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// ----------------------------------------------------------------------------
+// INCLUDE FILES
+// ----------------------------------------------------------------------------
+
+#include <new>
+
+#include "RecoTreeArena.h"
+
+
+// ----------------------------------------------------------------------------
+// CLASS METHODS
+// ----------------------------------------------------------------------------
+
+namespace CRL 
+{
+
+  //! Definition of the class variable
+  thread_local RecoTreeArena* RecoTreeArena::_currentArena = NULL;
+
+
+  /** Without an arena, the allocation is a plain heap allocation.
+  *   \param[in] size number of bytes
+  *   \return address aligned on SegmentedArena::ALIGNMENT
+  */
+  void* RecoTreeArena::allocateCurrent(size_t size)
+  {
+    if (_currentArena != NULL)
+      return _currentArena->allocate(size);
+    return ::operator new(size);
+  }
+
+
+  /** The arena of the memory, if any, is found from its address, so that
+  *   the deallocation is possible whatever the arena current at that time.
+  *   \param[in] ptr address returned by #allocateCurrent
+  */
+  void RecoTreeArena::deallocateAny(void* ptr)
+  {
+    if ( (ptr != NULL) && !deallocate(ptr) )
+      ::operator delete(ptr);
+  }
+
+
+  /** \param[in] arena arena of the next allocations of the thread (NULL: heap)
+  *   \return previous arena
+  */
+  RecoTreeArena* RecoTreeArena::setCurrent(RecoTreeArena* arena)
+  {
+    RecoTreeArena* previous = _currentArena;
+    _currentArena = arena;
+    return previous;
+  }
+
+} /* namespace CRL */
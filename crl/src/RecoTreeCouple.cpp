@@ -47,11 +47,32 @@ namespace CRL
   */
 
 
-  /** \param[in] e event at this node of the tree
+  /** The members (possibly NULL) are held by the new node, so that they
+  *   are not deleted before it.
+  *   \param[in] left left member
+  *   \param[in] right right member
   */
-  RecoTreeCouple::RecoTreeCouple(const RecoTree* left, const RecoTree* right, bool rightToDelete)
-    : RecoTree(2), _leftMember(left), _rightMember(right), _rightToDelete(rightToDelete)
+  RecoTreeCouple::RecoTreeCouple(const RecoTree* left, const RecoTree* right)
+    : RecoTree(2), _leftMember(left), _rightMember(right)
   {
+    if (_leftMember != NULL)
+      _leftMember->addRef();
+    if (_rightMember != NULL)
+      _rightMember->addRef();
+
+    _structuralHash = combineHash(_structuralHash, (_leftMember  == NULL) ? 0 : _leftMember->getStructuralHash());
+    _structuralHash = combineHash(_structuralHash, (_rightMember == NULL) ? 0 : _rightMember->getStructuralHash());
+  }
+
+
+  /** Releases the members, which are deleted if not held elsewhere.
+  */
+  RecoTreeCouple::~RecoTreeCouple()
+  {
+    if (_leftMember != NULL)
+      _leftMember->release();
+    if (_rightMember != NULL)
+      _rightMember->release();
   }
 
 
@@ -79,17 +100,23 @@ namespace CRL
   }
 
 
-  /** Recursively examines the sub-trees and compares them.
+  /** Recursively examines the sub-trees and compares them. Trees of different
+  *   structural hashes are told apart at once, and the comparison stops at the 
+  *   members shared by both trees.
   *   \param[in] t recognition tree to be compared
   *   \return true sif both trees are indentical
   */
   bool RecoTreeCouple::equal(const RecoTree* t) const 
   {
     if ((t == NULL) || (t->getArity() != 2)) return false;
+    if (t == this) return true;
+    if (t->getStructuralHash() != _structuralHash) return false;
 
     const RecoTree* t_leftMember  = t->getLeftMember();
     const RecoTree* t_rightMember = t->getRightMember();
 
+    if ((_leftMember == t_leftMember) && (_rightMember == t_rightMember)) return true;
+
     if ((_leftMember  == NULL) && (t_leftMember  != NULL)) return false;
     if ((_rightMember == NULL) && (t_rightMember != NULL)) return false;
 
@@ -48,19 +48,45 @@ namespace CRL
 
   
 
-  /** \param[in] e event at this node of the tree
+  /** A dynamic event is held by the node, so that it is not deleted before it.
+  *   \param[in] e event at this node of the tree
+  *   \param[in] eventToDelete true if the event is to be deleted with its last holder
   */
   RecoTreeSingle::RecoTreeSingle(const Event* e, bool eventToDelete)
-    : RecoTree(1), _event(e), _tree(NULL), _eventToDelete(eventToDelete), _treeToDelete(false)
+    : RecoTree(1), _eventHeld((e != NULL) && e->isDynamic()), _hasTree(false), _event(e), _heldTree(NULL)
   { 
+    if (_eventHeld)
+    {
+      if (eventToDelete)
+        _event->setReleasable();
+      _event->addRef();
+    }
+    _structuralHash = combineHash(_structuralHash, (std::size_t)_event);
   }
 
 
   /** \param[in] r inferior node
   */
-  RecoTreeSingle::RecoTreeSingle(const RecoTree* r, bool treeToDelete)
-    : RecoTree(1), _event(NULL), _tree(r),_eventToDelete(false), _treeToDelete(treeToDelete)
+  RecoTreeSingle::RecoTreeSingle(const RecoTree* r)
+    : RecoTree(1), _eventHeld(false), _hasTree(true), _tree(r), _heldTree(NULL)
   { 
+    if (_tree != NULL)
+      _tree->addRef();
+    _structuralHash = combineHash(_structuralHash, (_tree == NULL) ? 0 : _tree->getStructuralHash());
+  }
+
+
+  /** Used when the properties of a recognition are copied (without transfer
+  *   of ownership) into a node which does not contain it, as for chronicle AT.
+  *   \param[in] r recognition owning the shared properties
+  */
+  void RecoTreeSingle::holdTree(const RecoTree* r)
+  {
+    if (r != NULL)
+      r->addRef();
+    if (_heldTree != NULL)
+      _heldTree->release();
+    _heldTree = r;
   }
 
   /** Returns a pointer to the event at this node of the tree.
@@ -68,7 +94,7 @@ namespace CRL
   */
   const Event* RecoTreeSingle::getEvent() const
   { 
-    return _event;
+    return _hasTree ? NULL : _event;
   }
 
 
@@ -76,7 +102,7 @@ namespace CRL
   */
   const RecoTree* RecoTreeSingle::getLeftMember() const
   {
-    return _tree;
+    return _hasTree ? _tree : NULL;
   }
 
 
@@ -84,18 +110,21 @@ namespace CRL
   */
   const RecoTree* RecoTreeSingle::getRightMember() const
   {
-    return _tree;
+    return _hasTree ? _tree : NULL;
   }
 
 
-  /** Possibly calls the destructor of the contained object
+  /** Releases the event and the lower node, which are deleted if not 
+  *   held elsewhere (and releasable, for the event).
   */
   RecoTreeSingle::~RecoTreeSingle()
   {
-    if (_eventToDelete)
-      delete _event;
-    if (_treeToDelete)
-      delete _tree;
+    if (_eventHeld)
+      _event->release();
+    if (_hasTree && (_tree != NULL))
+      _tree->release();
+    if (_heldTree != NULL)
+      _heldTree->release();
   }
 
 
@@ -107,14 +136,17 @@ namespace CRL
   bool RecoTreeSingle::equal(const RecoTree* t) const 
   {
     if ((t == NULL) || (t->getArity() != _arity)) return false;
+    if (t->getStructuralHash() != _structuralHash) return false;
 
+    const RecoTree* tree    = getLeftMember();
     const RecoTree* t_tree  = t->getLeftMember();
+    if ((tree != NULL) && (tree == t_tree)) return true;
 
-    if ((_tree  == NULL) && (t_tree  != NULL)) return false;
-    if ((_tree  == NULL) && (t_tree  == NULL)) 
-      return (t->getEvent() == this->_event);
+    if ((tree  == NULL) && (t_tree  != NULL)) return false;
+    if ((tree  == NULL) && (t_tree  == NULL)) 
+      return (t->getEvent() == getEvent());
 
-    return _tree->equal(t_tree);
+    return tree->equal(t_tree);
   }
 
 
@@ -122,7 +154,7 @@ namespace CRL
   */
   const Event* RecoTreeSingle::lastEvent() const 
   {
-    return _event;
+    return getEvent();
   }
 
 
@@ -132,7 +164,7 @@ namespace CRL
   */
   void RecoTreeSingle::prettyPrint(std::ostream& os, int ntab) const
   {
-    if (_event != NULL)
+    if (!_hasTree && (_event != NULL))
     {
       for(int n=0; n<ntab; n++) os << ' '; //'\t';
       if (_event->getName() != Event::getTimeEventName())
@@ -140,7 +172,7 @@ namespace CRL
       else
         os << "<(\193," << _event->getDate() << ")>" << std::endl;
     }
-    else if (_tree != NULL)
+    else if (_hasTree && (_tree != NULL))
     { 
       _tree->prettyPrint(os, ntab+1);
     }
@@ -27,11 +27,13 @@
 // ----------------------------------------------------------------------------
 
 #include <cstdlib>
+#include <algorithm>
 #include <sstream>
 #include <iostream>
 #include <typeinfo>
 
 #include "RecognitionEngine.h"
+#include "Operators.h"
 
 
 // ----------------------------------------------------------------------------
@@ -46,7 +48,11 @@ namespace CRL
   RecognitionEngine::RecognitionEngine() 
     : _currentTime(NO_DATE), _currentOrder(0),
       _insertionPolicy(LAST_EVENT), _verbosityLevel(SILENT), 
-      _outputLog(NULL), _purgeOldRecognitions(false)
+      _outputLog(NULL), _purgeOldRecognitions(false),
+      _maxTotalRecognitions(-1), _evictionCount(0), _shareSubChronicles(false),
+      _optimizeChronicles(false), _actionQueue(NULL),
+      _recognitionSink(NULL), _useCompiledPlan(false), _planOutdated(true),
+      _recoTreeArena(NULL)
   {
   }
 
@@ -58,7 +64,11 @@ namespace CRL
                                        VerbosityLevel lvl) 
     : _currentTime(NO_DATE), _currentOrder(0),
       _insertionPolicy(LAST_EVENT), _verbosityLevel(lvl), 
-      _outputLog(out), _purgeOldRecognitions(false)
+      _outputLog(out), _purgeOldRecognitions(false),
+      _maxTotalRecognitions(-1), _evictionCount(0), _shareSubChronicles(false),
+      _optimizeChronicles(false), _actionQueue(NULL),
+      _recognitionSink(NULL), _useCompiledPlan(false), _planOutdated(true),
+      _recoTreeArena(NULL)
   {
     CRL_LOG(VERBOSE) << "Engine created  : "
                      << "t = " << _currentTime
@@ -69,9 +79,16 @@ namespace CRL
   }
 
   //! Destructor: deletes only the events created by the engine itself
+  //! (and the sub-chronicles replaced by shared ones)
   RecognitionEngine::~RecognitionEngine(){
+    delete _actionQueue;
     clearEventBuffer();
     //clearChronicleList();
+    std::list<Chronicle*>::iterator it;
+    for(it=_detachedChronicles.begin(); it!=_detachedChronicles.end(); it++)
+      (*it)->deepDestroy();
+    if (_recoTreeArena != NULL)
+      _recoTreeArena->close();
   }
 
 
@@ -88,7 +105,20 @@ namespace CRL
     {
       cr->setPurgeable(false);
       _rootChronicles.push_back(cr);
+      if (_optimizeChronicles)
+        _optimizer.optimize(cr);
+      if (_shareSubChronicles)
+      {
+        if ( isShareable(cr) && 
+             (_sharedChronicles.find(cr->structuralSignature()) == _sharedChronicles.end()) )
+          _sharedChronicles[cr->structuralSignature()] = cr;
+        shareSubChronicles(cr);
+      }
       cr->setMyEngine(this);
+      _planOutdated = true;
+      if (_replanner.getPeriod() > 0)
+        _replanner.addChronicle(cr);
+      computeRetentionHorizons();
       CRL_LOG(VERBOSE) << "Added chronicle : " << cr->toString() << std::endl
                        << std::flush;
     }               
@@ -112,6 +142,9 @@ namespace CRL
       (*it)->setMyEngine(NULL);
 
     _rootChronicles.clear();
+    _sharedChronicles.clear();
+    _planOutdated = true;
+    _replanner.clear();
   }
 
 
@@ -128,10 +161,21 @@ namespace CRL
   *  If the event is not dated, it will be dated by the engine, following the 
   *  insertion policy.
   *
+  *  An event to be deleted by the engine is held by the buffer, then by the
+  *  recognition trees which refer to it: it is deleted once processed and
+  *  no longer part of any recognition (see Event::release).
+  *
   *   \param[in] e pointer to the event to be inserted in the flow.
+  *   \param[in] toDelete true if the engine has to delete the event
   */
   void RecognitionEngine::addEvent(CRL::Event* e, bool toDelete)
   {
+    if (toDelete)
+    {
+      e->setReleasable();
+      e->addRef();
+    }
+
     CRL_LOG(DETAILED) << "Evts buffer ==> : " << eventBufferToString() << std::endl << std::flush;
 
     // If the buffer is empty
@@ -245,21 +289,40 @@ namespace CRL
 
   /** \param[in] d date to be inserted in the flow
   */
+#ifdef CRL_INTEGER_DATES
+  RecognitionEngine& RecognitionEngine::operator<<(const DateType& d)
+  {
+    this->addEvent(new Event(d), true);
+    return *this;
+  }
+
+
+  /** \param[in] d date to be inserted in the flow, a whole number of nanoseconds
+  */
+  RecognitionEngine& RecognitionEngine::operator<<(const double& d)
+  {
+    return *this << DateTraits<DateType>::fromUnits(d);
+  }
+#else
   RecognitionEngine& RecognitionEngine::operator<<(const double& d)
   {
 	  DateType dd = d;
     this->addEvent(new Event(dd), true);
     return *this;
   }
+#endif
 
 
 
   /** Removes all the events from the input buffer
-  *   #_eventBuffer, before their recognition. Does not call the
-  *   destructors of the events.
+  *   #_eventBuffer, before their recognition. Only the events 
+  *   to be deleted by the engine are deleted.
   */
   void RecognitionEngine::clearEventBuffer()
   {
+    std::list<EventStored>::iterator it;
+    for (it=_eventBuffer.begin(); it!=_eventBuffer.end(); it++)
+      if ((*it).second) (*it).first->release();
     _eventBuffer.clear();
     CRL_LOG(DETAILED) << "Evts buffer <== : " << eventBufferToString() << std::endl << std::flush;
   }
@@ -284,19 +347,14 @@ namespace CRL
     	DateType look=this->lookAhead();
     	if (look < (*it).first->getDate())
     	{
-        Event* e = new Event(look);
-        addEvent(e, true);
-        processEvent(e->getDate(), e);
-        removeEvent(e);
-        //process(e);
-        //_eventBuffer.remove(e);
-        this->_currentTime = look;
+        processDate(look);
     	}
     	else
     	{
         this->_currentTime = (*it).first->getDate();
         processEvent((*it).first->getDate(), (*it).first);
         count++;
+        if ((*it).second) (*it).first->release();
         it=_eventBuffer.erase(it);
     	}
     }
@@ -308,25 +366,9 @@ namespace CRL
       {
         DateType look=this->lookAhead();
         if (look < date)
-        {
-          Event* e = new Event(look);
-          addEvent(e,true);
-          processEvent(e->getDate(), e);
-          removeEvent(e);
-          //process(e);
-          //_eventBuffer.remove(e);
-          this->_currentTime = look;
-        }
+          processDate(look);
         else
-        {
-          Event* e = new Event(date);
-          addEvent(e, true);
-          processEvent(e->getDate(), e);
-          removeEvent(e);
-          //process(e);
-          //_eventBuffer.remove(e);
-          this->_currentTime = date;
-        }
+          processDate(date);
       }
     }
     CRL_LOG(VERBOSE) << "Processed evts  : " << count 
@@ -335,6 +377,92 @@ namespace CRL
     return count;
   }
 
+
+  /** Processes the events of the input buffer (see #process), then the
+  *   events of \a batch in their order, like events of the input buffer:
+  *   "pure date" events are inserted according to the lookahead, and the
+  *   orders of the events of the batch are set.
+  *
+  *   Only the rows which name matches a ChronicleSingleEvent of the chronicles,
+  *   found by a scan of the name column (see ChronicleSingleEvent::findMatchingRows()),
+  *   are turned into events with their properties (see EventBatch::makeEvent()),
+  *   deleted once no longer part of any recognition.
+  *   The other rows change no recognition set: they are skipped, only their
+  *   orders and dates are taken into account. They still go through a single
+  *   reusable event, without properties, if a chronicle depends on the passing
+  *   of time (delays, absences, single dates, peremption).
+  *   If a chronicle contains an operator @, which recognitions refer to the 
+  *   events, every row is turned into an event.
+  *   \param[in,out] batch events to be processed, dated after the current time
+  *   \return number of processed events
+  */
+  int RecognitionEngine::processBatch(EventBatch& batch)
+  {
+    int count = process();
+    if ( (batch.size() > 0) && (batch.getDate(0) < _currentTime) )
+      throw("RecognitionEngine::processBatch : event prior to the current time");
+
+    std::vector<Chronicle*> nodes;
+    std::list<CRL::Chronicle*>::iterator it;
+    for (it=_rootChronicles.begin(); it!=_rootChronicles.end();it++)
+      collectChronicles(*it, nodes);
+
+    bool allRows = false, timeDriven = false;
+    std::vector<size_t> rows;
+    for (size_t i=0; i<nodes.size(); i++)
+    {
+      if (dynamic_cast<ChronicleAt*>(nodes[i]) != NULL)
+        allRows = true;
+      if ( (dynamic_cast<ChronicleDelayOp*>(nodes[i]) != NULL) ||
+           (dynamic_cast<ChronicleAbsence*>(nodes[i]) != NULL) ||
+           (dynamic_cast<ChronicleSingleDate*>(nodes[i]) != NULL) ||
+           (nodes[i]->getPeremptionDuration() >= 0.0) )
+        timeDriven = true;
+      ChronicleSingleEvent* leaf = dynamic_cast<ChronicleSingleEvent*>(nodes[i]);
+      if (leaf != NULL)
+        leaf->findMatchingRows(batch, rows);
+    }
+    std::vector<bool> matching(batch.size(), allRows);
+    for (size_t i=0; i<rows.size(); i++)
+      matching[rows[i]] = true;
+
+    Event reusable(NO_DATE);
+    for (size_t i=0; i<batch.size(); i++)
+    {
+      const DateType& date = batch.getDate(i);
+      DateType look = this->lookAhead();
+      while (look < date)
+      {
+        processDate(look);
+        look = this->lookAhead();
+      }
+
+      batch.setOrder(i, _currentOrder); _currentOrder++;
+      this->_currentTime = date;
+      if (matching[i])
+      {
+        Event* e = batch.makeEvent(i);
+        e->setReleasable();
+        e->addRef();
+        processEvent(date, e);
+        e->release();
+      }
+      else if (timeDriven)
+      {
+        reusable.setName(EventBatch::getName(batch.getNameId(i)));
+        reusable.setDate(date);
+        reusable.setOrder(batch.getOrder(i));
+        processEvent(date, &reusable);
+      }
+      count++;
+    }
+    CRL_LOG(VERBOSE) << "Processed batch : " << batch.size() << " evts, " 
+                     << rows.size() << " matching"
+                     << "\t t = " << _currentTime << std::endl
+                     << std::flush;
+    return count;
+  }
+
   
   /** Adds event \e e to the input buffer, and then processes it by 
   *   updating the recognition sets of all the chronicles.
@@ -390,19 +518,63 @@ namespace CRL
   */
   void RecognitionEngine::processEvent(const DateType& d, CRL::Event *e)
   {
+    RecoTreeArena::Scope arenaScope(_recoTreeArena);
     if (_purgeOldRecognitions) purgeOldRecognitions();
+    if (_actionQueue != NULL) _actionQueue->collect();
+    if (_useCompiledPlan)
+    {
+      if (_planOutdated)
+      {
+        _plan.compile(_rootChronicles);
+        _planOutdated = false;
+      }
+      _plan.process(d, e);
+    }
     bool flag;
     std::list<CRL::Chronicle*>::iterator it;
     for (it=_rootChronicles.begin(); it!=_rootChronicles.end();it++)
     {
-      flag = (*it)->process(d, e);
+      flag = _useCompiledPlan ? (*it)->hasNewRecognitions() : (*it)->process(d, e);
       if (flag) {
         CRL_LOG(VERBOSE) << "Chronicle       : " << (*it)->toString() << " recognition at" 
                          << " (" << d << ")" << std::endl << std::flush;
         CRL_LOG(DETAILED) << "                  " << (*it)->prettyPrint() << std::endl << std::flush;
+        if ( (_actionQueue != NULL) || (_recognitionSink != NULL) )
+        {
+          Chronicle::RecoSet::const_iterator itR;
+          for (itR  = (*it)->getNewRecognitions().begin();
+               itR != (*it)->getNewRecognitions().end(); itR++)
+          {
+            if (_recognitionSink != NULL) _recognitionSink->write(**itR);
+            if (_actionQueue != NULL) _actionQueue->push(*itR);
+          }
+        }
       }
     }
+    _replanner.observe();
     purgeNewRecognitions();
+    if (_maxTotalRecognitions >= 0) enforceTotalBudget();
+    if (_replanner.replanIfDue())
+    {
+      CRL_LOG(VERBOSE) << "Re-planned chains (" << _replanner.getReplanCount() << " changes)"
+                       << std::endl << std::flush;
+      computeRetentionHorizons();
+      _planOutdated = true;
+    }
+  }
+
+
+  /** Internal class method. Processes a "pure date" event created by the
+  *   engine, and places the engine at this date.
+  *   \param[in] date date of the event
+  */
+  void RecognitionEngine::processDate(const DateType& date)
+  {
+    Event* e = new Event(date);
+    addEvent(e, true);
+    processEvent(e->getDate(), e);
+    removeEvent(e);
+    this->_currentTime = date;
   }
 
 
@@ -415,6 +587,7 @@ namespace CRL
     {
       if ( (*it).first == e )
       {
+        if ((*it).second) e->release();
         _eventBuffer.erase(it);
         return;
       }
@@ -427,6 +600,11 @@ namespace CRL
   */
   void RecognitionEngine::purgeNewRecognitions()
   {
+    if (_useCompiledPlan)
+    {
+      _plan.purgeNewRecognitions();
+      return;
+    }
     std::list<CRL::Chronicle*>::iterator it;
     for (it=_rootChronicles.begin(); it!=_rootChronicles.end();it++)
     {
@@ -448,6 +626,130 @@ namespace CRL
   }
 
 
+  /** \return sum of the sizes of the recognition sets of all the chronicles
+  */
+  long RecognitionEngine::getTotalRecognitions()
+  {
+    std::vector<Chronicle*> nodes;
+    std::list<CRL::Chronicle*>::iterator it;
+    for (it=_rootChronicles.begin(); it!=_rootChronicles.end();it++)
+      collectChronicles(*it, nodes);
+
+    long total = 0;
+    for (size_t i=0; i<nodes.size(); i++)
+      total += (long)nodes[i]->getRecognitionSet().size();
+    return total;
+  }
+
+
+  /** Internal class method. While the total number of recognitions exceeds
+  *   #_maxTotalRecognitions, a recognition is evicted from the largest
+  *   recognition set, following its own eviction policy 
+  *   (see Chronicle::evictRecognition()).
+  */
+  void RecognitionEngine::enforceTotalBudget()
+  {
+    std::vector<Chronicle*> nodes;
+    std::list<CRL::Chronicle*>::iterator it;
+    for (it=_rootChronicles.begin(); it!=_rootChronicles.end();it++)
+      collectChronicles(*it, nodes);
+
+    long total = 0;
+    for (size_t i=0; i<nodes.size(); i++)
+      total += (long)nodes[i]->getRecognitionSet().size();
+
+    while (total > _maxTotalRecognitions)
+    {
+      Chronicle* largest = NULL;
+      for (size_t i=0; i<nodes.size(); i++)
+        if ( (largest == NULL) || 
+             (nodes[i]->getRecognitionSet().size() > largest->getRecognitionSet().size()) )
+          largest = nodes[i];
+
+      if ( (largest == NULL) || (!largest->evictRecognition()) ) return;
+      total--;
+      _evictionCount++;
+      CRL_LOG(DETAILED) << "Evicted reco    : " << largest->toString() << std::endl << std::flush;
+    }
+  }
+
+
+  /** \param[in] cr root of the tree of chronicles
+  *   \param[in,out] nodes chronicles collected so far
+  */
+  void RecognitionEngine::collectChronicles(Chronicle* cr, std::vector<Chronicle*>& nodes)
+  {
+    if ( (cr == NULL) || (std::find(nodes.begin(), nodes.end(), cr) != nodes.end()) )
+      return;
+    nodes.push_back(cr);
+    collectChronicles(cr->getChild1(), nodes);
+    collectChronicles(cr->getChild2(), nodes);
+  }
+
+
+  /** Internal class method. The tree is visited from the top: a sub-chronicle
+  *   identical to a chronicle already registered (same structure, user functions 
+  *   and settings) is replaced by it, and is detached (destroyed with the engine).
+  *   The shared chronicle is processed once per event, and its new recognitions feed
+  *   all its parents. It is purgeable only if all the parents allow it.
+  *   \param[in] parent chronicle which sub-chronicles are to be shared
+  */
+  void RecognitionEngine::shareSubChronicles(Chronicle* parent)
+  {
+    for (int i=1; i<=2; i++)
+    {
+      Chronicle* child = (i == 1) ? parent->getChild1() : parent->getChild2();
+      if (child == NULL) continue;
+
+      if ( isShareable(child) && (!parent->consumesChildRecognitions()) )
+      {
+        std::string signature = child->structuralSignature();
+        std::map<std::string, Chronicle*>::iterator it = _sharedChronicles.find(signature);
+        if (it == _sharedChronicles.end())
+          _sharedChronicles[signature] = child;
+        else if (it->second != child)
+        {
+          Chronicle* shared = it->second;
+          shared->share();
+          shared->setPurgeable(shared->isPurgeable() && child->isPurgeable());
+          if (i == 1)
+            parent->setChild1(shared);
+          else
+            parent->setChild2(shared);
+          _detachedChronicles.push_back(child);
+          CRL_LOG(VERBOSE) << "Shared chronicle: " << shared->toString() << std::endl << std::flush;
+          continue;
+        }
+      }
+      shareSubChronicles(child);
+    }
+  }
+
+
+  /** Only the chronicles of the library without action function are shared:
+  *   the action would be called once instead of once per parent, and the
+  *   methods of user sub-classes may depend on their own state.
+  *   \param[in] cr chronicle
+  *   \return true if the chronicle may be shared
+  */
+  bool RecognitionEngine::isShareable(Chronicle* cr)
+  {
+    if (cr->hasActionFunction()) return false;
+
+    const std::type_info& t = typeid(*cr);
+    return ( (t == typeid(ChronicleSingleEvent)) || (t == typeid(ChronicleSingleDate))
+          || (t == typeid(ChronicleNamed)) || (t == typeid(ChronicleAt))
+          || (t == typeid(ChronicleConjunction)) || (t == typeid(ChronicleDisjunction))
+          || (t == typeid(ChronicleSequence)) || (t == typeid(ChronicleAbsence))
+          || (t == typeid(ChronicleEquals)) || (t == typeid(ChronicleDuring))
+          || (t == typeid(ChronicleStarts)) || (t == typeid(ChronicleFinishes))
+          || (t == typeid(ChronicleMeets)) || (t == typeid(ChronicleOverlaps))
+          || (t == typeid(ChronicleCut)) || (t == typeid(ChronicleStateChange))
+          || (t == typeid(ChronicleDelayThen)) || (t == typeid(ChronicleDelayLasts))
+          || (t == typeid(ChronicleDelayAtLeast)) || (t == typeid(ChronicleDelayAtMost)) );
+  }
+
+
   /** \return string with the #_insertionPolicy name
   */
   std::string RecognitionEngine::insertionPolicyToString() const
@@ -483,20 +785,154 @@ namespace CRL
 
   /** Activates the deleting policy of too old recognitions
    *  recursively and for all chronicles, setting the peremption
-   *  duration to \a d.
+   *  duration to \a d, or to the retention horizon of the chronicle
+   *  if it is shorter (see #computeRetentionHorizons). Refused if a chronicle
+   *  has been rewritten by the optimizer (see #setOptimizeChronicles), or if
+   *  a chronicle has a factorised form (see ChronicleConjunction::setFactorised).
    *  \param[in] d is the value of the peremption duration
    */
-  void RecognitionEngine::activateForget(double d)
+  void RecognitionEngine::activateForget(DurationType d)
   {
+    std::vector<Chronicle*> nodes;
+    std::list<CRL::Chronicle*>::iterator it;
+    for (it=_rootChronicles.begin(); it!=_rootChronicles.end();it++)
+      collectChronicles(*it, nodes);
+
+    // The same duration on the nodes of a rewritten tree would purge other recognitions
+    for (size_t i=0; (d >= 0.0) && (i<nodes.size()); i++)
+      if (nodes[i]->isRewritten())
+        throw("RecognitionEngine::activateForget : chronicle rewritten by the optimizer " 
+              + nodes[i]->toString());
+
+    // The factors would keep the recognitions purged from the members
+    std::vector<Chronicle*> factorised;
+    collectFactorised(nodes, factorised);
+    if ( (d >= 0.0) && !factorised.empty() )
+      throw("RecognitionEngine::activateForget : chronicle in factorised form " 
+            + factorised[0]->toString());
     _purgeOldRecognitions=true;
+
+    for (size_t i=0; i<nodes.size(); i++)
+    {
+      DurationType h = nodes[i]->getRetentionHorizon();
+      nodes[i]->setPeremptionDuration( ((d < 0.0) || (h < 0.0)) ? d : std::min(d, h), false );
+    }
+  }
+
+
+  /** Activates the deleting policy of too old recognitions, each chronicle
+   *  using its own retention horizon. The chronicles which horizon is unbounded 
+   *  (the roots, at least) keep all their recognitions, as do the factorised
+   *  conjunctions and their members (see ChronicleConjunction::setFactorised).
+   */
+  void RecognitionEngine::activateAutoForget()
+  {
+    _purgeOldRecognitions=true;
+    std::vector<Chronicle*> nodes;
     std::list<CRL::Chronicle*>::iterator it;
     for (it=_rootChronicles.begin(); it!=_rootChronicles.end();it++)
+      collectChronicles(*it, nodes);
+
+    std::vector<Chronicle*> factorised;
+    collectFactorised(nodes, factorised);
+    for (size_t i=0; i<nodes.size(); i++)
+      if (std::find(factorised.begin(), factorised.end(), nodes[i]) == factorised.end())
+        nodes[i]->setPeremptionDuration(nodes[i]->getRetentionHorizon(), false);
+  }
+
+
+  /** \param[in] nodes chronicles
+  *   \param[out] factorised factorised conjunctions, and their members
+  */
+  void RecognitionEngine::collectFactorised(const std::vector<Chronicle*>& nodes, 
+                                            std::vector<Chronicle*>& factorised)
+  {
+    for (size_t i=0; i<nodes.size(); i++)
     {
-      (*it)->setPeremptionDuration(d, true);
+      ChronicleConjunction* conj = dynamic_cast<ChronicleConjunction*>(nodes[i]);
+      if ( (conj != NULL) && conj->isFactorised() )
+      {
+        factorised.push_back(conj);
+        factorised.push_back(conj->getOpLeft());
+        factorised.push_back(conj->getOpRight());
+      }
     }
   }
 
 
+  /** Static analysis of the chronicles, run when a chronicle is added. The
+   *  retention horizon of a chronicle is the age (relative to the maximal 
+   *  date) beyond which its recognitions can no longer contribute to a 
+   *  recognition of the roots: it is bounded by the temporal constraints 
+   *  of the ancestors (ex: ChronicleDelayAtMost), and is zero for chronicles 
+   *  which only new recognitions are used. The roots keep all their recognitions.
+   */
+  void RecognitionEngine::computeRetentionHorizons()
+  {
+    std::vector<Chronicle*> nodes;
+    std::list<CRL::Chronicle*>::iterator it;
+    for (it=_rootChronicles.begin(); it!=_rootChronicles.end();it++)
+      collectChronicles(*it, nodes);
+
+    for (size_t i=0; i<nodes.size(); i++)
+      nodes[i]->resetRetentionHorizon();
+
+    for (it=_rootChronicles.begin(); it!=_rootChronicles.end();it++)
+    {
+      (*it)->mergeRetentionHorizon(-1.0);
+      (*it)->inferRetentionHorizons(-1.0);
+    }
+  }
+
+
+  /** The new recognitions of the root chronicles are then queued instead of
+  *   being handled inside the processing of the events: the function \a f
+  *   receives them by batches, in a consumer thread, so that a slow delivery
+  *   (log, forwarding) does not delay the recognition. Each tree remains
+  *   valid until the call of \a f on its batch returns; it must not be
+  *   modified. The actions of the chronicles themselves stay synchronous.
+  *   The previous queue, if any, is emptied first.
+  *   \param[in] f user function called with each batch (NULL: synchronous delivery only)
+  *   \param[in] capacity maximal number of recognitions waiting for delivery
+  *   \param[in] maxBatchSize maximal number of recognitions per batch
+  */
+  void RecognitionEngine::setAsyncActions(ActionQueue::BatchFunction f, size_t capacity, size_t maxBatchSize)
+  {
+    delete _actionQueue;
+    _actionQueue = NULL;
+    if (f != NULL)
+      _actionQueue = new ActionQueue(f, capacity, maxBatchSize);
+  }
+
+
+  /** The recognitions created while processing the events, their properties
+  *   and the blocks of their property entries are then allocated contiguously,
+  *   in the order of time: the segments are freed as a whole once the purge
+  *   has deleted all their recognitions. The previous arena, if any, is
+  *   deleted with its last recognition. The recognitions must then be
+  *   released by the thread of the engine.
+  *   \param[in] segmentSize size of the segments (0: allocations on the heap)
+  */
+  void RecognitionEngine::setRecoTreeArena(size_t segmentSize)
+  {
+    if (_recoTreeArena != NULL)
+      _recoTreeArena->close();
+    _recoTreeArena = NULL;
+    if (segmentSize > 0)
+      _recoTreeArena = new RecoTreeArena(segmentSize);
+  }
+
+
+  /** Must be called before destroying the chronicles, since the trees
+  *   delivered refer to their chronicle.
+  */
+  void RecognitionEngine::flushActions()
+  {
+    if (_actionQueue != NULL)
+      _actionQueue->flush();
+  }
+
+
   /** Displays the content of a list of events (for example the input buffer of
   *   an engine) in the form of a string.
   *   \param[in] s the list of events
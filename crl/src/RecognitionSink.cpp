@@ -0,0 +1,406 @@
+/** ***********************************************************************************
+ * \file RecognitionSink.cpp
+ * \author Ariane Piel & Jean Bourrely / Onera DCPS
+ * \date 2014
+ * \brief Compact binary records of the recognitions
+ **************************************************************************************/
+
+/*  Copyright (C) 2012, 2013, 2014  ONERA  http://www.onera.fr
+    This file is part of CRL : Chronicle Recognition Library.
+
+    CRL is free software: you can redistribute it and/or modify it under
+    the terms of the Lesser GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    CRL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    Lesser GNU General Public License for more details.
+
+    You should have received a copy of the Lesser GNU General Public License
+    along with CRL.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// ----------------------------------------------------------------------------
+// INCLUDE FILES
+// ----------------------------------------------------------------------------
+
+#include <cstring>
+#include <algorithm>
+
+#include "Property.h"
+#include "RecognitionSink.h"
+
+
+// ----------------------------------------------------------------------------
+// CLASS METHODS
+// ----------------------------------------------------------------------------
+
+namespace CRL 
+{
+
+  /** \param[in] path path of the file
+  *   \param[in] bufferSize number of bytes gathered before each write
+  */
+  FileRecordWriter::FileRecordWriter(const std::string& path, size_t bufferSize)
+    : _file(std::fopen(path.c_str(), "wb")), _bufferSize(bufferSize)
+  {
+    if (_file == NULL)
+      throw("FileRecordWriter : cannot open " + path);
+    _buffer.reserve(bufferSize);
+  }
+
+
+  /** 
+  */
+  FileRecordWriter::~FileRecordWriter()
+  {
+    flush();
+    std::fclose(_file);
+  }
+
+
+  /** \param[in] data bytes of the record
+  *   \param[in] size number of bytes
+  */
+  void FileRecordWriter::write(const char* data, size_t size)
+  {
+    _buffer.insert(_buffer.end(), data, data + size);
+    if (_buffer.size() >= _bufferSize)
+    {
+      std::fwrite(&_buffer[0], 1, _buffer.size(), _file);
+      _buffer.clear();
+    }
+  }
+
+
+  /** 
+  */
+  void FileRecordWriter::flush()
+  {
+    if (!_buffer.empty())
+      std::fwrite(&_buffer[0], 1, _buffer.size(), _file);
+    _buffer.clear();
+    std::fflush(_file);
+  }
+
+
+  /** The oldest records are dropped until the new one fits. A record
+  *   larger than the whole ring is dropped.
+  *   \param[in] data bytes of the record, length prefix included
+  *   \param[in] size number of bytes
+  */
+  void RingRecordWriter::write(const char* data, size_t size)
+  {
+    if (size > _ring.size())
+    {
+      _droppedCount++;
+      return;
+    }
+    while (_ring.size() - _size < size)
+      dropOldest();
+
+    size_t pos = (_head + _size) % _ring.size();
+    size_t first = std::min(size, _ring.size() - pos);
+    std::memcpy(&_ring[pos], data, first);
+    std::memcpy(&_ring[0], data + first, size - first);
+    _size += size;
+  }
+
+
+  /** \param[out] record oldest record, length prefix included
+  *   \return false if the ring is empty
+  */
+  bool RingRecordWriter::read(std::string& record)
+  {
+    if (_size == 0)
+      return false;
+    uint32_t length;
+    copyOut(_head, reinterpret_cast<char*>(&length), sizeof(length));
+    record.resize(sizeof(length) + length);
+    copyOut(_head, &record[0], record.size());
+    _head = (_head + record.size()) % _ring.size();
+    _size -= record.size();
+    return true;
+  }
+
+
+  /** 
+  */
+  void RingRecordWriter::dropOldest()
+  {
+    uint32_t length;
+    copyOut(_head, reinterpret_cast<char*>(&length), sizeof(length));
+    _head = (_head + sizeof(length) + length) % _ring.size();
+    _size -= sizeof(length) + length;
+    _droppedCount++;
+  }
+
+
+  /** \param[in] pos position in the ring
+  *   \param[out] data destination
+  *   \param[in] size number of bytes
+  */
+  void RingRecordWriter::copyOut(size_t pos, char* data, size_t size) const
+  {
+    size_t first = std::min(size, _ring.size() - pos);
+    std::memcpy(data, &_ring[pos], first);
+    std::memcpy(data + first, &_ring[0], size - first);
+  }
+
+
+  const char RecognitionSink::MAGIC[4] = { 'C', 'R', 'L', 'R' };
+
+
+  /** \param[in] path names of the properties, from the recognition
+  */
+  void RecognitionSink::selectProperty(const RecoIndex::PropertyPath& path)
+  {
+    if (_headerWritten)
+      throw("RecognitionSink : properties must be selected before the first record");
+    _selectedPaths.push_back(path);
+  }
+
+
+  /** \param[in] name name of the property
+  */
+  void RecognitionSink::selectProperty(const std::string& name)
+  {
+    selectProperty(RecoIndex::PropertyPath(1, name));
+  }
+
+
+  /** \param[in] cr chronicle
+  *   \param[in] id identifier in the records
+  */
+  void RecognitionSink::setChronicleId(const Chronicle* cr, uint32_t id)
+  {
+    _chronicleIds[cr] = id;
+    if (id >= _nextId)
+      _nextId = id + 1;
+  }
+
+
+  /** The chronicles without identifier are numbered in the order in which
+  *   their first recognition is written.
+  *   \param[in] cr chronicle
+  *   \return identifier
+  */
+  uint32_t RecognitionSink::getChronicleId(const Chronicle* cr)
+  {
+    std::map<const Chronicle*, uint32_t>::iterator it = _chronicleIds.find(cr);
+    if (it != _chronicleIds.end())
+      return it->second;
+    _chronicleIds[cr] = _nextId;
+    return _nextId++;
+  }
+
+
+  /** Header : magic number, version (uint16), size of the dates (uint16), 
+  *   number of selected properties (uint16), then each path as its number
+  *   of names (uint16) followed by the names (uint16 length, then the bytes).
+  *   Every value is in host byte order: the magic number reveals it.
+  */
+  void RecognitionSink::writeHeader()
+  {
+    _record.clear();
+    _record.append(MAGIC, sizeof(MAGIC));
+    append((uint16_t)VERSION);
+    append((uint16_t)sizeof(DateType));
+    append((uint16_t)_selectedPaths.size());
+    for (size_t i = 0; i < _selectedPaths.size(); i++)
+    {
+      append((uint16_t)_selectedPaths[i].size());
+      for (size_t j = 0; j < _selectedPaths[i].size(); j++)
+      {
+        append((uint16_t)_selectedPaths[i][j].size());
+        _record.append(_selectedPaths[i][j]);
+      }
+    }
+    _writer.writeHeader(_record.data(), _record.size());
+    _headerWritten = true;
+  }
+
+
+  /** Record : length of the rest of the record (uint32), chronicle identifier
+  *   (uint32), min and max dates (DateType), min and max orders (int64),
+  *   number of leaf events (uint32) and their orders (int64), then for each
+  *   selected property its type (uint8, Property::DataTypeEnum) and its value:
+  *   int64 for the integral types, double for the floating ones, uint32 length
+  *   then the characters for the strings (uint32 each for the wide ones),
+  *   nothing if the property is missing.
+  *   \param[in] rc recognition
+  */
+  void RecognitionSink::write(const RecoTree& rc)
+  {
+    if (!_headerWritten)
+      writeHeader();
+
+    _record.clear();
+    append((uint32_t)0);
+    append(getChronicleId(rc.getMyChronicle()));
+    append(rc.getMinDate());
+    append(rc.getMaxDate());
+    append((int64_t)rc.getMinOrder());
+    append((int64_t)rc.getMaxOrder());
+
+    size_t countPos = _record.size();
+    uint32_t count = 0;
+    append(count);
+    appendEvents(&rc, count);
+    std::memcpy(&_record[countPos], &count, sizeof(count));
+
+    for (size_t i = 0; i < _selectedPaths.size(); i++)
+      appendProperty(rc, _selectedPaths[i]);
+
+    uint32_t length = (uint32_t)(_record.size() - sizeof(uint32_t));
+    std::memcpy(&_record[0], &length, sizeof(length));
+    _writer.write(_record.data(), _record.size());
+    _recordCount++;
+  }
+
+
+  /** \param[in] rc tree (may be NULL, for the empty member of a disjunction)
+  *   \param[in,out] count number of events appended
+  */
+  void RecognitionSink::appendEvents(const RecoTree* rc, uint32_t& count)
+  {
+    if (rc == NULL)
+      return;
+    if (rc->getArity() == 1)
+    {
+      if (rc->getEvent() != NULL)
+      {
+        append((int64_t)rc->getEvent()->getOrder());
+        count++;
+      }
+      else
+        appendEvents(rc->getLeftMember(), count);
+    }
+    else if (rc->getArity() == 2)
+    {
+      appendEvents(rc->getLeftMember(), count);
+      appendEvents(rc->getRightMember(), count);
+    }
+  }
+
+
+  /** \param[in] pm properties of the recognition
+  *   \param[in] path path of the property
+  */
+  void RecognitionSink::appendProperty(const PropertyManager& pm, const RecoIndex::PropertyPath& path)
+  {
+    const PropertyManager* current = &pm;
+    const Property* p = NULL;
+    for (size_t i = 0; (i < path.size()) && (current != NULL); i++)
+      current = p = current->findProperty(path[i]);
+
+    if (p == NULL)                append((uint8_t)Property::NONE);
+    else if (p->isBool())         { append((uint8_t)Property::B);   append((int64_t)(bool)(*p)); }
+    else if (p->isChar())         { append((uint8_t)Property::CH);  append((int64_t)(char)(*p)); }
+    else if (p->isWchar_t())      { append((uint8_t)Property::WCH); append((int64_t)(wchar_t)(*p)); }
+    else if (p->isInt())          { append((uint8_t)Property::I);   append((int64_t)(int)(*p)); }
+    else if (p->isUnsignedInt())  { append((uint8_t)Property::UI);  append((int64_t)(unsigned int)(*p)); }
+    else if (p->isLong())         { append((uint8_t)Property::L);   append((int64_t)(long)(*p)); }
+    else if (p->isUnsignedLong()) { append((uint8_t)Property::UL);  append((int64_t)(unsigned long)(*p)); }
+    else if (p->isFloat())        { append((uint8_t)Property::F);   append((double)(float)(*p)); }
+    else if (p->isDouble())       { append((uint8_t)Property::D);   append((double)(*p)); }
+    else if (p->isString())
+    {
+      std::string s = (std::string)(*p);
+      append((uint8_t)Property::STR);
+      append((uint32_t)s.size());
+      _record.append(s);
+    }
+    else if (p->isWstring())
+    {
+      std::wstring s = (std::wstring)(*p);
+      append((uint8_t)Property::WSTR);
+      append((uint32_t)s.size());
+      for (size_t i = 0; i < s.size(); i++)
+        append((uint32_t)s[i]);
+    }
+    else
+      append((uint8_t)Property::NONE);
+  }
+
+
+  /** Reads a value of type \a T at position \a pos of \a data, if available.
+  *   \param[in] data record
+  *   \param[in,out] pos position, moved after the value
+  *   \param[out] x value
+  *   \return false if the record is too short
+  */
+  template <class T> static bool extract(const std::string& data, size_t& pos, T& x)
+  {
+    if (pos + sizeof(T) > data.size())
+      return false;
+    std::memcpy(&x, data.data() + pos, sizeof(T));
+    pos += sizeof(T);
+    return true;
+  }
+
+
+  /** The selected properties are decoded according to their types, their
+  *   names being given by the header.
+  *   \param[in] data record, length prefix included
+  *   \param[out] record decoded record
+  *   \return false if the record is malformed
+  */
+  bool RecognitionSink::decode(const std::string& data, Record& record)
+  {
+    size_t pos = 0;
+    uint32_t length, count;
+    if ( !extract(data, pos, length) || (sizeof(length) + length != data.size()) )
+      return false;
+    if ( !extract(data, pos, record.chronicleId) || !extract(data, pos, record.minDate) ||
+         !extract(data, pos, record.maxDate) || !extract(data, pos, record.minOrder) ||
+         !extract(data, pos, record.maxOrder) || !extract(data, pos, count) )
+      return false;
+
+    record.events.resize(count);
+    for (uint32_t i = 0; i < count; i++)
+      if (!extract(data, pos, record.events[i]))
+        return false;
+
+    record.properties.clear();
+    uint8_t type;
+    while (extract(data, pos, type))
+    {
+      Value v;
+      v.type = type;
+      v.l = 0;
+      v.d = 0.0;
+      bool ok = true;
+      if ( (type == Property::F) || (type == Property::D) )
+        ok = extract(data, pos, v.d);
+      else if (type == Property::STR)
+      {
+        ok = extract(data, pos, count) && (pos + count <= data.size());
+        if (ok)
+        {
+          v.str.assign(data, pos, count);
+          pos += count;
+        }
+      }
+      else if (type == Property::WSTR)
+      {
+        ok = extract(data, pos, count);
+        uint32_t c;
+        for (uint32_t i = 0; ok && (i < count); i++)
+        {
+          ok = extract(data, pos, c);
+          v.wstr += (wchar_t)c;
+        }
+      }
+      else if (type != Property::NONE)
+        ok = extract(data, pos, v.l);
+      if (!ok)
+        return false;
+      record.properties.push_back(v);
+    }
+    return true;
+  }
+
+} /* namespace CRL */
@@ -0,0 +1,198 @@
+/** ***********************************************************************************
+ * \file SegmentedArena.cpp
+ * \author Ariane Piel & Jean Bourrely / Onera DCPS
+ * \date 2014
+ * \brief Segmented memory arena, whose segments are found from the addresses
+ **************************************************************************************/
+
+/*  Copyright (C) 2012, 2013, 2014  ONERA  http://www.onera.fr
+    This file is part of CRL : Chronicle Recognition Library.
+
+    CRL is free software: you can redistribute it and/or modify it under
+    the terms of the Lesser GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    CRL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    Lesser GNU General Public License for more details.
+
+    You should have received a copy of the Lesser GNU General Public License
+    along with CRL.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// ----------------------------------------------------------------------------
+// INCLUDE FILES
+// ----------------------------------------------------------------------------
+
+#include <cstdlib>
+#include <new>
+
+#include "SegmentedArena.h"
+
+
+// ----------------------------------------------------------------------------
+// CLASS METHODS
+// ----------------------------------------------------------------------------
+
+namespace CRL 
+{
+
+  //! Definition of the class variable
+  thread_local std::unordered_map<uintptr_t, SegmentedArena::Segment*> SegmentedArena::_segments;
+
+
+  /** \param[in] segmentSize size of the segments
+  */
+  SegmentedArena::SegmentedArena(size_t segmentSize)
+    : _segmentSize((segmentSize + GRANULE - 1) / GRANULE * GRANULE),
+      _current(NULL), _spare(NULL),
+      _segmentCount(0), _freedSegmentCount(0), _live(0), _closed(false)
+  {
+    if (_segmentSize == 0)
+      _segmentSize = GRANULE;
+  }
+
+
+  SegmentedArena::~SegmentedArena()
+  {
+    if (_current != NULL)
+      freeSegment(_current);
+    if (_spare != NULL)
+      freeSegment(_spare);
+  }
+
+
+  /** Each granule of the segment is recorded in #_segments, so that the
+  *   segment of an allocation is found from its address alone: the 
+  *   allocations carry no header, and the memory allocated on the heap
+  *   is told apart from the memory of the arenas.
+  *   \param[in] size number of bytes available in the segment
+  *   \return new segment, empty
+  */
+  SegmentedArena::Segment* SegmentedArena::createSegment(size_t size)
+  {
+    Segment* s;
+    if ( (_spare != NULL) && (size <= _spare->size) )
+    {
+      s = _spare;
+      _spare = NULL;
+    }
+    else
+    {
+      size = (size + GRANULE - 1) / GRANULE * GRANULE;
+      char* memory = (char*)malloc(size + GRANULE - 1);
+      if (memory == NULL)
+        throw std::bad_alloc();
+      s = new Segment;
+      s->arena = this;
+      s->memory = memory;
+      s->begin = (char*)(((uintptr_t)memory + GRANULE - 1) / GRANULE * GRANULE);
+      s->size = size;
+      for (size_t g=0; g<size; g+=GRANULE)
+        _segments[(uintptr_t)(s->begin + g) / GRANULE] = s;
+    }
+    s->used = 0;
+    s->live = 0;
+    _segmentCount++;
+    return s;
+  }
+
+
+  /** The segments of the standard size are kept one at a time for reuse,
+  *   the others are returned to the heap.
+  *   \param[in] s empty segment
+  */
+  void SegmentedArena::dropSegment(Segment* s)
+  {
+    _segmentCount--;
+    _freedSegmentCount++;
+    if ( (_spare == NULL) && (s->size == _segmentSize) )
+      _spare = s;
+    else
+      freeSegment(s);
+  }
+
+
+  /** \param[in] s segment, not used any more
+  */
+  void SegmentedArena::freeSegment(Segment* s)
+  {
+    for (size_t g=0; g<s->size; g+=GRANULE)
+      _segments.erase((uintptr_t)(s->begin + g) / GRANULE);
+    free(s->memory);
+    delete s;
+  }
+
+
+  /** The allocations of a segment are made in increasing order of time,
+  *   so that a segment becomes empty when the purge removes the objects
+  *   of its time span. Allocations larger than a segment get their own one.
+  *   \param[in] size number of bytes
+  *   \return address aligned on #ALIGNMENT
+  */
+  void* SegmentedArena::allocate(size_t size)
+  {
+    size = (size + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+    Segment* s = _current;
+    if (size > _segmentSize)
+      s = createSegment(size);
+    else if ( (s == NULL) || (s->used + size > s->size) )
+    {
+      newSegment();
+      s = _current = createSegment(_segmentSize);
+    }
+    void* ptr = s->begin + s->used;
+    s->used += size;
+    s->live++;
+    _live++;
+    return ptr;
+  }
+
+
+  /** The memory of an arena is deallocated by the thread which allocates
+  *   it. Without any segment in the thread, the lookup is skipped.
+  *   \param[in] ptr address returned by #allocate, or by another allocator
+  *   \return false if \a ptr has not been allocated by an arena
+  */
+  bool SegmentedArena::deallocate(void* ptr)
+  {
+    if (_segments.empty())
+      return false;
+    std::unordered_map<uintptr_t, Segment*>::const_iterator it =
+      _segments.find((uintptr_t)ptr / GRANULE);
+    if (it == _segments.end())
+      return false;
+
+    Segment* s = it->second;
+    SegmentedArena* arena = s->arena;
+    arena->_live--;
+    if ( (--s->live == 0) && (s != arena->_current) )
+      arena->dropSegment(s);
+    if (arena->_closed && (arena->_live == 0))
+      delete arena;
+    return true;
+  }
+
+
+  /** The current segment is freed at once if it is empty, otherwise with
+  *   its last allocation.
+  */
+  void SegmentedArena::newSegment()
+  {
+    Segment* s = _current;
+    _current = NULL;
+    if ( (s != NULL) && (s->live == 0) )
+      dropSegment(s);
+  }
+
+
+  void SegmentedArena::close()
+  {
+    _closed = true;
+    if (_live == 0)
+      delete this;
+  }
+
+} /* namespace CRL */
@@ -53,6 +53,18 @@ void testSingleDate();
 void testChronicleCoRef();
 void testAction();
 void testPeremptionDuration();
+void testRecognitionBudget();
+void testChronicleLoader();
+void testChronicleOptimizer();
+void testCountOnly();
+void testRecognitionSink();
+void testEventBatch();
+void testRecoColumns();
+void testChroniclePlan();
+void testStaticChronicle();
+void testDateTraits();
+void testRecoTreeArena();
+void testRecoSet();
 
 
 int main() 
@@ -87,6 +99,18 @@ int main()
     testChronicleCoRef();
     testAction();
     testPeremptionDuration();
+    testRecognitionBudget();
+    testChronicleLoader();
+    testChronicleOptimizer();
+    testCountOnly();
+    testRecognitionSink();
+    testEventBatch();
+    testRecoColumns();
+    testChroniclePlan();
+    testStaticChronicle();
+    testDateTraits();
+    testRecoTreeArena();
+    testRecoSet();
 
     CRL::CRL_ErrReport::PRINT_ALL();
 
@@ -26,6 +26,9 @@
 // INCLUDE FILES
 // ----------------------------------------------------------------------------
 
+#include <chrono>
+#include <thread>
+
 #include "TestUtils.h"
 #include "Operators.h"
 #include "RecognitionEngine.h"
@@ -309,6 +312,58 @@ void testChangeDelay()
 
 
 
+long testAsyncActions_count = 0;
+long testAsyncActions_batches = 0;
+double testAsyncActions_dates = 0.0;
+
+void testAsyncActions_batch(const std::vector<RecoTree*>& batch)
+{
+  // Slow delivery: the engine goes on meanwhile
+  std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  for (size_t i=0; i<batch.size(); i++)
+    testAsyncActions_dates += batch[i]->getMaxDate() - batch[i]->getLeftMember()->getMinDate();
+  testAsyncActions_count += (long)batch.size();
+  testAsyncActions_batches++;
+}
+
+
+void testAsyncActions()
+{
+  std::cout << "------- Test testAsyncActions : (A B)<delivered by batches>" 
+              << std::endl << std::endl;
+
+  RecognitionEngine engine(&std::cout, RecognitionEngine::SILENT);
+  ChronicleSequence& c1 = $(A) + $(B);         //A B
+  // The recognitions leave the set at once, the queue keeps them alive
+  c1.setRecognitionBudget(1);
+  engine.setAsyncActions(testAsyncActions_batch, 4, 3);
+  engine.addChronicle(&c1);
+  CRL::testBoolean(engine.hasAsyncActions(), true, false);
+
+  // 10 A then 10 B : 100 recognitions, by batches of 3 at most
+  for (int i=0; i<10; i++)
+    engine << (double)i << "A";
+  for (int i=10; i<20; i++)
+    engine << (double)i << "B";
+  engine << flush;
+  engine.flushActions();
+
+  CRL::testInteger(testAsyncActions_count, 100, false);
+  CRL::testInteger((long)engine.getActionQueue()->getDeliveredCount(), 100, false);
+  CRL::testBoolean(testAsyncActions_batches >= 34, true, false);
+  // Sum of the spans (j - i) for i in [0,10[ and j in [10,20[
+  CRL::testDouble(testAsyncActions_dates, 1000.0, 1e-9, false);
+  CRL::testInteger((long)c1.getRecognitionSet().size(), 1, false);
+
+  engine.setAsyncActions(NULL);
+  CRL::testBoolean(engine.hasAsyncActions(), false, false);
+
+  std::cout << std::endl;
+
+  c1.deepDestroy();
+}
+
+
 void testAction()
 {
   CRL::CRL_ErrReport::START("CRL","ChronicleAction");
@@ -319,6 +374,7 @@ void testAction()
   testActionPostEventNow();
   testActionPostEventInFuture();
   testChangeDelay();
+  testAsyncActions();
   Event::freeAllInstances();
   std::cout << std::endl;
 }
@@ -155,7 +155,10 @@ void testRecoTree()
   r3.setMinDate(2.0);
   r3.setMaxDate(2.0);
 
-  RecoTreeCouple r1r3(&r1, &r3, false);
+  // The couple holds its members: trees on the stack are held by the test too
+  r1.addRef();
+  r3.addRef();
+  RecoTreeCouple r1r3(&r1, &r3);
   r1r3.copyDateAndOrder(r1,r3);
   CRL::testInteger(r1r3.getMinOrder(), 2);
   CRL::testInteger(r1r3.getMaxOrder(), 3);
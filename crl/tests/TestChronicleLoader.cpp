@@ -0,0 +1,232 @@
+/** ***********************************************************************************
+ * \file TestChronicleLoader.cpp
+ * \author Ariane Piel & Jean Bourrely / Onera DCPS
+ * \date 2014
+ * \brief Unit tests of the loading of chronicles from their text notation
+ **************************************************************************************/
+
+/*  Copyright (C) 2012, 2013, 2014  ONERA  http://www.onera.fr
+    This file is part of CRL : Chronicle Recognition Library.
+
+    CRL is free software: you can redistribute it and/or modify it under
+    the terms of the Lesser GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    CRL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    Lesser GNU General Public License for more details.
+
+    You should have received a copy of the Lesser GNU General Public License
+    along with CRL.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// ----------------------------------------------------------------------------
+// INCLUDE FILES
+// ----------------------------------------------------------------------------
+
+#include <sstream>
+
+#include "TestUtils.h"
+#include "Operators.h"
+#include "RecognitionEngine.h"
+#include "ChronicleLoader.h"
+
+using namespace CRL;
+
+
+// ----------------------------------------------------------------------------
+// UNIT TESTS
+// ----------------------------------------------------------------------------
+
+void testChronicleLoaderNotation()
+{
+  std::cout << "------- Tests of the notation of each operator" << std::endl << std::endl;
+
+  // Delay of 2.5 seconds, in the units of the dates
+  std::stringstream delay;
+  delay << "((A B)+" << DateTraits<DurationType>::fromSeconds(2.5) << ")";
+  std::string delayNotation = delay.str();
+
+  const char* notations[] = { "A", "tcrl5", "(A B)", "((A B)&&C)", "(A||B)", "(A==B)", "(A&=B)",
+                              "(A|=B)", "(A>=B)", "(A meets B)", "(A/B)", "(A ! B)", "(A != B)",
+                              "(A+4)", "(A==4)", "(A>>4)", "(A<<4)", delayNotation.c_str(), "(A->x)", "@A",
+                              "([A B]-C)", "(]A B[-C)", "((A->x) (B->y))", NULL };
+
+  ChronicleLoader loader;
+  for (int i=0; notations[i] != NULL; i++)
+  {
+    Chronicle* cr = loader.parse(notations[i]);
+    CRL::testString(cr->toString().c_str(), notations[i], false);
+  }
+  CRL::testInteger((long)loader.getChronicles().size(), 23, false);
+
+  // A fractional number of time units is rejected by the exact representations
+  bool rejected = false;
+  try { loader.parse("(A+0.5)"); } catch (const std::string&) { rejected = true; }
+  CRL::testBoolean(rejected, DateTraits<DateType>::exact, false);
+  loader.destroyChronicles();
+
+  std::cout << std::endl;
+}
+
+void testChronicleLoaderSharing()
+{
+  std::cout << "------- Tests of the sharing of identical sub-chronicles" << std::endl << std::endl;
+
+  ChronicleLoader loader;
+
+  Chronicle* conj = loader.parse("((A B)&&(A B))");
+  CRL::testBoolean(conj->getChild1() == conj->getChild2(), true, false);
+  CRL::testInteger(conj->getChild1()->getShareCount(), 1, false);
+
+  // Shared across chronicles
+  Chronicle* seq = loader.parse("((A B) C)");
+  CRL::testBoolean(seq->getChild1() == conj->getChild1(), true, false);
+  CRL::testInteger(conj->getChild1()->getShareCount(), 2, false);
+
+  // DelayThen consumes the recognitions of its operand: the operand is not shared
+  Chronicle* delay = loader.parse("((A B)+2)");
+  CRL::testBoolean(delay->getChild1() != conj->getChild1(), true, false);
+  CRL::testString(delay->getChild1()->toString().c_str(), "(A B)", false);
+  CRL::testBoolean(delay->getChild1()->getChild1() == conj->getChild1()->getChild1(), true, false);
+
+  // Top nodes are never shared
+  Chronicle* other = loader.parse("((A B) C)");
+  CRL::testBoolean(other != seq, true, false);
+  CRL::testBoolean(other->getChild1() == seq->getChild1(), true, false);
+
+  loader.destroyChronicles();
+
+  std::cout << std::endl;
+}
+
+void testChronicleLoaderFile()
+{
+  std::cout << "------- Tests of a definition file" << std::endl << std::endl;
+
+  std::istringstream file(
+    "# Chronicles of the test\n"
+    "AB = (A B)\n"
+    "\n"
+    "ABC = (AB C)   # reference to AB\n"
+    "(ABC||D)\n"
+    "(AB+10)\n");
+
+  ChronicleLoader loader;
+  CRL::testInteger((long)loader.load(file), 4, false);
+  CRL::testInteger((long)loader.getChronicles().size(), 4, false);
+
+  Chronicle* AB = loader.getDefinition("AB");
+  Chronicle* ABC = loader.getDefinition("ABC");
+  CRL::testBoolean(loader.getDefinition("D") == NULL, true, false);
+  CRL::testString(AB->toString().c_str(), "AB", false);
+  CRL::testString(ABC->toString().c_str(), "ABC", false);
+  CRL::testBoolean(ABC->getChild1() == AB, true, false);
+  CRL::testString(loader.getChronicles().back()->toString().c_str(), "((A B)+10)", false);
+  CRL::testBoolean(loader.getChronicles().back()->getChild1() != AB, true, false);
+
+  RecognitionEngine engine(&std::cout, RecognitionEngine::VERBOSE);
+  std::list<Chronicle*>::const_iterator it;
+  for (it=loader.getChronicles().begin(); it!=loader.getChronicles().end(); it++)
+    engine.addChronicle(*it);
+
+  engine << 1.0 << "A" << 2.0 << "B" << 3.0 << "C" << 4.0 << "D" << flush;
+  CRL::testInteger((long)AB->getRecognitionSet().size(), 1, false);
+  CRL::testInteger((long)ABC->getRecognitionSet().size(), 1, false);
+  CRL::testInteger((long)(*(++loader.getChronicles().begin()))->getRecognitionSet().size(), 1, false);
+  CRL::testInteger((long)(*(++++loader.getChronicles().begin()))->getRecognitionSet().size(), 2, false);
+
+  engine << 12.0 << flush;
+  CRL::testInteger((long)loader.getChronicles().back()->getRecognitionSet().size(), 1, false);
+
+  loader.destroyChronicles();
+
+  std::cout << std::endl;
+}
+
+void testChronicleLoaderErrors()
+{
+  std::cout << "------- Tests of syntax errors" << std::endl << std::endl;
+
+  const char* errors[] = { "(A B", "(A ? B)", "(A+)", "A B", "([A B-C)", "()", NULL };
+
+  ChronicleLoader loader;
+  for (int i=0; errors[i] != NULL; i++)
+  {
+    bool thrown = false;
+    try
+    {
+      loader.parse(errors[i]);
+    }
+    catch (std::string& msg)
+    {
+      std::cout << msg << std::endl;
+      thrown = true;
+    }
+    CRL::testBoolean(thrown, true, false);
+  }
+
+  std::istringstream file("AB = (A B)\nAB = (A C)\n");
+  bool thrown = false;
+  try
+  {
+    loader.load(file);
+  }
+  catch (std::string& msg)
+  {
+    std::cout << msg << std::endl;
+    thrown = true;
+  }
+  CRL::testBoolean(thrown, true, false);
+
+  loader.destroyChronicles();
+
+  std::cout << std::endl;
+}
+
+void testChronicleLoader()
+{
+  CRL::CRL_ErrReport::START("CRL","ChronicleLoader");
+  std::cout << "##### ------- Tests of the chronicle loader" 
+              << std::endl << std::endl;
+  testChronicleLoaderNotation();
+  testChronicleLoaderSharing();
+  testChronicleLoaderFile();
+  testChronicleLoaderErrors();
+  Event::freeAllInstances();
+  std::cout << std::endl;
+}
+
+
+#ifdef UNITARY_TEST
+int main() 
+{
+  try
+  {
+    testChronicleLoader();
+    
+    CRL::CRL_ErrReport::PRINT_ALL();
+
+    return 0;
+  }
+
+  catch(std::string& msg) {                        
+    std::cout << "main : "     
+    << msg << std::endl;
+    return 1;                                      
+  }                                                
+  catch(const char* msg) {                         
+  std::cout << "main : "       
+  << msg << std::endl;
+  return 1;                                        
+  }                                                                                           
+  catch(...) {                                     
+  std::cout << "main : Unknown Exception"
+  << std::endl;
+  return 1;                                        
+  }
+
+}
+#endif
@@ -0,0 +1,347 @@
+/** ***********************************************************************************
+ * \file TestChronicleOptimizer.cpp
+ * \author Ariane Piel & Jean Bourrely / Onera DCPS
+ * \date 2014
+ * \brief Unit tests of the rewrites of chronicle trees
+ **************************************************************************************/
+
+/*  Copyright (C) 2012, 2013, 2014  ONERA  http://www.onera.fr
+    This file is part of CRL : Chronicle Recognition Library.
+
+    CRL is free software: you can redistribute it and/or modify it under
+    the terms of the Lesser GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    CRL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    Lesser GNU General Public License for more details.
+
+    You should have received a copy of the Lesser GNU General Public License
+    along with CRL.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// ----------------------------------------------------------------------------
+// INCLUDE FILES
+// ----------------------------------------------------------------------------
+
+#include "TestUtils.h"
+#include "Operators.h"
+#include "RecognitionEngine.h"
+#include "ChronicleOptimizer.h"
+
+using namespace CRL;
+
+
+// ----------------------------------------------------------------------------
+// UNIT TESTS
+// ----------------------------------------------------------------------------
+
+static DateType seconds(double s) { return DateTraits<DateType>::fromSeconds(s); }
+
+void testChronicleOptimizerReassociation()
+{
+  std::cout << "------- Tests with chronicle ((A B) C), A and B frequent" << std::endl << std::endl;
+
+  RecognitionEngine optimized(&std::cout, RecognitionEngine::VERBOSE);
+  RecognitionEngine reference(&std::cout, RecognitionEngine::SILENT);
+  optimized.setOptimizeChronicles(true);
+  optimized.getOptimizer().setEventCardinality("A", 100.0);
+  optimized.getOptimizer().setEventCardinality("B", 100.0);
+
+  ChronicleSequence& ABC = (($(A) + $(B)) + $(C));
+  ChronicleSequence& ABCref = (($(A) + $(B)) + $(C));
+  optimized.addChronicle(ABC);
+  reference.addChronicle(ABCref);
+
+  // The root is kept, the chain is re-associated
+  CRL::testString(ABC.toString().c_str(), "(A (B C))", false);
+  CRL::testInteger((long)optimized.getOptimizer().getRewriteCount(), 1, false);
+
+  optimized << 1.0 << "A" << 2.0 << "A" << 3.0 << "B" << 4.0 << "B" << 5.0 << "C" << flush;
+  reference << 1.0 << "A" << 2.0 << "A" << 3.0 << "B" << 4.0 << "B" << 5.0 << "C" << flush;
+  CRL::testInteger((long)ABC.getRecognitionSet().size(), 4, false);
+  CRL::testInteger((long)ABC.getRecognitionSet().size(), (long)ABCref.getRecognitionSet().size(), false);
+
+  // Named chronicles are never rewritten
+  ChronicleSequence& AB = ($(A) + $(B));
+  AB.setName("AB");
+  ChronicleSequence& ABC2 = (AB + $(C));
+  optimized.addChronicle(ABC2);
+  CRL::testString(ABC2.getOpLeft()->toString().c_str(), "AB", false);
+
+  std::cout << std::endl;
+
+  ABC.deepDestroy();
+  ABCref.deepDestroy();
+  ABC2.deepDestroy();
+}
+
+void testChronicleOptimizerPeremption()
+{
+  std::cout << "------- Tests with chronicle ((A B) C) re-associated, then peremption durations" 
+            << std::endl << std::endl;
+
+  RecognitionEngine optimized(&std::cout, RecognitionEngine::VERBOSE);
+  RecognitionEngine reference(&std::cout, RecognitionEngine::SILENT);
+  optimized.setOptimizeChronicles(true);
+  optimized.getOptimizer().setEventCardinality("A", 100.0);
+  optimized.getOptimizer().setEventCardinality("B", 100.0);
+
+  ChronicleSequence& ABC = (($(A) + $(B)) + $(C));
+  ChronicleSequence& ABCref = (($(A) + $(B)) + $(C));
+  optimized.addChronicle(ABC);
+  reference.addChronicle(ABCref);
+  CRL::testBoolean(ABC.isRewritten(), true, false);
+  CRL::testBoolean(ABC.getOpRight()->isRewritten(), true, false);
+  CRL::testBoolean(ABCref.isRewritten(), false, false);
+
+  // The windows would apply to other sub-chronicles than those of the original tree
+  bool thrown = false;
+  try { optimized.activateForget(3.0); } catch (...) { thrown = true; }
+  CRL::testBoolean(thrown, true, false);
+  thrown = false;
+  try { ABC.setPeremptionDuration(3.0, true); } catch (...) { thrown = true; }
+  CRL::testBoolean(thrown, true, false);
+  CRL::testDouble(ABC.getOpLeft()->getPeremptionDuration(), -1.0, false);
+
+  // The retention horizons keep the recognitions of the root
+  optimized.activateAutoForget();
+  reference.activateAutoForget();
+  optimized << 1.0 << "A" << 2.0 << "A" << 3.0 << "B" << 4.0 << "B" << 5.0 << "C" << flush;
+  reference << 1.0 << "A" << 2.0 << "A" << 3.0 << "B" << 4.0 << "B" << 5.0 << "C" << flush;
+  CRL::testInteger((long)ABC.getRecognitionSet().size(), 4, false);
+  CRL::testInteger((long)ABC.getRecognitionSet().size(), (long)ABCref.getRecognitionSet().size(), false);
+
+  std::cout << std::endl;
+
+  ABC.deepDestroy();
+  ABCref.deepDestroy();
+}
+
+void testChronicleOptimizerFilters()
+{
+  std::cout << "------- Tests with chronicles (((A B)<<5)<<3) and (((A B) C)<<5)" << std::endl << std::endl;
+
+  ChronicleOptimizer optimizer;
+
+  ChronicleDelayAtMost& fused = ((($(A) + $(B)) < 5.0) < 3.0);
+  optimizer.optimize(&fused);
+  CRL::testString(fused.toString().c_str(), "((A B)<<3)", false);
+
+  ChronicleDelayAtLeast& fusedLeast = ((($(A) + $(B)) > 5.0) > 3.0);
+  optimizer.optimize(&fusedLeast);
+  CRL::testString(fusedLeast.toString().c_str(), "((A B)>>5)", false);
+
+  optimizer.setDefaultCardinality(10.0);
+  RecognitionEngine optimized(&std::cout, RecognitionEngine::VERBOSE);
+  RecognitionEngine reference(&std::cout, RecognitionEngine::SILENT);
+  ChronicleDelayAtMost& pushed = ((($(A) + $(B)) + $(C)) < 5.0);
+  ChronicleDelayAtMost& pushedRef = ((($(A) + $(B)) + $(C)) < 5.0);
+  CRL::testBoolean(optimizer.estimateCost(&pushed) > 400.0, true, false);
+  optimizer.optimize(&pushed);
+  CRL::testString(pushed.toString().c_str(), "((((A B)<<5) C)<<5)", false);
+  CRL::testBoolean(optimizer.estimateCost(&pushed) < 300.0, true, false);
+  optimized.addChronicle(pushed);
+  reference.addChronicle(pushedRef);
+
+  optimized << 1.0 << "A" << 2.0 << "B" << 3.0 << "C" << 10.0 << "A" << 20.0 << "B" << 21.0 << "C" << flush;
+  reference << 1.0 << "A" << 2.0 << "B" << 3.0 << "C" << 10.0 << "A" << 20.0 << "B" << 21.0 << "C" << flush;
+  CRL::testInteger((long)pushed.getRecognitionSet().size(), 1, false);
+  CRL::testInteger((long)pushed.getRecognitionSet().size(), (long)pushedRef.getRecognitionSet().size(), false);
+
+  std::cout << std::endl;
+
+  fused.deepDestroy();
+  fusedLeast.deepDestroy();
+  pushed.deepDestroy();
+  pushedRef.deepDestroy();
+}
+
+void testChronicleOptimizerAbsences()
+{
+  std::cout << "------- Tests with chronicle (((A B) - C) - D)" << std::endl << std::endl;
+
+  RecognitionEngine optimized(&std::cout, RecognitionEngine::VERBOSE);
+  RecognitionEngine reference(&std::cout, RecognitionEngine::SILENT);
+  optimized.setOptimizeChronicles(true);
+  optimized.getOptimizer().setDefaultCardinality(10.0);
+  optimized.getOptimizer().setEventCardinality("C", 1.0);
+  optimized.getOptimizer().setEventCardinality("D", 1.0);
+
+  ChronicleAbsence& ABCD = ((($(A) + $(B)) - $(C)) - $(D));
+  ChronicleAbsence& ABCDref = ((($(A) + $(B)) - $(C)) - $(D));
+  optimized.addChronicle(ABCD);
+  reference.addChronicle(ABCDref);
+
+  CRL::testString(ABCD.getOpLeft()->toString().c_str(), "(A B)", false);
+  CRL::testString(ABCD.getOpRight()->toString().c_str(), "(C||D)", false);
+
+  optimized << 1.0 << "A" << 2.0 << "C" << 3.0 << "B" << 5.0 << "A" << 6.0 << "D" << 7.0 << "B"
+            << 10.0 << "A" << 12.0 << "B" << flush;
+  reference << 1.0 << "A" << 2.0 << "C" << 3.0 << "B" << 5.0 << "A" << 6.0 << "D" << 7.0 << "B"
+            << 10.0 << "A" << 12.0 << "B" << flush;
+  CRL::testInteger((long)ABCD.getRecognitionSet().size(), 1, false);
+  CRL::testInteger((long)ABCD.getRecognitionSet().size(), (long)ABCDref.getRecognitionSet().size(), false);
+
+  // Rare A and B: the nested absences are cheaper
+  ChronicleOptimizer optimizer;
+  optimizer.setDefaultCardinality(1.0);
+  optimizer.setEventCardinality("C", 10.0);
+  ChronicleAbsence& kept = ((($(A) + $(B)) - $(C)) - $(D));
+  optimizer.optimize(&kept);
+  CRL::testInteger((long)optimizer.getRewriteCount(), 0, false);
+  CRL::testString(kept.getOpRight()->toString().c_str(), "D", false);
+
+  std::cout << std::endl;
+
+  ABCD.deepDestroy();
+  ABCDref.deepDestroy();
+  kept.deepDestroy();
+}
+
+void testChronicleOptimizerReplanning()
+{
+  std::cout << "------- Tests with chronicles ((A B) C) and ((A&&B)&&C), re-planned every 10 events" << std::endl << std::endl;
+
+  RecognitionEngine adaptive(&std::cout, RecognitionEngine::VERBOSE);
+  RecognitionEngine reference(&std::cout, RecognitionEngine::SILENT);
+  adaptive.setReplanPeriod(10);
+
+  ChronicleSequence& ABC = (($(A) + $(B)) + $(C));
+  ChronicleSequence& ABCref = (($(A) + $(B)) + $(C));
+  ChronicleConjunction& conj = (($(A) && $(B)) && $(C));
+  ChronicleConjunction& conjRef = (($(A) && $(B)) && $(C));
+  adaptive.addChronicle(ABC);
+  adaptive.addChronicle(conj);
+  reference.addChronicle(ABCref);
+  reference.addChronicle(conjRef);
+  CRL::testInteger((long)adaptive.getReplanner().getChains().size(), 2, false);
+
+  // Frequent A and B: the pending recognitions (A B) are migrated when the chains switch to (A (B C))
+  double t = 0.0;
+  for (int i=0; i<5; i++)
+  {
+    adaptive << seconds(t) << "A" << seconds(t + 0.5) << "B" << flush;
+    reference << seconds(t) << "A" << seconds(t + 0.5) << "B" << flush;
+    t += 1.0;
+  }
+  CRL::testInteger((long)adaptive.getReplanner().getReplanCount(), 2, false);
+  CRL::testString(ABC.toString().c_str(), "(A (B C))", false);
+  CRL::testString(conj.toString().c_str(), "(A&&(B&&C))", false);
+
+  adaptive << seconds(t) << "C" << seconds(t + 0.5) << "A" << seconds(t + 0.7) << "B" << seconds(t + 0.9) << "C" << flush;
+  reference << seconds(t) << "C" << seconds(t + 0.5) << "A" << seconds(t + 0.7) << "B" << seconds(t + 0.9) << "C" << flush;
+  CRL::testInteger((long)ABC.getRecognitionSet().size(), 36, false);
+  CRL::testInteger((long)ABC.getRecognitionSet().size(), (long)ABCref.getRecognitionSet().size(), false);
+  CRL::testInteger((long)conj.getRecognitionSet().size(), (long)conjRef.getRecognitionSet().size(), false);
+
+  // Then frequent C: any further change of plan keeps the recognitions
+  t += 1.0;
+  for (int i=0; i<20; i++)
+  {
+    adaptive << seconds(t) << "C" << flush;
+    reference << seconds(t) << "C" << flush;
+    t += 1.0;
+  }
+  adaptive << seconds(t) << "A" << seconds(t + 0.5) << "B" << seconds(t + 0.7) << "C" << flush;
+  reference << seconds(t) << "A" << seconds(t + 0.5) << "B" << seconds(t + 0.7) << "C" << flush;
+  CRL::testInteger((long)ABC.getRecognitionSet().size(), (long)ABCref.getRecognitionSet().size(), false);
+  CRL::testInteger((long)conj.getRecognitionSet().size(), (long)conjRef.getRecognitionSet().size(), false);
+  CRL::testInteger((long)adaptive.getReplanner().getReplanCount(), 4, false);
+  CRL::testString(ABC.toString().c_str(), "((A B) C)", false);
+
+  // The recognitions of the root still refer to the former links
+  const RecoTree* reco = *ABC.getRecognitionSet().begin();
+  CRL::testString(reco->getRightMember()->getMyChronicle()->toString().c_str(), "(B C)", false);
+  CRL::testBoolean(reco->getRightMember()->getMyChronicle()->getRecognitionSet().empty(), true, false);
+
+  // A re-planned chronicle tree cannot forget its recognitions anymore
+  bool thrown = false;
+  try { adaptive.activateForget(seconds(5.0)); }
+  catch (...) { thrown = true; }
+  CRL::testBoolean(thrown, true, false);
+
+  std::cout << std::endl;
+
+  ABC.deepDestroy();
+  ABCref.deepDestroy();
+  conj.deepDestroy();
+  conjRef.deepDestroy();
+}
+
+void testChronicleOptimizerReplanningPeremption()
+{
+  std::cout << "------- Tests with chronicle ((C A) B), forgetting, re-planned every 3 events" << std::endl << std::endl;
+
+  RecognitionEngine adaptive(&std::cout, RecognitionEngine::VERBOSE);
+  RecognitionEngine reference(&std::cout, RecognitionEngine::SILENT);
+  adaptive.setReplanPeriod(3);
+
+  ChronicleSequence& CAB = (($(C) + $(A)) + $(B));
+  ChronicleSequence& CABref = (($(C) + $(A)) + $(B));
+  adaptive.addChronicle(CAB);
+  reference.addChronicle(CABref);
+  adaptive.activateForget(seconds(3.0));
+  reference.activateForget(seconds(3.0));
+
+  // Frequent A and B would favour (C (A B)), but the pending recognitions (C A) are forgotten
+  adaptive << seconds(1.0) << "C" << seconds(2.0) << "A" << seconds(2.5) << "B" << seconds(3.0) << "A" << seconds(3.5) << "B" << seconds(4.0) << "B" << flush;
+  reference << seconds(1.0) << "C" << seconds(2.0) << "A" << seconds(2.5) << "B" << seconds(3.0) << "A" << seconds(3.5) << "B" << seconds(4.0) << "B" << flush;
+  CRL::testInteger((long)adaptive.getReplanner().getReplanCount(), 0, false);
+  CRL::testString(CAB.toString().c_str(), "((C A) B)", false);
+  CRL::testInteger((long)CAB.getRecognitionSet().size(), (long)CABref.getRecognitionSet().size(), false);
+
+  std::cout << std::endl;
+
+  CAB.deepDestroy();
+  CABref.deepDestroy();
+}
+
+void testChronicleOptimizer()
+{
+  CRL::CRL_ErrReport::START("CRL","ChronicleOptimizer");
+  std::cout << "##### ------- Tests of the chronicle optimizer" 
+              << std::endl << std::endl;
+  testChronicleOptimizerReassociation();
+  testChronicleOptimizerPeremption();
+  testChronicleOptimizerFilters();
+  testChronicleOptimizerAbsences();
+  testChronicleOptimizerReplanning();
+  testChronicleOptimizerReplanningPeremption();
+  Event::freeAllInstances();
+  std::cout << std::endl;
+}
+
+
+#ifdef UNITARY_TEST
+int main() 
+{
+  try
+  {
+    testChronicleOptimizer();
+    
+    CRL::CRL_ErrReport::PRINT_ALL();
+
+    return 0;
+  }
+
+  catch(std::string& msg) {                        
+    std::cout << "main : "     
+    << msg << std::endl;
+    return 1;                                      
+  }                                                
+  catch(const char* msg) {                         
+  std::cout << "main : "       
+  << msg << std::endl;
+  return 1;                                        
+  }                                                                                           
+  catch(...) {                                     
+  std::cout << "main : Unknown Exception"
+  << std::endl;
+  return 1;                                        
+  }
+
+}
+#endif
@@ -0,0 +1,238 @@
+/** ***********************************************************************************
+ * \file TestChroniclePlan.cpp
+ * \author Ariane Piel & Jean Bourrely / Onera DCPS
+ * \date 2014
+ * \brief Unit tests of the compiled execution plans
+ **************************************************************************************/
+
+/*  Copyright (C) 2012, 2013, 2014  ONERA  http://www.onera.fr
+    This file is part of CRL : Chronicle Recognition Library.
+
+    CRL is free software: you can redistribute it and/or modify it under
+    the terms of the Lesser GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    CRL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    Lesser GNU General Public License for more details.
+
+    You should have received a copy of the Lesser GNU General Public License
+    along with CRL.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// ----------------------------------------------------------------------------
+// INCLUDE FILES
+// ----------------------------------------------------------------------------
+
+#include <set>
+#include <sstream>
+
+#include "TestUtils.h"
+#include "Operators.h"
+#include "RecognitionEngine.h"
+#include "ChroniclePlan.h"
+
+using namespace CRL;
+
+
+// ----------------------------------------------------------------------------
+// UNIT TESTS
+// ----------------------------------------------------------------------------
+
+static DateType seconds(double s) { return DateTraits<DateType>::fromSeconds(s); }
+
+//! Number of chronicles built by #testChroniclePlan_build
+const int testChroniclePlan_nb = 9;
+
+
+bool testChroniclePlan_pred(const PropertyManager& p)
+{
+  return ( (long)p["x"]["CRL ID"] % 2 == 0 );
+}
+
+
+//! Returns the dates and orders of the recognitions of \a cr, sorted
+std::string testChroniclePlan_recognitions(Chronicle& cr)
+{
+  std::set<std::string> recos;
+  Chronicle::RecoSet::const_iterator it;
+  for (it=cr.getRecognitionSet().begin(); it!=cr.getRecognitionSet().end(); it++)
+  {
+    std::ostringstream os;
+    os << (*it)->getMinDate() << "," << (*it)->getMinOrder() << "-" 
+       << (*it)->getMaxDate() << "," << (*it)->getMaxOrder();
+    recos.insert(os.str());
+  }
+  std::string s;
+  std::set<std::string>::iterator itS;
+  for (itS=recos.begin(); itS!=recos.end(); itS++)
+    s += *itS + " ";
+  return s;
+}
+
+
+//! Builds chronicles using most of the operators
+void testChroniclePlan_build(Chronicle* chronicles[])
+{
+  ChronicleSequence& AxB = ($$($(A),x) + $(B));
+  AxB.setPredicateFunction(testChroniclePlan_pred);
+  chronicles[0] = &AxB;
+  chronicles[1] = &(($(A) + $(B)) + 2.0);
+  chronicles[2] = &(($(A) + $(C)) - $(D));
+  chronicles[3] = &($(A) += $(B));
+  chronicles[4] = &($(B) != $(C));
+  chronicles[5] = &(AT($(A) + $(B)) + $(D));
+  chronicles[6] = &((($(A) && $(C)) || $(D)) < 3.0);
+  chronicles[7] = &(($(A) + $(B)) / ($(B) + $(C)));
+  chronicles[8] = &(($(A) + $(B)) + $(C));
+  chronicles[8]->setCountOnly(true);
+}
+
+
+void testChroniclePlan_equivalence()
+{
+  std::cout << "------- Tests of the compiled plan against the recursive processing" 
+            << std::endl << std::endl;
+
+  RecognitionEngine engine(&std::cout, RecognitionEngine::SILENT);
+  RecognitionEngine planEngine(&std::cout, RecognitionEngine::SILENT);
+  planEngine.setUseCompiledPlan(true);
+  Chronicle* chronicles[testChroniclePlan_nb];
+  Chronicle* planChronicles[testChroniclePlan_nb];
+  testChroniclePlan_build(chronicles);
+  testChroniclePlan_build(planChronicles);
+  for (int i=0; i<testChroniclePlan_nb; i++)
+  {
+    engine.addChronicle(chronicles[i]);
+    planEngine.addChronicle(planChronicles[i]);
+  }
+
+  const char* names[] = { "A", "B", "C", "D", "E" };
+  unsigned long seed = 5;
+  double date = 0.0;
+  for (int i=0; i<60; i++)
+  {
+    seed = seed * 1103515245 + 12345;
+    date += (double)((seed >> 4) % 3);
+    engine << date << names[(seed >> 16) % 5];
+    planEngine << date << names[(seed >> 16) % 5];
+  }
+  engine << flush;
+  planEngine << flush;
+
+  CRL::testInteger(planEngine.getCurrentOrder(), engine.getCurrentOrder(), false);
+  for (int i=0; i<testChroniclePlan_nb-1; i++)
+  {
+    CRL::testBoolean(chronicles[i]->getRecognitionSet().size() > 0, true, false);
+    CRL::testString(testChroniclePlan_recognitions(*planChronicles[i]).c_str(),
+                    testChroniclePlan_recognitions(*chronicles[i]).c_str(), false);
+  }
+  CRL::testBoolean(chronicles[testChroniclePlan_nb-1]->getCount() > 0.0, true, false);
+  CRL::testDouble(planChronicles[testChroniclePlan_nb-1]->getCount(),
+                  chronicles[testChroniclePlan_nb-1]->getCount(), 0.0, false);
+
+  std::cout << std::endl;
+
+  for (int i=0; i<testChroniclePlan_nb; i++)
+  {
+    chronicles[i]->deepDestroy();
+    planChronicles[i]->deepDestroy();
+  }
+}
+
+
+void testChroniclePlan_steps()
+{
+  std::cout << "------- Tests of the steps of the plan of (A B) && (A B), with shared members, and (A B) + 1" 
+            << std::endl << std::endl;
+
+  RecognitionEngine engine(&std::cout, RecognitionEngine::SILENT);
+  engine.setShareSubChronicles(true);
+  engine.setUseCompiledPlan(true);
+  ChronicleConjunction& ABandAB = (($(A) + $(B)) && ($(A) + $(B)));
+  ChronicleDelayThen& ABthen1 = (($(A) + $(B)) + seconds(1.0));
+  engine.addChronicle(ABandAB);
+  engine.addChronicle(ABthen1);
+
+  engine << seconds(1.0) << "A" << seconds(2.0) << "B" << flush;
+  CRL::testInteger((long)ABandAB.getRecognitionSet().size(), 1, false);
+
+  ChroniclePlan plan;
+  plan.compile(engine.getRootChronicles());
+  const std::vector<ChroniclePlan::Step>& steps = plan.getSteps();
+
+  // A, B and (A B) appear once, before their parents ; the member of the
+  // delay keeps its new recognitions from one event to the next
+  CRL::testInteger((long)steps.size(), 6, false);
+  CRL::testInteger(steps[0].kind, ChroniclePlan::LEAF_EVENT, false);
+  CRL::testString(steps[0].code->c_str(), "A", false);
+  CRL::testInteger(steps[2].kind, ChroniclePlan::RIGHT_DRIVEN, false);
+  CRL::testInteger(steps[3].kind, ChroniclePlan::EITHER_DRIVEN, false);
+  CRL::testInteger(steps[3].op, ChroniclePlan::CONJUNCTION, false);
+  CRL::testInteger(steps[3].child1, 2, false);
+  CRL::testInteger(steps[3].child2, 2, false);
+  CRL::testInteger(steps[5].kind, ChroniclePlan::ALWAYS, false);
+  CRL::testInteger(steps[5].op, ChroniclePlan::DELAY_THEN, false);
+  CRL::testInteger(steps[5].child1, 4, false);
+  for (size_t i=0; i<steps.size(); i++)
+  {
+    CRL::testBoolean(steps[i].child1 < (int)i, true, false);
+    CRL::testBoolean(steps[i].child2 < (int)i, true, false);
+    CRL::testBoolean(steps[i].keepNewRecognitions, (i == 4), false);
+  }
+
+  engine << seconds(2.5) << "A" << seconds(3.0) << "B" << seconds(5.0) << flush;
+  CRL::testInteger((long)ABandAB.getRecognitionSet().size(), 9, false);
+  CRL::testInteger((long)ABthen1.getRecognitionSet().size(), 3, false);
+
+  std::cout << std::endl;
+
+  ABandAB.deepDestroy();
+  ABthen1.deepDestroy();
+}
+
+
+void testChroniclePlan()
+{
+  CRL::CRL_ErrReport::START("CRL","ChroniclePlan");
+  std::cout << "##### ------- Tests of the compiled plan of the chronicles" 
+              << std::endl << std::endl;
+  testChroniclePlan_equivalence();
+  testChroniclePlan_steps();
+  Event::freeAllInstances();
+  std::cout << std::endl;
+}
+
+
+#ifdef UNITARY_TEST
+int main() 
+{
+  try
+  {
+    testChroniclePlan();
+    
+    CRL::CRL_ErrReport::PRINT_ALL();
+
+    return 0;
+  }
+
+  catch(std::string& msg) {                        
+    std::cout << "main : "     
+    << msg << std::endl;
+    return 1;                                      
+  }                                                
+  catch(const char* msg) {                         
+  std::cout << "main : "       
+  << msg << std::endl;
+  return 1;                                        
+  }                                                                                           
+  catch(...) {                                     
+  std::cout << "main : Unknown Exception"
+  << std::endl;
+  return 1;                                        
+  }
+
+}
+#endif
@@ -234,6 +234,173 @@ void testConjunctionWithPredicate()
 }
 
 
+void testConjunctionPolicies()
+{
+  std::cout << "------- Tests with chronicle (A&&B) and selection policies" << std::endl << std::endl;
+
+  RecognitionEngine engine(&std::cout, RecognitionEngine::VERBOSE);
+  ChronicleConjunction& all      = ($(A) && $(B));
+  ChronicleConjunction& earliest = ($(A) && $(B));
+  ChronicleConjunction& recent   = ($(A) && $(B));
+  ChronicleConjunction& consumed = ($(A) && $(B));
+  earliest.setSelectionPolicy(ChronicleBinaryOp::EARLIEST);
+  recent.setSelectionPolicy(ChronicleBinaryOp::MOST_RECENT);
+  consumed.setSelectionPolicy(ChronicleBinaryOp::EARLIEST);
+  consumed.setConsumeOnMatch(true);
+  engine.addChronicle(all);
+  engine.addChronicle(earliest);
+  engine.addChronicle(recent);
+  engine.addChronicle(consumed);
+
+  engine << 1.0 << "A" << 2.0 << "A" << 3.0 << "B" << 4.0 << "B" << flush;
+  CRL::testInteger((long)all.getRecognitionSet().size(), 4, false);
+  CRL::testInteger((long)earliest.getRecognitionSet().size(), 2, false);
+  CRL::testInteger((long)recent.getRecognitionSet().size(), 2, false);
+  CRL::testInteger((long)consumed.getRecognitionSet().size(), 2, false);
+  CRL::testInteger((long)consumed.getOpLeft()->getRecognitionSet().size(), 0, false);
+  CRL::testInteger((long)consumed.getOpRight()->getRecognitionSet().size(), 0, false);
+
+  // The right member is also selected, and consumed
+  engine << 5.0 << "A" << flush;
+  CRL::testInteger((long)all.getRecognitionSet().size(), 6, false);
+  CRL::testInteger((long)earliest.getRecognitionSet().size(), 3, false);
+  CRL::testInteger((long)consumed.getRecognitionSet().size(), 2, false);
+  CRL::testInteger((long)consumed.getOpLeft()->getRecognitionSet().size(), 1, false);
+
+  std::cout << std::endl;
+
+  all.deepDestroy();
+  earliest.deepDestroy();
+  recent.deepDestroy();
+  consumed.deepDestroy();
+}
+
+
+void testConjunctionDuplicates()
+{
+  std::cout << "------- Tests with chronicle (A&&A) and elimination of the duplicates" << std::endl << std::endl;
+
+  RecognitionEngine engine(&std::cout, RecognitionEngine::VERBOSE);
+  ChronicleConjunction& all    = ($(A) && $(A));
+  ChronicleConjunction& unique = ($(A) && $(A));
+  unique.setEliminateDuplicates(true);
+  CRL::testBoolean(all.structuralSignature() == unique.structuralSignature(), false, false);
+  engine.addChronicle(all);
+  engine.addChronicle(unique);
+
+  // (a1,a2) and (a2,a1) have the same members, swapped
+  engine << 1.0 << "A" << 2.0 << "A" << flush;
+  CRL::testInteger((long)all.getRecognitionSet().size(), 4, false);
+  CRL::testInteger((long)unique.getRecognitionSet().size(), 3, false);
+  engine << 3.0 << "A" << flush;
+  CRL::testInteger((long)all.getRecognitionSet().size(), 9, false);
+  CRL::testInteger((long)unique.getRecognitionSet().size(), 6, false);
+
+  // The recognitions kept are structurally equal to those of the first chronicle
+  // (same members, in the same order), with equal hashes
+  Chronicle::RecoHashSet hashed(unique.getRecognitionSet().begin(), unique.getRecognitionSet().end());
+  CRL::testInteger((long)hashed.size(), 6, false);
+  long found = 0;
+  Chronicle::RecoSet::const_iterator it;
+  for (it=all.getRecognitionSet().begin(); it!=all.getRecognitionSet().end(); it++)
+  {
+    if (Chronicle::isIn(**it, hashed)) found++;
+    CRL::testBoolean(Chronicle::isIn(**it, hashed), Chronicle::isIn(**it, unique.getRecognitionSet()), false);
+  }
+  CRL::testInteger(found, 6, false);
+
+  std::cout << std::endl;
+
+  all.deepDestroy();
+  unique.deepDestroy();
+}
+
+
+//! Recognitions of the reference chronicle, for #testConjunctionFactorised_check
+static const Chronicle::RecoSet* testConjunctionFactorised_reference = NULL;
+
+//! Number of enumerated recognitions found in the reference
+static long testConjunctionFactorised_found = 0;
+
+void testConjunctionFactorised_check(RecoTree& rc)
+{
+  if (Chronicle::isIn(rc, *testConjunctionFactorised_reference))
+    testConjunctionFactorised_found++;
+}
+
+void testConjunctionFactorised()
+{
+  std::cout << "------- Tests with chronicle (A B)&&(C D) in factorised form" << std::endl << std::endl;
+
+  RecognitionEngine engine(&std::cout, RecognitionEngine::VERBOSE);
+  ChronicleConjunction& expanded   = (($(A) + $(B)) && ($(C) + $(D)));
+  ChronicleConjunction& factorised = (($(A) + $(B)) && ($(C) + $(D)));
+  factorised.setFactorised(true);
+  CRL::testBoolean(factorised.isFactorised(), true, false);
+  CRL::testBoolean(expanded.structuralSignature() == factorised.structuralSignature(), false, false);
+  engine.addChronicle(expanded);
+  engine.addChronicle(factorised);
+
+  engine << 1.0 << "A" << 2.0 << "C" << 3.0 << "B" << 4.0 << "A" << 5.0 << "D" << flush;
+  CRL::testInteger((long)factorised.getCount(), (long)expanded.getRecognitionSet().size(), false);
+  engine << 6.0 << "B" << 7.0 << "C" << 8.0 << "D" << flush;
+  CRL::testInteger((long)expanded.getRecognitionSet().size(), 9, false);
+  CRL::testInteger((long)factorised.getCount(), 9, false);
+  CRL::testInteger((long)factorised.getNewCount(), 6, false);
+
+  // Only the members are kept : 3 recognitions of each side instead of 9
+  CRL::testInteger((long)factorised.getRecognitionSet().size(), 0, false);
+  CRL::testInteger((long)factorised.getLeftFactor().size(), 3, false);
+  CRL::testInteger((long)factorised.getRightFactor().size(), 3, false);
+  RecoTree* l = *factorised.getLeftFactor().begin();
+  RecoTree* r = *factorised.getRightFactor().begin();
+  CRL::testBoolean(factorised.containsRecognition(l, r), true, false);
+  CRL::testBoolean(factorised.containsRecognition(r, l), false, false);
+
+  // The recognitions built on demand are those of the expanded chronicle
+  testConjunctionFactorised_reference = &expanded.getRecognitionSet();
+  testConjunctionFactorised_found = 0;
+  CRL::testInteger((long)factorised.enumerateRecognitions(testConjunctionFactorised_check), 9, false);
+  CRL::testInteger(testConjunctionFactorised_found, 9, false);
+  testConjunctionFactorised_found = 0;
+  CRL::testInteger((long)factorised.enumerateRecognitions(testConjunctionFactorised_check, true), 6, false);
+  CRL::testInteger(testConjunctionFactorised_found, 6, false);
+
+  // The members keep all their recognitions, the engine does not make them forget
+  bool forgetThrown = false;
+  try { engine.activateForget(3.0); } catch (...) { forgetThrown = true; }
+  CRL::testBoolean(forgetThrown, true, false);
+  engine.activateAutoForget();
+  CRL::testBoolean(factorised.getPeremptionDuration() < 0.0, true, false);
+  CRL::testBoolean(factorised.getOpLeft()->getPeremptionDuration() < 0.0, true, false);
+  CRL::testBoolean(factorised.getOpRight()->getPeremptionDuration() < 0.0, true, false);
+  engine << 20.0 << "A" << 21.0 << "B" << flush;
+  CRL::testInteger((long)factorised.getCount(), (long)expanded.getRecognitionSet().size(), false);
+
+  // Unsupported : the recognitions are used by a parent, or filtered by a predicate
+  ChronicleConjunction& withPredicate = ($(A) && $(B));
+  withPredicate.setPredicateFunction(testConjunctionWithPredicate_pred);
+  bool thrown = false;
+  try { withPredicate.setFactorised(true); } catch (...) { thrown = true; }
+  CRL::testBoolean(thrown, true, false);
+  ChronicleConjunction& withSelection = ($(A) && $(B));
+  withSelection.setSelectionPolicy(ChronicleBinaryOp::EARLIEST);
+  thrown = false;
+  try { withSelection.setFactorised(true); } catch (...) { thrown = true; }
+  CRL::testBoolean(thrown, true, false);
+
+  factorised.setFactorised(false);
+  CRL::testInteger((long)factorised.getLeftFactor().size(), 0, false);
+
+  std::cout << std::endl;
+
+  expanded.deepDestroy();
+  factorised.deepDestroy();
+  withPredicate.deepDestroy();
+  withSelection.deepDestroy();
+}
+
+
 void testChronicleConjunction()
 {
   CRL::CRL_ErrReport::START("CRL","ChronicleConjunction");
@@ -246,6 +413,9 @@ void testChronicleConjunction()
   testNoDistributivitySeqOverConj();
   testChronicleSequenceConjunction();
   testConjunctionWithPredicate();
+  testConjunctionPolicies();
+  testConjunctionDuplicates();
+  testConjunctionFactorised();
   Event::freeAllInstances();
   std::cout << std::endl;
 }
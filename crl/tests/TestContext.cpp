@@ -205,6 +205,34 @@ void testContext2()
 }
 
 
+void testContext3()
+{
+  // The names are interned in their order of appearance, not alphabetically
+  unsigned int z = Context::internName("zz");
+  unsigned int y = Context::internName("yy");
+  CRL::testBoolean( z < y, true );
+  CRL::testInteger( Context::internName("zz"), z );
+  CRL::testString( Context::getName(y).c_str(), "yy" );
+
+  Context c1(true); c1.add("zz"); c1.add("yy");  // c1 = { ANONYMOUS, yy, zz }
+  Context c2; c2.add("yy"); c2.add("zz");        // c2 = { yy, zz }
+  CRL::testString( c1[0].c_str(), Context::ANONYMOUS().c_str() );
+  CRL::testString( c1[1].c_str(), "yy" );
+  CRL::testString( c1[2].c_str(), "zz" );
+  CRL::testBoolean( Context::areEquals(c1, c2, true), true );
+  CRL::testBoolean( c2.contains("zz"), true );
+  CRL::testBoolean( c2.contains("xx"), false );
+
+  Context result;
+  Context::contextIntersection(c1, c2, result);  // { yy, zz }
+  CRL::testBoolean( Context::areEquals(result, c2), true );
+  Context::contextUnion(c1, c2, result, true);   // { yy, zz }
+  CRL::testBoolean( Context::areEquals(result, c2), true );
+
+  std::cout << std::endl;
+}
+
+
 void testContext()
 {
   CRL::CRL_ErrReport::START("CRL", "Context");
@@ -212,6 +240,7 @@ void testContext()
 
   testContext1();
   testContext2();
+  testContext3();
   Event::freeAllInstances();
 }
 
@@ -190,6 +190,119 @@ void testCoRef2ter()
 }
 
 
+void testCoRefJoinKey()
+{
+  std::cout << "------- Tests with equi-join keys x.\"CRL ID\" == y.\"CRL ID\" instead of predicates" 
+              << std::endl << std::endl;
+
+  RecognitionEngine engine(&std::cout, RecognitionEngine::VERBOSE);
+  ChronicleConjunction& ABandBDcoref = ($(A)+$$($(B),x)) && ($$($(B),y)+$(D))  ;
+  ChronicleConjunction& BAandCAcoref = ($(B)+$$($(A),x)) && ($(C)+$$($(A),y))  ;
+  ChronicleAbsence& ABmACcoref = ($$($(A),x)+$(B)) - ($$($(A),y)+=$(C))  ;
+  ABandBDcoref.addJoinKey("x", "CRL ID", "y", "CRL ID");
+  BAandCAcoref.addJoinKey("x", "CRL ID", "y", "CRL ID");
+  ABmACcoref.addJoinKey("x", "CRL ID", "y", "CRL ID");
+  engine.addChronicle(ABandBDcoref);
+  engine.addChronicle(BAandCAcoref);
+  engine.addChronicle(ABmACcoref);
+
+  engine << 0.0 << "A" << "B" << "B" << "C" << "A" << flush;
+  CRL::testInteger((long)ABandBDcoref.getRecognitionSet().size(),    0, false);
+  CRL::testInteger((long)BAandCAcoref.getRecognitionSet().size(),    2, false);
+  CRL::testInteger((long)ABmACcoref.getRecognitionSet().size(),    2, false);
+
+  engine << "D" << "A" << flush;
+  CRL::testInteger((long)ABandBDcoref.getRecognitionSet().size(),    2, false);
+  CRL::testInteger((long)BAandCAcoref.getRecognitionSet().size(),    4, false);
+
+  // Keys declared after the beginning of the recognition
+  ChronicleConjunction& AandA = $$($(A),x) && $$($(A),y);
+  engine.addChronicle(AandA);
+  engine << "A" << flush;
+  AandA.addJoinKey("x", "CRL ID", "y", "CRL ID");
+  engine << "A" << flush;
+  CRL::testInteger((long)AandA.getRecognitionSet().size(),    2, false);
+
+  std::cout << std::endl;
+
+  ABandBDcoref.deepDestroy();
+  BAandCAcoref.deepDestroy();
+  ABmACcoref.deepDestroy();
+  AandA.deepDestroy();
+}
+
+
+void testCoRefJoinKeyValues()
+{
+  std::cout << "------- Tests of the values of the equi-join keys, and of the operators refusing them" 
+              << std::endl << std::endl;
+
+  RecoIndex::KeyPaths paths(1, RecoIndex::PropertyPath(1, "v"));
+  PropertyManager pmInt, pmDouble, pmFrac, pmHuge, pmString;
+  pmInt["v"]    = 3;
+  pmDouble["v"] = 3.0;
+  pmFrac["v"]   = 3.5;
+  pmHuge["v"]   = 1.0e30;
+  pmString["v"] = std::string("3");
+
+  std::string kInt, kDouble, kFrac, kHuge, kString, kMissing;
+  CRL::testBoolean(RecoIndex::extractKey(pmInt, paths, kInt), true, false);
+  CRL::testBoolean(RecoIndex::extractKey(pmDouble, paths, kDouble), true, false);
+  CRL::testBoolean(RecoIndex::extractKey(pmFrac, paths, kFrac), true, false);
+  CRL::testBoolean(RecoIndex::extractKey(pmHuge, paths, kHuge), true, false);
+  CRL::testBoolean(RecoIndex::extractKey(pmString, paths, kString), true, false);
+  CRL::testBoolean(RecoIndex::extractKey(PropertyManager(), paths, kMissing), false, false);
+  CRL::testBoolean(kInt == kDouble, true, false);
+  CRL::testBoolean(kInt == kFrac, false, false);
+  CRL::testBoolean(kInt == kString, false, false);
+  CRL::testBoolean(kHuge == kFrac, false, false);
+
+  // The cuts scan the recognitions awaited by the operator : the keys would be ignored
+  ChronicleCut& AcutB = ($$($(A),x) += $$($(B),y));
+  ChronicleStateChange& AchangeB = ($$($(A),x) != $$($(B),y));
+  bool thrown = false;
+  try { AcutB.addJoinKey("x", "CRL ID", "y", "CRL ID"); } catch (...) { thrown = true; }
+  CRL::testBoolean(thrown, true, false);
+  thrown = false;
+  try { AchangeB.addJoinKey("x", "CRL ID", "y", "CRL ID"); } catch (...) { thrown = true; }
+  CRL::testBoolean(thrown, true, false);
+
+  std::cout << std::endl;
+
+  AcutB.deepDestroy();
+  AchangeB.deepDestroy();
+}
+
+
+void testCoRefJoinKeyShared()
+{
+  std::cout << "------- Tests of the indexes of a shared sub-chronicle, one of its parents being destroyed" 
+              << std::endl << std::endl;
+
+  RecognitionEngine engine(&std::cout, RecognitionEngine::VERBOSE);
+  ChronicleSequence& AB = ($$($(A),x) + $$($(B),w));
+  AB.share();
+  AB.share();
+  ChronicleConjunction& ABandC = (AB && $$($(C),y));
+  ChronicleConjunction& ABandD = (AB && $$($(D),z));
+  ABandC.addJoinKey("x", "CRL ID", "y", "CRL ID");
+  ABandD.addJoinKey("w", "CRL ID", "z", "CRL ID");
+  engine.addChronicle(ABandC);
+  engine.addChronicle(ABandD);
+  CRL::testInteger((long)AB.getIndexCount(), 2, false);
+
+  engine << 0.0 << "A" << "B" << "C" << "D" << flush;
+  engine.clearChronicleList();
+  ABandC.deepDestroy();
+  CRL::testInteger((long)AB.getIndexCount(), 1, false);
+  ABandD.deepDestroy();
+  CRL::testInteger((long)AB.getIndexCount(), 0, false);
+
+  std::cout << std::endl;
+
+  AB.deepDestroy();
+}
+
 
 void testChronicleCoRef()
 {
@@ -201,6 +314,9 @@ void testChronicleCoRef()
   testCoRef2();
   testCoRef2bis();
   testCoRef2ter();
+  testCoRefJoinKey();
+  testCoRefJoinKeyValues();
+  testCoRefJoinKeyShared();
   Event::freeAllInstances();
   std::cout << std::endl;
 }
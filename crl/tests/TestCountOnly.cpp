@@ -0,0 +1,194 @@
+/** ***********************************************************************************
+ * \file TestCountOnly.cpp
+ * \author Ariane Piel & Jean Bourrely / Onera DCPS
+ * \date 2014
+ * \brief Unit tests of the count-only recognition mode
+ **************************************************************************************/
+
+/*  Copyright (C) 2012, 2013, 2014  ONERA  http://www.onera.fr
+    This file is part of CRL : Chronicle Recognition Library.
+
+    CRL is free software: you can redistribute it and/or modify it under
+    the terms of the Lesser GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    CRL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    Lesser GNU General Public License for more details.
+
+    You should have received a copy of the Lesser GNU General Public License
+    along with CRL.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// ----------------------------------------------------------------------------
+// INCLUDE FILES
+// ----------------------------------------------------------------------------
+
+#include "TestUtils.h"
+#include "Operators.h"
+#include "RecognitionEngine.h"
+
+using namespace CRL;
+
+
+// ----------------------------------------------------------------------------
+// UNIT TESTS
+// ----------------------------------------------------------------------------
+
+//! Feeds the same events to a count-only chronicle and to its reference,
+//! then compares the number of recognitions
+void testCountOnlyAgainst(Chronicle& counted, Chronicle& reference)
+{
+  std::cout << "------- Tests with chronicle " << counted.toString() << std::endl << std::endl;
+
+  const char* names[] = { "A", "A", "B", "C", "A", "B", "B", "C", "C", "A", "B", "C", NULL };
+  const double dates[] = { 1.0, 2.0, 2.0, 3.0, 4.0, 5.0, 5.0, 6.0, 7.0, 7.0, 8.0, 9.0 };
+
+  RecognitionEngine countEngine(&std::cout, RecognitionEngine::VERBOSE);
+  RecognitionEngine refEngine(&std::cout, RecognitionEngine::SILENT);
+  counted.setCountOnly(true);
+  countEngine.addChronicle(counted);
+  refEngine.addChronicle(reference);
+
+  for (int i=0; names[i] != NULL; i++)
+  {
+    countEngine << dates[i] << names[i] << flush;
+    refEngine << dates[i] << names[i] << flush;
+  }
+
+  CRL::testBoolean(counted.isCountOnly(), true, false);
+  CRL::testInteger((long)counted.getCount(), (long)reference.getRecognitionSet().size(), false);
+  CRL::testInteger((long)counted.getRecognitionSet().size(), 0, false);
+  CRL::testInteger((long)counted.getChild1()->getRecognitionSet().size(), 0, false);
+
+  std::cout << std::endl;
+
+  counted.deepDestroy();
+  reference.deepDestroy();
+}
+
+void testCountOnlyOperators()
+{
+  testCountOnlyAgainst($(A) + $(B), $(A) + $(B));
+  testCountOnlyAgainst(($(A) + $(B)) + $(C), ($(A) + $(B)) + $(C));
+  testCountOnlyAgainst(($(A) && $(B)) + $(C), ($(A) && $(B)) + $(C));
+  testCountOnlyAgainst(($(A) || $(B)) + $(C), ($(A) || $(B)) + $(C));
+  testCountOnlyAgainst(($(A) && $(B)) && $(C), ($(A) && $(B)) && $(C));
+  testCountOnlyAgainst($$($(A),aa) + ($(B) || $(C)), $$($(A),aa) + ($(B) || $(C)));
+}
+
+void testCountOnlyBursts()
+{
+  std::cout << "------- Tests with chronicle (A && B), bursts of events" << std::endl << std::endl;
+
+  RecognitionEngine engine(&std::cout, RecognitionEngine::SILENT);
+  ChronicleConjunction& AB = ($(A) && $(B));
+  AB.setCountOnly(true);
+  engine.addChronicle(AB);
+
+  // 1000 A then 1000 B : one million recognitions, none of them built
+  for (int i=0; i<1000; i++)
+    engine << (double)i << "A";
+  engine << flush;
+  CRL::testInteger((long)AB.getCount(), 0, false);
+  for (int i=0; i<1000; i++)
+    engine << 1000.0 + i << "B";
+  engine << flush;
+  CRL::testInteger((long)AB.getCount(), 1000000, false);
+  CRL::testInteger((long)AB.getNewCount(), 1000, false);
+  CRL::testInteger((long)AB.getRecognitionSet().size(), 0, false);
+
+  std::cout << std::endl;
+
+  AB.deepDestroy();
+  Event::freeAllInstances();
+}
+
+bool testCountOnly_pred(const PropertyManager&)
+{
+  return true;
+}
+
+void testCountOnlyUnsupported()
+{
+  std::cout << "------- Tests of chronicles without count-only mode" << std::endl << std::endl;
+
+  ChronicleSequence& ABC = ($(A) + ($(B) + $(C)));
+  ChronicleSequence& AB = ($(A) + $(B));
+  AB.setPredicateFunction(testCountOnly_pred);
+  ChronicleAbsence& AnotB = ($(A) - $(B));
+  ChronicleDisjunction& ABCorD = (($(A) + ($(B) + $(C))) || $(D));
+
+  Chronicle* chronicles[] = { &ABC, &AB, &AnotB, &ABCorD, NULL };
+  for (int i=0; chronicles[i] != NULL; i++)
+  {
+    bool thrown = false;
+    try
+    {
+      chronicles[i]->setCountOnly(true);
+    }
+    catch (std::string& msg)
+    {
+      std::cout << msg << std::endl;
+      thrown = true;
+    }
+    CRL::testBoolean(thrown, true, false);
+  }
+
+  // The whole tree is left unchanged
+  CRL::testBoolean(ABCorD.isCountOnly(), false, false);
+  CRL::testBoolean(ABCorD.getChild2()->isCountOnly(), false, false);
+
+  std::cout << std::endl;
+
+  ABCorD.deepDestroy();
+  ABC.deepDestroy();
+  AB.deepDestroy();
+  AnotB.deepDestroy();
+}
+
+void testCountOnly()
+{
+  CRL::CRL_ErrReport::START("CRL","CountOnly");
+  std::cout << "##### ------- Tests of the count-only recognition mode" 
+              << std::endl << std::endl;
+  testCountOnlyOperators();
+  testCountOnlyBursts();
+  testCountOnlyUnsupported();
+  Event::freeAllInstances();
+  std::cout << std::endl;
+}
+
+
+#ifdef UNITARY_TEST
+int main() 
+{
+  try
+  {
+    testCountOnly();
+    
+    CRL::CRL_ErrReport::PRINT_ALL();
+
+    return 0;
+  }
+
+  catch(std::string& msg) {                        
+    std::cout << "main : "     
+    << msg << std::endl;
+    return 1;                                      
+  }                                                
+  catch(const char* msg) {                         
+  std::cout << "main : "       
+  << msg << std::endl;
+  return 1;                                        
+  }                                                                                           
+  catch(...) {                                     
+  std::cout << "main : Unknown Exception"
+  << std::endl;
+  return 1;                                        
+  }
+
+}
+#endif
@@ -127,6 +127,30 @@ void testCutSeveral()
   AcutBDE.deepDestroy();
 }
 
+void testCutOrder()
+{
+  std::cout << "------- Tests of the order of the recognitions of chronicle (A ! (B&&C))" << std::endl << std::endl;
+
+  RecognitionEngine engine(&std::cout, RecognitionEngine::VERBOSE);
+  ChronicleCut& AcutBC = ($(A) += ($(B) && $(C)));
+  engine.addChronicle(AcutBC);
+
+  // Two awaiting A, two new (B&&C) at once: each A is joined with both, in turn
+  engine << 0.0 << "A" << "A" << "B" << "B" << "C" << flush;
+  CRL::testInteger((long)AcutBC.getRecognitionSet().size(), 4, false);
+  long expected[4][2] = { {1, 3}, {1, 4}, {2, 3}, {2, 4} };
+  long inOrder = 1, k = 0;
+  Chronicle::RecoSet::const_iterator it;
+  for (it=AcutBC.getRecognitionSet().begin(); it!=AcutBC.getRecognitionSet().end(); it++, k++)
+    if ( ((*it)->getLeftMember()->getMinOrder() != expected[k][0]) ||
+         ((*it)->getRightMember()->getMinOrder() != expected[k][1]) ) inOrder = 0;
+  CRL::testInteger(inOrder, 1, false);
+
+  std::cout << std::endl;
+
+  AcutBC.deepDestroy();
+}
+
 void testCut1()
 {
   std::cout << "------- Tests with chronicle ((A ! B) C)" << std::endl << std::endl;
@@ -217,6 +241,7 @@ void testChronicleCut()
   testCut0();
   testCutFirstToFinish();
   testCutSeveral();
+  testCutOrder();
   testCut1();
   testCut2();
   testCut2bis();
@@ -0,0 +1,135 @@
+/** ***********************************************************************************
+ * \file TestDateTraits.cpp
+ * \author Ariane Piel & Jean Bourrely / Onera DCPS
+ * \date 2014
+ * \brief Unit tests of the date representations
+ **************************************************************************************/
+
+/*  Copyright (C) 2012, 2013, 2014  ONERA  http://www.onera.fr
+    This file is part of CRL : Chronicle Recognition Library.
+
+    CRL is free software: you can redistribute it and/or modify it under
+    the terms of the Lesser GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    CRL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    Lesser GNU General Public License for more details.
+
+    You should have received a copy of the Lesser GNU General Public License
+    along with CRL.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+// ----------------------------------------------------------------------------
+// INCLUDE FILES
+// ----------------------------------------------------------------------------
+
+#include "TestUtils.h"
+#include "Event.h"
+#include "DateTraits.h"
+
+using namespace CRL;
+
+
+// ----------------------------------------------------------------------------
+// UNIT TESTS
+// ----------------------------------------------------------------------------
+
+void testDateTraits_double()
+{
+  std::cout << "------- Tests of the dates counted in seconds" << std::endl << std::endl;
+
+  CRL::testBoolean(DateTraits<double>::exact, false, false);
+  CRL::testDouble(DateTraits<double>::fromSeconds(2.5), 2.5, 0.0, false);
+  CRL::testDouble(DateTraits<double>::toSeconds(2.5), 2.5, 0.0, false);
+  CRL::testDouble(DateTraits<double>::unitsPerSecond(), 1.0, 0.0, false);
+  CRL::testDouble(DateTraits<double>::fromUnits(2.5), 2.5, 0.0, false);
+
+  std::cout << std::endl;
+}
+
+
+void testDateTraits_integer()
+{
+  std::cout << "------- Tests of the dates counted in nanoseconds" << std::endl << std::endl;
+
+  CRL::testBoolean(DateTraits<int64_t>::exact, true, false);
+  CRL::testBoolean(DateTraits<int64_t>::fromSeconds(2.5) == 2500000000LL, true, false);
+  CRL::testBoolean(DateTraits<int64_t>::fromSeconds(-0.000000001) == -1LL, true, false);
+  CRL::testBoolean(DateTraits<int64_t>::fromSeconds(0.1) + DateTraits<int64_t>::fromSeconds(0.2)
+                   == DateTraits<int64_t>::fromSeconds(0.3), true, false);
+  CRL::testDouble(DateTraits<int64_t>::toSeconds(1500000000LL), 1.5, 0.0, false);
+
+  // A fractional number of nanoseconds is rejected, not truncated
+  CRL::testBoolean(DateTraits<int64_t>::fromUnits(3.0) == 3LL, true, false);
+  CRL::testBoolean(DateTraits<int64_t>::representable(2.5), false, false);
+  bool rejected = false;
+  try { DateTraits<int64_t>::fromUnits(2.5); } catch (const char*) { rejected = true; }
+  CRL::testBoolean(rejected, true, false);
+
+  // A date of the current epoch is kept to the nanosecond
+  int64_t epoch = 1700000000123456789LL;
+  CRL::testBoolean(epoch + DateTraits<int64_t>::fromSeconds(1.0) == 1700000001123456789LL, true, false);
+
+  std::cout << std::endl;
+}
+
+
+void testDateTraits_engine()
+{
+  std::cout << "------- Tests of the date representation of the engine" << std::endl << std::endl;
+
+  // The sentinels are kept apart from the dates converted from seconds
+  CRL::testBoolean(DateTraits<DateType>::fromSeconds(1.0e6) < INFTY_DATE, true, false);
+  CRL::testBoolean(DateTraits<DateType>::fromSeconds(-1.0e6) > NO_DATE, true, false);
+  CRL::testDouble(DateTraits<DateType>::toSeconds(DateTraits<DateType>::fromSeconds(3.0)), 3.0, 0.0, false);
+
+  std::cout << std::endl;
+}
+
+
+void testDateTraits()
+{
+  CRL::CRL_ErrReport::START("CRL","DateTraits");
+  std::cout << "##### ------- Tests of the date representations" 
+              << std::endl << std::endl;
+  testDateTraits_double();
+  testDateTraits_integer();
+  testDateTraits_engine();
+  std::cout << std::endl;
+}
+
+
+#ifdef UNITARY_TEST
+int main() 
+{
+  try
+  {
+    testDateTraits();
+    
+    CRL::CRL_ErrReport::PRINT_ALL();
+
+    return 0;
+  }
+
+  catch(std::string& msg) {                        
+    std::cout << "main : "     
+    << msg << std::endl;
+    return 1;                                      
+  }                                                
+  catch(const char* msg) {                         
+  std::cout << "main : "       
+  << msg << std::endl;
+  return 1;                                        
+  }                                                                                           
+  catch(...) {                                     
+  std::cout << "main : Unknown Exception"
+  << std::endl;
+  return 1;                                        
+  }
+
+}
+#endif
@@ -36,6 +36,8 @@ using namespace CRL;
 // UNIT TESTS
 // ----------------------------------------------------------------------------
 
+static DateType seconds(double s) { return DateTraits<DateType>::fromSeconds(s); }
+
 void testDelayAtLeast1()
 {
   std::cout << "------- Tests with chronicles ((B A) > 3) and (B A)" 
@@ -46,20 +48,20 @@ void testDelayAtLeast1()
   // C       B       A       F           A   A       
 
   RecognitionEngine engine(&std::cout, RecognitionEngine::VERBOSE);
-  ChronicleDelayAtLeast& BA3 = ( ( $(B) + $(A) ) > 3.0 );  //(B A) at least 3
-  ChronicleSequence&     BA  = ( $(B) + $(A) );            //(B A)
+  ChronicleDelayAtLeast& BA3 = ( ( $(B) + $(A) ) > seconds(3.0) );  //(B A) at least 3
+  ChronicleSequence&     BA  = ( $(B) + $(A) );                     //(B A)
   engine.addChronicle(&BA3);
   engine.addChronicle(&BA);
 
-  engine << 0.0 << "C" << 1.0 << "B" << 2.0 << "A" << flush;
+  engine << seconds(0.0) << "C" << seconds(1.0) << "B" << seconds(2.0) << "A" << flush;
   CRL::testInteger((long)BA3.getRecognitionSet().size(), 0, false);
   CRL::testInteger((long)BA.getRecognitionSet().size(), 1, false);
 
-  engine << 3.0 << "F" << 4.5 << "A" << flush;
+  engine << seconds(3.0) << "F" << seconds(4.5) << "A" << flush;
   CRL::testInteger((long)BA3.getRecognitionSet().size(), 1, false);
   CRL::testInteger((long)BA.getRecognitionSet().size(), 2, false);
 
-  engine << 5.0 << "A" << flush;
+  engine << seconds(5.0) << "A" << flush;
   CRL::testInteger((long)BA3.getRecognitionSet().size(), 2, false);
   CRL::testInteger((long)BA.getRecognitionSet().size(), 3, false);
 
@@ -84,7 +86,7 @@ void testDelayAtLeastWithPredicate()
 
 
   RecognitionEngine engine(&std::cout, RecognitionEngine::VERBOSE);
-  ChronicleDelayAtLeast& BA3 = ( ( $$($(B),b) + $$($(A),a) ) > 3.0 );  //(B A) at least 3
+  ChronicleDelayAtLeast& BA3 = ( ( $$($(B),b) + $$($(A),a) ) > seconds(3.0) );  //(B A) at least 3
   engine.addChronicle(&BA3);
   BA3.setPredicateFunction(testDelayAtLeastWithPredicate_pred);
 
@@ -95,13 +97,13 @@ void testDelayAtLeastWithPredicate()
   b1["x"] = 0;
   a2["x"] = 1;
 
-  engine << 0.0 << "C" << 1.0 << b1 << 5.0 << a1 << flush;
+  engine << seconds(0.0) << "C" << seconds(1.0) << b1 << seconds(5.0) << a1 << flush;
   CRL::testInteger((long)BA3.getRecognitionSet().size(), 1, false);
 
-  engine << 6.0 << "F" << 7.5 << a2 << flush;
+  engine << seconds(6.0) << "F" << seconds(7.5) << a2 << flush;
   CRL::testInteger((long)BA3.getRecognitionSet().size(), 1, false);
 
-  engine << 10.0 << "A" << flush;
+  engine << seconds(10.0) << "A" << flush;
   CRL::testInteger((long)BA3.getRecognitionSet().size(), 1, false);
 
   std::cout << std::endl;
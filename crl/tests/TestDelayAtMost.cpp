@@ -36,6 +36,8 @@ using namespace CRL;
 // UNIT TESTS
 // ----------------------------------------------------------------------------
 
+static DateType seconds(double s) { return DateTraits<DateType>::fromSeconds(s); }
+
 void testDelayAtMost1()
 {
   std::cout << "------- Tests with chronicles ((B A) < 3) and (B A)" 
@@ -46,24 +48,24 @@ void testDelayAtMost1()
   // C       B       A       F   A           A       B           A
 
   RecognitionEngine engine(&std::cout, RecognitionEngine::VERBOSE);
-  ChronicleDelayAtMost& BA3 = ( ( $(B) + $(A) ) < 3.0 );  //(B A) at most 3
+  ChronicleDelayAtMost& BA3 = ( ( $(B) + $(A) ) < seconds(3.0) );  //(B A) at most 3
   ChronicleSequence&     BA  = ( $(B) + $(A) );           //(B A)
   engine.addChronicle(&BA3);
   engine.addChronicle(&BA);
 
-  engine << 0.0 << "C" << 1.0 << "B" << 2.0 << "A" << flush;
+  engine << seconds(0.0) << "C" << seconds(1.0) << "B" << seconds(2.0) << "A" << flush;
   CRL::testInteger((long)BA3.getRecognitionSet().size(), 1, false);
   CRL::testInteger((long)BA.getRecognitionSet().size(), 1, false);
 
-  engine << 3.0 << "F" << 3.5 << "A" << flush;
+  engine << seconds(3.0) << "F" << seconds(3.5) << "A" << flush;
   CRL::testInteger((long)BA3.getRecognitionSet().size(), 2, false);
   CRL::testInteger((long)BA.getRecognitionSet().size(), 2, false);
 
-  engine << 5.0 << "A" << flush;
+  engine << seconds(5.0) << "A" << flush;
   CRL::testInteger((long)BA3.getRecognitionSet().size(), 2, false);
   CRL::testInteger((long)BA.getRecognitionSet().size(), 3, false);
 
-  engine << 6.0 << "B" << 8.5 << "A" << flush;
+  engine << seconds(6.0) << "B" << seconds(8.5) << "A" << flush;
   CRL::testInteger((long)BA3.getRecognitionSet().size(), 3, false);
   CRL::testInteger((long)BA.getRecognitionSet().size(), 5, false);
 
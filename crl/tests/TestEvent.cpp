@@ -28,10 +28,63 @@
 
 #include "Event.h"
 #include "TestUtils.h"
+#include "Operators.h"
+#include "RecognitionEngine.h"
+#include <thread>
 
 using namespace CRL;
 
 
+  void testEventLifetime()
+  {
+    std::cout << "------- Tests of the lifetime of the events" << std::endl << std::endl;
+
+    long before = (long)Event::getDynamicInstanceCount();
+    RecognitionEngine engine(&std::cout, RecognitionEngine::SILENT);
+    ChronicleSequence& AB = $(A) + $(B);
+    engine.addChronicle(AB);
+
+    // The events of no recognition are deleted once processed
+    for (int i=0; i<1000; i++)
+      engine << (double)i << "C";
+    engine << flush;
+    CRL::testInteger((long)Event::getDynamicInstanceCount() - before, 0L);
+
+    // The events of the recognitions are kept with them
+    engine << 1000.0 << "A" << 1001.0 << "B" << flush;
+    CRL::testInteger((long)AB.getRecognitionSet().size(), 1L);
+    CRL::testInteger((long)Event::getDynamicInstanceCount() - before, 2L);
+    const Event* b = (*AB.getRecognitionSet().begin())->lastEvent();
+    CRL::testString(b->getName().c_str(), "B");
+    CRL::testInteger(b->getRefCount(), 1L);
+
+    // The events of the user are never deleted by the engine
+    Event s("A", 1002.0);
+    Event* u = new Event("A", 1003.0);
+    CRL::testBoolean(s.isDynamic(), false);
+    CRL::testBoolean(u->isDynamic(), true);
+    engine << s << u << flush;
+    CRL::testInteger(u->getRefCount(), 1L);
+
+    AB.deepDestroy();
+    CRL::testInteger((long)Event::getDynamicInstanceCount() - before, 1L);
+    CRL::testInteger(u->getRefCount(), 0L);
+    delete u;
+
+    // The dynamic instances are counted by the thread which allocates them
+    long other = -1;
+    std::thread t([&other]() { delete new Event("A");
+                               Event* e = new Event("B");
+                               other = (long)Event::getDynamicInstanceCount();
+                               delete e; });
+    t.join();
+    CRL::testInteger(other, 1L);
+    CRL::testInteger((long)Event::getDynamicInstanceCount() - before, 0L);
+
+    std::cout << std::endl;
+  }
+
+
   void testEvent()
   {
     CRL::CRL_ErrReport::START("CRL", "Event");
@@ -39,16 +92,21 @@ using namespace CRL;
 
     // Various constructors
     Event   a("A");
-    Event   b("B", 2.5);
+    Event   b("B", DateTraits<DateType>::fromSeconds(2.5));
 
     CRL::testString(a.getName().c_str(), "A");
 
     CRL::testInteger(a.getOrder(), -1L);
 
-    CRL::testDouble((double)b.getDate(), 2.5);
+    CRL::testDouble(DateTraits<DateType>::toSeconds(b.getDate()), 2.5);
+
+    a.setDate(DateTraits<DateType>::fromSeconds(1.5));
+    CRL::testDouble(DateTraits<DateType>::toSeconds(a.getDate()), 1.5);
 
-    a.setDate(1.5);
-    CRL::testDouble((double)a.getDate(), 1.5);
+    // A fractional number of time units is rejected by the exact representations
+    bool rejected = false;
+    try { Event f("F", 0.5); } catch (const char*) { rejected = true; }
+    CRL::testBoolean(rejected, DateTraits<DateType>::exact);
 
     a.setOrder(5L);
     CRL::testInteger(a.getOrder(), 5L);
@@ -57,6 +115,7 @@ using namespace CRL;
     CRL::testString(a.getName().c_str(), "AA");
 
     std::cout << std::endl;
+    testEventLifetime();
     Event::freeAllInstances();
   }
 
@@ -0,0 +1,297 @@
+/** ***********************************************************************************
+ * \file TestEventBatch.cpp
+ * \author Ariane Piel & Jean Bourrely / Onera DCPS
+ * \date 2014
+ * \brief Unit tests of the batches of events
+ **************************************************************************************/
+
+/*  Copyright (C) 2012, 2013, 2014  ONERA  http://www.onera.fr
+    This file is part of CRL : Chronicle Recognition Library.
+
+    CRL is free software: you can redistribute it and/or modify it under
+    the terms of the Lesser GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    CRL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    Lesser GNU General Public License for more details.
+
+    You should have received a copy of the Lesser GNU General Public License
+    along with CRL.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// ----------------------------------------------------------------------------
+// INCLUDE FILES
+// ----------------------------------------------------------------------------
+
+#include <set>
+#include <sstream>
+
+#include "TestUtils.h"
+#include "Operators.h"
+#include "RecognitionEngine.h"
+#include "EventBatch.h"
+
+using namespace CRL;
+
+
+// ----------------------------------------------------------------------------
+// UNIT TESTS
+// ----------------------------------------------------------------------------
+
+bool testEventBatch_pred(const PropertyManager& p)
+{
+  return ( (long)p["x"]["num"] > 5 );
+}
+
+
+//! Returns the dates and orders of the recognitions of \a cr, sorted
+std::string testEventBatch_recognitions(Chronicle& cr)
+{
+  std::set<std::string> recos;
+  Chronicle::RecoSet::const_iterator it;
+  for (it=cr.getRecognitionSet().begin(); it!=cr.getRecognitionSet().end(); it++)
+  {
+    std::ostringstream os;
+    os << (*it)->getMinDate() << "," << (*it)->getMinOrder() << "-" 
+       << (*it)->getMaxDate() << "," << (*it)->getMaxOrder();
+    recos.insert(os.str());
+  }
+  std::string s;
+  std::set<std::string>::iterator itS;
+  for (itS=recos.begin(); itS!=recos.end(); itS++)
+    s += *itS + " ";
+  return s;
+}
+
+
+void testEventBatch_scan()
+{
+  std::cout << "------- Tests of the scan of the name column" << std::endl << std::endl;
+
+  const char* names[] = { "A", "B", "C", "D", "E" };
+  unsigned long seed = 7;
+  EventBatch batch;
+  for (int i=0; i<1003; i++)
+  {
+    seed = seed * 1103515245 + 12345;
+    batch.addEvent(names[(seed >> 16) % 5], (double)i);
+  }
+
+  for (int n=0; n<5; n++)
+  {
+    std::vector<size_t> rows, rowsScalar;
+    batch.findRows(EventBatch::internName(names[n]), rows);
+    batch.findRowsScalar(EventBatch::internName(names[n]), rowsScalar);
+    CRL::testBoolean(rows == rowsScalar, true, false);
+    CRL::testBoolean(rows.size() > 100, true, false);
+  }
+  std::vector<size_t> rows;
+  batch.findRows(EventBatch::internName("unknown name"), rows);
+  CRL::testInteger((long)rows.size(), 0, false);
+
+  // Typed columns
+  batch.setLong(2, "num", 12);
+  batch.setString(1000, "label", "last ones");
+  CRL::testInteger(batch.getColumn("num")->type, Property::L, false);
+  CRL::testBoolean(batch.getColumn("num")->present[1], false, false);
+  CRL::testBoolean(batch.getColumn("missing") == NULL, true, false);
+  bool thrown = false;
+  try { batch.setDouble(3, "num", 1.5); }
+  catch (...) { thrown = true; }
+  CRL::testBoolean(thrown, true, false);
+
+  Event* e = batch.makeEvent(2);
+  CRL::testString(e->getName().c_str(), EventBatch::getName(batch.getNameId(2)).c_str(), false);
+  CRL::testInteger((long)(*e)["num"], 12, false);
+  CRL::testBoolean(e->findProperty("label") == NULL, true, false);
+  delete e;
+
+  thrown = false;
+  try { batch.addEvent("A", 10.0); }
+  catch (...) { thrown = true; }
+  CRL::testBoolean(thrown, true, false);
+
+  std::cout << std::endl;
+}
+
+
+//! Feeds the same events to \a engine through its input buffer and to \a batchEngine through batches
+void testEventBatch_feed(RecognitionEngine& engine, RecognitionEngine& batchEngine)
+{
+  const char* names[] = { "A", "B", "C", "D" };
+  unsigned long seed = 11;
+  EventBatch batch;
+  double date = 0.0;
+  for (int i=0; i<80; i++)
+  {
+    seed = seed * 1103515245 + 12345;
+    const char* name = names[(seed >> 16) % 4];
+    long num = (seed >> 8) % 10;
+    date += (double)((seed >> 4) % 3);
+
+    Event* e = new Event(name, date);
+    (*e)["num"] = num;
+    engine.addEvent(e, true);
+
+    size_t row = batch.addEvent(name, date);
+    batch.setLong(row, "num", num);
+    if (i == 39)
+    {
+      batchEngine.processBatch(batch);
+      batch.clear();
+    }
+  }
+  engine << flush;
+  batchEngine.processBatch(batch);
+  batchEngine << flush;
+  CRL::testInteger(batch.getOrder(batch.size()-1), batchEngine.getCurrentOrder()-1, false);
+}
+
+
+void testEventBatch_engine()
+{
+  std::cout << "------- Tests of the processing of batches of events" << std::endl << std::endl;
+
+  RecognitionEngine engine(&std::cout, RecognitionEngine::SILENT);
+  RecognitionEngine batchEngine(&std::cout, RecognitionEngine::SILENT);
+  Chronicle* chronicles[2][3];
+  for (int k=0; k<2; k++)
+  {
+    RecognitionEngine& eng = (k == 0) ? engine : batchEngine;
+    ChronicleSequence& AxB = ($$($(A),x) + $(B));
+    AxB.setPredicateFunction(testEventBatch_pred);
+    chronicles[k][0] = &AxB;
+    chronicles[k][1] = &(($(A) + $(B)) + 2.0);
+    chronicles[k][2] = &(($(A) + $(C)) - $(D));
+    for (int i=0; i<3; i++)
+      eng.addChronicle(chronicles[k][i]);
+  }
+
+  testEventBatch_feed(engine, batchEngine);
+  CRL::testInteger(batchEngine.getCurrentOrder(), engine.getCurrentOrder(), false);
+  for (int i=0; i<3; i++)
+  {
+    CRL::testBoolean(chronicles[0][i]->getRecognitionSet().size() > 0, true, false);
+    CRL::testString(testEventBatch_recognitions(*chronicles[1][i]).c_str(),
+                    testEventBatch_recognitions(*chronicles[0][i]).c_str(), false);
+  }
+
+  std::cout << std::endl;
+
+  for (int k=0; k<2; k++)
+    for (int i=0; i<3; i++)
+      chronicles[k][i]->deepDestroy();
+}
+
+
+void testEventBatch_skip()
+{
+  std::cout << "------- Tests of the processing of batches of events, rows of C and D skipped" 
+            << std::endl << std::endl;
+
+  RecognitionEngine engine(&std::cout, RecognitionEngine::SILENT);
+  RecognitionEngine batchEngine(&std::cout, RecognitionEngine::SILENT);
+  Chronicle* chronicles[2][3];
+  for (int k=0; k<2; k++)
+  {
+    RecognitionEngine& eng = (k == 0) ? engine : batchEngine;
+    ChronicleSequence& AxB = ($$($(A),x) + $(B));
+    AxB.setPredicateFunction(testEventBatch_pred);
+    ChronicleSequence& contiguousAB = ($(A) + $(B));
+    contiguousAB.setSelectionPolicy(ChronicleBinaryOp::STRICT_CONTIGUITY);
+    chronicles[k][0] = &AxB;
+    chronicles[k][1] = &contiguousAB;
+    chronicles[k][2] = &($(A) && $(B));
+    for (int i=0; i<3; i++)
+      eng.addChronicle(chronicles[k][i]);
+  }
+
+  // The orders of the skipped rows still separate the events A and B
+  testEventBatch_feed(engine, batchEngine);
+  CRL::testInteger(batchEngine.getCurrentOrder(), engine.getCurrentOrder(), false);
+  for (int i=0; i<3; i++)
+  {
+    CRL::testBoolean(chronicles[0][i]->getRecognitionSet().size() > 0, true, false);
+    CRL::testString(testEventBatch_recognitions(*chronicles[1][i]).c_str(),
+                    testEventBatch_recognitions(*chronicles[0][i]).c_str(), false);
+  }
+
+  std::cout << std::endl;
+
+  for (int k=0; k<2; k++)
+    for (int i=0; i<3; i++)
+      chronicles[k][i]->deepDestroy();
+}
+
+
+void testEventBatch_at()
+{
+  std::cout << "------- Tests of the processing of batches of events with @(A B) D" 
+            << std::endl << std::endl;
+
+  RecognitionEngine engine(&std::cout, RecognitionEngine::SILENT);
+  RecognitionEngine batchEngine(&std::cout, RecognitionEngine::SILENT);
+  ChronicleSequence& atABD = (AT($(A) + $(B)) + $(D));
+  ChronicleSequence& atABDbis = (AT($(A) + $(B)) + $(D));
+  engine.addChronicle(atABD);
+  batchEngine.addChronicle(atABDbis);
+
+  testEventBatch_feed(engine, batchEngine);
+  CRL::testBoolean(atABD.getRecognitionSet().size() > 0, true, false);
+  CRL::testString(testEventBatch_recognitions(atABDbis).c_str(),
+                  testEventBatch_recognitions(atABD).c_str(), false);
+
+  std::cout << std::endl;
+
+  atABD.deepDestroy();
+  atABDbis.deepDestroy();
+}
+
+
+void testEventBatch()
+{
+  CRL::CRL_ErrReport::START("CRL","EventBatch");
+  std::cout << "##### ------- Tests of the columnar event batches" 
+              << std::endl << std::endl;
+  testEventBatch_scan();
+  testEventBatch_engine();
+  testEventBatch_skip();
+  testEventBatch_at();
+  Event::freeAllInstances();
+  std::cout << std::endl;
+}
+
+
+#ifdef UNITARY_TEST
+int main() 
+{
+  try
+  {
+    testEventBatch();
+    
+    CRL::CRL_ErrReport::PRINT_ALL();
+
+    return 0;
+  }
+
+  catch(std::string& msg) {                        
+    std::cout << "main : "     
+    << msg << std::endl;
+    return 1;                                      
+  }                                                
+  catch(const char* msg) {                         
+  std::cout << "main : "       
+  << msg << std::endl;
+  return 1;                                        
+  }                                                                                           
+  catch(...) {                                     
+  std::cout << "main : Unknown Exception"
+  << std::endl;
+  return 1;                                        
+  }
+
+}
+#endif
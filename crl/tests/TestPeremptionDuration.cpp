@@ -37,6 +37,8 @@ using namespace CRL;
 // UNIT TESTS
 // ----------------------------------------------------------------------------
 
+static DateType seconds(double s) { return DateTraits<DateType>::fromSeconds(s); }
+
 void testPeremptionDurationSequenceSimple()
 {
   std::cout << "------- Tests with chronicle (A A) with window of 4.0" << std::endl << std::endl;
@@ -398,6 +400,145 @@ void testPartlyPeremptionDuration()
   AB.deepDestroy();
 }
 
+void testLatePeremptionDuration()
+{
+  std::cout << "------- Tests with chronicle (A A), window set after the first recognitions, then removed" << std::endl << std::endl;
+
+  RecognitionEngine engine(&std::cout, RecognitionEngine::VERBOSE);
+  engine.setPurgeOldRecognitions(true);
+
+  ChronicleSequence& AA = ($(A) + $(A));
+  engine.addChronicle(AA);
+
+  engine << seconds(0.0) << "A" << seconds(1.0) << "A" << seconds(2.0) << "A" << flush;
+  CRL::testInteger((long)AA.getRecognitionSet().size(), 3, false);
+
+  AA.setPeremptionDuration(seconds(1.5), true);
+  engine << seconds(3.0) << flush;
+  CRL::testInteger((long)AA.getRecognitionSet().size(), 2, false);
+  CRL::testInteger((long)AA.getOpLeft()->getRecognitionSet().size(), 1, false);
+
+  engine << seconds(4.0) << "A" << flush;
+  CRL::testInteger((long)AA.getRecognitionSet().size(), 0, false);
+
+  AA.setPeremptionDuration(-1.0, true);
+  engine << seconds(10.0) << "A" << flush;
+  CRL::testInteger((long)AA.getRecognitionSet().size(), 1, false);
+
+  std::cout << std::endl;
+
+  AA.deepDestroy();
+}
+
+RecoTree* testPeremptionReleasesRecognitions_kept = NULL;
+
+void testPeremptionReleasesRecognitions_action(RecoTree& r)
+{
+  r.addRef();
+  testPeremptionReleasesRecognitions_kept = &r;
+}
+
+void testPeremptionReleasesRecognitions()
+{
+  std::cout << "------- Tests with chronicle (A B) with window of 4.0, recognitions released by the peremption" << std::endl << std::endl;
+
+  RecognitionEngine engine(&std::cout, RecognitionEngine::VERBOSE);
+  engine.setPurgeOldRecognitions(true);
+
+  ChronicleSequence& AB = ($(A) + $(B));
+  engine.addChronicle(AB);
+  AB.setPeremptionDuration(4.0, true);
+  AB.setActionFunction(testPeremptionReleasesRecognitions_action);
+
+  engine << 0.0 << "A" << 1.0 << "B" << flush;
+  RecoTree* kept = testPeremptionReleasesRecognitions_kept;
+  CRL::testInteger((long)(kept != NULL), 1, false);
+  CRL::testInteger(kept->getRefCount(), 2, false);                  // AB set and test
+  CRL::testInteger(kept->getLeftMember()->getRefCount(), 2, false); // A set and AB tree
+
+  engine << 6.0 << flush;
+  CRL::testInteger((long)AB.getRecognitionSet().size(), 0, false);
+  CRL::testInteger((long)AB.getOpLeft()->getRecognitionSet().size(), 0, false);
+  CRL::testInteger(kept->getRefCount(), 1, false);
+  CRL::testInteger(kept->getLeftMember()->getRefCount(), 1, false);
+  kept->release(); // Deletes the whole tree
+
+  std::cout << std::endl;
+
+  AB.deepDestroy();
+}
+
+void testRepeatedRecognitionPeremption()
+{
+  std::cout << "------- Tests with chronicle A with window of 1.0, recognition saved twice" << std::endl << std::endl;
+
+  RecognitionEngine engine(&std::cout, RecognitionEngine::VERBOSE);
+  engine.setPurgeOldRecognitions(true);
+
+  ChronicleSingleEvent& A = $(A);
+  engine.addChronicle(A);
+  A.setPeremptionDuration(1.0, false);
+
+  engine << 0.0 << "A" << flush;
+  CRL::testInteger((long)A.getRecognitionSet().size(), 1, false);
+
+  // A recognition already in the set is not queued twice for the peremption
+  RecoTree* kept = *A.getRecognitionSet().begin();
+  kept->addRef();
+  A.applyActionFunction(*kept);
+  A.purgeNewRecognitions(false);
+  CRL::testInteger((long)A.getRecognitionSet().size(), 1, false);
+  CRL::testInteger(kept->getRefCount(), 2, false); // A set and test
+
+  engine << 5.0 << flush;
+  CRL::testInteger((long)A.getRecognitionSet().size(), 0, false);
+  CRL::testInteger(kept->getRefCount(), 1, false);
+  kept->release();
+
+  std::cout << std::endl;
+
+  A.deepDestroy();
+}
+
+void testRetentionHorizons()
+{
+  std::cout << "------- Tests with chronicles ((A B) < 3) and ((C && D) + 5), inferred retention horizons" << std::endl << std::endl;
+
+  RecognitionEngine engine(&std::cout, RecognitionEngine::VERBOSE);
+
+  ChronicleSequence& AB = ($(A) + $(B));
+  ChronicleDelayAtMost& AB3 = (AB < seconds(3.0));
+  ChronicleConjunction& CD = ($(C) && $(D));
+  ChronicleDelayThen& CD5 = (CD + seconds(5.0));
+  engine.addChronicle(AB3);
+  engine.addChronicle(CD5);
+
+  CRL::testDouble(AB3.getRetentionHorizon(), -1.0, false);
+  CRL::testDouble(DateTraits<DateType>::toSeconds(AB.getRetentionHorizon()), 0.0, false);
+  CRL::testDouble(DateTraits<DateType>::toSeconds(AB.getOpLeft()->getRetentionHorizon()), 3.0, false);
+  CRL::testDouble(DateTraits<DateType>::toSeconds(AB.getOpRight()->getRetentionHorizon()), 0.0, false);
+  CRL::testDouble(CD5.getRetentionHorizon(), -1.0, false);
+  CRL::testDouble(DateTraits<DateType>::toSeconds(CD.getRetentionHorizon()), 5.0, false);
+  CRL::testDouble(CD.getOpLeft()->getRetentionHorizon(), -1.0, false);
+
+  engine.activateAutoForget();
+  engine << seconds(0.0) << "A" << seconds(1.0) << "A" << seconds(5.0) << "A" << seconds(6.0) << "C" << seconds(7.0) << "D" << flush;
+  CRL::testInteger((long)AB.getOpLeft()->getRecognitionSet().size(), 1, false);
+  CRL::testInteger((long)CD.getOpLeft()->getRecognitionSet().size(), 1, false);
+
+  engine << seconds(7.5) << "B" << flush;
+  CRL::testInteger((long)AB3.getRecognitionSet().size(), 1, false);
+
+  // The delayed recognition is still produced
+  engine << seconds(12.0) << "E" << flush;
+  CRL::testInteger((long)CD5.getRecognitionSet().size(), 1, false);
+
+  std::cout << std::endl;
+
+  AB3.deepDestroy();
+  CD5.deepDestroy();
+}
+
 void testPeremptionDuration()
 {
   CRL::CRL_ErrReport::START("CRL","PeremptionDuration");
@@ -413,6 +554,10 @@ void testPeremptionDuration()
   testPeremptionDurationDelayThenInf();
   testPeremptionDurationDelayThenSup();
   testPartlyPeremptionDuration();
+  testLatePeremptionDuration();
+  testPeremptionReleasesRecognitions();
+  testRepeatedRecognitionPeremption();
+  testRetentionHorizons();
   Event::freeAllInstances();
   std::cout << std::endl;
 }
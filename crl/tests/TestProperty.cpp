@@ -107,6 +107,37 @@ void testProperty()
   try{ std::cout << (int)m1["a"]["??"] << std::endl; } catch(...) { count++; }
   try{ std::cout << (bool)m1["a"]["b"] << std::endl; } catch(...) { count++; }
   CRL::testInteger(count, 2);
+
+  // 4) Out of line storage, sorted by name whatever the order of insertion
+  CRL::testInteger((long)sizeof(PropertyManager), (long)sizeof(void*));
+  CRL::PropertyManager m2;
+  CRL::testInteger(m2.countProperties(), 0);
+  CRL::testBoolean(m2.findProperty("z") == NULL, true);
+  const char* names[] = { "m", "c", "x", "a", "q", "b", "z", "k" };
+  for (int i=0; i<8; i++)
+    m2[names[i]] = i;
+  CRL::testInteger(m2.countProperties(), 8);
+  for (int i=0; i<8; i++)
+    CRL::testBoolean((int)m2[names[i]] == i, true);
+  Property shared;
+  shared = 99;
+  m2.insertProperty("a", &shared, false);   // already present: ignored
+  m2.insertProperty("s", &shared, false);
+  CRL::testBoolean((int)m2["a"] == 3, true);
+  CRL::testBoolean(m2.findProperty("s") == &shared, true);
+
+  // 5) Copies: owned properties are copied, the others shared
+  m2["b"]["c"] = 7;
+  CRL::PropertyManager m3(m2);
+  CRL::testInteger(m3.countProperties(), 9);
+  CRL::testBoolean(m3.findProperty("s") == &shared, true);
+  CRL::testBoolean(m3.findProperty("b") != m2.findProperty("b"), true);
+  CRL::testBoolean((int)m3["b"]["c"] == 7, true);
+  m2["b"]["c"] = 8;
+  CRL::testBoolean((int)m3["b"]["c"] == 7, true);
+  m3 = m1;
+  CRL::testInteger(m3.countProperties(), m1.countProperties());
+  CRL::testBoolean((int)m3["a"]["b"]["c"] == 30, true);
   
   Event::freeAllInstances();
   std::cout << std::endl;
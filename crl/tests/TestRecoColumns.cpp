@@ -0,0 +1,240 @@
+/** ***********************************************************************************
+ * \file TestRecoColumns.cpp
+ * \author Ariane Piel & Jean Bourrely / Onera DCPS
+ * \date 2014
+ * \brief Unit tests of the columns of the recognition sets
+ **************************************************************************************/
+
+/*  Copyright (C) 2012, 2013, 2014  ONERA  http://www.onera.fr
+    This file is part of CRL : Chronicle Recognition Library.
+
+    CRL is free software: you can redistribute it and/or modify it under
+    the terms of the Lesser GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    CRL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    Lesser GNU General Public License for more details.
+
+    You should have received a copy of the Lesser GNU General Public License
+    along with CRL.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// ----------------------------------------------------------------------------
+// INCLUDE FILES
+// ----------------------------------------------------------------------------
+
+#include <vector>
+
+#include "TestUtils.h"
+#include "Operators.h"
+#include "RecognitionEngine.h"
+#include "RecoTreeSingle.h"
+#include "RecoColumns.h"
+
+using namespace CRL;
+
+
+// ----------------------------------------------------------------------------
+// UNIT TESTS
+// ----------------------------------------------------------------------------
+
+static DateType seconds(double s) { return DateTraits<DateType>::fromSeconds(s); }
+
+//! Compares RecoColumns::select with RecoColumns::selectScalar and with the recognitions themselves
+void testRecoColumns_check(const RecoColumns& columns, int64_t minLow, int64_t minHigh,
+                           int64_t maxLow, int64_t maxHigh)
+{
+  std::vector<size_t> rows, rowsScalar;
+  columns.select(minLow, minHigh, maxLow, maxHigh, rows);
+  columns.selectScalar(minLow, minHigh, maxLow, maxHigh, rowsScalar);
+  CRL::testBoolean(rows == rowsScalar, true, false);
+  for (size_t i=0; i<rows.size(); i++)
+  {
+    const RecoTree* rc = columns.getTree(rows[i]);
+    CRL::testBoolean( (rc->getMinOrder() > minLow) && (rc->getMinOrder() < minHigh) &&
+                      (rc->getMaxOrder() > maxLow) && (rc->getMaxOrder() < maxHigh), true, false);
+  }
+}
+
+
+//! Erases a recognition from a set and from its columns
+void testRecoColumns_erase(RecoSet& set, RecoColumns& columns, RecoTree* rc)
+{
+  RecoSet::iterator it = set.find(rc);
+  if (it == set.end()) return;
+  columns.erase(it.getPosition());
+  set.erase(rc);
+}
+
+
+void testRecoColumns_kernels()
+{
+  std::cout << "------- Tests of the filters of the orders (AVX2: " 
+            << (RecoColumns::hasAVX2() ? "yes" : "no") << ")" << std::endl << std::endl;
+
+  std::vector<RecoTree*> trees;
+  RecoSet set;
+  RecoColumns columns;
+  unsigned long seed = 3;
+  for (int i=0; i<203; i++)
+  {
+    seed = seed * 1103515245 + 12345;
+    RecoTree* rc = new RecoTreeSingle();
+    rc->setMinOrder((seed >> 8) % 100);
+    rc->setMaxOrder(rc->getMinOrder() + (long)((seed >> 16) % 20));
+    rc->setMinDate((double)rc->getMinOrder());
+    rc->setMaxDate((double)rc->getMaxOrder());
+    trees.push_back(rc);
+    columns.insert(set.insert(rc).first.getPosition(), rc);
+  }
+  CRL::testBoolean(set.insert(trees[0]).second, false, false);
+  bool thrown = false;
+  try { columns.insert(0, trees[0]); } catch (...) { thrown = true; }
+  CRL::testBoolean(thrown, true, false);
+  CRL::testInteger((long)columns.size(), 203, false);
+
+  // Sequence, overlaps and during bounds
+  testRecoColumns_check(columns, RecoColumns::NO_LOWER_BOUND, RecoColumns::NO_UPPER_BOUND,
+                        RecoColumns::NO_LOWER_BOUND, 50);
+  testRecoColumns_check(columns, RecoColumns::NO_LOWER_BOUND, 40, 40, 55);
+  testRecoColumns_check(columns, 30, RecoColumns::NO_UPPER_BOUND, RecoColumns::NO_LOWER_BOUND, 60);
+  testRecoColumns_check(columns, 200, RecoColumns::NO_UPPER_BOUND, 
+                        RecoColumns::NO_LOWER_BOUND, RecoColumns::NO_UPPER_BOUND);
+
+  std::vector<size_t> rows;
+  columns.select(RecoColumns::NO_LOWER_BOUND, RecoColumns::NO_UPPER_BOUND, 
+                 RecoColumns::NO_LOWER_BOUND, RecoColumns::NO_UPPER_BOUND, rows);
+  CRL::testInteger((long)rows.size(), 203, false);
+
+  // Erasures : the rows are emptied, the recognitions stay in the order of insertion
+  for (size_t i=0; i<trees.size(); i+=3)
+    testRecoColumns_erase(set, columns, trees[i]);
+  testRecoColumns_erase(set, columns, trees[0]);
+  CRL::testInteger((long)columns.size(), 135, false);
+  CRL::testInteger((long)columns.getTombstoneCount(), 68, false);
+  testRecoColumns_check(columns, RecoColumns::NO_LOWER_BOUND, 40, 40, 55);
+  testRecoColumns_check(columns, RecoColumns::NO_LOWER_BOUND, RecoColumns::NO_UPPER_BOUND,
+                        RecoColumns::NO_LOWER_BOUND, RecoColumns::NO_UPPER_BOUND);
+  rows.clear();
+  columns.select(RecoColumns::NO_LOWER_BOUND, RecoColumns::NO_UPPER_BOUND, 
+                 RecoColumns::NO_LOWER_BOUND, RecoColumns::NO_UPPER_BOUND, rows);
+  CRL::testInteger((long)rows.size(), 135, false);
+  long inOrder = 1;
+  for (size_t i=0, k=0; i<trees.size(); i++)
+    if ( (i % 3) != 0 )
+      if ( (k >= rows.size()) || (columns.getTree(rows[k++]) != trees[i]) ) inOrder = 0;
+  CRL::testInteger(inOrder, 1, false);
+
+  // Compaction, with the set, once the empty rows outnumber the recognitions
+  CRL::testBoolean(set.compact(), false, false);
+  CRL::testInteger((long)columns.getTombstoneCount(), 68, false);
+  for (size_t i=1; i<trees.size(); i+=3)
+    testRecoColumns_erase(set, columns, trees[i]);
+  CRL::testBoolean(set.compact(), true, false);
+  columns.compact();
+  CRL::testInteger((long)columns.getTombstoneCount(), 0, false);
+  CRL::testInteger((long)columns.size(), 67, false);
+  long samePositions = 1;
+  for (RecoSet::iterator it=set.begin(); it!=set.end(); it++)
+    if (columns.getTree(it.getPosition()) != *it) samePositions = 0;
+  CRL::testInteger(samePositions, 1, false);
+  for (size_t i=0, k=0; i<trees.size(); i++)
+    if ( (i % 3) == 2 )
+    {
+      CRL::testBoolean(columns.getTree(k) == trees[i], true, false);
+      CRL::testInteger(columns.getMinOrder(k), trees[i]->getMinOrder(), false);
+      CRL::testInteger(columns.getMaxOrder(k), trees[i]->getMaxOrder(), false);
+      k++;
+    }
+  testRecoColumns_check(columns, RecoColumns::NO_LOWER_BOUND, 40, 40, 55);
+
+  set.clear();
+  columns.clear();
+  rows.clear();
+  columns.select(RecoColumns::NO_LOWER_BOUND, RecoColumns::NO_UPPER_BOUND, 
+                 RecoColumns::NO_LOWER_BOUND, RecoColumns::NO_UPPER_BOUND, rows);
+  CRL::testInteger((long)rows.size(), 0, false);
+
+  for (size_t i=0; i<trees.size(); i++)
+    trees[i]->release();
+
+  std::cout << std::endl;
+}
+
+
+void testRecoColumns_chronicle()
+{
+  std::cout << "------- Tests of the columns of the recognition set of A B in (A B) C" 
+            << std::endl << std::endl;
+
+  RecognitionEngine engine(&std::cout, RecognitionEngine::SILENT);
+  ChronicleSequence& AB = ($(A) + $(B));
+  ChronicleSequence& ABC = (AB + $(C));
+  engine.addChronicle(ABC);
+  engine.activateForget(seconds(3.0));
+
+  engine << seconds(1.0) << "A" << seconds(2.0) << "B" << "B" << seconds(3.0) << "C" << flush;
+  CRL::testInteger((long)AB.getColumns().size(), (long)AB.getRecognitionSet().size(), false);
+  CRL::testInteger((long)ABC.getRecognitionSet().size(), 2, false);
+
+  // The recognitions purged leave the columns
+  engine << seconds(8.0) << "A" << seconds(9.0) << "B" << flush;
+  CRL::testInteger((long)AB.getRecognitionSet().size(), 1, false);
+  CRL::testInteger((long)AB.getColumns().size(), 1, false);
+  CRL::testInteger(AB.getColumns().getTree(0)->getMinOrder(), 
+                   (*AB.getRecognitionSet().begin())->getMinOrder(), false);
+
+  engine << seconds(9.5) << "C" << flush;
+  CRL::testInteger((long)ABC.getRecognitionSet().size(), 1, false);
+
+  std::cout << std::endl;
+
+  ABC.deepDestroy();
+}
+
+
+void testRecoColumns()
+{
+  CRL::CRL_ErrReport::START("CRL","RecoColumns");
+  std::cout << "##### ------- Tests of the order columns" 
+              << std::endl << std::endl;
+  testRecoColumns_kernels();
+  testRecoColumns_chronicle();
+  Event::freeAllInstances();
+  std::cout << std::endl;
+}
+
+
+#ifdef UNITARY_TEST
+int main() 
+{
+  try
+  {
+    testRecoColumns();
+    
+    CRL::CRL_ErrReport::PRINT_ALL();
+
+    return 0;
+  }
+
+  catch(std::string& msg) {                        
+    std::cout << "main : "     
+    << msg << std::endl;
+    return 1;                                      
+  }                                                
+  catch(const char* msg) {                         
+  std::cout << "main : "       
+  << msg << std::endl;
+  return 1;                                        
+  }                                                                                           
+  catch(...) {                                     
+  std::cout << "main : Unknown Exception"
+  << std::endl;
+  return 1;                                        
+  }
+
+}
+#endif
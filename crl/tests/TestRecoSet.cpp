@@ -0,0 +1,215 @@
+/** ***********************************************************************************
+ * \file TestRecoSet.cpp
+ * \author Ariane Piel & Jean Bourrely / Onera DCPS
+ * \date 2014
+ * \brief Unitary tests of the insertion-ordered recognition set
+ **************************************************************************************/
+
+/*  Copyright (C) 2012, 2013, 2014  ONERA  http://www.onera.fr
+    This file is part of CRL : Chronicle Recognition Library.
+
+    CRL is free software: you can redistribute it and/or modify it under
+    the terms of the Lesser GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    CRL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    Lesser GNU General Public License for more details.
+
+    You should have received a copy of the Lesser GNU General Public License
+    along with CRL.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// ----------------------------------------------------------------------------
+// INCLUDE FILES
+// ----------------------------------------------------------------------------
+
+#include <vector>
+
+#include "TestUtils.h"
+#include "Operators.h"
+#include "RecognitionEngine.h"
+#include "RecoTreeSingle.h"
+
+using namespace CRL;
+
+
+// ----------------------------------------------------------------------------
+// UNIT TESTS
+// ----------------------------------------------------------------------------
+
+//! Returns 1 if the set holds the trees of \a trees marked in \a kept, in this order
+long testRecoSet_sameOrder(const RecoSet& s, const std::vector<RecoTree*>& trees, 
+                           const std::vector<bool>& kept)
+{
+  RecoSet::const_iterator it = s.begin();
+  for (size_t i=0; i<trees.size(); i++)
+    if (kept[i])
+    {
+      if ( (it == s.end()) || (*it != trees[i]) ) return 0;
+      ++it;
+    }
+  return (it == s.end()) ? 1 : 0;
+}
+
+void testRecoSetContainer()
+{
+  std::cout << "------- Tests of the insertion-ordered recognition set" << std::endl << std::endl;
+
+  std::vector<RecoTree*> trees;
+  std::vector<bool> kept;
+  for (int i=0; i<1000; i++)
+  {
+    trees.push_back(new RecoTreeSingle);
+    kept.push_back(true);
+  }
+
+  // Insertions in the first chunk, then beyond (hash table), duplicates refused
+  RecoSet s;
+  CRL::testInteger((long)s.empty(), 1, false);
+  for (size_t i=0; i<trees.size(); i++)
+    CRL::testInteger((long)s.insert(trees[i]).second, 1, false);
+  CRL::testInteger((long)s.insert(trees[3]).second, 0, false);
+  CRL::testInteger((long)s.insert(trees[500]).second, 0, false);
+  CRL::testInteger((long)(*s.insert(trees[500]).first == trees[500]), 1, false);
+  CRL::testInteger((long)s.size(), 1000, false);
+  CRL::testInteger(testRecoSet_sameOrder(s, trees, kept), 1, false);
+
+  // Erasures leave tombstones, skipped by the iterations
+  for (size_t i=0; i<trees.size(); i+=3)
+  {
+    CRL::testInteger((long)s.erase(trees[i]), 1, false);
+    kept[i] = false;
+  }
+  CRL::testInteger((long)s.erase(trees[0]), 0, false);
+  CRL::testInteger((long)s.count(trees[0]), 0, false);
+  CRL::testInteger((long)s.count(trees[1]), 1, false);
+  CRL::testInteger((long)(s.find(trees[0]) == s.end()), 1, false);
+  CRL::testInteger((long)(*s.find(trees[998]) == trees[998]), 1, false);
+  CRL::testInteger((long)s.size(), 666, false);
+  CRL::testInteger((long)s.getTombstoneCount(), 334, false);
+  CRL::testInteger(testRecoSet_sameOrder(s, trees, kept), 1, false);
+
+  // Erasure during an iteration (the iterators stay valid)
+  RecoSet::iterator it = s.begin();
+  while (it != s.end())
+  {
+    if ((*it) == trees[1] || (*it) == trees[2])
+      it = s.erase(it);
+    else
+      ++it;
+  }
+  kept[1] = kept[2] = false;
+  CRL::testInteger(testRecoSet_sameOrder(s, trees, kept), 1, false);
+
+  // Insertion after erasures, at the end
+  CRL::testInteger((long)s.insert(trees[0]).second, 1, false);
+  CRL::testInteger((long)(*s.find(trees[998]) == trees[998]), 1, false);
+  RecoSet::const_iterator itLast = s.find(trees[998]);
+  CRL::testInteger((long)(*(++itLast) == trees[0]), 1, false);
+
+  // Compaction keeps the order (not done while the recognitions outnumber the tombstones)
+  s.compact();
+  CRL::testInteger((long)s.getTombstoneCount(), 336, false);
+  for (size_t i=3; i<trees.size(); i++)
+    if (kept[i] && (i < 900))
+    {
+      s.erase(trees[i]);
+      kept[i] = false;
+    }
+  s.erase(trees[0]);
+  s.compact();
+  CRL::testInteger((long)s.getTombstoneCount(), 0, false);
+  CRL::testInteger((long)s.size(), 66, false);
+  CRL::testInteger(testRecoSet_sameOrder(s, trees, kept), 1, false);
+  CRL::testInteger((long)s.count(trees[998]), 1, false);
+  CRL::testInteger((long)s.count(trees[899]), 0, false);
+
+  // Copy, then clear
+  RecoSet copy(s);
+  CRL::testInteger((long)copy.size(), 66, false);
+  CRL::testInteger(testRecoSet_sameOrder(copy, trees, kept), 1, false);
+  s.clear();
+  CRL::testInteger((long)s.empty(), 1, false);
+  CRL::testInteger((long)(s.begin() == s.end()), 1, false);
+  CRL::testInteger((long)s.insert(trees[5]).second, 1, false);
+  CRL::testInteger((long)(*s.begin() == trees[5]), 1, false);
+
+  for (size_t i=0; i<trees.size(); i++)
+    trees[i]->release();
+
+  std::cout << std::endl;
+}
+
+void testRecoSetChronicle()
+{
+  std::cout << "------- Tests with chronicle (A B), recognitions in the order of insertion" 
+            << std::endl << std::endl;
+
+  RecognitionEngine engine(&std::cout, RecognitionEngine::VERBOSE);
+
+  ChronicleSequence& AB = ($(A) + $(B));
+  engine.addChronicle(AB);
+
+  engine << 0.0 << "A" << 1.0 << "A" << 2.0 << "B" << 3.0 << "A" << 4.0 << "B" << flush;
+  CRL::testInteger((long)AB.getRecognitionSet().size(), 5, false);
+
+  // Sorted by the date of B, then in the order of the As
+  double expected[5][2] = { {0.0, 2.0}, {1.0, 2.0}, {0.0, 4.0}, {1.0, 4.0}, {3.0, 4.0} };
+  Chronicle::RecoSet::const_iterator it;
+  int i = 0;
+  for (it=AB.getRecognitionSet().begin(); it!=AB.getRecognitionSet().end(); it++, i++)
+  {
+    CRL::testDouble((*it)->getMinDate(), expected[i][0], false);
+    CRL::testDouble((*it)->getMaxDate(), expected[i][1], false);
+  }
+
+  std::cout << std::endl;
+
+  AB.deepDestroy();
+}
+
+void testRecoSet()
+{
+  CRL::CRL_ErrReport::START("CRL","RecoSet");
+  std::cout << "##### ------- Tests of the recognition sets" 
+              << std::endl << std::endl;
+  testRecoSetContainer();
+  testRecoSetChronicle();
+  Event::freeAllInstances();
+  std::cout << std::endl;
+}
+
+
+#ifdef UNITARY_TEST
+int main() 
+{
+  try
+  {
+    testRecoSet();
+    
+    CRL::CRL_ErrReport::PRINT_ALL();
+
+    return 0;
+  }
+
+  catch(std::string& msg) {                        
+    std::cout << "main : "     
+    << msg << std::endl;
+    return 1;                                      
+  }                                                
+  catch(const char* msg) {                         
+  std::cout << "main : "       
+  << msg << std::endl;
+  return 1;                                        
+  }                                                                                           
+  catch(...) {                                     
+  std::cout << "main : Unknown Exception"
+  << std::endl;
+  return 1;                                        
+  }
+
+}
+#endif
@@ -0,0 +1,226 @@
+/** ***********************************************************************************
+ * \file TestRecoTreeArena.cpp
+ * \author Ariane Piel & Jean Bourrely / Onera DCPS
+ * \date 2014
+ * \brief Unitary tests of the arena of the recognition trees
+ **************************************************************************************/
+
+/*  Copyright (C) 2012, 2013, 2014  ONERA  http://www.onera.fr
+    This file is part of CRL : Chronicle Recognition Library.
+
+    CRL is free software: you can redistribute it and/or modify it under
+    the terms of the Lesser GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    CRL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    Lesser GNU General Public License for more details.
+
+    You should have received a copy of the Lesser GNU General Public License
+    along with CRL.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// ----------------------------------------------------------------------------
+// INCLUDE FILES
+// ----------------------------------------------------------------------------
+
+#include <type_traits>
+
+#include "TestUtils.h"
+#include "Operators.h"
+#include "RecognitionEngine.h"
+#include "RecoTreeSingle.h"
+#include "RecoTreeCouple.h"
+
+using namespace CRL;
+
+
+// ----------------------------------------------------------------------------
+// UNIT TESTS
+// ----------------------------------------------------------------------------
+
+bool testRecoTreeArena_pred(const PropertyManager& p)
+{
+  return ( (long)p["x"]["CRL ID"] == (long)p["y"]["CRL ID"] );
+}
+
+void testRecoTreeArenaCoRef()
+{
+  std::cout << "------- Tests with chronicle ( (A B->x) && (B->y D) ) coreferencing the Bs, recognitions in an arena" 
+              << std::endl << std::endl;
+
+  RecognitionEngine engine(&std::cout, RecognitionEngine::VERBOSE);
+  engine.setRecoTreeArena(1024);
+  ChronicleConjunction& ABandBDcoref = ($(A)+$$($(B),x)) && ($$($(B),y)+$(D))  ;
+  ChronicleConjunction& ABandBD = ($(A)+$(B)) && ($(B)+$(D))  ;
+  ABandBDcoref.setPredicateFunction(testRecoTreeArena_pred);
+  engine.addChronicle(ABandBDcoref);
+  engine.addChronicle(ABandBD);
+
+  engine << 0.0 << "A" << "B" << "B" << "D" << flush;
+  CRL::testInteger((long)ABandBD.getRecognitionSet().size(),    4, false);
+  CRL::testInteger((long)ABandBDcoref.getRecognitionSet().size(),    2, false);
+  CRL::testInteger((long)(engine.getRecoTreeArena()->getLiveCount() > 0), 1, false);
+
+  // Properties of the recognitions allocated in the arena
+  const RecoTree* r = *ABandBDcoref.getRecognitionSet().begin();
+  CRL::testInteger((long)(*r)["x"]["CRL ID"], (long)(*r)["y"]["CRL ID"], false);
+
+  std::cout << std::endl;
+
+  ABandBDcoref.deepDestroy();
+  ABandBD.deepDestroy();
+  CRL::testInteger((long)engine.getRecoTreeArena()->getLiveCount(), 0, false);
+}
+
+void testRecoTreeArenaPurge()
+{
+  std::cout << "------- Tests with chronicle (A B) and forget duration 2, recognitions in an arena or on the heap" 
+              << std::endl << std::endl;
+
+  RecognitionEngine heapEngine, arenaEngine;
+  arenaEngine.setRecoTreeArena(4096);
+  ChronicleSequence& heapAB = ($(A) + $(B));
+  ChronicleSequence& arenaAB = ($(A) + $(B));
+  heapEngine.addChronicle(heapAB);
+  arenaEngine.addChronicle(arenaAB);
+  heapEngine.activateForget(2.0);
+  arenaEngine.activateForget(2.0);
+
+  for (int i=0; i<2000; i++)
+  {
+    heapEngine << (double)i << "A" << "B" << flush;
+    arenaEngine << (double)i << "A" << "B" << flush;
+  }
+  CRL::testInteger((long)arenaAB.getRecognitionSet().size(), 
+                   (long)heapAB.getRecognitionSet().size(), false);
+  CRL::testInteger((long)arenaAB.getOpLeft()->getRecognitionSet().size(), 
+                   (long)heapAB.getOpLeft()->getRecognitionSet().size(), false);
+
+  // The segments of the purged recognitions have been freed as a whole
+  const RecoTreeArena* arena = arenaEngine.getRecoTreeArena();
+  CRL::testInteger((long)(arena->getFreedSegmentCount() > 0), 1, false);
+  CRL::testInteger((long)(arena->getSegmentCount() <= 4), 1, false);
+
+  std::cout << std::endl;
+
+  heapAB.deepDestroy();
+  arenaAB.deepDestroy();
+  CRL::testInteger((long)arena->getLiveCount(), 0, false);
+}
+
+void testRecoTreeArenaSegments()
+{
+  std::cout << "------- Tests of the segments of an arena" << std::endl << std::endl;
+
+  RecognitionEngine engine;
+  engine.setRecoTreeArena(256);
+  const RecoTreeArena* arena = engine.getRecoTreeArena();
+
+  // The segments are made of whole granules
+  CRL::testInteger((long)arena->getSegmentSize(), (long)SegmentedArena::GRANULE, false);
+
+  // Allocations larger than a segment, and allocations on the heap outside a scope
+  void* big = NULL;
+  void* heap = RecoTreeArena::allocateCurrent(64);
+  {
+    RecoTreeArena::Scope scope(const_cast<RecoTreeArena*>(arena));
+    big = RecoTreeArena::allocateCurrent(3*SegmentedArena::GRANULE);
+  }
+  CRL::testInteger((long)arena->getSegmentCount(), 1, false);
+  CRL::testInteger((long)arena->getLiveCount(), 1, false);
+  CRL::testInteger((long)(RecoTreeArena::getCurrent() == NULL), 1, false);
+  RecoTreeArena::deallocateAny(big);
+  RecoTreeArena::deallocateAny(heap);
+  CRL::testInteger((long)arena->getSegmentCount(), 0, false);
+  CRL::testInteger((long)arena->getFreedSegmentCount(), 1, false);
+
+  std::cout << std::endl;
+}
+
+void testRecoTreeArenaLayout()
+{
+  std::cout << "------- Tests of the nodes without vtable" << std::endl << std::endl;
+
+  CRL::testInteger((long)std::is_polymorphic<RecoTree>::value, 0, false);
+  CRL::testInteger((long)sizeof(RecoTreeCouple), (long)(sizeof(RecoTree) + 2*sizeof(void*)), false);
+
+  RecognitionEngine engine;
+  engine.setRecoTreeArena(4096);
+  const RecoTreeArena* arena = engine.getRecoTreeArena();
+  Event* e = new Event("A", 1.0);
+  e->setOrder(5);
+  {
+    RecoTreeArena::Scope scope(const_cast<RecoTreeArena*>(arena));
+    RecoTree* single = new RecoTreeSingle(e);
+    single->copyDateAndOrder(*e);
+    RecoTree* none = new RecoTree(2, 3, 2.0, 3.0);
+    RecoTree* couple = new RecoTreeCouple(single, none);
+    couple->copyDateAndOrder(*single, *none);
+    couple->addRef();
+    CRL::testInteger((long)arena->getLiveCount(), 3, false);
+
+    // The methods dispatch on the arity
+    CRL::testInteger((long)(couple->getLeftMember()->getEvent() == e), 1, false);
+    CRL::testInteger((long)(couple->getRightMember()->getEvent() == NULL), 1, false);
+    CRL::testInteger((long)(couple->lastEvent() == e), 1, false);
+    RecoTree* other = new RecoTree(2, 3, 2.0, 3.0);
+    CRL::testInteger((long)none->equal(other), 1, false);
+    CRL::testInteger((long)single->equal(other), 0, false);
+    other->release();
+
+    // The sub-class is destroyed, with its members
+    couple->release();
+    CRL::testInteger((long)arena->getLiveCount(), 0, false);
+  }
+  delete e;
+
+  std::cout << std::endl;
+}
+
+void testRecoTreeArena()
+{
+  CRL::CRL_ErrReport::START("CRL","RecoTreeArena");
+  std::cout << "##### ------- Tests of the recognition tree arenas" 
+              << std::endl << std::endl;
+  testRecoTreeArenaCoRef();
+  testRecoTreeArenaPurge();
+  testRecoTreeArenaSegments();
+  testRecoTreeArenaLayout();
+  Event::freeAllInstances();
+  std::cout << std::endl;
+}
+
+
+#ifdef UNITARY_TEST
+int main() 
+{
+  try
+  {
+    testRecoTreeArena();
+    
+    CRL::CRL_ErrReport::PRINT_ALL();
+
+    return 0;
+  }
+
+  catch(std::string& msg) {                        
+    std::cout << "main : "     
+    << msg << std::endl;
+    return 1;                                      
+  }                                                
+  catch(const char* msg) {                         
+  std::cout << "main : "       
+  << msg << std::endl;
+  return 1;                                        
+  }                                                                                           
+  catch(...) {                                     
+  std::cout << "main : Unknown Exception"
+  << std::endl;
+  return 1;                                        
+  }
+
+}
+#endif
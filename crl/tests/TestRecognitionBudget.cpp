@@ -0,0 +1,193 @@
+/** ***********************************************************************************
+ * \file TestRecognitionBudget.cpp
+ * \author Ariane Piel & Jean Bourrely / Onera DCPS
+ * \date 2014
+ * \brief Test Recognition Budget
+ **************************************************************************************/
+
+/*  Copyright (C) 2012, 2013, 2014  ONERA  http://www.onera.fr
+    This file is part of CRL : Chronicle Recognition Library.
+
+    CRL is free software: you can redistribute it and/or modify it under
+    the terms of the Lesser GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    CRL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    Lesser GNU General Public License for more details.
+
+    You should have received a copy of the Lesser GNU General Public License
+    along with CRL.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// ----------------------------------------------------------------------------
+// INCLUDE FILES
+// ----------------------------------------------------------------------------
+
+#include "TestUtils.h"
+#include "Operators.h"
+#include "RecognitionEngine.h"
+
+using namespace CRL;
+
+
+// ----------------------------------------------------------------------------
+// UNIT TESTS
+// ----------------------------------------------------------------------------
+
+void testRecognitionBudgetPolicy(RecoBudget::Policy policy, const std::string& name)
+{
+  std::cout << "------- Tests with chronicle (A B), budget of 2 recognitions on A, policy " 
+            << name << std::endl << std::endl;
+
+  RecognitionEngine engine(&std::cout, RecognitionEngine::VERBOSE);
+
+  ChronicleSequence& AB = ($(A) + $(B));
+  engine.addChronicle(AB);
+  AB.getOpLeft()->setRecognitionBudget(2, policy);
+
+  engine << 0.0 << "A" << 1.0 << "A" << 2.0 << "A" << 3.0 << "A" << flush;
+  CRL::testInteger((long)AB.getOpLeft()->getRecognitionSet().size(), 2, false);
+  CRL::testInteger((long)AB.getOpLeft()->getEvictionCount(), 2, false);
+
+  // The two most recent A are kept
+  engine << 4.0 << "B" << flush;
+  CRL::testInteger((long)AB.getRecognitionSet().size(), 2, false);
+  Chronicle::RecoSet::const_iterator it;
+  for (it=AB.getRecognitionSet().begin(); it!=AB.getRecognitionSet().end(); it++)
+    CRL::testInteger((long)((*it)->getLeftMember()->getMinDate() >= 2.0), 1, false);
+
+  std::cout << std::endl;
+
+  AB.deepDestroy();
+}
+
+void testRecognitionBudgetReservoir()
+{
+  std::cout << "------- Tests with chronicle (A B), budget of 3 recognitions on A, reservoir sampling" 
+            << std::endl << std::endl;
+
+  RecognitionEngine engine(&std::cout, RecognitionEngine::VERBOSE);
+
+  ChronicleSequence& AB = ($(A) + $(B));
+  engine.addChronicle(AB);
+  AB.getOpLeft()->setRecognitionBudget(3, RecoBudget::RESERVOIR);
+
+  for (int i=0; i<20; i++)
+    engine << (double)i << "A";
+  engine << flush;
+  CRL::testInteger((long)AB.getOpLeft()->getRecognitionSet().size(), 3, false);
+  CRL::testInteger((long)AB.getOpLeft()->getEvictionCount(), 17, false);
+
+  engine << 20.0 << "B" << flush;
+  CRL::testInteger((long)AB.getRecognitionSet().size(), 3, false);
+
+  // Budget removed: the set grows again
+  AB.getOpLeft()->setRecognitionBudget(-1);
+  engine << 21.0 << "A" << flush;
+  CRL::testInteger((long)AB.getOpLeft()->getRecognitionSet().size(), 4, false);
+  CRL::testInteger(AB.getOpLeft()->getRecognitionBudget(), -1, false);
+
+  std::cout << std::endl;
+
+  AB.deepDestroy();
+}
+
+void testRecognitionBudgetLate()
+{
+  std::cout << "------- Tests with chronicle (A B), budget of 1 recognition on A set after the recognitions" 
+            << std::endl << std::endl;
+
+  RecognitionEngine engine(&std::cout, RecognitionEngine::VERBOSE);
+
+  ChronicleSequence& AB = ($(A) + $(B));
+  engine.addChronicle(AB);
+
+  engine << 0.0 << "A" << 1.0 << "A" << 2.0 << "A" << flush;
+  AB.getOpLeft()->setRecognitionBudget(1);
+  CRL::testInteger((long)AB.getOpLeft()->getRecognitionSet().size(), 1, false);
+  CRL::testInteger((long)AB.getOpLeft()->getEvictionCount(), 2, false);
+  CRL::testDouble((*AB.getOpLeft()->getRecognitionSet().begin())->getMaxDate(), 2.0, false);
+
+  std::cout << std::endl;
+
+  AB.deepDestroy();
+}
+
+void testRecognitionBudgetEngine()
+{
+  std::cout << "------- Tests with chronicles (A B) and (A C), engine-wide budget of 4 recognitions" 
+            << std::endl << std::endl;
+
+  RecognitionEngine engine(&std::cout, RecognitionEngine::VERBOSE);
+  engine.setMaxTotalRecognitions(4);
+
+  ChronicleSequence& AB = ($(A) + $(B));
+  ChronicleSequence& AC = ($(A) + $(C));
+  engine.addChronicle(AB);
+  engine.addChronicle(AC);
+
+  engine << 0.0 << "A" << 1.0 << "A" << 2.0 << "A" << flush;
+  CRL::testInteger(engine.getTotalRecognitions(), 4, false);
+  CRL::testInteger((long)engine.getEvictionCount(), 2, false);
+  CRL::testInteger((long)AB.getOpLeft()->getRecognitionSet().size(), 2, false);
+  CRL::testInteger((long)AC.getOpLeft()->getRecognitionSet().size(), 2, false);
+
+  engine << 3.0 << "B" << flush;
+  CRL::testInteger(engine.getTotalRecognitions(), 4, false);
+  CRL::testInteger((long)AB.getRecognitionSet().size() + (long)AB.getOpLeft()->getRecognitionSet().size() +
+                   (long)AC.getOpLeft()->getRecognitionSet().size(), 4, false);
+
+  std::cout << std::endl;
+
+  AB.deepDestroy();
+  AC.deepDestroy();
+}
+
+void testRecognitionBudget()
+{
+  CRL::CRL_ErrReport::START("CRL","RecognitionBudget");
+  std::cout << "##### ------- Tests of the recognition budgets" 
+              << std::endl << std::endl;
+  testRecognitionBudgetPolicy(RecoBudget::OLDEST_MAX_DATE, "OLDEST_MAX_DATE");
+  testRecognitionBudgetPolicy(RecoBudget::OLDEST_INSERTION, "OLDEST_INSERTION");
+  testRecognitionBudgetReservoir();
+  testRecognitionBudgetLate();
+  testRecognitionBudgetEngine();
+  Event::freeAllInstances();
+  std::cout << std::endl;
+}
+
+
+#ifdef UNITARY_TEST
+int main() 
+{
+  try
+  {
+    testRecognitionBudget();
+    
+    CRL::CRL_ErrReport::PRINT_ALL();
+
+    return 0;
+  }
+
+  catch(std::string& msg) {                        
+    std::cout << "main : "     
+    << msg << std::endl;
+    return 1;                                      
+  }                                                
+  catch(const char* msg) {                         
+  std::cout << "main : "       
+  << msg << std::endl;
+  return 1;                                        
+  }                                                                                           
+  catch(...) {                                     
+  std::cout << "main : Unknown Exception"
+  << std::endl;
+  return 1;                                        
+  }
+
+}
+#endif
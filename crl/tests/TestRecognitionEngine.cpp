@@ -50,30 +50,32 @@ using namespace CRL;
 // UNIT TESTS
 // ----------------------------------------------------------------------------
 
+static DateType seconds(double s) { return DateTraits<DateType>::fromSeconds(s); }
+
 void testRecognitionEngine_addEvent()
 {
   RecognitionEngine r1(&std::cout, RecognitionEngine::DETAILED);
 
   // Adding a non-dated event to an empty buffer t=0, order=0
-  r1.setCurrentTime(0.0);
+  r1.setCurrentTime(seconds(0.0));
   Event a("a");
   r1.addEvent(&a, false);
-  CRL::testDouble((double)a.getDate(), 0.0, 1e-10, false);
+  CRL::testDouble(DateTraits<DateType>::toSeconds(a.getDate()), 0.0, 1e-10, false);
   CRL::testInteger(a.getOrder(), 0L, false);
   CRL::testInteger((long)r1.getEventBuffer().size(), 1L, false);
 
   // Adding a dated event to an empty buffer t=0, order=0
   r1.clearEventBuffer();
-  Event b("b", 2.5);
+  Event b("b", seconds(2.5));
   r1 << b;
-  CRL::testDouble((double)b.getDate(), 2.5, 1e-10, false);
+  CRL::testDouble(DateTraits<DateType>::toSeconds(b.getDate()), 2.5, 1e-10, false);
   CRL::testInteger(b.getOrder(), 1L, false);
   CRL::testInteger((long)r1.getEventBuffer().size(), 1, false);
 
   // Adding a second non-dated event in LAST_EVENT mode
   Event c("c");
   r1 << &c;
-  CRL::testDouble((double)c.getDate(), 2.5, 1e-10, false);
+  CRL::testDouble(DateTraits<DateType>::toSeconds(c.getDate()), 2.5, 1e-10, false);
   CRL::testInteger(c.getOrder(), 2L, false);
   CRL::testInteger((long)r1.getEventBuffer().size(), 2, false);
 
@@ -81,7 +83,7 @@ void testRecognitionEngine_addEvent()
   r1.setPolicyCurrentTime();
   Event d("d");
   r1 << d;
-  CRL::testDouble((double)d.getDate(), 0.0, 1e-10, false);
+  CRL::testDouble(DateTraits<DateType>::toSeconds(d.getDate()), 0.0, 1e-10, false);
   CRL::testInteger(d.getOrder(), 1L, false);
   CRL::testInteger(b.getOrder(), 2L, false);
   CRL::testInteger(c.getOrder(), 3L, false);
@@ -95,22 +97,22 @@ void testRecognitionEngine_addEvent()
   CRL::testBoolean(r1.isInsertionPolicyLastEvent(),    true, false);
 
   // Adding a fourth dated event in the middle of the buffer
-  Event e("e", 1.5);
+  Event e("e", seconds(1.5));
   r1 << e;
-  CRL::testDouble((double)e.getDate(), 1.5, 1e-10, false);
+  CRL::testDouble(DateTraits<DateType>::toSeconds(e.getDate()), 1.5, 1e-10, false);
   CRL::testInteger(e.getOrder(), 2L, false);
   CRL::testInteger(d.getOrder(), 1L, false);
   CRL::testInteger(b.getOrder(), 3L, false);
   CRL::testInteger(c.getOrder(), 4L, false);
 
   // Adding a fifth and a sixth dated events at the end of the buffer
-  Event f("f", 2.5);
+  Event f("f", seconds(2.5));
   r1 << f;
-  CRL::testDouble((double)f.getDate(), 2.5, 1e-10, false);
+  CRL::testDouble(DateTraits<DateType>::toSeconds(f.getDate()), 2.5, 1e-10, false);
   CRL::testInteger(f.getOrder(), 5L, false);
-  Event g("g", 3.5);
+  Event g("g", seconds(3.5));
   r1 << g;
-  CRL::testDouble((double)g.getDate(), 3.5, 1e-10, false);
+  CRL::testDouble(DateTraits<DateType>::toSeconds(g.getDate()), 3.5, 1e-10, false);
   CRL::testInteger(g.getOrder(), 6L, false);
 
   // Tests of shortened operators
@@ -132,18 +134,18 @@ void testRecognitionEngine_process()
 {
   RecognitionEngine r1(&std::cout, RecognitionEngine::DETAILED);
 
-  CRL::testInteger(r1.process(0.0), 0, true);
+  CRL::testInteger(r1.process(seconds(0.0)), 0, true);
   r1 << "a";
-  CRL::testInteger(r1.process(0.0), 1, true);
-  Event b("b", 1.5);
+  CRL::testInteger(r1.process(seconds(0.0)), 1, true);
+  Event b("b", seconds(1.5));
   r1 << b;
-  Event c("c", 2.5);
+  Event c("c", seconds(2.5));
   r1 << c;
-  CRL::testInteger(r1.process(2.0), 1, true);
-  CRL::testInteger(r1.process(2.0), 0, true);
-  CRL::testInteger(r1.process(2.5), 1, true);
-  CRL::testInteger(r1.process(2.5), 0, true);
-  CRL::testInteger(r1.process(3.5), 0, true);
+  CRL::testInteger(r1.process(seconds(2.0)), 1, true);
+  CRL::testInteger(r1.process(seconds(2.0)), 0, true);
+  CRL::testInteger(r1.process(seconds(2.5)), 1, true);
+  CRL::testInteger(r1.process(seconds(2.5)), 0, true);
+  CRL::testInteger(r1.process(seconds(3.5)), 0, true);
 
 
   std::cout << std::endl;
@@ -172,6 +174,55 @@ void testRecognitionEngine_lookAhead()
 }
 
 
+bool testRecognitionEngine_share_pred(const PropertyManager&)
+{
+  return true;
+}
+
+
+void testRecognitionEngine_share()
+{
+  RecognitionEngine engine(&std::cout, RecognitionEngine::VERBOSE);
+  engine.setShareSubChronicles(true);
+
+  ChronicleSequence& AB = ($(A) + $(B));
+  ChronicleConjunction& ABandC = (($(A) + $(B)) && $(C));
+  ChronicleSequence& ABthenD = (($(A) + $(B)) + $(D));
+  ChronicleSequence& AC = ($(A) + $(C));
+  ChronicleSequence& ABp = ($(A) + $(B));
+  ABp.setPredicateFunction(testRecognitionEngine_share_pred);
+  ChronicleConjunction& ABpandC = (ABp && $(C));
+  engine.addChronicle(AB);
+  engine.addChronicle(ABandC);
+  engine.addChronicle(ABthenD);
+  engine.addChronicle(AC);
+  engine.addChronicle(ABpandC);
+
+  CRL::testInteger((long)(ABandC.getOpLeft() == &AB), 1, false);
+  CRL::testInteger((long)(ABthenD.getOpLeft() == &AB), 1, false);
+  CRL::testInteger(AB.getShareCount(), 2, false);
+  CRL::testInteger((long)AB.isPurgeable(), 0, false);
+  CRL::testInteger((long)(AC.getOpLeft() == AB.getOpLeft()), 1, false);
+  CRL::testInteger((long)(ABandC.getOpRight() == AC.getOpRight()), 1, false);
+  // Different predicate: not shared, but its sub-chronicles are
+  CRL::testInteger((long)(ABpandC.getOpLeft() == &ABp), 1, false);
+  CRL::testInteger((long)(ABp.getOpRight() == AB.getOpRight()), 1, false);
+
+  engine << 0.0 << "A" << 1.0 << "B" << 2.0 << "C" << 3.0 << "D" << flush;
+  CRL::testInteger((long)AB.getRecognitionSet().size(), 1, false);
+  CRL::testInteger((long)ABandC.getRecognitionSet().size(), 1, false);
+  CRL::testInteger((long)ABthenD.getRecognitionSet().size(), 1, false);
+  CRL::testInteger((long)AC.getRecognitionSet().size(), 1, false);
+  CRL::testInteger((long)ABpandC.getRecognitionSet().size(), 1, false);
+
+  AB.deepDestroy();
+  ABandC.deepDestroy();
+  ABthenD.deepDestroy();
+  AC.deepDestroy();
+  ABpandC.deepDestroy();
+}
+
+
 void testRecognitionEngine()
 {
   CRL::CRL_ErrReport::START("CRL", "RecognitionEngine");
@@ -198,10 +249,16 @@ void testRecognitionEngine()
 
   CRL::testDouble((double)r1.getCurrentTime(), NO_DATE);
   CRL::testInteger(r1.getCurrentOrder(), 0L);
-  r1.setCurrentTime(2.5);
+  r1.setCurrentTime(seconds(2.5));
   r1.setCurrentOrder(10L);
-  CRL::testDouble((double)r1.getCurrentTime(), 2.5);
+  CRL::testDouble(DateTraits<DateType>::toSeconds(r1.getCurrentTime()), 2.5);
   CRL::testInteger(r1.getCurrentOrder(), 10L);
+
+  // A fractional number of time units is rejected by the exact representations
+  bool rejected = false;
+  try { r1 << 0.5; } catch (const char*) { rejected = true; }
+  CRL::testBoolean(rejected, DateTraits<DateType>::exact);
+  r1.clearEventBuffer();
   std::cout << std::endl;
 
   std::cout << "------- addEvent/clearEventBuffer functions" << std::endl << std::endl;
@@ -216,6 +273,10 @@ void testRecognitionEngine()
 
   testRecognitionEngine_lookAhead();
 
+  std::cout << "------- Sharing of sub-chronicles" << std::endl << std::endl;
+
+  testRecognitionEngine_share();
+
   Event::freeAllInstances();
   std::cout << std::endl;
 
@@ -0,0 +1,231 @@
+/** ***********************************************************************************
+ * \file TestRecognitionSink.cpp
+ * \author Ariane Piel & Jean Bourrely / Onera DCPS
+ * \date 2014
+ * \brief Unit tests of the binary records of the recognitions
+ **************************************************************************************/
+
+/*  Copyright (C) 2012, 2013, 2014  ONERA  http://www.onera.fr
+    This file is part of CRL : Chronicle Recognition Library.
+
+    CRL is free software: you can redistribute it and/or modify it under
+    the terms of the Lesser GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    CRL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    Lesser GNU General Public License for more details.
+
+    You should have received a copy of the Lesser GNU General Public License
+    along with CRL.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// ----------------------------------------------------------------------------
+// INCLUDE FILES
+// ----------------------------------------------------------------------------
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+#include "TestUtils.h"
+#include "Operators.h"
+#include "RecognitionEngine.h"
+#include "RecognitionSink.h"
+
+using namespace CRL;
+
+
+// ----------------------------------------------------------------------------
+// UNIT TESTS
+// ----------------------------------------------------------------------------
+
+//! Feeds A A B C B, the B events having a string property "name"
+void testRecognitionSink_feed(RecognitionEngine& engine)
+{
+  engine << 1.0 << "A" << 2.0 << "A";
+  Event* b = new Event("B", 3.0);
+  (*b)["name"] = std::string("bob");
+  engine.addEvent(b, true);
+  engine << 4.0 << "C";
+  b = new Event("B", 5.0);
+  (*b)["name"] = std::string("bill");
+  engine.addEvent(b, true);
+  engine << flush;
+}
+
+
+void testRecognitionSink_ring()
+{
+  std::cout << "------- Tests of the binary records in a ring buffer" << std::endl << std::endl;
+
+  RecognitionEngine engine(&std::cout, RecognitionEngine::SILENT);
+  ChronicleSequence& AB = ($$($(A),a) + $$($(B),b));
+  engine.addChronicle(AB);
+
+  RingRecordWriter ring(4096);
+  RecognitionSink sink(ring);
+  RecoIndex::PropertyPath idOfA, nameOfB;
+  idOfA.push_back("a");
+  idOfA.push_back("CRL ID");
+  nameOfB.push_back("b");
+  nameOfB.push_back("name");
+  sink.selectProperty(idOfA);
+  sink.selectProperty(nameOfB);
+  sink.selectProperty("missing");
+  sink.setChronicleId(&AB, 7);
+  engine.setRecognitionSink(&sink);
+
+  testRecognitionSink_feed(engine);
+  CRL::testInteger((long)sink.getRecordCount(), 4, false);
+
+  // Header : magic number, version, size of the dates, selected properties
+  const std::string& header = ring.getHeader();
+  CRL::testBoolean(header.compare(0, 4, "CRLR") == 0, true, false);
+  unsigned short version, dateSize, nbPaths;
+  std::memcpy(&version, header.data() + 4, 2);
+  std::memcpy(&dateSize, header.data() + 6, 2);
+  std::memcpy(&nbPaths, header.data() + 8, 2);
+  CRL::testInteger(version, RecognitionSink::VERSION, false);
+  CRL::testInteger(dateSize, sizeof(DateType), false);
+  CRL::testInteger(nbPaths, 3, false);
+
+  std::string data;
+  long count = 0;
+  while (ring.read(data))
+  {
+    RecognitionSink::Record record;
+    CRL::testBoolean(RecognitionSink::decode(data, record), true, false);
+    CRL::testInteger(record.chronicleId, 7, false);
+    CRL::testInteger((long)record.events.size(), 2, false);
+    CRL::testInteger((long)record.events[0], (long)record.minOrder, false);
+    CRL::testInteger((long)record.events[1], (long)record.maxOrder, false);
+    CRL::testBoolean(record.minDate < record.maxDate, true, false);
+    CRL::testInteger((long)record.properties.size(), 3, false);
+    CRL::testInteger(record.properties[0].type, Property::L, false);
+    CRL::testInteger((long)record.properties[0].l, (long)record.minOrder, false);
+    CRL::testInteger(record.properties[1].type, Property::STR, false);
+    CRL::testString(record.properties[1].str.c_str(), (record.maxDate == 3.0) ? "bob" : "bill", false);
+    CRL::testInteger(record.properties[2].type, Property::NONE, false);
+    count++;
+  }
+  CRL::testInteger(count, 4, false);
+  CRL::testInteger((long)ring.size(), 0, false);
+
+  // A small ring only keeps the last records
+  RingRecordWriter small(150);
+  RecognitionSink sink2(small);
+  sink2.write(**AB.getRecognitionSet().begin());
+  sink2.write(**AB.getRecognitionSet().begin());
+  sink2.write(**AB.getRecognitionSet().begin());
+  CRL::testInteger((long)small.getDroppedCount(), 1, false);
+  RecognitionSink::Record record;
+  CRL::testBoolean(small.read(data) && RecognitionSink::decode(data, record), true, false);
+  CRL::testBoolean(small.read(data) && RecognitionSink::decode(data, record), true, false);
+  CRL::testBoolean(small.read(data), false, false);
+
+  std::cout << std::endl;
+
+  AB.deepDestroy();
+}
+
+
+void testRecognitionSink_file()
+{
+  std::cout << "------- Tests of the binary records in a file" << std::endl << std::endl;
+
+  const char* path = "TestRecognitionSink.bin";
+  RecognitionEngine engine(&std::cout, RecognitionEngine::SILENT);
+  ChronicleSequence& AB = ($(A) + $(B));
+  ChronicleSequence& AC = ($(A) + $(C));
+  engine.addChronicle(AB);
+  engine.addChronicle(AC);
+  {
+    FileRecordWriter file(path, 64);
+    RecognitionSink sink(file);
+    engine.setRecognitionSink(&sink);
+    testRecognitionSink_feed(engine);
+    engine.setRecognitionSink(NULL);
+    CRL::testInteger((long)sink.getRecordCount(), 6, false);
+    CRL::testInteger(sink.getChronicleId(&AB), 0, false);
+    CRL::testInteger(sink.getChronicleId(&AC), 1, false);
+  }
+
+  std::ifstream in(path, std::ios::binary);
+  std::ostringstream os;
+  os << in.rdbuf();
+  std::string contents = os.str();
+  in.close();
+  std::remove(path);
+
+  // Header without selected property, then the records
+  CRL::testBoolean(contents.compare(0, 4, "CRLR") == 0, true, false);
+  size_t pos = 10;
+  long count = 0, countAC = 0;
+  while (pos + 4 <= contents.size())
+  {
+    unsigned int length;
+    std::memcpy(&length, contents.data() + pos, 4);
+    RecognitionSink::Record record;
+    CRL::testBoolean(RecognitionSink::decode(contents.substr(pos, 4 + length), record), true, false);
+    CRL::testInteger((long)record.properties.size(), 0, false);
+    if (record.chronicleId == 1) countAC++;
+    pos += 4 + length;
+    count++;
+  }
+  CRL::testInteger((long)pos, (long)contents.size(), false);
+  CRL::testInteger(count, 6, false);
+  CRL::testInteger(countAC, 2, false);
+
+  std::cout << std::endl;
+
+  AB.deepDestroy();
+  AC.deepDestroy();
+}
+
+
+void testRecognitionSink()
+{
+  CRL::CRL_ErrReport::START("CRL","RecognitionSink");
+  std::cout << "##### ------- Tests of the binary records of the recognitions" 
+              << std::endl << std::endl;
+  testRecognitionSink_ring();
+  testRecognitionSink_file();
+  Event::freeAllInstances();
+  std::cout << std::endl;
+}
+
+
+#ifdef UNITARY_TEST
+int main() 
+{
+  try
+  {
+    testRecognitionSink();
+    
+    CRL::CRL_ErrReport::PRINT_ALL();
+
+    return 0;
+  }
+
+  catch(std::string& msg) {                        
+    std::cout << "main : "     
+    << msg << std::endl;
+    return 1;                                      
+  }                                                
+  catch(const char* msg) {                         
+  std::cout << "main : "       
+  << msg << std::endl;
+  return 1;                                        
+  }                                                                                           
+  catch(...) {                                     
+  std::cout << "main : Unknown Exception"
+  << std::endl;
+  return 1;                                        
+  }
+
+}
+#endif
@@ -184,6 +184,67 @@ void testSequenceWithPredicate()
 }
 
 
+//! Number of recognitions of \a rs beginning at \a d
+long countBeginningAt(const Chronicle::RecoSet& rs, const DateType& d)
+{
+  long n = 0;
+  Chronicle::RecoSet::const_iterator it;
+  for (it=rs.begin(); it!=rs.end(); it++)
+    if ((*it)->getMinDate() == d) n++;
+  return n;
+}
+
+
+void testSequencePolicies()
+{
+  std::cout << "------- Tests with chronicle (A B) and selection policies" << std::endl << std::endl;
+
+  RecognitionEngine engine(&std::cout, RecognitionEngine::VERBOSE);
+  ChronicleSequence& all      = ($(A) + $(B));
+  ChronicleSequence& earliest = ($(A) + $(B));
+  ChronicleSequence& recent   = ($(A) + $(B));
+  ChronicleSequence& strict   = ($(A) + $(B));
+  ChronicleSequence& consumed = ($(A) + $(B));
+  ChronicleSequence& allConsumed = ($(A) + $(B));
+  earliest.setSelectionPolicy(ChronicleBinaryOp::EARLIEST);
+  recent.setSelectionPolicy(ChronicleBinaryOp::MOST_RECENT);
+  strict.setSelectionPolicy(ChronicleBinaryOp::STRICT_CONTIGUITY);
+  consumed.setSelectionPolicy(ChronicleBinaryOp::EARLIEST);
+  consumed.setConsumeOnMatch(true);
+  allConsumed.setConsumeOnMatch(true);
+  ChronicleSequence* chronicles[] = { &all, &earliest, &recent, &strict, &consumed, &allConsumed, NULL };
+  for (int i=0; chronicles[i] != NULL; i++)
+    engine.addChronicle(chronicles[i]);
+
+  engine << 1.0 << "A" << 2.0 << "A" << 3.0 << "C" << 4.0 << "B" << flush;
+  CRL::testInteger((long)all.getRecognitionSet().size(), 2, false);
+  CRL::testInteger(countBeginningAt(earliest.getRecognitionSet(), 1.0), 1, false);
+  CRL::testInteger(countBeginningAt(recent.getRecognitionSet(), 2.0), 1, false);
+  CRL::testInteger((long)strict.getRecognitionSet().size(), 0, false);
+  CRL::testInteger(countBeginningAt(consumed.getRecognitionSet(), 1.0), 1, false);
+  CRL::testInteger((long)allConsumed.getRecognitionSet().size(), 2, false);
+
+  // The dates are events too: B directly follows A
+  engine << 5.0 << "A" << "B" << flush;
+  CRL::testInteger((long)all.getRecognitionSet().size(), 5, false);
+  // The earliest A is selected again, unless consumed
+  CRL::testInteger(countBeginningAt(earliest.getRecognitionSet(), 1.0), 2, false);
+  CRL::testInteger(countBeginningAt(consumed.getRecognitionSet(), 2.0), 1, false);
+  CRL::testInteger((long)consumed.getOpLeft()->getRecognitionSet().size(), 1, false);
+  CRL::testInteger(countBeginningAt(recent.getRecognitionSet(), 5.0), 1, false);
+  CRL::testInteger(countBeginningAt(strict.getRecognitionSet(), 5.0), 1, false);
+  CRL::testInteger((long)strict.getRecognitionSet().size(), 1, false);
+  // Each A takes part in one recognition only
+  CRL::testInteger((long)allConsumed.getRecognitionSet().size(), 3, false);
+  CRL::testInteger((long)allConsumed.getOpLeft()->getRecognitionSet().size(), 0, false);
+
+  std::cout << std::endl;
+
+  for (int i=0; chronicles[i] != NULL; i++)
+    chronicles[i]->deepDestroy();
+}
+
+
 void testChronicleSequence()
 {
   CRL::CRL_ErrReport::START("CRL","ChronicleSequence");
@@ -194,6 +255,7 @@ void testChronicleSequence()
   testNoDistributivityConjOverSeq();
   testSurplusDeRecoSeq();
   testSequenceWithPredicate();
+  testSequencePolicies();
   Event::freeAllInstances();
   std::cout << std::endl;
 }
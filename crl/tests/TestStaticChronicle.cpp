@@ -0,0 +1,213 @@
+/** ***********************************************************************************
+ * \file TestStaticChronicle.cpp
+ * \author Ariane Piel & Jean Bourrely / Onera DCPS
+ * \date 2014
+ * \brief Unit tests of the static chronicles
+ **************************************************************************************/
+
+/*  Copyright (C) 2012, 2013, 2014  ONERA  http://www.onera.fr
+    This file is part of CRL : Chronicle Recognition Library.
+
+    CRL is free software: you can redistribute it and/or modify it under
+    the terms of the Lesser GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    CRL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    Lesser GNU General Public License for more details.
+
+    You should have received a copy of the Lesser GNU General Public License
+    along with CRL.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+// ----------------------------------------------------------------------------
+// INCLUDE FILES
+// ----------------------------------------------------------------------------
+
+#include <algorithm>
+#include <sstream>
+#include <vector>
+
+#include "TestUtils.h"
+#include "Operators.h"
+#include "RecognitionEngine.h"
+#include "StaticChronicle.h"
+
+using namespace CRL;
+
+
+// ----------------------------------------------------------------------------
+// UNIT TESTS
+// ----------------------------------------------------------------------------
+
+//! Number of chronicles built by #testStaticChronicle_build
+const int testStaticChronicle_nb = 5;
+
+
+//! Returns the dates and orders of the recognitions of \a cr, sorted (duplicates kept)
+std::string testStaticChronicle_recognitions(Chronicle& cr)
+{
+  std::vector<std::string> recos;
+  Chronicle::RecoSet::const_iterator it;
+  for (it=cr.getRecognitionSet().begin(); it!=cr.getRecognitionSet().end(); it++)
+  {
+    std::ostringstream os;
+    os << (*it)->getMinDate() << "," << (*it)->getMinOrder() << "-" 
+       << (*it)->getMaxDate() << "," << (*it)->getMaxOrder();
+    recos.push_back(os.str());
+  }
+  std::sort(recos.begin(), recos.end());
+  std::string s;
+  for (size_t i=0; i<recos.size(); i++)
+    s += recos[i] + " ";
+  return s;
+}
+
+
+//! Builds the same chronicles with the runtime operators and with the static ones
+void testStaticChronicle_build(Chronicle* chronicles[], Chronicle* staticChronicles[])
+{
+  chronicles[0] = &($(A) + $(B));
+  staticChronicles[0] = &Static::makeChronicle($S(A) + $S(B));
+  chronicles[1] = &(($(A) + $(B)) && $(C));
+  staticChronicles[1] = &Static::makeChronicle(($S(A) + $S(B)) && $S(C));
+  chronicles[2] = &(($(A) || $(B)) + $(C));
+  staticChronicles[2] = &Static::makeChronicle(($S(A) || $S(B)) + $S(C));
+  chronicles[3] = &(($(A) + $(C)) - $(B));
+  staticChronicles[3] = &Static::makeChronicle(($S(A) + $S(C)) - $S(B));
+  chronicles[4] = &(($(A) + ($(B) && $(D))) + $(C));
+  staticChronicles[4] = &Static::makeChronicle(($S(A) + ($S(B) && $S(D))) + $S(C));
+}
+
+
+//! Feeds the same pseudo-random stream to both engines
+void testStaticChronicle_feed(RecognitionEngine& engine, RecognitionEngine& staticEngine)
+{
+  const char* names[] = { "A", "B", "C", "D", "E" };
+  unsigned long seed = 7;
+  double date = 0.0;
+  for (int i=0; i<60; i++)
+  {
+    seed = seed * 1103515245 + 12345;
+    date += (double)((seed >> 4) % 3);
+    engine << date << names[(seed >> 16) % 5];
+    staticEngine << date << names[(seed >> 16) % 5];
+  }
+  engine << flush;
+  staticEngine << flush;
+}
+
+
+void testStaticChronicle_equivalence(double peremption)
+{
+  std::cout << "------- Tests of the static chronicles against the runtime ones";
+  if (peremption >= 0.0)
+    std::cout << " (peremption duration " << peremption << ")";
+  std::cout << std::endl << std::endl;
+
+  RecognitionEngine engine(&std::cout, RecognitionEngine::SILENT);
+  RecognitionEngine staticEngine(&std::cout, RecognitionEngine::SILENT);
+  Chronicle* chronicles[testStaticChronicle_nb];
+  Chronicle* staticChronicles[testStaticChronicle_nb];
+  testStaticChronicle_build(chronicles, staticChronicles);
+  for (int i=0; i<testStaticChronicle_nb; i++)
+  {
+    if (peremption >= 0.0)
+    {
+      chronicles[i]->setPeremptionDuration(peremption, true);
+      staticChronicles[i]->setPeremptionDuration(peremption, true);
+    }
+    engine.addChronicle(chronicles[i]);
+    staticEngine.addChronicle(staticChronicles[i]);
+  }
+
+  testStaticChronicle_feed(engine, staticEngine);
+
+  for (int i=0; i<testStaticChronicle_nb; i++)
+  {
+    CRL::testBoolean(chronicles[i]->getRecognitionSet().size() > 0, true, false);
+    CRL::testString(testStaticChronicle_recognitions(*staticChronicles[i]).c_str(),
+                    testStaticChronicle_recognitions(*chronicles[i]).c_str(), false);
+  }
+
+  std::cout << std::endl;
+
+  for (int i=0; i<testStaticChronicle_nb; i++)
+  {
+    chronicles[i]->deepDestroy();
+    staticChronicles[i]->deepDestroy();
+  }
+}
+
+
+void testStaticChronicle_display()
+{
+  std::cout << "------- Tests of the display of the static chronicles" << std::endl << std::endl;
+
+  RecognitionEngine engine(&std::cout, RecognitionEngine::SILENT);
+  Chronicle& cr = Static::makeChronicle(($S(A) + $S(B)) - $S(C));
+  engine.addChronicle(&cr);
+  CRL::testString(cr.toString().c_str(), "((A B)-C)", false);
+
+  engine << 1.0 << "A" << 2.0 << "C" << 3.0 << "B" << 4.0 << "A" << 5.0 << "B" << flush;
+  CRL::testInteger(cr.getRecognitionSet().size(), 1, false);
+
+  const RecoTree* rc = *cr.getRecognitionSet().begin();
+  CRL::testInteger(rc->getArity(), 0, false);
+  CRL::testDouble(rc->getMinDate(), 4.0, 0.0, false);
+  CRL::testDouble(rc->getMaxDate(), 5.0, 0.0, false);
+  std::ostringstream os;
+  rc->prettyPrint(os, 0);
+  CRL::testString(os.str().c_str(), "<[4,5]>\n", false);
+
+  std::cout << std::endl;
+  cr.deepDestroy();
+}
+
+
+void testStaticChronicle()
+{
+  CRL::CRL_ErrReport::START("CRL","StaticChronicle");
+  std::cout << "##### ------- Tests of the static chronicles" 
+              << std::endl << std::endl;
+  testStaticChronicle_equivalence(-1.0);
+  testStaticChronicle_equivalence(4.0);
+  testStaticChronicle_display();
+  Event::freeAllInstances();
+  std::cout << std::endl;
+}
+
+
+#ifdef UNITARY_TEST
+int main() 
+{
+  try
+  {
+    testStaticChronicle();
+    
+    CRL::CRL_ErrReport::PRINT_ALL();
+
+    return 0;
+  }
+
+  catch(std::string& msg) {                        
+    std::cout << "main : "     
+    << msg << std::endl;
+    return 1;                                      
+  }                                                
+  catch(const char* msg) {                         
+  std::cout << "main : "       
+  << msg << std::endl;
+  return 1;                                        
+  }                                                                                           
+  catch(...) {                                     
+  std::cout << "main : Unknown Exception"
+  << std::endl;
+  return 1;                                        
+  }
+
+}
+#endif